@@ -9,26 +9,61 @@
 //
 //*********************************************************
 
+// Per vertex: a corner of the unit quad. Per instance: a SpriteInstance (see SpriteBatch.h).
+struct VSInput
+{
+    float2 corner : POSITION;
+    float4 rect : RECT;         // x, y, width, height in pixels
+    float4 uvRect : UVRECT;     // u, v, width, height in normalized texture coordinates
+    float4 color : COLOR;
+    uint texture : TEXTURE;     // Slot in g_textures
+};
+
 struct PSInput
 {
     float4 position : SV_POSITION;
     float2 uv : TEXCOORD;
+    float4 color : COLOR;
+    nointerpolation uint texture : TEXTURE;
+};
+
+cbuffer FrameConstants : register(b0)
+{
+    float2 g_pixelToClip;       // 2 / viewport size
 };
 
-Texture2D g_texture : register(t0);
+// Bindless texture table. Every instance indexes it with its own texture, so texture changes don't break batches.
+Texture2D g_textures[] : register(t0);
 SamplerState g_sampler : register(s0);
+SamplerState g_linearSampler : register(s1);
 
-PSInput VSMain(float4 position : POSITION, float4 uv : TEXCOORD)
+PSInput VSMain(VSInput input)
 {
     PSInput result;
 
-    result.position = position;
-    result.uv = uv;
+    float2 pixel = input.rect.xy + input.corner * input.rect.zw;
+    result.position = float4(pixel.x * g_pixelToClip.x - 1.0f, 1.0f - pixel.y * g_pixelToClip.y, 0.0f, 1.0f);
+    result.uv = input.uvRect.xy + input.corner * input.uvRect.zw;
+    result.color = input.color;
+    result.texture = input.texture;
 
     return result;
 }
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return g_texture.Sample(g_sampler, input.uv);
+    // The index varies within a draw, which has to be declared or the hardware may only use one lane's value
+    return g_textures[NonUniformResourceIndex(input.texture)].Sample(g_sampler, input.uv) * input.color;
+}
+
+// Text is drawn as sprites whose texture is a glyph atlas holding signed distance fields in alpha (see GlyphAtlas.h):
+// 0.5 is the glyph edge. Filtering the distance rather than coverage keeps edges sharp at any size.
+float4 PSText(PSInput input) : SV_TARGET
+{
+    float distance = g_textures[NonUniformResourceIndex(input.texture)].Sample(g_linearSampler, input.uv).a;
+
+    // Antialias over one screen pixel, however much the glyph is scaled
+    float width = max(fwidth(distance), 1e-4f);
+    float coverage = smoothstep(0.5f - width, 0.5f + width, distance);
+    return float4(input.color.rgb, input.color.a * coverage);
 }
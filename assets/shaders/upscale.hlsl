@@ -0,0 +1,35 @@
+// Stretches the dynamic resolution scene target over the back buffer. The scene is rendered into the top left
+// corner of a target sized for the largest scale, so the UVs only cover the part that was rendered to.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+};
+
+cbuffer UpscaleConstants : register(b0)
+{
+    float2 g_uvScale;           // Rendered size / scene target size
+    float2 g_uvMax;             // Half a texel inside the rendered area
+};
+
+Texture2D g_scene : register(t0);
+SamplerState g_linearSampler : register(s1);
+
+// One triangle that covers the whole viewport, no vertex buffer needed
+PSInput VSMain(uint vertexId : SV_VertexID)
+{
+    PSInput result;
+
+    float2 corner = float2((vertexId << 1) & 2, vertexId & 2);
+    result.position = float4(corner.x * 2.0f - 1.0f, 1.0f - corner.y * 2.0f, 0.0f, 1.0f);
+    result.uv = corner * g_uvScale;
+
+    return result;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    // Bilinear filtering must not blend in texels outside the rendered area
+    return g_scene.Sample(g_linearSampler, min(input.uv, g_uvMax));
+}
@@ -74,6 +74,7 @@ public class BirdGameProject : Project
 		conf.LibraryFiles.Add("dxgi");
 		conf.LibraryFiles.Add("d3dcompiler");
 		conf.LibraryFiles.Add("dxguid");
+		conf.LibraryFiles.Add("shell32"); // CommandLineToArgvW
 
         // Copy Assets folder to destination. Mirror the file structure
         conf.EventPostBuildExe.Add(
@@ -87,10 +88,24 @@ public class BirdGameProject : Project
 			 )
         );
 
-        // Set the working directory in the user file so the program knows where to find the shader file
+        // Build the shader bytecode into the copied assets with the game's own -compileshaders. This has to run
+        // after the copy, whose mirroring deletes anything that isn't in the source assets folder.
+        conf.EventPostBuildExe.Add(
+            new Configuration.BuildStepExecutable(
+                Path.Join("[conf.TargetPath]", "[conf.TargetFileFullNameWithExtension]"),  // executableFile
+                "",                                                 // executableInputFileArgumentOption
+                "",                                                 // executableOutputFileArgumentOption
+                "-compileshaders",                                  // executableOtherArguments
+                "[conf.TargetPath]"                                 // executableWorkingDirectory
+            )
+        );
+
+        // Set the working directory in the user file so the program knows where to find the shader file.
+        // Shader hot reload watches the checkout rather than the copied assets, which every build overwrites.
         conf.VcxprojUserFile = new Configuration.VcxprojUserFileSettings()
         {
-            LocalDebuggerWorkingDirectory = "[conf.TargetPath]"
+            LocalDebuggerWorkingDirectory = "[conf.TargetPath]",
+            LocalDebuggerCommandArguments = "-sourceroot \"[project.SharpmakeCsPath]\""
         };
     }
 }
@@ -1,14 +1,27 @@
 #include "pch.h"
 #include "Application.h"
 
+#include "CommandLine.h"
+#include "MemoryReservation.h"
+#include "MemoryTracker.h"
 #include "RendererDX.h"
+#include "RenderTypes.h"
 #include "Window.h"
 
 #include <assert.h>
+#include <fstream>
+
+namespace
+{
+	// The whole address space budget is reserved up front so nothing is requested from the OS during gameplay
+	constexpr size_t kMemoryBudget = 512 * 1024 * 1024;
+	constexpr uint32_t kCaptureFramesPerSecond = 60; // Presentation is vsynced
+}
 
 std::unique_ptr<BirdGame::Application> BirdGame::Application::mInstance;
 
-BirdGame::Application::Application()
+BirdGame::Application::Application() :
+	mTestMode(false)
 {
 }
 
@@ -16,13 +29,52 @@ BirdGame::Application::~Application()
 {
 }
 
-void BirdGame::Application::Initialize(HINSTANCE hInstance, int nCmdShow)
+void BirdGame::Application::Initialize(HINSTANCE hInstance, int nCmdShow, const CommandLine& commandLine)
 {
 	mInstance.reset(new Application());
+	mInstance->mTestMode = commandLine.HasOption(L"-test");
+
+	// -largepages backs the reservation with large pages. This needs the "Lock pages in memory" privilege,
+	// we silently fall back to regular pages without it.
+	MemoryReservation::Settings memorySettings = {};
+	memorySettings.budget = kMemoryBudget;
+	memorySettings.useLargePages = commandLine.HasOption(L"-largepages");
+	mInstance->mMemory.reset(new MemoryReservation(memorySettings));
+
 	mInstance->mWindow.reset(new Window());
 	mInstance->mWindow->Initialize(L"Bird Game", 960, 720, hInstance, nCmdShow);
-	mInstance->mRenderer.reset(new RendererDX());
+
+	// -triplebuffer lets the CPU run up to three frames ahead of the GPU instead of two, at the cost of latency.
+	// -dev recompiles shaders whose precompiled bytecode is stale at runtime; debug builds always do.
+	RendererDX::Settings rendererSettings = {};
+	rendererSettings.framesInFlight = commandLine.HasOption(L"-triplebuffer") ? 3 : 2;
+#if defined(_DEBUG)
+	rendererSettings.developmentMode = true;
+#else
+	rendererSettings.developmentMode = commandLine.HasOption(L"-dev");
+#endif
+	// -sourceroot <checkout> hot reloads the shaders in the checkout instead of the copies next to the executable,
+	// which the next build overwrites. The debugger passes it, see main.sharpmake.cs.
+	rendererSettings.sourceRoot = commandLine.GetValue(L"-sourceroot");
+	// Drops to half resolution at worst when the GPU can't keep up
+	rendererSettings.minResolutionScale = 0.5f;
+	rendererSettings.maxResolutionScale = 1.0f;
+
+	// -screenshot saves the first frame to screenshot.png, -capture records the whole session to capture.y4m
+	const bool screenshot = commandLine.HasOption(L"-screenshot");
+	const bool captureVideo = commandLine.HasOption(L"-capture");
+	rendererSettings.frameCapture = screenshot || captureVideo;
+	mInstance->mRenderer.reset(new RendererDX(*mInstance->mMemory, rendererSettings));
 	mInstance->mRenderer->Initialize(*mInstance->mWindow);
+
+	if (screenshot)
+	{
+		mInstance->mRenderer->CaptureScreenshot("screenshot.png");
+	}
+	if (captureVideo)
+	{
+		mInstance->mRenderer->BeginVideoCapture("capture.y4m", kCaptureFramesPerSecond);
+	}
 }
 
 BirdGame::Application& BirdGame::Application::Instance()
@@ -31,6 +83,38 @@ BirdGame::Application& BirdGame::Application::Instance()
 	return *mInstance;
 }
 
+int BirdGame::Application::Shutdown()
+{
+	assert(mInstance != nullptr);
+	const bool testMode = mInstance->mTestMode;
+
+	mInstance->mRenderer->Shutdown();
+	mInstance->mWindow->Shutdown();
+
+	// Arena high-water marks are how we size the memory budget
+	std::string report;
+	mInstance->mMemory->WriteReport(report);
+	mInstance.reset();
+
+	// Everything should have been released by now, so anything left in the tracker is a leak
+	const size_t leakCount = MemoryTracker::WriteReport(report);
+	OutputDebugStringA(report.c_str());
+
+	if (testMode)
+	{
+		// Also write the report next to the executable so test runs without a debugger attached can inspect it
+		std::ofstream reportFile("memory_report.txt");
+		reportFile << report;
+
+		if (leakCount > 0)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 int BirdGame::Application::Run()
 {
 	while (mWindow->ProcessMessages())
@@ -55,5 +139,11 @@ void BirdGame::Application::Update()
 
 void BirdGame::Application::Render()
 {
+	// Placeholder scene until there is game state to draw
+	const float spriteSize = 256.0f;
+	const Rect rect = { (mWindow->GetWidth() - spriteSize) * 0.5f, (mWindow->GetHeight() - spriteSize) * 0.5f, spriteSize, spriteSize };
+	mRenderer->SubmitSprite(kDefaultTexture, rect, { 0.0f, 0.0f, 1.0f, 1.0f }, kWhite, 0);
+	mRenderer->SubmitText("Bird Game", { 48.0f, 0.0f, TextAlign::Left }, 16.0f, 16.0f, kWhite, 1);
+
 	mRenderer->Render();
 }
@@ -4,7 +4,9 @@
 
 namespace BirdGame
 {
+	class CommandLine;
 	class IRenderer;
+	class MemoryReservation;
 	class Window;
 
 	class Application final
@@ -12,9 +14,13 @@ namespace BirdGame
 	public:
 		~Application();
 
-		static void Initialize(HINSTANCE hInstance, int nCmdShow);
+		static void Initialize(HINSTANCE hInstance, int nCmdShow, const CommandLine& commandLine);
 		static Application& Instance();
 
+		// Shuts down all subsystems and writes the memory report.
+		// Returns a non-zero exit code if running in test mode and anything leaked.
+		static int Shutdown();
+
 		int Run();
 
 		// Windows message handlers
@@ -28,9 +34,15 @@ namespace BirdGame
 		void Update();
 		void Render();
 
+		// Declared first so it outlives every subsystem that carved an arena out of it
+		std::unique_ptr<MemoryReservation> mMemory;
+
 		std::unique_ptr<Window> mWindow;
 		std::unique_ptr<IRenderer> mRenderer;
 
+		// Set by passing -test on the command line. Leaks fail the run instead of only being reported.
+		bool mTestMode;
+
 		static std::unique_ptr<Application> mInstance;
 	};
 }
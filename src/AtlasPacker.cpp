@@ -0,0 +1,273 @@
+#include "pch.h"
+#include "AtlasPacker.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	struct PackRect
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	bool Contains(const PackRect& outer, const PackRect& inner)
+	{
+		return inner.x >= outer.x && inner.y >= outer.y &&
+			inner.x + inner.width <= outer.x + outer.width &&
+			inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	bool Intersects(const PackRect& a, const PackRect& b)
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width &&
+			a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	uint32_t NextPowerOfTwo(uint32_t value)
+	{
+		uint32_t result = 1;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	// One page worth of MaxRects state: the list of maximal free rectangles
+	class MaxRectsBin
+	{
+	public:
+		explicit MaxRectsBin(uint32_t size)
+		{
+			mFreeRects.push_back({ 0, 0, size, size });
+		}
+
+		// Best short side fit: pick the free rect that leaves the smallest leftover on its shorter side
+		bool Insert(uint32_t width, uint32_t height, PackRect& outPlacement)
+		{
+			uint32_t bestShortSide = UINT_MAX;
+			uint32_t bestLongSide = UINT_MAX;
+			const PackRect* best = nullptr;
+
+			for (const PackRect& freeRect : mFreeRects)
+			{
+				if (freeRect.width >= width && freeRect.height >= height)
+				{
+					const uint32_t leftoverX = freeRect.width - width;
+					const uint32_t leftoverY = freeRect.height - height;
+					const uint32_t shortSide = std::min(leftoverX, leftoverY);
+					const uint32_t longSide = std::max(leftoverX, leftoverY);
+					if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+					{
+						bestShortSide = shortSide;
+						bestLongSide = longSide;
+						best = &freeRect;
+					}
+				}
+			}
+
+			if (best == nullptr)
+			{
+				return false;
+			}
+
+			outPlacement = { best->x, best->y, width, height };
+			SplitFreeRects(outPlacement);
+			PruneFreeRects();
+			return true;
+		}
+
+	private:
+		// Replace every free rect overlapping the placement with up to four maximal rects around it
+		void SplitFreeRects(const PackRect& used)
+		{
+			const size_t count = mFreeRects.size();
+			for (size_t i = 0; i < count; ++i)
+			{
+				const PackRect freeRect = mFreeRects[i];
+				if (!Intersects(freeRect, used))
+				{
+					mSplit.push_back(freeRect);
+					continue;
+				}
+
+				if (used.x > freeRect.x)
+				{
+					mSplit.push_back({ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height });
+				}
+				if (used.x + used.width < freeRect.x + freeRect.width)
+				{
+					const uint32_t right = used.x + used.width;
+					mSplit.push_back({ right, freeRect.y, freeRect.x + freeRect.width - right, freeRect.height });
+				}
+				if (used.y > freeRect.y)
+				{
+					mSplit.push_back({ freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y });
+				}
+				if (used.y + used.height < freeRect.y + freeRect.height)
+				{
+					const uint32_t bottom = used.y + used.height;
+					mSplit.push_back({ freeRect.x, bottom, freeRect.width, freeRect.y + freeRect.height - bottom });
+				}
+			}
+
+			mFreeRects.swap(mSplit);
+			mSplit.clear();
+		}
+
+		// Remove free rects that are fully contained in another one
+		void PruneFreeRects()
+		{
+			for (size_t i = 0; i < mFreeRects.size(); ++i)
+			{
+				for (size_t j = i + 1; j < mFreeRects.size(); ++j)
+				{
+					if (Contains(mFreeRects[j], mFreeRects[i]))
+					{
+						mFreeRects.erase(mFreeRects.begin() + i);
+						--i;
+						break;
+					}
+					if (Contains(mFreeRects[i], mFreeRects[j]))
+					{
+						mFreeRects.erase(mFreeRects.begin() + j);
+						--j;
+					}
+				}
+			}
+		}
+
+		std::vector<PackRect> mFreeRects;
+		std::vector<PackRect> mSplit;
+	};
+
+	// Copies the sprite to (x, y) and repeats its edge pixels extrusion times on every side
+	void BlitExtruded(const BirdGame::Image& source, BirdGame::Image& page, uint32_t x, uint32_t y, uint32_t extrusion)
+	{
+		const int32_t extrude = static_cast<int32_t>(extrusion);
+		for (int32_t row = -extrude; row < static_cast<int32_t>(source.height) + extrude; ++row)
+		{
+			const uint32_t sourceY = static_cast<uint32_t>(std::clamp(row, 0, static_cast<int32_t>(source.height) - 1));
+			for (int32_t column = -extrude; column < static_cast<int32_t>(source.width) + extrude; ++column)
+			{
+				const uint32_t sourceX = static_cast<uint32_t>(std::clamp(column, 0, static_cast<int32_t>(source.width) - 1));
+				memcpy(page.GetPixel(x + column, y + row), source.GetPixel(sourceX, sourceY), BirdGame::Image::kBytesPerPixel);
+			}
+		}
+	}
+}
+
+BirdGame::AtlasPacker::AtlasPacker(const Settings& settings) :
+	mSettings(settings)
+{
+	assert((settings.maxPageSize & (settings.maxPageSize - 1)) == 0 && "Page size must be a power of two");
+}
+
+void BirdGame::AtlasPacker::AddSprite(SpriteId id, const Image& image)
+{
+	assert(image.width > 0 && image.height > 0);
+	mSprites.push_back({ id, &image });
+}
+
+BirdGame::TextureAtlas BirdGame::AtlasPacker::Pack() const
+{
+	struct Placement
+	{
+		const PendingSprite* sprite;
+		uint32_t page;
+		PackRect cell;
+	};
+
+	const uint32_t border = mSettings.extrusion * 2 + mSettings.padding;
+
+	// Big sprites first packs much tighter
+	std::vector<const PendingSprite*> remaining;
+	remaining.reserve(mSprites.size());
+	for (const PendingSprite& sprite : mSprites)
+	{
+		if (sprite.image->width + border > mSettings.maxPageSize || sprite.image->height + border > mSettings.maxPageSize)
+		{
+			throw std::runtime_error("Sprite is too large for the atlas page size");
+		}
+		remaining.push_back(&sprite);
+	}
+
+	std::stable_sort(remaining.begin(), remaining.end(), [](const PendingSprite* a, const PendingSprite* b)
+	{
+		const uint32_t maxSideA = std::max(a->image->width, a->image->height);
+		const uint32_t maxSideB = std::max(b->image->width, b->image->height);
+		if (maxSideA != maxSideB)
+		{
+			return maxSideA > maxSideB;
+		}
+		return a->image->width * a->image->height > b->image->width * b->image->height;
+	});
+
+	// Fill one page at a time. Whatever doesn't fit moves on to the next page.
+	std::vector<Placement> placements;
+	std::vector<std::pair<uint32_t, uint32_t>> pageExtents;
+	while (!remaining.empty())
+	{
+		const uint32_t page = static_cast<uint32_t>(pageExtents.size());
+		MaxRectsBin bin(mSettings.maxPageSize);
+		uint32_t extentX = 0;
+		uint32_t extentY = 0;
+
+		std::vector<const PendingSprite*> overflow;
+		for (const PendingSprite* sprite : remaining)
+		{
+			PackRect cell;
+			if (bin.Insert(sprite->image->width + border, sprite->image->height + border, cell))
+			{
+				placements.push_back({ sprite, page, cell });
+				extentX = std::max(extentX, cell.x + cell.width);
+				extentY = std::max(extentY, cell.y + cell.height);
+			}
+			else
+			{
+				overflow.push_back(sprite);
+			}
+		}
+
+		pageExtents.emplace_back(extentX, extentY);
+		remaining.swap(overflow);
+	}
+
+	// Shrink every page to the smallest power of two that still holds everything placed on it
+	TextureAtlas atlas;
+	atlas.pages.resize(pageExtents.size());
+	for (size_t i = 0; i < pageExtents.size(); ++i)
+	{
+		atlas.pages[i].Resize(NextPowerOfTwo(pageExtents[i].first), NextPowerOfTwo(pageExtents[i].second));
+	}
+
+	atlas.regions.reserve(placements.size());
+	for (const Placement& placement : placements)
+	{
+		Image& page = atlas.pages[placement.page];
+		const Image& image = *placement.sprite->image;
+		const uint32_t x = placement.cell.x + mSettings.extrusion;
+		const uint32_t y = placement.cell.y + mSettings.extrusion;
+
+		BlitExtruded(image, page, x, y, mSettings.extrusion);
+
+		AtlasRegion region = {};
+		region.page = placement.page;
+		region.x = x;
+		region.y = y;
+		region.width = image.width;
+		region.height = image.height;
+		region.uv = { static_cast<float>(x) / page.width, static_cast<float>(y) / page.height,
+			static_cast<float>(image.width) / page.width, static_cast<float>(image.height) / page.height };
+		atlas.regions.emplace(placement.sprite->id, region);
+	}
+
+	return atlas;
+}
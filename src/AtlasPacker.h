@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Image.h"
+#include "RenderTypes.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace BirdGame
+{
+	using SpriteId = uint32_t;
+
+	// Where a sprite ended up in an atlas
+	struct AtlasRegion
+	{
+		uint32_t page;
+		uint32_t x;      // Top left of the sprite itself in pixels, excluding extrusion
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+		Rect uv;         // Normalized texture coordinates of the sprite on its page
+	};
+
+	struct TextureAtlas
+	{
+		std::vector<Image> pages;
+		std::unordered_map<SpriteId, AtlasRegion> regions;
+
+		// Returns nullptr if the sprite isn't in the atlas
+		const AtlasRegion* Find(SpriteId id) const
+		{
+			auto it = regions.find(id);
+			return (it != regions.end()) ? &it->second : nullptr;
+		}
+	};
+
+	// Packs many small sprites into as few power-of-two pages as possible using the MaxRects algorithm
+	// (best short side fit), so a whole scene can be drawn with a single texture bind.
+	class AtlasPacker final
+	{
+	public:
+		struct Settings
+		{
+			uint32_t maxPageSize = 2048;  // Must be a power of two
+			uint32_t padding = 2;         // Empty pixels between sprites
+			uint32_t extrusion = 1;       // Edge pixels repeated around each sprite so filtering doesn't bleed in neighbors
+		};
+
+		explicit AtlasPacker(const Settings& settings);
+
+		// The image is copied when Pack() is called, so it has to stay alive until then
+		void AddSprite(SpriteId id, const Image& image);
+
+		// Throws std::runtime_error if a sprite doesn't fit on an empty page
+		TextureAtlas Pack() const;
+
+	private:
+		struct PendingSprite
+		{
+			SpriteId id;
+			const Image* image;
+		};
+
+		Settings mSettings;
+		std::vector<PendingSprite> mSprites;
+	};
+}
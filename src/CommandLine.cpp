@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "CommandLine.h"
+
+#include <shellapi.h>
+
+BirdGame::CommandLine::CommandLine()
+{
+	// Parse the full command line rather than wWinMain's lpCmdLine: CommandLineToArgvW() applies the executable
+	// name rules to the first token, and returns the executable path for an empty string
+	int count = 0;
+	LPWSTR* arguments = CommandLineToArgvW(GetCommandLineW(), &count);
+	if (arguments == nullptr)
+	{
+		return;
+	}
+
+	for (int i = 1; i < count; ++i)
+	{
+		mArguments.emplace_back(arguments[i]);
+	}
+	LocalFree(arguments);
+}
+
+bool BirdGame::CommandLine::HasOption(const wchar_t* option) const
+{
+	for (const std::wstring& argument : mArguments)
+	{
+		if (argument == option)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string BirdGame::CommandLine::GetValue(const wchar_t* option) const
+{
+	for (size_t i = 0; i + 1 < mArguments.size(); ++i)
+	{
+		if (mArguments[i] == option)
+		{
+			const std::wstring& value = mArguments[i + 1];
+			const int size = WideCharToMultiByte(CP_ACP, 0, value.c_str(), static_cast<int>(value.size()), nullptr, 0, nullptr, nullptr);
+			std::string converted(static_cast<size_t>(size), '\0');
+			WideCharToMultiByte(CP_ACP, 0, value.c_str(), static_cast<int>(value.size()), converted.data(), size, nullptr, nullptr);
+			return converted;
+		}
+	}
+	return std::string();
+}
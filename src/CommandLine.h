@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace BirdGame
+{
+	// The process command line split into arguments by CommandLineToArgvW(), with the same quoting rules as the C
+	// runtime. Options only match whole arguments, so -golden doesn't also fire for -goldenupdate or for a path
+	// that happens to contain it.
+	class CommandLine final
+	{
+	public:
+		CommandLine();
+
+		// True if one of the arguments is exactly option, e.g. L"-dev"
+		bool HasOption(const wchar_t* option) const;
+
+		// The argument after option, converted to the ANSI code page like the paths the game passes to the
+		// A versions of the file APIs. Empty if option isn't there or has nothing after it.
+		std::string GetValue(const wchar_t* option) const;
+
+	private:
+		CommandLine(const CommandLine&) = delete;
+
+		std::vector<std::wstring> mArguments; // Without the executable
+	};
+}
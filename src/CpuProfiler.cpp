@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "CpuProfiler.h"
+
+#include <chrono>
+
+BirdGame::CpuProfiler::CpuProfiler() :
+	mTimestamps(ProfileFrameBuilder::kMaxTimestamps),
+	mFrameNumber(0),
+	mLatestFrame(),
+	mHasResults(false)
+{
+}
+
+void BirdGame::CpuProfiler::BeginFrame()
+{
+	mBuilder.BeginFrame(mFrameNumber++);
+}
+
+void BirdGame::CpuProfiler::EndFrame()
+{
+	mBuilder.EndFrame();
+
+	using Clock = std::chrono::steady_clock;
+	const uint64_t ticksPerSecond = static_cast<uint64_t>(Clock::period::den / Clock::period::num);
+	mBuilder.Resolve(mTimestamps.data(), ticksPerSecond, mLatestFrame);
+	mHasResults = true;
+}
+
+void BirdGame::CpuProfiler::BeginScope(const char* name)
+{
+	const uint32_t scope = mBuilder.BeginScope(name);
+	if (scope != ProfileFrameBuilder::kDroppedScope)
+	{
+		mTimestamps[scope * 2] = GetTimestamp();
+	}
+}
+
+void BirdGame::CpuProfiler::EndScope()
+{
+	const uint32_t scope = mBuilder.EndScope();
+	if (scope != ProfileFrameBuilder::kDroppedScope)
+	{
+		mTimestamps[scope * 2 + 1] = GetTimestamp();
+	}
+}
+
+const BirdGame::ProfileFrame* BirdGame::CpuProfiler::GetLatestFrame() const
+{
+	return mHasResults ? &mLatestFrame : nullptr;
+}
+
+uint64_t BirdGame::CpuProfiler::GetTimestamp()
+{
+	return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "IProfiler.h"
+#include "ProfileFrameBuilder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// IProfiler that measures wall clock time on the calling thread, for renderers without GPU timestamps.
+	// Results of a frame are available right after EndFrame().
+	class CpuProfiler final : public IProfiler
+	{
+	public:
+		CpuProfiler();
+
+		void BeginFrame();
+		void EndFrame();
+
+		virtual void BeginScope(const char* name) override;
+		virtual void EndScope() override;
+
+		virtual const ProfileFrame* GetLatestFrame() const override;
+
+	private:
+		CpuProfiler(const CpuProfiler&) = delete;
+
+		static uint64_t GetTimestamp();
+
+		ProfileFrameBuilder mBuilder;
+		std::vector<uint64_t> mTimestamps;
+		uint64_t mFrameNumber;
+		ProfileFrame mLatestFrame;
+		bool mHasResults;
+	};
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace BirdGame
+{
+	// Turns a failed D3D12 or DXGI call into an exception
+	inline void CheckHResult(HRESULT result)
+	{
+		if (FAILED(result))
+		{
+			throw std::exception("borked");
+		}
+	}
+}
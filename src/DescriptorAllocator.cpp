@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "DescriptorAllocator.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <new>
+
+BirdGame::DescriptorAllocator::DescriptorAllocator(uint32_t persistentCount, uint32_t transientCount) :
+	mPersistentCount(persistentCount),
+	mTransientCount(transientCount)
+{
+	if (persistentCount != 0)
+	{
+		mFreeRanges.push_back({ 0, persistentCount });
+	}
+
+	// The ring only deals in offsets, here they are counted in descriptors instead of bytes
+	mTransientRing.Initialize(nullptr, transientCount);
+}
+
+uint32_t BirdGame::DescriptorAllocator::AllocatePersistent(uint32_t count)
+{
+	assert(count != 0);
+
+	for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it)
+	{
+		if (it->count >= count)
+		{
+			const uint32_t first = it->first;
+			it->first += count;
+			it->count -= count;
+			if (it->count == 0)
+			{
+				mFreeRanges.erase(it);
+			}
+			return first;
+		}
+	}
+
+	assert(false && "Persistent descriptor region is full, increase its size");
+	throw std::bad_alloc();
+}
+
+void BirdGame::DescriptorAllocator::FreePersistent(uint32_t first, uint32_t count)
+{
+	assert(count != 0 && first + count <= mPersistentCount);
+	mFreedThisFrame.push_back({ first, count });
+}
+
+uint32_t BirdGame::DescriptorAllocator::AllocateTransient(uint32_t count)
+{
+	const UploadRingBuffer::Allocation allocation = mTransientRing.Allocate(count, 1);
+	return mPersistentCount + static_cast<uint32_t>(allocation.offset);
+}
+
+void BirdGame::DescriptorAllocator::EndFrame(uint64_t fenceValue)
+{
+	mTransientRing.EndFrame(fenceValue);
+
+	for (const Range& range : mFreedThisFrame)
+	{
+		mPendingFrees.push_back({ fenceValue, range });
+	}
+	mFreedThisFrame.clear();
+}
+
+void BirdGame::DescriptorAllocator::Retire(uint64_t completedFenceValue)
+{
+	mTransientRing.Retire(completedFenceValue);
+
+	while (!mPendingFrees.empty() && mPendingFrees.front().fenceValue <= completedFenceValue)
+	{
+		ReleaseRange(mPendingFrees.front().range);
+		mPendingFrees.pop_front();
+	}
+}
+
+void BirdGame::DescriptorAllocator::StageCopy(uint32_t destination, uint32_t source, uint32_t count)
+{
+	if (!mStagedCopies.empty())
+	{
+		CopyRange& last = mStagedCopies.back();
+		if (last.destination + last.count == destination && last.source + last.count == source)
+		{
+			last.count += count;
+			return;
+		}
+	}
+
+	mStagedCopies.push_back({ destination, source, count });
+}
+
+uint32_t BirdGame::DescriptorAllocator::GetPersistentFreeCount() const
+{
+	uint32_t freeCount = 0;
+	for (const Range& range : mFreeRanges)
+	{
+		freeCount += range.count;
+	}
+	return freeCount;
+}
+
+void BirdGame::DescriptorAllocator::ReleaseRange(const Range& range)
+{
+	auto next = std::lower_bound(mFreeRanges.begin(), mFreeRanges.end(), range.first, [](const Range& freeRange, uint32_t first)
+	{
+		return freeRange.first < first;
+	});
+
+	assert((next == mFreeRanges.end() || range.first + range.count <= next->first) && "Descriptor range freed twice");
+
+	// Merge with the free range before and/or after it
+	if (next != mFreeRanges.begin())
+	{
+		auto previous = next - 1;
+		assert(previous->first + previous->count <= range.first && "Descriptor range freed twice");
+		if (previous->first + previous->count == range.first)
+		{
+			previous->count += range.count;
+			if (next != mFreeRanges.end() && previous->first + previous->count == next->first)
+			{
+				previous->count += next->count;
+				mFreeRanges.erase(next);
+			}
+			return;
+		}
+	}
+
+	if (next != mFreeRanges.end() && range.first + range.count == next->first)
+	{
+		next->first = range.first;
+		next->count += range.count;
+		return;
+	}
+
+	mFreeRanges.insert(next, range);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "UploadRingBuffer.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace BirdGame
+{
+	// Hands out descriptor indices in one heap that is split into two regions:
+	// - a persistent region [0, persistentCount) for long lived views (textures, ...), managed by a free list
+	// - a transient region after it for per-frame tables, managed as a ring that is retired by fence value
+	// It also collects the copies from a CPU staging heap into the heap and merges contiguous ones so a
+	// backend can issue one copy call per run. Only deals in indices, see DescriptorHeapDX for the D3D12 side.
+	class DescriptorAllocator final
+	{
+	public:
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+		struct CopyRange
+		{
+			uint32_t destination;
+			uint32_t source;
+			uint32_t count;
+		};
+
+		DescriptorAllocator(uint32_t persistentCount, uint32_t transientCount);
+
+		// Contiguous first fit. Throws std::bad_alloc if the persistent region is exhausted.
+		uint32_t AllocatePersistent(uint32_t count = 1);
+
+		// The GPU may still reference the descriptors, so they only become available again once the fence of
+		// the current frame is retired
+		void FreePersistent(uint32_t first, uint32_t count = 1);
+
+		// Valid until the fence of the current frame is retired. Throws std::bad_alloc if the ring is full.
+		uint32_t AllocateTransient(uint32_t count);
+
+		// Tags everything allocated or freed since the last EndFrame() with the fence value the GPU signals when done with it
+		void EndFrame(uint64_t fenceValue);
+		void Retire(uint64_t completedFenceValue);
+
+		// Records a copy of count descriptors. Merged with the previous copy if both ranges continue it.
+		void StageCopy(uint32_t destination, uint32_t source, uint32_t count);
+		const std::vector<CopyRange>& GetStagedCopies() const { return mStagedCopies; }
+		void ClearStagedCopies() { mStagedCopies.clear(); }
+
+		uint32_t GetPersistentCount() const { return mPersistentCount; }
+		uint32_t GetTransientCount() const { return mTransientCount; }
+		uint32_t GetPersistentFreeCount() const;
+
+	private:
+		DescriptorAllocator(const DescriptorAllocator&) = delete;
+
+		struct Range
+		{
+			uint32_t first;
+			uint32_t count;
+		};
+
+		struct PendingFree
+		{
+			uint64_t fenceValue;
+			Range range;
+		};
+
+		// Inserts into the sorted free list, merging with its neighbours
+		void ReleaseRange(const Range& range);
+
+		uint32_t mPersistentCount;
+		uint32_t mTransientCount;
+
+		std::vector<Range> mFreeRanges;  // Sorted by first index
+		std::vector<Range> mFreedThisFrame;
+		std::deque<PendingFree> mPendingFrees;
+
+		UploadRingBuffer mTransientRing;
+
+		std::vector<CopyRange> mStagedCopies;
+	};
+}
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "DescriptorHeapDX.h"
+
+#include "DXHelpers.h"
+
+#include <assert.h>
+
+BirdGame::DescriptorHeapDX::DescriptorHeapDX(uint32_t persistentCount, uint32_t transientCount) :
+	mAllocator(persistentCount, transientCount),
+	mType(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV),
+	mDescriptorSize(0),
+	mShaderVisible(false)
+{
+}
+
+BirdGame::DescriptorHeapDX::~DescriptorHeapDX()
+{
+}
+
+void BirdGame::DescriptorHeapDX::Initialize(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, bool shaderVisible, const wchar_t* debugName)
+{
+	assert(!shaderVisible || type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+	mDevice = device;
+	mType = type;
+	mShaderVisible = shaderVisible;
+	mDescriptorSize = device->GetDescriptorHandleIncrementSize(type);
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+	heapDesc.NumDescriptors = mAllocator.GetPersistentCount() + mAllocator.GetTransientCount();
+	heapDesc.Type = type;
+	heapDesc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	CheckHResult(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&mHeap)));
+	mHeap->SetName(debugName);
+
+	if (shaderVisible)
+	{
+		// Only the persistent region needs a staging copy, transient tables are built from it
+		D3D12_DESCRIPTOR_HEAP_DESC stagingDesc = {};
+		stagingDesc.NumDescriptors = mAllocator.GetPersistentCount();
+		stagingDesc.Type = type;
+		stagingDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		CheckHResult(device->CreateDescriptorHeap(&stagingDesc, IID_PPV_ARGS(&mStagingHeap)));
+	}
+}
+
+void BirdGame::DescriptorHeapDX::Destroy()
+{
+	mAllocator.ClearStagedCopies();
+	mStagingHeap.Reset();
+	mHeap.Reset();
+	mDevice.Reset();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE BirdGame::DescriptorHeapDX::GetWriteHandle(uint32_t index) const
+{
+	assert(index < mAllocator.GetPersistentCount());
+	if (!mShaderVisible)
+	{
+		return GetCpuHandle(index);
+	}
+	return CD3DX12_CPU_DESCRIPTOR_HANDLE(mStagingHeap->GetCPUDescriptorHandleForHeapStart(), index, mDescriptorSize);
+}
+
+void BirdGame::DescriptorHeapDX::MarkDirty(uint32_t first, uint32_t count)
+{
+	if (mShaderVisible)
+	{
+		mAllocator.StageCopy(first, first, count);
+	}
+}
+
+uint32_t BirdGame::DescriptorHeapDX::AllocateTable(const uint32_t* persistentIndices, uint32_t count)
+{
+	assert(mShaderVisible && "Tables are only needed in shader visible heaps");
+
+	const uint32_t table = mAllocator.AllocateTransient(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		mAllocator.StageCopy(table + i, persistentIndices[i], 1);
+	}
+	return table;
+}
+
+void BirdGame::DescriptorHeapDX::FlushCopies()
+{
+	const CD3DX12_CPU_DESCRIPTOR_HANDLE stagingStart(mStagingHeap != nullptr ? mStagingHeap->GetCPUDescriptorHandleForHeapStart() : D3D12_CPU_DESCRIPTOR_HANDLE{});
+	for (const DescriptorAllocator::CopyRange& copy : mAllocator.GetStagedCopies())
+	{
+		mDevice->CopyDescriptorsSimple(copy.count, GetCpuHandle(copy.destination), CD3DX12_CPU_DESCRIPTOR_HANDLE(stagingStart, copy.source, mDescriptorSize), mType);
+	}
+	mAllocator.ClearStagedCopies();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE BirdGame::DescriptorHeapDX::GetCpuHandle(uint32_t index) const
+{
+	return CD3DX12_CPU_DESCRIPTOR_HANDLE(mHeap->GetCPUDescriptorHandleForHeapStart(), index, mDescriptorSize);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE BirdGame::DescriptorHeapDX::GetGpuHandle(uint32_t index) const
+{
+	assert(mShaderVisible);
+	return CD3DX12_GPU_DESCRIPTOR_HANDLE(mHeap->GetGPUDescriptorHandleForHeapStart(), index, mDescriptorSize);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "DescriptorAllocator.h"
+
+namespace BirdGame
+{
+	// A D3D12 descriptor heap managed by a DescriptorAllocator. Shader visible heaps are write-combined and slow
+	// to write from the CPU, so views are created in a CPU-only staging heap that mirrors the persistent region
+	// and copied over in batches by FlushCopies(). Non shader visible heaps (RTV, DSV) are written directly.
+	class DescriptorHeapDX final
+	{
+	public:
+		DescriptorHeapDX(uint32_t persistentCount, uint32_t transientCount);
+		~DescriptorHeapDX();
+
+		void Initialize(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, bool shaderVisible, const wchar_t* debugName);
+		void Destroy();
+
+		uint32_t AllocatePersistent(uint32_t count = 1) { return mAllocator.AllocatePersistent(count); }
+		void FreePersistent(uint32_t first, uint32_t count = 1) { mAllocator.FreePersistent(first, count); }
+
+		// Where to create the view for a persistent descriptor. Call MarkDirty() afterwards to get it copied to the GPU heap.
+		D3D12_CPU_DESCRIPTOR_HANDLE GetWriteHandle(uint32_t index) const;
+		void MarkDirty(uint32_t first, uint32_t count = 1);
+
+		// Copies persistent descriptors into a contiguous per-frame table and returns the table's first index.
+		// Both this and MarkDirty() only take effect on the GPU heap after FlushCopies().
+		uint32_t AllocateTable(const uint32_t* persistentIndices, uint32_t count);
+
+		// Issues the staged copies, one CopyDescriptorsSimple() per contiguous run. Call before recording draws.
+		void FlushCopies();
+
+		void EndFrame(uint64_t fenceValue) { mAllocator.EndFrame(fenceValue); }
+		void Retire(uint64_t completedFenceValue) { mAllocator.Retire(completedFenceValue); }
+
+		ID3D12DescriptorHeap* GetHeap() const { return mHeap.Get(); }
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index) const;
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const;
+
+	private:
+		DescriptorHeapDX(const DescriptorHeapDX&) = delete;
+
+		DescriptorAllocator mAllocator;
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mHeap;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mStagingHeap;
+		D3D12_DESCRIPTOR_HEAP_TYPE mType;
+		uint32_t mDescriptorSize;
+		bool mShaderVisible;
+	};
+}
@@ -0,0 +1,58 @@
+#include "pch.h"
+#include "FenceDX.h"
+
+#include "DXHelpers.h"
+
+BirdGame::FenceDX::FenceDX() :
+	mEvent(NULL)
+{
+}
+
+BirdGame::FenceDX::~FenceDX()
+{
+	Destroy();
+}
+
+void BirdGame::FenceDX::Initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue)
+{
+	mCommandQueue = commandQueue;
+	CheckHResult(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+
+	// Create an event handle to use for frame synchronization.
+	mEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (mEvent == nullptr)
+	{
+		CheckHResult(HRESULT_FROM_WIN32(GetLastError()));
+	}
+}
+
+void BirdGame::FenceDX::Destroy()
+{
+	if (mEvent != NULL)
+	{
+		CloseHandle(mEvent);
+		mEvent = NULL;
+	}
+
+	mFence.Reset();
+	mCommandQueue.Reset();
+}
+
+void BirdGame::FenceDX::Signal(uint64_t value)
+{
+	CheckHResult(mCommandQueue->Signal(mFence.Get(), value));
+}
+
+uint64_t BirdGame::FenceDX::GetCompletedValue() const
+{
+	return mFence->GetCompletedValue();
+}
+
+void BirdGame::FenceDX::WaitForValue(uint64_t value)
+{
+	if (mFence->GetCompletedValue() < value)
+	{
+		CheckHResult(mFence->SetEventOnCompletion(value, mEvent));
+		WaitForSingleObject(mEvent, INFINITE);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "IFence.h"
+
+namespace BirdGame
+{
+	// IFence on top of an ID3D12Fence that is signalled on a command queue
+	class FenceDX final : public IFence
+	{
+	public:
+		FenceDX();
+		~FenceDX();
+
+		void Initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue);
+		void Destroy();
+
+		virtual void Signal(uint64_t value) override;
+		virtual uint64_t GetCompletedValue() const override;
+		virtual void WaitForValue(uint64_t value) override;
+
+	private:
+		FenceDX(const FenceDX&) = delete;
+
+		Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue;
+		HANDLE mEvent;
+	};
+}
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "FileWatcher.h"
+
+BirdGame::FileWatcher::FileWatcher(std::chrono::milliseconds pollInterval) :
+	mPollInterval(pollInterval),
+	mLastPoll(std::chrono::steady_clock::now())
+{
+}
+
+void BirdGame::FileWatcher::Watch(const std::string& path)
+{
+	for (const WatchedFile& file : mFiles)
+	{
+		if (file.path == path)
+		{
+			return;
+		}
+	}
+
+	std::error_code error;
+	WatchedFile file = {};
+	file.path = path;
+	file.lastWriteTime = std::filesystem::last_write_time(path, error);
+	file.exists = !error;
+	mFiles.push_back(file);
+}
+
+bool BirdGame::FileWatcher::Poll(std::vector<std::string>& changed)
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (now - mLastPoll < mPollInterval)
+	{
+		return false;
+	}
+
+	return PollNow(changed);
+}
+
+bool BirdGame::FileWatcher::PollNow(std::vector<std::string>& changed)
+{
+	mLastPoll = std::chrono::steady_clock::now();
+
+	bool anyChanged = false;
+	for (WatchedFile& file : mFiles)
+	{
+		std::error_code error;
+		const auto writeTime = std::filesystem::last_write_time(file.path, error);
+		if (error)
+		{
+			file.exists = false;
+			continue;
+		}
+
+		if (!file.exists || writeTime != file.lastWriteTime)
+		{
+			file.lastWriteTime = writeTime;
+			file.exists = true;
+			changed.push_back(file.path);
+			anyChanged = true;
+		}
+	}
+
+	return anyChanged;
+}
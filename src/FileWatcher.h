@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace BirdGame
+{
+	// Detects changes to a set of files by polling their modification times. Polling is throttled to one check
+	// per interval, so Poll() can be called every frame.
+	class FileWatcher final
+	{
+	public:
+		explicit FileWatcher(std::chrono::milliseconds pollInterval);
+
+		void Watch(const std::string& path);
+
+		// Appends the paths that changed since the last check to changed. Returns true if there were any.
+		// A file that is missing (editors often delete and rewrite on save) is reported once it is back.
+		bool Poll(std::vector<std::string>& changed);
+
+		// Checks right away, ignoring the poll interval
+		bool PollNow(std::vector<std::string>& changed);
+
+	private:
+		FileWatcher(const FileWatcher&) = delete;
+
+		struct WatchedFile
+		{
+			std::string path;
+			std::filesystem::file_time_type lastWriteTime;
+			bool exists;
+		};
+
+		std::chrono::milliseconds mPollInterval;
+		std::chrono::steady_clock::time_point mLastPoll;
+		std::vector<WatchedFile> mFiles;
+	};
+}
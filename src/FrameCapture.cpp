@@ -0,0 +1,213 @@
+#include "pch.h"
+#include "FrameCapture.h"
+
+#include "Image.h"
+#include "Png.h"
+
+#include <assert.h>
+#include <cstring>
+
+BirdGame::FrameCapture::FrameCapture(uint32_t bufferCount) :
+	mBuffers(bufferCount),
+	mEncoding(false),
+	mStopping(false),
+	mCurrentVideo(0),
+	mEndingVideo(false),
+	mOpenVideo(0),
+	mDroppedFrames(0),
+	mWriteErrors(0)
+{
+	assert(bufferCount > 0);
+	for (uint32_t buffer = 0; buffer < bufferCount; ++buffer)
+	{
+		mFreeBuffers.push_back(buffer);
+	}
+	mWorker = std::thread(&FrameCapture::WorkerMain, this);
+}
+
+BirdGame::FrameCapture::~FrameCapture()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWorkAvailable.notify_one();
+	mWorker.join();
+}
+
+void BirdGame::FrameCapture::RequestScreenshot(const char* path)
+{
+	mPendingScreenshot = path;
+}
+
+void BirdGame::FrameCapture::BeginVideo(const char* path, uint32_t framesPerSecond)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mVideos.push_back({ path, framesPerSecond });
+	mCurrentVideo = static_cast<uint32_t>(mVideos.size());
+}
+
+void BirdGame::FrameCapture::EndVideo()
+{
+	// Frames of the video may still be on their way from the GPU, so the close travels with the next request
+	mEndingVideo = (mCurrentVideo != 0);
+	mCurrentVideo = 0;
+}
+
+BirdGame::FrameCapture::Request BirdGame::FrameCapture::TakeRequest()
+{
+	Request request;
+	request.screenshotPath.swap(mPendingScreenshot);
+	request.video = mCurrentVideo;
+	request.endVideo = mEndingVideo;
+	mEndingVideo = false;
+	return request;
+}
+
+void BirdGame::FrameCapture::Submit(const Request& request, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch)
+{
+	if (request.IsEmpty())
+	{
+		return;
+	}
+
+	uint32_t buffer = kNoBuffer;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!request.HasFrame())
+		{
+			// Nothing to copy, the worker only has to close the video once the frames before this one are written
+			mJobs.push_back({ request, kNoBuffer, width, height });
+		}
+		else if (!mFreeBuffers.empty())
+		{
+			buffer = mFreeBuffers.back();
+			mFreeBuffers.pop_back();
+		}
+		else
+		{
+			// The encoder is behind. Waiting for it would stall the game, so this frame is lost. Its video gets
+			// the previous frame again in its place, or is still closed if it has just ended.
+			mDroppedFrames.fetch_add(1, std::memory_order_relaxed);
+			if (request.video != 0 || request.endVideo)
+			{
+				Job repeat = { Request(), kNoBuffer, width, height };
+				repeat.request.video = request.video;
+				mJobs.push_back(std::move(repeat));
+			}
+		}
+	}
+
+	if (buffer != kNoBuffer)
+	{
+		// The buffer belongs to this thread until it's queued, so the copy happens outside the lock
+		std::vector<uint8_t>& frame = mBuffers[buffer];
+		const size_t stride = static_cast<size_t>(width) * Image::kBytesPerPixel;
+		frame.resize(stride * height);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			std::memcpy(&frame[y * stride], pixels + static_cast<size_t>(y) * rowPitch, stride);
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back({ request, buffer, width, height });
+	}
+	mWorkAvailable.notify_one();
+}
+
+void BirdGame::FrameCapture::Capture(const Image& frame)
+{
+	const Request request = TakeRequest();
+	Submit(request, frame.pixels.data(), frame.width, frame.height, frame.GetRowPitch());
+}
+
+void BirdGame::FrameCapture::Flush()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWorkDone.wait(lock, [this]() { return mJobs.empty() && !mEncoding; });
+}
+
+void BirdGame::FrameCapture::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (;;)
+	{
+		mWorkAvailable.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+		if (mJobs.empty())
+		{
+			// Only stops once everything queued is written
+			break;
+		}
+
+		const Job job = std::move(mJobs.front());
+		mJobs.pop_front();
+		mEncoding = true;
+
+		lock.unlock();
+		Encode(job);
+		lock.lock();
+
+		if (job.buffer != kNoBuffer)
+		{
+			mFreeBuffers.push_back(job.buffer);
+		}
+		mEncoding = false;
+		mWorkDone.notify_all();
+	}
+
+	mVideoWriter.Close();
+}
+
+void BirdGame::FrameCapture::Encode(const Job& job)
+{
+	const uint8_t* pixels = (job.buffer != kNoBuffer) ? mBuffers[job.buffer].data() : nullptr;
+	const uint32_t rowPitch = job.width * Image::kBytesPerPixel;
+
+	if (pixels != nullptr && !job.request.screenshotPath.empty())
+	{
+		if (!WritePng(job.request.screenshotPath.c_str(), pixels, job.width, job.height, rowPitch, false))
+		{
+			mWriteErrors.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Frames arrive in the order they were rendered, so a frame outside the open video means it has ended
+	if (job.request.video != mOpenVideo)
+	{
+		mVideoWriter.Close();
+		mOpenVideo = job.request.video;
+		if (mOpenVideo != 0)
+		{
+			Video video;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				video = mVideos[mOpenVideo - 1];
+			}
+
+			if (!mVideoWriter.Open(video.path.c_str(), job.width, job.height, video.framesPerSecond))
+			{
+				mWriteErrors.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	if (!mVideoWriter.IsOpen() || job.request.video == 0)
+	{
+		return;
+	}
+
+	// The stream's size is fixed by its first frame, frames of any other size are left out
+	if (job.width != mVideoWriter.GetWidth() || job.height != mVideoWriter.GetHeight())
+	{
+		return;
+	}
+
+	if (pixels != nullptr)
+	{
+		mVideoWriter.WriteFrame(pixels, rowPitch);
+	}
+	else
+	{
+		mVideoWriter.RepeatFrame();
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Y4mWriter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BirdGame
+{
+	struct Image;
+
+	// Screenshots (PNG) and video (Y4M) of rendered frames. Frames are copied into one of a fixed set of buffers and
+	// encoded on a worker thread, so the render thread never waits for the encoder. With every buffer still queued
+	// a frame is dropped instead; a dropped video frame is replaced by repeating the one before it.
+	class FrameCapture final
+	{
+	public:
+		// What a frame is captured for, decided when it's rendered. Backends that read frames back from the GPU a
+		// few frames later keep the request with the readback until it reaches Submit().
+		struct Request
+		{
+			std::string screenshotPath; // Empty for none
+			uint32_t video = 0;         // Video started by BeginVideo(), 0 for none
+			bool endVideo = false;      // EndVideo() was called before this frame, so the open video is closed
+
+			bool IsEmpty() const { return !HasFrame() && !endVideo; }
+
+			// Whether the frame's pixels are needed. A request that only ends a video is submitted without them.
+			bool HasFrame() const { return !screenshotPath.empty() || video != 0; }
+		};
+
+		explicit FrameCapture(uint32_t bufferCount);
+
+		// Finishes encoding everything submitted
+		~FrameCapture();
+
+		// Captures the next frame rendered
+		void RequestScreenshot(const char* path);
+
+		// Every frame rendered from now until EndVideo() goes into a new video at path. The file is created when
+		// its first frame arrives and closed once the frame rendered after EndVideo() is submitted, or on destruction.
+		void BeginVideo(const char* path, uint32_t framesPerSecond);
+		void EndVideo();
+
+		// The request for the frame about to be rendered. Takes the pending screenshot, if any. Backends skip the
+		// capture altogether when the request is empty, and the copy of the frame when it has no frame.
+		Request TakeRequest();
+
+		// Queues a copy of RGBA8 rows rowPitch bytes apart for encoding. pixels is only read if request.HasFrame().
+		void Submit(const Request& request, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch);
+
+		// TakeRequest() and Submit() in one, for framebuffers that live on the CPU
+		void Capture(const Image& frame);
+
+		// Blocks until everything submitted so far is written. Never call this during a frame.
+		void Flush();
+
+		// Frames that arrived while every buffer was busy, including screenshots
+		uint32_t GetDroppedFrameCount() const { return mDroppedFrames.load(std::memory_order_relaxed); }
+
+		// Screenshots and videos whose files couldn't be written
+		uint32_t GetWriteErrorCount() const { return mWriteErrors.load(std::memory_order_relaxed); }
+
+	private:
+		FrameCapture(const FrameCapture&) = delete;
+
+		static constexpr uint32_t kNoBuffer = UINT32_MAX;
+
+		struct Job
+		{
+			Request request;
+			uint32_t buffer; // kNoBuffer to write the video's previous frame again, or without a video to only close it
+			uint32_t width;
+			uint32_t height;
+		};
+
+		struct Video
+		{
+			std::string path;
+			uint32_t framesPerSecond;
+		};
+
+		void WorkerMain();
+		void Encode(const Job& job);
+
+		std::thread mWorker;
+		std::mutex mMutex;
+		std::condition_variable mWorkAvailable;
+		std::condition_variable mWorkDone;
+
+		// Guarded by mMutex
+		std::vector<std::vector<uint8_t>> mBuffers; // Tightly packed frames
+		std::vector<uint32_t> mFreeBuffers;
+		std::deque<Job> mJobs;
+		std::vector<Video> mVideos;                 // Indexed by Request::video - 1
+		bool mEncoding;
+		bool mStopping;
+
+		// Render thread only
+		std::string mPendingScreenshot;
+		uint32_t mCurrentVideo;
+		bool mEndingVideo;
+
+		// Worker only
+		Y4mWriter mVideoWriter;
+		uint32_t mOpenVideo;
+
+		std::atomic<uint32_t> mDroppedFrames;
+		std::atomic<uint32_t> mWriteErrors;
+	};
+}
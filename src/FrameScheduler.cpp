@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "FrameScheduler.h"
+
+#include "IFence.h"
+
+#include <assert.h>
+#include <algorithm>
+
+BirdGame::FrameScheduler::FrameScheduler(IFence& fence, uint32_t framesInFlight) :
+	mFence(fence),
+	mFramesInFlight(std::min(std::max(framesInFlight, kMinFramesInFlight), kMaxFramesInFlight)),
+	mCurrentSlot(0),
+	mSlots(),
+	mLastSignalledValue(0),
+	mFrameCount(0),
+	mWaitCount(0)
+{
+}
+
+uint32_t BirdGame::FrameScheduler::BeginFrame()
+{
+	Slot& slot = mSlots[mCurrentSlot];
+	assert(slot.state != SlotState::Recording && "BeginFrame() called twice without EndFrame()");
+
+	if (slot.state == SlotState::InFlight)
+	{
+		if (mFence.GetCompletedValue() < slot.fenceValue)
+		{
+			mFence.WaitForValue(slot.fenceValue);
+			mWaitCount++;
+		}
+		assert(mFence.GetCompletedValue() >= slot.fenceValue);
+	}
+
+	slot.state = SlotState::Recording;
+	return mCurrentSlot;
+}
+
+uint64_t BirdGame::FrameScheduler::EndFrame()
+{
+	Slot& slot = mSlots[mCurrentSlot];
+	assert(slot.state == SlotState::Recording && "EndFrame() called without BeginFrame()");
+
+	slot.fenceValue = ++mLastSignalledValue;
+	slot.state = SlotState::InFlight;
+	mFence.Signal(slot.fenceValue);
+
+	mCurrentSlot = (mCurrentSlot + 1) % mFramesInFlight;
+	mFrameCount++;
+	return slot.fenceValue;
+}
+
+void BirdGame::FrameScheduler::WaitForIdle()
+{
+	if (mFence.GetCompletedValue() < mLastSignalledValue)
+	{
+		mFence.WaitForValue(mLastSignalledValue);
+	}
+
+	for (uint32_t i = 0; i < mFramesInFlight; ++i)
+	{
+		assert(mSlots[i].state != SlotState::Recording && "WaitForIdle() called while recording a frame");
+		mSlots[i].state = SlotState::Available;
+	}
+}
+
+uint64_t BirdGame::FrameScheduler::GetCompletedFenceValue() const
+{
+	return mFence.GetCompletedValue();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BirdGame
+{
+	class IFence;
+
+	// Lets the CPU record up to N frames ahead of the GPU. Every frame in flight owns a slot (command allocator,
+	// per-frame buffers, ...) that cycles Available -> Recording -> InFlight and only blocks when a slot is
+	// reused before the GPU has reached the fence value it was tagged with.
+	class FrameScheduler final
+	{
+	public:
+		static constexpr uint32_t kMinFramesInFlight = 2;
+		static constexpr uint32_t kMaxFramesInFlight = 3;
+
+		enum class SlotState : uint8_t
+		{
+			Available,
+			Recording,
+			InFlight
+		};
+
+		// framesInFlight is clamped to [kMinFramesInFlight, kMaxFramesInFlight]. The fence has to start at 0 and
+		// doesn't need to be initialized until the first BeginFrame().
+		FrameScheduler(IFence& fence, uint32_t framesInFlight);
+
+		// Waits until the GPU is done with the next slot and returns its index
+		uint32_t BeginFrame();
+
+		// Signals the fence for the slot that is being recorded and returns the fence value. Resources used by
+		// the frame may be reused once GetCompletedFenceValue() reaches it.
+		uint64_t EndFrame();
+
+		// Blocks until the GPU has finished every submitted frame, e.g. before shutdown
+		void WaitForIdle();
+
+		uint32_t GetFramesInFlight() const { return mFramesInFlight; }
+		uint32_t GetCurrentSlot() const { return mCurrentSlot; }
+		SlotState GetSlotState(uint32_t slot) const { return mSlots[slot].state; }
+		uint64_t GetCompletedFenceValue() const;
+		uint64_t GetLastSignalledFenceValue() const { return mLastSignalledValue; }
+		uint64_t GetFrameCount() const { return mFrameCount; }
+
+		// How often BeginFrame() had to block, the CPU is ahead of the GPU if this keeps growing
+		uint64_t GetWaitCount() const { return mWaitCount; }
+
+	private:
+		FrameScheduler(const FrameScheduler&) = delete;
+
+		struct Slot
+		{
+			SlotState state;
+			uint64_t fenceValue;
+		};
+
+		IFence& mFence;
+		uint32_t mFramesInFlight;
+		uint32_t mCurrentSlot;
+		Slot mSlots[kMaxFramesInFlight];
+
+		uint64_t mLastSignalledValue;
+		uint64_t mFrameCount;
+		uint64_t mWaitCount;
+	};
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "GlyphAtlas.h"
+
+#include "AtlasPacker.h"
+#include "JobSystem.h"
+#include "SignedDistanceField.h"
+#include "TrueTypeFont.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+BirdGame::GlyphAtlas::GlyphAtlas() :
+	mAscender(0.0f),
+	mDescender(0.0f),
+	mLineHeight(0.0f)
+{
+}
+
+void BirdGame::GlyphAtlas::Build(const TrueTypeFont& font, const uint32_t* codepoints, uint32_t count, const Settings& settings, JobSystem& jobSystem)
+{
+	mGlyphs.clear();
+	mKerning.clear();
+
+	const float unitsPerEm = font.GetUnitsPerEm();
+	const float scale = settings.pixelsPerEm / unitsPerEm;
+	mAscender = font.GetAscender() / unitsPerEm;
+	mDescender = font.GetDescender() / unitsPerEm;
+	mLineHeight = (font.GetAscender() - font.GetDescender() + font.GetLineGap()) / unitsPerEm;
+
+	std::vector<uint32_t> unique;
+	unique.reserve(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (mGlyphs.emplace(codepoints[i], Glyph()).second)
+		{
+			unique.push_back(codepoints[i]);
+		}
+	}
+
+	// Most of the time goes into the distance transform, which is independent for every glyph
+	std::vector<Glyph> glyphs(unique.size());
+	std::vector<uint16_t> glyphIndices(unique.size());
+	std::vector<Image> images(unique.size());
+	jobSystem.ParallelFor(static_cast<uint32_t>(unique.size()), 1, [&](uint32_t, uint32_t begin, uint32_t end, uint32_t)
+	{
+		GlyphOutline outline;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			Glyph& glyph = glyphs[i];
+			glyphIndices[i] = font.GetGlyphIndex(unique[i]);
+
+			const TrueTypeFont::GlyphMetrics metrics = font.GetGlyphMetrics(glyphIndices[i]);
+			glyph.advance = metrics.advance / unitsPerEm;
+			glyph.visible = font.GetOutline(glyphIndices[i], outline) && !outline.segments.empty();
+			if (!glyph.visible)
+			{
+				continue;
+			}
+
+			const uint32_t width = static_cast<uint32_t>(std::ceil((metrics.xMax - metrics.xMin) * scale + 2.0f * settings.range));
+			const uint32_t height = static_cast<uint32_t>(std::ceil((metrics.yMax - metrics.yMin) * scale + 2.0f * settings.range));
+			images[i].Resize(width, height);
+
+			const SdfPlacement placement = { scale, settings.range - metrics.xMin * scale, settings.range + metrics.yMax * scale };
+			GenerateSignedDistanceField(outline, placement, settings.range, images[i]);
+
+			glyph.plane.x = (metrics.xMin * scale - settings.range) / settings.pixelsPerEm;
+			glyph.plane.y = -(metrics.yMax * scale + settings.range) / settings.pixelsPerEm;
+			glyph.plane.width = width / settings.pixelsPerEm;
+			glyph.plane.height = height / settings.pixelsPerEm;
+		}
+	});
+
+	// Every pair is looked up, which is fine for the small glyph sets games use
+	for (size_t left = 0; left < unique.size(); ++left)
+	{
+		for (size_t right = 0; right < unique.size(); ++right)
+		{
+			const int16_t kerning = font.GetKerning(glyphIndices[left], glyphIndices[right]);
+			if (kerning != 0)
+			{
+				mKerning.emplace((static_cast<uint64_t>(unique[left]) << 32) | unique[right], kerning / unitsPerEm);
+			}
+		}
+	}
+
+	// The fields fade to "outside" at their borders, so padding is enough and extrusion isn't needed
+	AtlasPacker::Settings packerSettings;
+	packerSettings.maxPageSize = settings.maxPageSize;
+	packerSettings.padding = 2;
+	packerSettings.extrusion = 0;
+
+	AtlasPacker packer(packerSettings);
+	for (size_t i = 0; i < unique.size(); ++i)
+	{
+		if (glyphs[i].visible)
+		{
+			packer.AddSprite(unique[i], images[i]);
+		}
+	}
+
+	TextureAtlas atlas = packer.Pack();
+	if (atlas.pages.size() > 1)
+	{
+		throw std::runtime_error("Glyphs don't fit on one atlas page");
+	}
+
+	for (size_t i = 0; i < unique.size(); ++i)
+	{
+		if (const AtlasRegion* region = atlas.Find(unique[i]))
+		{
+			glyphs[i].uv = region->uv;
+		}
+		mGlyphs[unique[i]] = glyphs[i];
+	}
+
+	if (atlas.pages.empty())
+	{
+		// Only invisible glyphs, keep a valid texture around anyway
+		mImage.Resize(1, 1);
+	}
+	else
+	{
+		mImage = std::move(atlas.pages[0]);
+	}
+}
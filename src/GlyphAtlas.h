@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Image.h"
+#include "RenderTypes.h"
+
+#include <unordered_map>
+
+namespace BirdGame
+{
+	class JobSystem;
+	class TrueTypeFont;
+
+	// A set of glyphs rendered as signed distance fields into one atlas page. Distance fields stay sharp when
+	// scaled, so one atlas serves every text size. Metrics are in ems, so multiply by the font size in pixels.
+	class GlyphAtlas final
+	{
+	public:
+		struct Settings
+		{
+			float pixelsPerEm = 48.0f;     // Resolution the distance fields are rendered at
+			float range = 4.0f;            // Distance in pixels the field covers on either side of the edge
+			uint32_t maxPageSize = 1024;   // Must be a power of two
+		};
+
+		struct Glyph
+		{
+			float advance;      // Pen movement after this glyph
+			bool visible;       // False for glyphs without contours such as space, which have no quad
+			Rect plane;         // Quad relative to the pen position on the baseline, y down
+			Rect uv;            // Where the quad's distance field is on the atlas page
+		};
+
+		GlyphAtlas();
+
+		// Renders the code points' glyphs in parallel, one glyph per job, and packs them. Code points the font
+		// doesn't map get its missing glyph. Kerning between the code points is copied out of the font, so the
+		// font isn't needed afterwards. Throws std::runtime_error if the glyphs don't fit on one page.
+		void Build(const TrueTypeFont& font, const uint32_t* codepoints, uint32_t count, const Settings& settings, JobSystem& jobSystem);
+
+		// Returns nullptr if the code point wasn't part of the build
+		const Glyph* Find(uint32_t codepoint) const
+		{
+			auto it = mGlyphs.find(codepoint);
+			return (it != mGlyphs.end()) ? &it->second : nullptr;
+		}
+
+		// Adjustment of the advance between two code points of the atlas
+		float GetKerning(uint32_t left, uint32_t right) const
+		{
+			auto it = mKerning.find((static_cast<uint64_t>(left) << 32) | right);
+			return (it != mKerning.end()) ? it->second : 0.0f;
+		}
+
+		const Image& GetImage() const { return mImage; }
+
+		float GetAscender() const { return mAscender; }
+		float GetDescender() const { return mDescender; }
+		float GetLineHeight() const { return mLineHeight; }
+
+	private:
+		GlyphAtlas(const GlyphAtlas&) = delete;
+
+		std::unordered_map<uint32_t, Glyph> mGlyphs;
+		std::unordered_map<uint64_t, float> mKerning; // Only pairs with kerning, keyed by left << 32 | right
+		Image mImage;
+		float mAscender;
+		float mDescender;
+		float mLineHeight;
+	};
+}
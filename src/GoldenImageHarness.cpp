@@ -0,0 +1,458 @@
+#include "pch.h"
+#include "GoldenImageHarness.h"
+
+#include "Image.h"
+#include "ImageComparison.h"
+#include "Png.h"
+#include "RenderCommandBuffer.h"
+#include "SignedDistanceField.h"
+#include "SoftwareRasterizer.h"
+#include "SpriteBatch.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+	constexpr uint32_t kMaxSprites = 8192;
+	constexpr uint32_t kMaxDrawPackets = 1024;
+
+	// The scenes' texture table
+	enum SceneTexture : uint32_t
+	{
+		kCheckerboardTexture,
+		kGradientTexture,
+		kRingTexture,       // Signed distance field, for the text pipeline
+		kSceneTextureCount
+	};
+
+	constexpr uint32_t kTextureSize = 64;
+	constexpr uint32_t kCheckerboardCellSize = 8;
+	constexpr float kRingDistanceRange = 6.0f; // Pixels
+	constexpr float kRingUnitsPerTexture = 1024.0f;
+
+	constexpr BirdGame::Rect kFullUv = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	// Same colors as the checkerboard the renderer starts with, with smaller cells so sprites drawn at 1:1 show several
+	void GenerateCheckerboard(BirdGame::Image& image)
+	{
+		image.Resize(kTextureSize, kTextureSize);
+		for (uint32_t y = 0; y < kTextureSize; ++y)
+		{
+			for (uint32_t x = 0; x < kTextureSize; ++x)
+			{
+				const uint8_t value = ((x / kCheckerboardCellSize) % 2 == (y / kCheckerboardCellSize) % 2) ? 0x00 : 0xff;
+				uint8_t* pixel = image.GetPixel(x, y);
+				pixel[0] = value;
+				pixel[1] = value;
+				pixel[2] = value;
+				pixel[3] = 0xff;
+			}
+		}
+	}
+
+	// Red increases to the right, green downwards, alpha to the right. Shows blending mistakes that flat colors hide.
+	void GenerateGradient(BirdGame::Image& image)
+	{
+		image.Resize(kTextureSize, kTextureSize);
+		for (uint32_t y = 0; y < kTextureSize; ++y)
+		{
+			for (uint32_t x = 0; x < kTextureSize; ++x)
+			{
+				uint8_t* pixel = image.GetPixel(x, y);
+				pixel[0] = static_cast<uint8_t>(x * 255 / (kTextureSize - 1));
+				pixel[1] = static_cast<uint8_t>(y * 255 / (kTextureSize - 1));
+				pixel[2] = 0x80;
+				pixel[3] = static_cast<uint8_t>(32 + x * 223 / (kTextureSize - 1));
+			}
+		}
+	}
+
+	// A circle of quadratic arcs. The control point of each arc sits where the tangents at its ends meet.
+	void AddCircle(BirdGame::GlyphOutline& outline, float centerX, float centerY, float radius, bool clockwise)
+	{
+		constexpr uint32_t kArcCount = 8;
+		const float step = (clockwise ? -2.0f : 2.0f) * 3.14159265f / kArcCount;
+		const float controlRadius = radius / std::cos(step * 0.5f);
+		for (uint32_t arc = 0; arc < kArcCount; ++arc)
+		{
+			const float start = arc * step;
+			const float end = (arc + 1 == kArcCount) ? 0.0f : start + step;
+			const float middle = start + step * 0.5f;
+			outline.segments.push_back({
+				centerX + radius * std::cos(start), centerY + radius * std::sin(start),
+				centerX + controlRadius * std::cos(middle), centerY + controlRadius * std::sin(middle),
+				centerX + radius * std::cos(end), centerY + radius * std::sin(end) });
+		}
+	}
+
+	// Stands in for a glyph atlas: real glyphs would tie the goldens to whichever font the machine has
+	void GenerateRing(BirdGame::Image& image)
+	{
+		BirdGame::GlyphOutline outline;
+		const float center = kRingUnitsPerTexture * 0.5f;
+		AddCircle(outline, center, center, kRingUnitsPerTexture * 0.4f, false);
+		AddCircle(outline, center, center, kRingUnitsPerTexture * 0.2f, true);
+
+		image.Resize(kTextureSize, kTextureSize);
+		const float scale = kTextureSize / kRingUnitsPerTexture;
+		GenerateSignedDistanceField(outline, { scale, 0.0f, static_cast<float>(kTextureSize) }, kRingDistanceRange, image);
+	}
+
+	// Deterministic on every platform, unlike std::rand()
+	class SceneRandom final
+	{
+	public:
+		explicit SceneRandom(uint32_t seed) : mState(seed) {}
+
+		uint32_t Next(uint32_t range)
+		{
+			mState = mState * 1664525u + 1013904223u;
+			return (mState >> 8) % range;
+		}
+
+	private:
+		uint32_t mState;
+	};
+
+	void SubmitSprite(BirdGame::SpriteBatch& batch, uint32_t texture, const BirdGame::Rect& rect, BirdGame::Color color, uint8_t layer)
+	{
+		batch.Submit(texture, rect, kFullUv, color, layer, BirdGame::PipelineId::Sprite);
+	}
+
+	void SubmitRing(BirdGame::SpriteBatch& batch, const BirdGame::Rect& rect, BirdGame::Color color, uint8_t layer)
+	{
+		batch.Submit(kRingTexture, rect, kFullUv, color, layer, BirdGame::PipelineId::Text);
+	}
+
+	// Magnification, tinting, texture sub-rects and pixel coverage of rects that don't line up with pixels
+	void SubmitSpritesScene(BirdGame::SpriteBatch& batch)
+	{
+		SubmitSprite(batch, kCheckerboardTexture, { 16.0f, 16.0f, 64.0f, 64.0f }, BirdGame::kWhite, 0);
+		SubmitSprite(batch, kCheckerboardTexture, { 96.0f, 32.0f, 128.0f, 128.0f }, { 0xff, 0x60, 0x60, 0xff }, 1);
+		batch.Submit(kCheckerboardTexture, { 176.0f, 24.0f, 64.0f, 64.0f }, { 0.25f, 0.25f, 0.5f, 0.5f }, { 0x80, 0xff, 0x80, 0xff }, 0, BirdGame::PipelineId::Sprite);
+		SubmitSprite(batch, kCheckerboardTexture, { 20.5f, 120.25f, 48.5f, 47.75f }, BirdGame::kWhite, 0);
+	}
+
+	// Straight alpha blending of textures with varying alpha, and submission order within a layer
+	void SubmitAlphaBlendingScene(BirdGame::SpriteBatch& batch)
+	{
+		SubmitSprite(batch, kGradientTexture, { 16.0f, 16.0f, 128.0f, 128.0f }, BirdGame::kWhite, 0);
+		SubmitSprite(batch, kGradientTexture, { 80.0f, 48.0f, 128.0f, 128.0f }, { 0xff, 0xff, 0xff, 0x80 }, 0);
+		SubmitSprite(batch, kCheckerboardTexture, { 0.0f, 96.0f, 256.0f, 48.0f }, { 0xff, 0xc8, 0x00, 0x60 }, 1);
+	}
+
+	// Submitted out of order: layers have to come out back to front, and text after sprites within a layer
+	void SubmitLayerOrderScene(BirdGame::SpriteBatch& batch)
+	{
+		SubmitSprite(batch, kCheckerboardTexture, { 120.0f, 100.0f, 64.0f, 64.0f }, { 0x40, 0x40, 0xff, 0xff }, 3);
+		SubmitRing(batch, { 40.0f, 40.0f, 96.0f, 96.0f }, { 0xe0, 0x20, 0x20, 0xff }, 2);
+		SubmitSprite(batch, kGradientTexture, { 56.0f, 56.0f, 128.0f, 96.0f }, BirdGame::kWhite, 2);
+		SubmitSprite(batch, kCheckerboardTexture, { 0.0f, 0.0f, 256.0f, 192.0f }, { 0xff, 0xff, 0xff, 0x40 }, 0);
+		SubmitSprite(batch, kGradientTexture, { 8.0f, 120.0f, 200.0f, 64.0f }, { 0x20, 0xa0, 0x20, 0xff }, 1);
+	}
+
+	// Sprites across every edge, outside the view and around it
+	void SubmitCullingScene(BirdGame::SpriteBatch& batch)
+	{
+		SubmitSprite(batch, kGradientTexture, { -64.0f, -64.0f, 384.0f, 320.0f }, { 0xff, 0xff, 0xff, 0x40 }, 0);
+		SubmitSprite(batch, kCheckerboardTexture, { -32.0f, 40.0f, 64.0f, 64.0f }, BirdGame::kWhite, 1);
+		SubmitSprite(batch, kCheckerboardTexture, { 100.0f, -40.0f, 64.0f, 64.0f }, { 0xff, 0x80, 0x80, 0xff }, 1);
+		SubmitSprite(batch, kCheckerboardTexture, { 224.0f, 80.0f, 64.0f, 64.0f }, { 0x80, 0xff, 0x80, 0xff }, 1);
+		SubmitSprite(batch, kCheckerboardTexture, { 60.0f, 160.0f, 64.0f, 64.0f }, { 0x80, 0x80, 0xff, 0xff }, 1);
+		SubmitSprite(batch, kCheckerboardTexture, { 300.0f, 300.0f, 64.0f, 64.0f }, BirdGame::kWhite, 1);
+		SubmitSprite(batch, kCheckerboardTexture, { -100.0f, -100.0f, 50.0f, 50.0f }, BirdGame::kWhite, 1);
+		SubmitRing(batch, { 192.0f, -24.0f, 96.0f, 96.0f }, { 0xff, 0xff, 0x00, 0xff }, 2);
+	}
+
+	// The text pipeline's edge antialiasing from small to large, and the raw field through the sprite pipeline
+	void SubmitDistanceFieldScene(BirdGame::SpriteBatch& batch)
+	{
+		SubmitRing(batch, { 8.0f, 8.0f, 16.0f, 16.0f }, BirdGame::kWhite, 0);
+		SubmitRing(batch, { 32.0f, 8.0f, 32.0f, 32.0f }, { 0xff, 0xd0, 0x40, 0xff }, 0);
+		SubmitRing(batch, { 72.0f, 8.0f, 64.0f, 64.0f }, { 0x40, 0xff, 0xd0, 0xff }, 0);
+		SubmitRing(batch, { 120.0f, 56.0f, 128.0f, 128.0f }, { 0xff, 0x40, 0x80, 0x80 }, 0);
+		SubmitSprite(batch, kRingTexture, { 8.0f, 96.0f, 64.0f, 64.0f }, BirdGame::kWhite, 0);
+	}
+
+	// Mostly here to be timed: enough sprites of every kind for sorting and rasterization to show up
+	void SubmitManySpritesScene(BirdGame::SpriteBatch& batch)
+	{
+		constexpr uint32_t kSpriteCount = 2048;
+		constexpr uint32_t kLayerCount = 8;
+
+		// Few colors keep the golden image small
+		constexpr BirdGame::Color kPalette[] = {
+			{ 0xff, 0xff, 0xff, 0xff }, { 0xff, 0x60, 0x40, 0xff }, { 0x40, 0xc0, 0x60, 0xff }, { 0x50, 0x80, 0xff, 0xff },
+			{ 0xff, 0xd0, 0x40, 0xc0 }, { 0xc0, 0x60, 0xff, 0xc0 }, { 0x40, 0xe0, 0xe0, 0x80 }, { 0x20, 0x20, 0x20, 0x80 }
+		};
+
+		SceneRandom random(kSpriteCount);
+		for (uint32_t i = 0; i < kSpriteCount; ++i)
+		{
+			const float size = 4.0f + random.Next(32);
+			const BirdGame::Rect rect = { static_cast<float>(random.Next(336)) - 16.0f, static_cast<float>(random.Next(256)) - 16.0f, size, size };
+			const BirdGame::Color color = kPalette[random.Next(sizeof(kPalette) / sizeof(kPalette[0]))];
+			const uint8_t layer = static_cast<uint8_t>(random.Next(kLayerCount));
+			if (i % 8 == 0)
+			{
+				SubmitRing(batch, rect, color, layer);
+			}
+			else
+			{
+				SubmitSprite(batch, (i % 2 == 0) ? kCheckerboardTexture : kGradientTexture, rect, color, layer);
+			}
+		}
+	}
+
+	struct Scene
+	{
+		const char* name; // Also the name of its golden image
+		uint32_t width;
+		uint32_t height;
+		BirdGame::Color clearColor;
+		void (*submit)(BirdGame::SpriteBatch& batch);
+	};
+
+	// The renderer's clear color
+	constexpr BirdGame::Color kClearColor = { 0x00, 0x33, 0x66, 0xff };
+
+	constexpr Scene kScenes[] = {
+		{ "sprites", 256, 192, kClearColor, SubmitSpritesScene },
+		{ "alpha_blending", 256, 192, { 0x28, 0x28, 0x28, 0xff }, SubmitAlphaBlendingScene },
+		{ "layer_order", 256, 192, BirdGame::kWhite, SubmitLayerOrderScene },
+		{ "culling", 256, 192, kClearColor, SubmitCullingScene },
+		{ "distance_field", 256, 192, { 0x10, 0x10, 0x20, 0xff }, SubmitDistanceFieldScene },
+		{ "many_sprites", 320, 240, kClearColor, SubmitManySpritesScene }
+	};
+
+	// The same steps RendererImpl::RecordSpritePass() takes, with the rasterizer in place of the command list
+	void RenderScene(const Scene& scene, BirdGame::SpriteBatch& batch, BirdGame::RenderCommandBuffer& commands, BirdGame::SoftwareRasterizer& rasterizer, const BirdGame::SoftwareRasterizer::TextureLookup& textureLookup)
+	{
+		rasterizer.Clear(scene.clearColor);
+		scene.submit(batch);
+		batch.Build(commands, { 0.0f, 0.0f, static_cast<float>(scene.width), static_cast<float>(scene.height) });
+		commands.Sort();
+		assert(commands.Validate(batch.GetVisibleCount()));
+		rasterizer.Execute(commands, batch.GetInstances().data(), textureLookup);
+		commands.Clear();
+		batch.Clear();
+	}
+
+	// One "<scene> <milliseconds>" per line
+	void LoadTimings(const std::string& path, std::unordered_map<std::string, double>& timings)
+	{
+		std::ifstream file(path);
+		std::string scene;
+		double milliseconds = 0.0;
+		while (file >> scene >> milliseconds)
+		{
+			timings[scene] = milliseconds;
+		}
+	}
+
+	bool SaveTimings(const std::string& path, const std::unordered_map<std::string, double>& timings)
+	{
+		// In scene order, so the file diffs nicely between runs
+		std::ofstream file(path, std::ios::trunc);
+		for (const Scene& scene : kScenes)
+		{
+			const auto timing = timings.find(scene.name);
+			if (timing != timings.end())
+			{
+				file << scene.name << ' ' << timing->second << '\n';
+			}
+		}
+		return static_cast<bool>(file);
+	}
+
+	const char* GetStatusName(BirdGame::GoldenImageHarness::Status status)
+	{
+		switch (status)
+		{
+			case BirdGame::GoldenImageHarness::Status::Passed: return "passed";
+			case BirdGame::GoldenImageHarness::Status::Recorded: return "recorded";
+			case BirdGame::GoldenImageHarness::Status::Missing: return "MISSING";
+			case BirdGame::GoldenImageHarness::Status::ImageChanged: return "IMAGE CHANGED";
+			case BirdGame::GoldenImageHarness::Status::Slower: return "SLOWER";
+			case BirdGame::GoldenImageHarness::Status::Error: return "ERROR";
+			default: return "?";
+		}
+	}
+
+	bool IsFailure(BirdGame::GoldenImageHarness::Status status)
+	{
+		return status != BirdGame::GoldenImageHarness::Status::Passed && status != BirdGame::GoldenImageHarness::Status::Recorded;
+	}
+}
+
+BirdGame::GoldenImageHarness::GoldenImageHarness(const Settings& settings) :
+	mSettings(settings)
+{
+}
+
+uint32_t BirdGame::GoldenImageHarness::Run(std::string& report)
+{
+	mResults.clear();
+
+	std::error_code error;
+	if (mSettings.update)
+	{
+		std::filesystem::create_directories(mSettings.goldenDirectory, error);
+	}
+	std::filesystem::create_directories(mSettings.outputDirectory, error);
+
+	Image textures[kSceneTextureCount];
+	GenerateCheckerboard(textures[kCheckerboardTexture]);
+	GenerateGradient(textures[kGradientTexture]);
+	GenerateRing(textures[kRingTexture]);
+	const SoftwareRasterizer::TextureLookup textureLookup = [&textures](uint32_t textureIndex) -> const Image*
+	{
+		return (textureIndex < kSceneTextureCount) ? &textures[textureIndex] : nullptr;
+	};
+
+	std::unordered_map<std::string, double> timings;
+	if (mSettings.checkTimings)
+	{
+		LoadTimings(mSettings.timingsPath, timings);
+	}
+	bool timingsChanged = false;
+
+	SpriteBatch batch(kMaxSprites);
+	RenderCommandBuffer commands(kMaxDrawPackets);
+	std::vector<double> runMilliseconds;
+	uint32_t failureCount = 0;
+
+	for (const Scene& scene : kScenes)
+	{
+		SceneResult result = {};
+		result.scene = scene.name;
+		result.status = Status::Passed;
+
+		// The first render is the one we check. It also warms the caches and grows the batch's buffers for the timed ones.
+		SoftwareRasterizer rasterizer(scene.width, scene.height);
+		RenderScene(scene, batch, commands, rasterizer, textureLookup);
+		const Image& actual = rasterizer.GetFramebuffer();
+
+		// The median ignores the odd run the OS interrupted
+		runMilliseconds.clear();
+		for (uint32_t run = 0; run < std::max(mSettings.timingRuns, 1u); ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			RenderScene(scene, batch, commands, rasterizer, textureLookup);
+			runMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::nth_element(runMilliseconds.begin(), runMilliseconds.begin() + runMilliseconds.size() / 2, runMilliseconds.end());
+		result.milliseconds = runMilliseconds[runMilliseconds.size() / 2];
+
+		const std::string goldenPath = mSettings.goldenDirectory + "/" + scene.name + ".png";
+		const std::string outputPath = mSettings.outputDirectory + "/" + scene.name;
+		if (mSettings.update)
+		{
+			result.status = WritePng(goldenPath.c_str(), actual.pixels.data(), actual.width, actual.height, actual.GetRowPitch(), true) ? Status::Recorded : Status::Error;
+		}
+		else if (!std::filesystem::exists(goldenPath, error))
+		{
+			// Left with the outputs to look at before recording it
+			result.status = WritePng((outputPath + "_actual.png").c_str(), actual.pixels.data(), actual.width, actual.height, actual.GetRowPitch(), true) ? Status::Missing : Status::Error;
+		}
+		else
+		{
+			Image golden;
+			if (!ReadPng(goldenPath.c_str(), golden))
+			{
+				result.status = Status::Error;
+			}
+			else
+			{
+				Image diff;
+				const ImageDifference difference = CompareImages(actual, golden, mSettings.threshold, &diff);
+				result.differentPixels = difference.differentPixels;
+				result.maxDistance = difference.maxDistance;
+				if (!difference.sizeMatches || difference.differentPixels > mSettings.maxDifferentPixels)
+				{
+					// Next to each other, so an image viewer steps from one to the next
+					result.status = Status::ImageChanged;
+					bool written = WritePng((outputPath + "_actual.png").c_str(), actual.pixels.data(), actual.width, actual.height, actual.GetRowPitch(), true);
+					if (diff.width > 0)
+					{
+						written &= WritePng((outputPath + "_diff.png").c_str(), diff.pixels.data(), diff.width, diff.height, diff.GetRowPitch(), false);
+					}
+					if (!written)
+					{
+						result.status = Status::Error;
+					}
+				}
+			}
+		}
+
+		// A scene that got slower keeps its old timing, so a regression can't become the new normal by running twice
+		const auto timing = timings.find(scene.name);
+		if (mSettings.checkTimings && mSettings.update)
+		{
+			timings[scene.name] = result.milliseconds;
+			timingsChanged = true;
+		}
+		else if (mSettings.checkTimings && timing == timings.end())
+		{
+			if (result.status == Status::Passed)
+			{
+				result.status = Status::Missing;
+			}
+		}
+		else if (mSettings.checkTimings)
+		{
+			result.baselineMilliseconds = timing->second;
+			const bool slower = (result.milliseconds > result.baselineMilliseconds * mSettings.maxSlowdown) &&
+				(result.milliseconds - result.baselineMilliseconds > mSettings.minSlowdownMilliseconds);
+			if (slower && result.status == Status::Passed)
+			{
+				result.status = Status::Slower;
+			}
+		}
+
+		if (IsFailure(result.status))
+		{
+			failureCount++;
+		}
+		mResults.push_back(result);
+	}
+
+	const bool timingsSaved = !timingsChanged || SaveTimings(mSettings.timingsPath, timings);
+	if (!timingsSaved)
+	{
+		failureCount++;
+	}
+
+	std::string output;
+	char line[256];
+	snprintf(line, sizeof(line), "==== Golden images (%zu scenes, %u failed) ====\n", mResults.size(), failureCount);
+	output += line;
+	snprintf(line, sizeof(line), "%-20s %-14s %10s %10s %12s %12s\n", "Scene", "Result", "Pixels", "Distance", "Median ms", "Recorded ms");
+	output += line;
+	for (const SceneResult& result : mResults)
+	{
+		snprintf(line, sizeof(line), "%-20s %-14s %10u %10.4f %12.3f %12.3f\n", result.scene, GetStatusName(result.status), result.differentPixels, result.maxDistance, result.milliseconds, result.baselineMilliseconds);
+		output += line;
+	}
+	if (!timingsSaved)
+	{
+		output += "Failed to write " + mSettings.timingsPath + "\n";
+	}
+
+	const std::string reportPath = mSettings.outputDirectory + "/report.txt";
+	std::ofstream reportFile(reportPath, std::ios::trunc);
+	reportFile << output;
+	if (!reportFile)
+	{
+		output += "Failed to write " + reportPath + "\n";
+	}
+
+	report += output;
+	return failureCount;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BirdGame
+{
+	// Renders a fixed set of scripted scenes through the sprite and text pipelines and checks them against stored
+	// golden images, so a change to batching, sorting, culling or blending that alters what ends up on screen fails
+	// a run instead of slipping through. Scenes go through SpriteBatch, RenderCommandBuffer and SoftwareRasterizer,
+	// the same path RendererImpl::PopulateCommandList() feeds the GPU, which keeps the harness backend-neutral: it
+	// runs without a GPU or a window, on any platform.
+	// Every scene is also timed, median of several renders, and compared against the timings recorded on the same
+	// machine, so a run catches performance regressions along with visual ones.
+	class GoldenImageHarness final
+	{
+	public:
+		struct Settings
+		{
+			std::string goldenDirectory = "assets/golden";  // <scene>.png for every scene
+			std::string outputDirectory = "golden_output";  // Actual and diff images of failed scenes, and the report
+			std::string timingsPath = "golden_timings.txt"; // Machine specific, so not kept with the goldens
+
+			// Records the current output as the new goldens and timings instead of checking against them. Without
+			// it, a scene with no golden or timing fails, so a missing file can't make a run pass.
+			bool update = false;
+
+			// Timings only mean something on the machine that recorded them. Off, e.g. on shared build machines,
+			// only the images are checked and no timings are read or written.
+			bool checkTimings = true;
+
+			float threshold = 0.1f;          // Per pixel, see CompareImages()
+			uint32_t maxDifferentPixels = 0; // Pixels over the threshold a scene may have and still pass
+
+			uint32_t timingRuns = 15;
+			float maxSlowdown = 1.5f;            // Over the recorded median
+			double minSlowdownMilliseconds = 0.1; // Below this, slowdowns are timer noise
+		};
+
+		enum class Status : uint8_t
+		{
+			Passed,
+			Recorded,     // Updating
+			Missing,      // No golden or timing to check against
+			ImageChanged,
+			Slower,
+			Error         // A golden couldn't be read or an output couldn't be written
+		};
+
+		struct SceneResult
+		{
+			const char* scene;
+			Status status;
+			uint32_t differentPixels;
+			float maxDistance;
+			double milliseconds;         // Median render time
+			double baselineMilliseconds; // 0 if there was no recorded timing
+		};
+
+		explicit GoldenImageHarness(const Settings& settings);
+
+		// Renders and checks every scene, then writes the report to the output directory and appends it to report.
+		// Returns the number of scenes that failed.
+		uint32_t Run(std::string& report);
+
+		const std::vector<SceneResult>& GetResults() const { return mResults; }
+
+	private:
+		GoldenImageHarness(const GoldenImageHarness&) = delete;
+
+		Settings mSettings;
+		std::vector<SceneResult> mResults;
+	};
+}
@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "GpuProfilerDX.h"
+
+#include "DXHelpers.h"
+#include "MemoryTracker.h"
+
+#include <assert.h>
+
+BirdGame::GpuProfilerDX::GpuProfilerDX() :
+	mTimestampFrequency(1),
+	mResolved(),
+	mFrameSlot(0),
+	mFrameNumber(0),
+	mLatestFrame(),
+	mHasResults(false)
+{
+}
+
+BirdGame::GpuProfilerDX::~GpuProfilerDX()
+{
+	Destroy();
+}
+
+void BirdGame::GpuProfilerDX::Initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue, const CommandListSource& commandList)
+{
+	mCommandList = commandList;
+	CheckHResult(commandQueue->GetTimestampFrequency(&mTimestampFrequency));
+
+	const uint32_t queryCount = kMaxFramesInFlight * ProfileFrameBuilder::kMaxTimestamps;
+
+	D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+	queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	queryHeapDesc.Count = queryCount;
+	CheckHResult(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&mQueryHeap)));
+	mQueryHeap->SetName(L"GpuProfilerQueries");
+
+	const uint64_t readbackSize = queryCount * sizeof(uint64_t);
+	const CD3DX12_HEAP_PROPERTIES readbackHeapProperties(D3D12_HEAP_TYPE_READBACK);
+	const CD3DX12_RESOURCE_DESC readbackDesc = CD3DX12_RESOURCE_DESC::Buffer(readbackSize);
+	CheckHResult(device->CreateCommittedResource(
+		&readbackHeapProperties,
+		D3D12_HEAP_FLAG_NONE,
+		&readbackDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&mReadbackBuffer)));
+	mReadbackBuffer->SetName(L"GpuProfilerReadback");
+	MemoryTracker::TrackResource(mReadbackBuffer.Get(), "GpuProfilerReadback", MemoryTag::Renderer, readbackSize);
+}
+
+void BirdGame::GpuProfilerDX::Destroy()
+{
+	if (mReadbackBuffer != nullptr)
+	{
+		MemoryTracker::UntrackResource(mReadbackBuffer.Get());
+		mReadbackBuffer.Reset();
+	}
+	mQueryHeap.Reset();
+	mCommandList = nullptr;
+}
+
+void BirdGame::GpuProfilerDX::BeginFrame(uint32_t frameSlot)
+{
+	assert(frameSlot < kMaxFramesInFlight);
+	mFrameSlot = frameSlot;
+	ProfileFrameBuilder& frame = mFrames[frameSlot];
+
+	if (mResolved[frameSlot])
+	{
+		const SIZE_T begin = GetFirstQuery(frameSlot) * sizeof(uint64_t);
+		const D3D12_RANGE readRange = { begin, begin + frame.GetTimestampCount() * sizeof(uint64_t) };
+		const D3D12_RANGE writeRange = { 0, 0 };
+
+		void* data = nullptr;
+		CheckHResult(mReadbackBuffer->Map(0, &readRange, &data));
+		frame.Resolve(reinterpret_cast<const uint64_t*>(static_cast<const uint8_t*>(data) + begin), mTimestampFrequency, mLatestFrame);
+		mReadbackBuffer->Unmap(0, &writeRange);
+
+		mResolved[frameSlot] = false;
+		mHasResults = true;
+	}
+
+	frame.BeginFrame(mFrameNumber++);
+}
+
+void BirdGame::GpuProfilerDX::EndFrame(ID3D12GraphicsCommandList* commandList)
+{
+	ProfileFrameBuilder& frame = mFrames[mFrameSlot];
+	frame.EndFrame();
+
+	if (frame.GetScopeCount() > 0)
+	{
+		const uint32_t firstQuery = GetFirstQuery(mFrameSlot);
+		commandList->ResolveQueryData(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, firstQuery, frame.GetTimestampCount(), mReadbackBuffer.Get(), firstQuery * sizeof(uint64_t));
+		mResolved[mFrameSlot] = true;
+	}
+}
+
+void BirdGame::GpuProfilerDX::BeginScope(const char* name)
+{
+	const uint32_t scope = mFrames[mFrameSlot].BeginScope(name);
+	if (scope != ProfileFrameBuilder::kDroppedScope)
+	{
+		mCommandList()->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, GetFirstQuery(mFrameSlot) + scope * 2);
+	}
+}
+
+void BirdGame::GpuProfilerDX::EndScope()
+{
+	const uint32_t scope = mFrames[mFrameSlot].EndScope();
+	if (scope != ProfileFrameBuilder::kDroppedScope)
+	{
+		mCommandList()->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, GetFirstQuery(mFrameSlot) + scope * 2 + 1);
+	}
+}
+
+const BirdGame::ProfileFrame* BirdGame::GpuProfilerDX::GetLatestFrame() const
+{
+	return mHasResults ? &mLatestFrame : nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FrameScheduler.h"
+#include "IProfiler.h"
+#include "ProfileFrameBuilder.h"
+
+#include <functional>
+
+namespace BirdGame
+{
+	// IProfiler on top of D3D12 timestamp queries. Scopes write a timestamp into whatever command list the
+	// renderer is recording at the time. Every frame slot has its own range of queries, resolved into a readback
+	// buffer at the end of the frame and read once the slot comes around again, so results are as many frames
+	// late as there are frames in flight.
+	class GpuProfilerDX final : public IProfiler
+	{
+	public:
+		using CommandListSource = std::function<ID3D12GraphicsCommandList*()>;
+
+		GpuProfilerDX();
+		~GpuProfilerDX();
+
+		void Initialize(ID3D12Device* device, ID3D12CommandQueue* commandQueue, const CommandListSource& commandList);
+		void Destroy();
+
+		// The GPU has to be done with the frame last recorded in frameSlot. Its results become the latest frame.
+		void BeginFrame(uint32_t frameSlot);
+
+		// Resolves the frame's timestamps. Record it into the frame's last command list, after every scope ended.
+		void EndFrame(ID3D12GraphicsCommandList* commandList);
+
+		virtual void BeginScope(const char* name) override;
+		virtual void EndScope() override;
+
+		virtual const ProfileFrame* GetLatestFrame() const override;
+
+	private:
+		GpuProfilerDX(const GpuProfilerDX&) = delete;
+
+		static constexpr uint32_t kMaxFramesInFlight = FrameScheduler::kMaxFramesInFlight;
+
+		uint32_t GetFirstQuery(uint32_t frameSlot) const { return frameSlot * ProfileFrameBuilder::kMaxTimestamps; }
+
+		Microsoft::WRL::ComPtr<ID3D12QueryHeap> mQueryHeap;
+		Microsoft::WRL::ComPtr<ID3D12Resource> mReadbackBuffer;
+		uint64_t mTimestampFrequency;
+		CommandListSource mCommandList;
+
+		ProfileFrameBuilder mFrames[kMaxFramesInFlight];
+		bool mResolved[kMaxFramesInFlight]; // The slot's timestamps are on their way to the readback buffer
+		uint32_t mFrameSlot;
+		uint64_t mFrameNumber;
+
+		ProfileFrame mLatestFrame;
+		bool mHasResults;
+	};
+}
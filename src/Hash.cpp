@@ -0,0 +1,24 @@
+#include "pch.h"
+#include "Hash.h"
+
+#include <cstring>
+
+uint64_t BirdGame::HashFnv1a(const void* data, size_t size, uint64_t hash)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= kFnv1aPrime;
+	}
+	return hash;
+}
+
+BirdGame::Hasher& BirdGame::Hasher::AddString(const char* string)
+{
+	if (string == nullptr)
+	{
+		string = "";
+	}
+	return AddBytes(string, strlen(string) + 1);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace BirdGame
+{
+	constexpr uint64_t kFnv1aOffsetBasis = 14695981039346656037ull;
+	constexpr uint64_t kFnv1aPrime = 1099511628211ull;
+
+	// 64-bit FNV-1a. Fast and stable across runs and platforms, which is what on-disk keys and checksums need.
+	// Not suitable where collisions can be forced on purpose.
+	uint64_t HashFnv1a(const void* data, size_t size, uint64_t hash = kFnv1aOffsetBasis);
+
+	// Feeds values into one running FNV-1a hash
+	class Hasher final
+	{
+	public:
+		Hasher() : mHash(kFnv1aOffsetBasis) {}
+
+		Hasher& AddBytes(const void* data, size_t size)
+		{
+			mHash = HashFnv1a(data, size, mHash);
+			return *this;
+		}
+
+		// Hashes the object representation, so T must not have padding bytes
+		template <typename T>
+		Hasher& AddValue(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be hashed by value");
+			return AddBytes(&value, sizeof(T));
+		}
+
+		// Includes the terminator so consecutive strings can't run into each other. nullptr hashes like "".
+		Hasher& AddString(const char* string);
+
+		uint64_t Get() const { return mHash; }
+
+	private:
+		uint64_t mHash;
+	};
+}
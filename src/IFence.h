@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BirdGame
+{
+	// A monotonically increasing GPU timeline value, e.g. an ID3D12Fence signalled on a queue
+	class IFence
+	{
+	public:
+		IFence() = default;
+		virtual ~IFence() = default;
+
+		// Queues a signal that completes once all work submitted before it has finished
+		virtual void Signal(uint64_t value) = 0;
+		virtual uint64_t GetCompletedValue() const = 0;
+
+		// Blocks the calling thread until the completed value is >= value
+		virtual void WaitForValue(uint64_t value) = 0;
+
+	private:
+		IFence(const IFence&) = delete;
+	};
+}
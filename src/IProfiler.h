@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// One timed scope of a ProfileFrame
+	struct ProfileScopeResult
+	{
+		static constexpr uint32_t kNoParent = UINT32_MAX;
+
+		const char* name;
+		uint32_t parent; // Index of the enclosing scope, kNoParent at the top level
+		uint32_t depth;
+		double milliseconds;
+	};
+
+	// The scopes of one frame as a tree. Scopes are stored in the order they were opened, so parents come before
+	// their children and walking the array front to back is a depth-first walk of the tree.
+	struct ProfileFrame
+	{
+		uint64_t frameNumber;
+		std::vector<ProfileScopeResult> scopes;
+	};
+
+	// Named, nested timing scopes, collected per frame. GPU backends time the GPU work recorded between
+	// BeginScope() and EndScope() and only accept scopes while they record a frame. CpuProfiler times the
+	// calling thread instead.
+	class IProfiler
+	{
+	public:
+		IProfiler() = default;
+		virtual ~IProfiler() = default;
+
+		// name has to outlive the results, typically it is a string literal
+		virtual void BeginScope(const char* name) = 0;
+		virtual void EndScope() = 0;
+
+		// The most recent frame with results, nullptr until there is one. GPU results lag a few frames behind.
+		virtual const ProfileFrame* GetLatestFrame() const = 0;
+
+	private:
+		IProfiler(const IProfiler&) = delete;
+	};
+
+	// Times the enclosing block
+	class ProfileScope final
+	{
+	public:
+		ProfileScope(IProfiler& profiler, const char* name) : mProfiler(profiler) { mProfiler.BeginScope(name); }
+		~ProfileScope() { mProfiler.EndScope(); }
+
+	private:
+		ProfileScope(const ProfileScope&) = delete;
+
+		IProfiler& mProfiler;
+	};
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "RenderTypes.h"
+
 namespace BirdGame
 {
+	class IProfiler;
 	class Window;
 
 	class IRenderer
@@ -13,8 +16,31 @@ namespace BirdGame
 		virtual void Initialize(Window& window) = 0;
 		virtual void Shutdown() = 0;
 
+		// Queues a sprite for the next Render(). rect is in pixels, uv in normalized texture coordinates.
+		// Sprites are drawn back to front by layer and in submission order within a layer.
+		// Invalid or freed texture handles draw with kDefaultTexture.
+		virtual void SubmitSprite(TextureHandle texture, const Rect& rect, const Rect& uv, Color color, uint8_t layer) = 0;
+
+		// Queues UTF-8 text for the next Render(). (x, y) is the top left corner of the text box in pixels, see
+		// TextStyle for size, wrapping and alignment. '\n' starts a new line. Text is drawn after the sprites of its
+		// layer. Layouts are cached (see TextLayout), so resubmitting the same text every frame is cheap.
+		// Backends without a font draw nothing.
+		virtual void SubmitText(const char* text, const TextStyle& style, float x, float y, Color color, uint8_t layer) = 0;
+
 		virtual void Render() = 0;
 
+		// Saves the next rendered frame as a PNG at path. Frames are encoded on a worker thread, so the file is
+		// written a few frames later. Backends that can't capture, or have capture disabled, ignore this.
+		virtual void CaptureScreenshot(const char* path) = 0;
+
+		// Records every frame rendered until EndVideoCapture() into an uncompressed Y4M video at path. Frames the
+		// encoder can't keep up with repeat the previous one, so the video keeps its timing but never slows the game.
+		virtual void BeginVideoCapture(const char* path, uint32_t framesPerSecond) = 0;
+		virtual void EndVideoCapture() = 0;
+
+		// Frame and pass timings. Backends that can time the GPU report GPU time, the others CPU time.
+		virtual IProfiler& GetProfiler() = 0;
+
 	private:
 		IRenderer(const IRenderer&) = delete;
 	};
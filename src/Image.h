@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// CPU side RGBA8 image with tightly packed rows
+	struct Image
+	{
+		static constexpr uint32_t kBytesPerPixel = 4;
+
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> pixels;
+
+		void Resize(uint32_t newWidth, uint32_t newHeight)
+		{
+			width = newWidth;
+			height = newHeight;
+			pixels.assign(static_cast<size_t>(width) * height * kBytesPerPixel, 0);
+		}
+
+		uint32_t GetRowPitch() const { return width * kBytesPerPixel; }
+
+		uint8_t* GetPixel(uint32_t x, uint32_t y) { return &pixels[(static_cast<size_t>(y) * width + x) * kBytesPerPixel]; }
+		const uint8_t* GetPixel(uint32_t x, uint32_t y) const { return &pixels[(static_cast<size_t>(y) * width + x) * kBytesPerPixel]; }
+	};
+}
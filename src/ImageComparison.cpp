@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "ImageComparison.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Weighted squared YIQ distance between black and white, what distances are scaled by
+	constexpr float kMaxYiqDistance = 35215.0f;
+
+	// How much of the original brightness is left in the faded background of the diff image
+	constexpr float kDiffBackgroundOpacity = 0.1f;
+
+	struct Yiq
+	{
+		float y;
+		float i;
+		float q;
+	};
+
+	Yiq ToYiq(const uint8_t* pixel)
+	{
+		// Over white, so a transparent pixel looks the same whatever its color
+		const float alpha = pixel[3] / 255.0f;
+		const float r = 255.0f + (pixel[0] - 255.0f) * alpha;
+		const float g = 255.0f + (pixel[1] - 255.0f) * alpha;
+		const float b = 255.0f + (pixel[2] - 255.0f) * alpha;
+		return {
+			r * 0.29889531f + g * 0.58662247f + b * 0.11448223f,
+			r * 0.59597799f - g * 0.27417610f - b * 0.32180189f,
+			r * 0.21147017f - g * 0.52261711f + b * 0.31114694f
+		};
+	}
+
+	float PerceivedDistance(const uint8_t* a, const uint8_t* b)
+	{
+		const Yiq first = ToYiq(a);
+		const Yiq second = ToYiq(b);
+		const float y = first.y - second.y;
+		const float i = first.i - second.i;
+		const float q = first.q - second.q;
+		return std::sqrt((0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q) / kMaxYiqDistance);
+	}
+}
+
+BirdGame::ImageDifference BirdGame::CompareImages(const Image& actual, const Image& expected, float threshold, Image* diff)
+{
+	ImageDifference difference = {};
+	difference.sizeMatches = (actual.width == expected.width) && (actual.height == expected.height);
+	if (!difference.sizeMatches)
+	{
+		difference.differentPixels = std::max(actual.width * actual.height, expected.width * expected.height);
+		difference.maxDistance = 1.0f;
+		if (diff != nullptr)
+		{
+			diff->Resize(0, 0);
+		}
+		return difference;
+	}
+
+	if (diff != nullptr)
+	{
+		diff->Resize(expected.width, expected.height);
+	}
+
+	const size_t pixelCount = static_cast<size_t>(expected.width) * expected.height;
+	for (size_t index = 0; index < pixelCount; ++index)
+	{
+		const uint8_t* actualPixel = &actual.pixels[index * Image::kBytesPerPixel];
+		const uint8_t* expectedPixel = &expected.pixels[index * Image::kBytesPerPixel];
+
+		// Most pixels of a passing image are identical, so skip the color math for them
+		const float distance = (memcmp(actualPixel, expectedPixel, Image::kBytesPerPixel) == 0) ? 0.0f : PerceivedDistance(actualPixel, expectedPixel);
+		difference.maxDistance = std::max(difference.maxDistance, distance);
+
+		const bool different = distance > threshold;
+		if (different)
+		{
+			difference.differentPixels++;
+		}
+
+		if (diff != nullptr)
+		{
+			uint8_t* diffPixel = &diff->pixels[index * Image::kBytesPerPixel];
+			if (different)
+			{
+				diffPixel[0] = static_cast<uint8_t>(128.0f + 127.0f * std::min(distance, 1.0f) + 0.5f);
+				diffPixel[1] = 0;
+				diffPixel[2] = 0;
+			}
+			else
+			{
+				const uint8_t gray = static_cast<uint8_t>(255.0f + (ToYiq(expectedPixel).y - 255.0f) * kDiffBackgroundOpacity + 0.5f);
+				diffPixel[0] = gray;
+				diffPixel[1] = gray;
+				diffPixel[2] = gray;
+			}
+			diffPixel[3] = 0xff;
+		}
+	}
+
+	return difference;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Image.h"
+
+#include <cstdint>
+
+namespace BirdGame
+{
+	struct ImageDifference
+	{
+		bool sizeMatches;
+		uint32_t differentPixels; // Pixels further apart than the threshold
+		float maxDistance;        // Largest perceived distance of any pixel, 0 to 1
+	};
+
+	// Compares two images pixel by pixel by how different they look rather than by their bytes. Both are
+	// composited onto white, then the distance is measured in YIQ with brightness weighted the most (Kotsarenko and
+	// Ramos, "Measuring perceived color difference using YIQ NTSC transmission color space in mobile applications"),
+	// scaled so black against white is 1. Pixels more than threshold apart count as different; 0.1 ignores the
+	// rounding differences between rasterizers but catches any change people would notice.
+	// If diff isn't null it receives a picture of the result the size of expected: expected faded to light gray,
+	// with the different pixels drawn on top in red, brighter the further apart they are. It's left empty if the
+	// sizes don't match.
+	ImageDifference CompareImages(const Image& actual, const Image& expected, float threshold, Image* diff);
+}
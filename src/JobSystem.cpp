@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+#include <assert.h>
+#include <algorithm>
+
+BirdGame::JobSystem::JobSystem(uint32_t workerCount) :
+	mJob({ nullptr, 0, 1, 0, 0 }),
+	mStopping(false),
+	mNextChunk(0),
+	mCompletedChunks(0)
+{
+	mWorkers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		mWorkers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+	}
+}
+
+BirdGame::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mJobAvailable.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+uint32_t BirdGame::JobSystem::GetDefaultWorkerCount(uint32_t maxWorkers)
+{
+	// hardware_concurrency() may return 0 if it can't tell
+	const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	return std::min(hardwareThreads - 1, maxWorkers);
+}
+
+void BirdGame::JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const RangeJob& job)
+{
+	assert(grainSize > 0);
+	assert(mJob.function == nullptr && "ParallelFor() is not reentrant");
+
+	const uint32_t chunkCount = GetChunkCount(count, grainSize);
+	if (chunkCount == 0)
+	{
+		return;
+	}
+
+	// Not worth waking anyone up for
+	if (chunkCount == 1 || mWorkers.empty())
+	{
+		for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			job(chunk, chunk * grainSize, std::min(count, (chunk + 1) * grainSize), 0);
+		}
+		return;
+	}
+
+	Job current = {};
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		current = { &job, count, grainSize, chunkCount, mJob.generation + 1 };
+		mJob = current;
+		mNextChunk.store(static_cast<uint64_t>(current.generation) << 32);
+		mCompletedChunks.store(0);
+	}
+	mJobAvailable.notify_all();
+
+	RunChunks(current, 0);
+
+	// Workers may still be running the last chunks they claimed
+	std::unique_lock<std::mutex> lock(mMutex);
+	mJobDone.wait(lock, [&]() { return mCompletedChunks.load() == chunkCount; });
+	mJob.function = nullptr;
+}
+
+void BirdGame::JobSystem::WorkerMain(uint32_t workerIndex)
+{
+	uint32_t lastGeneration = 0;
+	for (;;)
+	{
+		Job job = {};
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobAvailable.wait(lock, [&]() { return mStopping || (mJob.function != nullptr && mJob.generation != lastGeneration); });
+			if (mStopping)
+			{
+				return;
+			}
+			job = mJob;
+			lastGeneration = job.generation;
+		}
+
+		RunChunks(job, workerIndex);
+	}
+}
+
+void BirdGame::JobSystem::RunChunks(const Job& job, uint32_t workerIndex)
+{
+	// A successful claim keeps the job alive: ParallelFor() can't return before the claimed chunk completes
+	uint64_t next = mNextChunk.load();
+	for (;;)
+	{
+		const uint32_t chunk = static_cast<uint32_t>(next);
+		if (static_cast<uint32_t>(next >> 32) != job.generation || chunk >= job.chunkCount)
+		{
+			return;
+		}
+		if (!mNextChunk.compare_exchange_weak(next, next + 1))
+		{
+			continue;
+		}
+
+		(*job.function)(chunk, chunk * job.grainSize, std::min(job.count, (chunk + 1) * job.grainSize), workerIndex);
+
+		if (mCompletedChunks.fetch_add(1) + 1 == job.chunkCount)
+		{
+			// Take the lock so the notification can't slip in between the caller checking and starting to wait
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJobDone.notify_all();
+		}
+		next = mNextChunk.load();
+	}
+}
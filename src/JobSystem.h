@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BirdGame
+{
+	// A fixed set of worker threads for data parallel work. The thread calling ParallelFor() works on the job too,
+	// so a JobSystem without workers simply runs everything inline. How work is split into chunks only depends on
+	// the item count and grain size, never on the number of threads or which thread ends up running a chunk.
+	class JobSystem final
+	{
+	public:
+		// Runs items [begin, end) of chunk chunkIndex. workerIndex is 0 for the calling thread and 1..GetWorkerCount()
+		// for the workers, for indexing per-thread resources.
+		using RangeJob = std::function<void(uint32_t chunkIndex, uint32_t begin, uint32_t end, uint32_t workerIndex)>;
+
+		explicit JobSystem(uint32_t workerCount);
+		~JobSystem();
+
+		// One worker per hardware thread besides the calling one, at most maxWorkers
+		static uint32_t GetDefaultWorkerCount(uint32_t maxWorkers);
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(mWorkers.size()); }
+
+		// Number of distinct workerIndex values a job can see
+		uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+		static uint32_t GetChunkCount(uint32_t count, uint32_t grainSize) { return (count + grainSize - 1) / grainSize; }
+
+		// Splits [0, count) into chunks of grainSize items (the last one may be smaller) and returns once all of
+		// them have run. Not reentrant: jobs must not call ParallelFor() themselves.
+		void ParallelFor(uint32_t count, uint32_t grainSize, const RangeJob& job);
+
+	private:
+		JobSystem(const JobSystem&) = delete;
+
+		// What workers need to know about a job. They copy it under mMutex when they pick up a new generation and
+		// only use the copy from then on: by the time they look again the members may already describe the next job.
+		struct Job
+		{
+			const RangeJob* function; // Null between jobs
+			uint32_t count;
+			uint32_t grainSize;
+			uint32_t chunkCount;
+			uint32_t generation;
+		};
+
+		void WorkerMain(uint32_t workerIndex);
+
+		// Claims and runs chunks of job until none are left or a newer job has started
+		void RunChunks(const Job& job, uint32_t workerIndex);
+
+		std::vector<std::thread> mWorkers;
+
+		std::mutex mMutex;
+		std::condition_variable mJobAvailable;
+		std::condition_variable mJobDone;
+
+		Job mJob; // Guarded by mMutex
+		bool mStopping;
+
+		// The job generation in the high 32 bits and the next chunk to claim in the low 32. Claims only succeed for
+		// the generation the claiming thread copied, so a worker that got preempted can't take a chunk of a later job.
+		std::atomic<uint64_t> mNextChunk;
+		std::atomic<uint32_t> mCompletedChunks;
+	};
+}
@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+BirdGame::MappedFile::MappedFile() :
+	mData(nullptr),
+	mSize(0),
+	mOpen(false)
+{
+}
+
+BirdGame::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool BirdGame::MappedFile::Open(const char* path)
+{
+	Close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// Empty files can't be mapped
+	if (fileSize.QuadPart > 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping != NULL)
+		{
+			mData = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+			// The view keeps the mapping alive
+			CloseHandle(mapping);
+		}
+
+		if (mData == nullptr)
+		{
+			CloseHandle(file);
+			return false;
+		}
+	}
+
+	CloseHandle(file);
+	mSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int file = open(path, O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat = {};
+	if (fstat(file, &fileStat) != 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// Empty files can't be mapped
+	if (fileStat.st_size > 0)
+	{
+		void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			close(file);
+			return false;
+		}
+		mData = static_cast<const uint8_t*>(data);
+	}
+
+	// The mapping keeps the file alive
+	close(file);
+	mSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	mOpen = true;
+	return true;
+}
+
+void BirdGame::MappedFile::Close()
+{
+	if (mData != nullptr)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(mData);
+#else
+		munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+	}
+
+	mData = nullptr;
+	mSize = 0;
+	mOpen = false;
+}
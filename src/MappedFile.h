@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BirdGame
+{
+	// Read-only memory mapping of a whole file (MapViewOfFile on Windows, mmap elsewhere). Pages are loaded on
+	// first access and shared with the OS file cache, so nothing is copied up front.
+	class MappedFile final
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		// Returns false if the file can't be opened or mapped. Empty files map successfully with a null GetData().
+		bool Open(const char* path);
+		void Close();
+
+		bool IsOpen() const { return mOpen; }
+		const uint8_t* GetData() const { return mData; }
+		size_t GetSize() const { return mSize; }
+
+	private:
+		MappedFile(const MappedFile&) = delete;
+
+		const uint8_t* mData;
+		size_t mSize;
+		bool mOpen;
+	};
+}
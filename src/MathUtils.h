@@ -0,0 +1,11 @@
+#pragma once
+
+namespace BirdGame
+{
+	// Rounds value up to the next multiple of alignment, which doesn't have to be a power of two
+	template <typename T>
+	constexpr T AlignUp(T value, T alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "MemoryArena.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <new>
+
+BirdGame::MemoryArena::MemoryArena(const char* name, MemoryTag tag, uint8_t* base, size_t capacity) :
+	mName(name),
+	mBase(base),
+	mCapacity(capacity),
+	mUsed(0),
+	mPeakUsed(0)
+{
+	// The arena is tracked as a whole since its memory is committed up front
+	MemoryTracker::TrackResource(mBase, mName, tag, mCapacity);
+}
+
+BirdGame::MemoryArena::~MemoryArena()
+{
+	MemoryTracker::UntrackResource(mBase);
+}
+
+void* BirdGame::MemoryArena::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+
+	const uintptr_t current = reinterpret_cast<uintptr_t>(mBase) + mUsed;
+	const uintptr_t aligned = (current + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+	const size_t newUsed = (aligned - reinterpret_cast<uintptr_t>(mBase)) + size;
+
+	if (newUsed > mCapacity)
+	{
+		assert(false && "MemoryArena is out of space, increase its size in the memory budget");
+		throw std::bad_alloc();
+	}
+
+	mUsed = newUsed;
+	mPeakUsed = std::max(mPeakUsed, mUsed);
+	return reinterpret_cast<void*>(aligned);
+}
+
+void BirdGame::MemoryArena::Rewind(size_t marker)
+{
+	assert(marker <= mUsed);
+	mUsed = marker;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "MemoryTracker.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BirdGame
+{
+	// Linear allocator over a fixed, already committed block of memory carved out of a MemoryReservation.
+	// Allocations are freed all at once with Reset() or back to a marker with Rewind().
+	class MemoryArena final
+	{
+	public:
+		MemoryArena(const char* name, MemoryTag tag, uint8_t* base, size_t capacity);
+		~MemoryArena();
+
+		// Throws std::bad_alloc if the arena is out of space since that means the memory budget is wrong
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template <typename T>
+		T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+		size_t GetMarker() const { return mUsed; }
+		void Rewind(size_t marker);
+		void Reset() { Rewind(0); }
+
+		const char* GetName() const { return mName; }
+		size_t GetUsed() const { return mUsed; }
+		size_t GetPeakUsed() const { return mPeakUsed; }
+		size_t GetCapacity() const { return mCapacity; }
+
+	private:
+		MemoryArena(const MemoryArena&) = delete;
+
+		const char* mName;
+		uint8_t* mBase;
+		size_t mCapacity;
+		size_t mUsed;
+		size_t mPeakUsed;
+	};
+
+	// Rewinds an arena to where it was when the scope was entered
+	class ArenaScope final
+	{
+	public:
+		explicit ArenaScope(MemoryArena& arena) : mArena(arena), mMarker(arena.GetMarker()) {}
+		~ArenaScope() { mArena.Rewind(mMarker); }
+
+	private:
+		ArenaScope(const ArenaScope&) = delete;
+
+		MemoryArena& mArena;
+		size_t mMarker;
+	};
+
+	// Allocator that lets std containers live in an arena. Memory is only reclaimed when the arena is rewound.
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = T;
+
+		explicit ArenaAllocator(MemoryArena& arena) : mArena(&arena) {}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : mArena(other.GetArena()) {}
+
+		T* allocate(size_t count) { return mArena->AllocateArray<T>(count); }
+		void deallocate(T* /*memory*/, size_t /*count*/) {}
+
+		MemoryArena* GetArena() const { return mArena; }
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return mArena == other.GetArena(); }
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return mArena != other.GetArena(); }
+
+	private:
+		MemoryArena* mArena;
+	};
+}
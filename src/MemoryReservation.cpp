@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "MemoryReservation.h"
+
+#include "MathUtils.h"
+#include "VirtualMemory.h"
+
+#include <assert.h>
+#include <cstdio>
+#include <new>
+
+namespace
+{
+#if !defined(_WIN32)
+	// Transparent huge pages can only back 2MB aligned ranges, so line the reservation up with them
+	constexpr size_t kTransparentHugePageSize = 2 * 1024 * 1024;
+#endif
+}
+
+BirdGame::MemoryReservation::MemoryReservation(const Settings& settings) :
+	mReservationBase(nullptr),
+	mReservationSize(0),
+	mBase(nullptr),
+	mSize(0),
+	mOffset(0),
+	mGranularity(VirtualMemory::GetPageSize()),
+	mUsesLargePages(false)
+{
+	const size_t largePageSize = VirtualMemory::GetLargePageSize();
+	if (settings.useLargePages && largePageSize != 0)
+	{
+		mReservationSize = AlignUp(settings.budget, largePageSize);
+		mReservationBase = static_cast<uint8_t*>(VirtualMemory::ReserveLargePages(mReservationSize));
+		if (mReservationBase != nullptr)
+		{
+			mUsesLargePages = true;
+			mGranularity = largePageSize;
+			mBase = mReservationBase;
+			mSize = mReservationSize;
+		}
+	}
+
+	if (!mUsesLargePages)
+	{
+#if defined(_WIN32)
+		mReservationSize = AlignUp(settings.budget, mGranularity);
+		mReservationBase = static_cast<uint8_t*>(VirtualMemory::Reserve(mReservationSize));
+		mBase = mReservationBase;
+#else
+		mReservationSize = AlignUp(settings.budget, mGranularity) + kTransparentHugePageSize;
+		mReservationBase = static_cast<uint8_t*>(VirtualMemory::Reserve(mReservationSize));
+		mBase = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<size_t>(mReservationBase), kTransparentHugePageSize));
+#endif
+		mSize = AlignUp(settings.budget, mGranularity);
+	}
+
+	if (mReservationBase == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+}
+
+BirdGame::MemoryReservation::~MemoryReservation()
+{
+	// Arenas have to go first so they are untracked before their memory disappears
+	mArenas.clear();
+	VirtualMemory::Release(mReservationBase, mReservationSize);
+}
+
+BirdGame::MemoryArena& BirdGame::MemoryReservation::CarveArena(const char* name, MemoryTag tag, size_t size, bool prefault)
+{
+	const size_t alignedSize = AlignUp(size, mGranularity);
+	if (mOffset + alignedSize > mSize)
+	{
+		assert(false && "Memory budget exceeded, increase the reservation size");
+		throw std::bad_alloc();
+	}
+
+	uint8_t* base = mBase + mOffset;
+
+	// Large pages are committed (and locked) when they are reserved, so there is nothing left to do for them
+	if (!mUsesLargePages)
+	{
+		if (!VirtualMemory::Commit(base, alignedSize))
+		{
+			throw std::bad_alloc();
+		}
+
+		if (prefault)
+		{
+			VirtualMemory::Prefault(base, alignedSize);
+		}
+	}
+
+	mOffset += alignedSize;
+	mArenas.emplace_back(new MemoryArena(name, tag, base, alignedSize));
+	return *mArenas.back();
+}
+
+void BirdGame::MemoryReservation::WriteReport(std::string& output) const
+{
+	char line[256];
+	snprintf(line, sizeof(line), "==== Arenas (%zu of %zu bytes carved, %s pages) ====\n", mOffset, mSize, mUsesLargePages ? "large" : "regular");
+	output += line;
+
+	for (const std::unique_ptr<MemoryArena>& arena : mArenas)
+	{
+		snprintf(line, sizeof(line), "%-20s %14zu %14zu\n", arena->GetName(), arena->GetCapacity(), arena->GetPeakUsed());
+		output += line;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MemoryArena.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace BirdGame
+{
+	// Reserves the engine's whole address space budget at startup. Subsystems carve committed (and optionally
+	// prefaulted) arenas out of it so no memory has to be faulted in or requested from the OS during gameplay.
+	class MemoryReservation final
+	{
+	public:
+		struct Settings
+		{
+			size_t budget;
+			// Back the reservation with explicit large pages if the OS allows it. Falls back to regular
+			// pages (plus transparent huge pages on Linux) if they aren't available.
+			bool useLargePages;
+		};
+
+		explicit MemoryReservation(const Settings& settings);
+		~MemoryReservation();
+
+		// Commits the next size bytes of the reservation as an arena. Prefaulted arenas have all of their pages
+		// touched now, which is what we want for hot per-frame arenas. The arena lives as long as the reservation.
+		MemoryArena& CarveArena(const char* name, MemoryTag tag, size_t size, bool prefault);
+
+		bool UsesLargePages() const { return mUsesLargePages; }
+		size_t GetReservedBytes() const { return mSize; }
+		size_t GetCarvedBytes() const { return mOffset; }
+
+		// Appends the capacity and high-water mark of each arena that was carved
+		void WriteReport(std::string& output) const;
+
+	private:
+		MemoryReservation(const MemoryReservation&) = delete;
+
+		// The range we got from the OS. mBase/mSize is the usable (aligned) part of it.
+		uint8_t* mReservationBase;
+		size_t mReservationSize;
+
+		uint8_t* mBase;
+		size_t mSize;
+		size_t mOffset;
+		size_t mGranularity;
+		bool mUsesLargePages;
+		std::vector<std::unique_ptr<MemoryArena>> mArenas;
+	};
+}
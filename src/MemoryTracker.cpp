@@ -0,0 +1,274 @@
+#include "pch.h"
+#include "MemoryTracker.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kNumMemoryTags = static_cast<size_t>(BirdGame::MemoryTag::Count);
+	constexpr uint32_t kNoCallSite = UINT32_MAX;
+
+	const char* const kMemoryTagNames[kNumMemoryTags] =
+	{
+		"Application",
+		"Renderer",
+		"Texture",
+		"Geometry"
+	};
+
+	// Stored in front of every tracked allocation. Live allocations are kept in an intrusive list so the
+	// report can walk them without a separate lookup table. Padded to keep the user block 16 byte aligned.
+	struct alignas(16) AllocationHeader
+	{
+		AllocationHeader* previous;
+		AllocationHeader* next;
+		uint64_t size;
+		BirdGame::MemoryTag tag;
+		uint32_t callSiteIndex;
+	};
+
+	struct ResourceRecord
+	{
+		const char* name;
+		BirdGame::MemoryTag tag;
+		uint64_t size;
+	};
+
+	struct TagStats
+	{
+		uint64_t currentBytes = 0;
+		uint64_t peakBytes = 0;
+	};
+
+	struct TrackerState
+	{
+		std::mutex mutex;
+		AllocationHeader* liveAllocations = nullptr;
+		uint64_t allocationCount = 0;
+		TagStats tags[kNumMemoryTags];
+		std::vector<BirdGame::CallSite> callSites;
+		std::unordered_map<const void*, ResourceRecord> resources;
+	};
+
+	// Function local so allocations made during static initialization are safe
+	TrackerState& GetState()
+	{
+		static TrackerState sState;
+		return sState;
+	}
+
+	void AddBytes(TrackerState& state, BirdGame::MemoryTag tag, uint64_t size)
+	{
+		TagStats& stats = state.tags[static_cast<size_t>(tag)];
+		stats.currentBytes += size;
+		stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes);
+	}
+
+	void RemoveBytes(TrackerState& state, BirdGame::MemoryTag tag, uint64_t size)
+	{
+		TagStats& stats = state.tags[static_cast<size_t>(tag)];
+		assert(stats.currentBytes >= size);
+		stats.currentBytes -= size;
+	}
+
+	uint32_t FindOrAddCallSite(TrackerState& state, const BirdGame::CallSite& callSite)
+	{
+		for (size_t i = 0; i < state.callSites.size(); ++i)
+		{
+			if (state.callSites[i].file == callSite.file && state.callSites[i].line == callSite.line)
+			{
+				return static_cast<uint32_t>(i);
+			}
+		}
+
+		state.callSites.push_back(callSite);
+		return static_cast<uint32_t>(state.callSites.size() - 1);
+	}
+
+	void AppendLine(std::string& output, const char* format, ...)
+	{
+		char buffer[512];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		va_end(args);
+		output += buffer;
+		output += '\n';
+	}
+}
+
+const char* BirdGame::GetMemoryTagName(MemoryTag tag)
+{
+	assert(tag < MemoryTag::Count);
+	return kMemoryTagNames[static_cast<size_t>(tag)];
+}
+
+void* BirdGame::MemoryTracker::Allocate(size_t size, MemoryTag tag, const CallSite& callSite)
+{
+	void* block = std::malloc(sizeof(AllocationHeader) + size);
+	if (block == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(block);
+	header->previous = nullptr;
+	header->size = size;
+	header->tag = tag;
+
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	header->callSiteIndex = (state.allocationCount++ % kCallSiteSampleRate == 0) ? FindOrAddCallSite(state, callSite) : kNoCallSite;
+	header->next = state.liveAllocations;
+	if (state.liveAllocations != nullptr)
+	{
+		state.liveAllocations->previous = header;
+	}
+	state.liveAllocations = header;
+
+	AddBytes(state, tag, size);
+
+	return header + 1;
+}
+
+void BirdGame::MemoryTracker::Free(void* memory)
+{
+	if (memory == nullptr)
+	{
+		return;
+	}
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(memory) - 1;
+
+	{
+		TrackerState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		if (header->previous != nullptr)
+		{
+			header->previous->next = header->next;
+		}
+		else
+		{
+			state.liveAllocations = header->next;
+		}
+
+		if (header->next != nullptr)
+		{
+			header->next->previous = header->previous;
+		}
+
+		RemoveBytes(state, header->tag, header->size);
+	}
+
+	std::free(header);
+}
+
+void BirdGame::MemoryTracker::TrackResource(const void* resource, const char* name, MemoryTag tag, uint64_t size)
+{
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	auto result = state.resources.emplace(resource, ResourceRecord{ name, tag, size });
+	assert(result.second && "Resource is already tracked");
+	if (result.second)
+	{
+		AddBytes(state, tag, size);
+	}
+}
+
+void BirdGame::MemoryTracker::UntrackResource(const void* resource)
+{
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	auto it = state.resources.find(resource);
+	if (it != state.resources.end())
+	{
+		RemoveBytes(state, it->second.tag, it->second.size);
+		state.resources.erase(it);
+	}
+}
+
+uint64_t BirdGame::MemoryTracker::GetCurrentBytes(MemoryTag tag)
+{
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	return state.tags[static_cast<size_t>(tag)].currentBytes;
+}
+
+uint64_t BirdGame::MemoryTracker::GetPeakBytes(MemoryTag tag)
+{
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	return state.tags[static_cast<size_t>(tag)].peakBytes;
+}
+
+size_t BirdGame::MemoryTracker::WriteReport(std::string& output)
+{
+	struct LeakGroup
+	{
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	TrackerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	AppendLine(output, "==== Memory report ====");
+	AppendLine(output, "%-12s %14s %14s", "Subsystem", "Current", "Peak");
+	for (size_t i = 0; i < kNumMemoryTags; ++i)
+	{
+		AppendLine(output, "%-12s %14llu %14llu", kMemoryTagNames[i],
+			static_cast<unsigned long long>(state.tags[i].currentBytes),
+			static_cast<unsigned long long>(state.tags[i].peakBytes));
+	}
+
+	// Group outstanding allocations by (tag, call site). Unsampled allocations share the kNoCallSite bucket.
+	std::map<std::pair<MemoryTag, uint32_t>, LeakGroup> groups;
+	size_t leakCount = 0;
+	for (const AllocationHeader* header = state.liveAllocations; header != nullptr; header = header->next)
+	{
+		LeakGroup& group = groups[{ header->tag, header->callSiteIndex }];
+		group.count++;
+		group.bytes += header->size;
+		leakCount++;
+	}
+
+	AppendLine(output, "Outstanding allocations: %zu", leakCount);
+	for (const auto& [key, group] : groups)
+	{
+		const MemoryTag tag = key.first;
+		const uint32_t callSiteIndex = key.second;
+		if (callSiteIndex == kNoCallSite)
+		{
+			AppendLine(output, "  [%s] %llu allocation(s), %llu bytes at unsampled call sites", GetMemoryTagName(tag),
+				static_cast<unsigned long long>(group.count), static_cast<unsigned long long>(group.bytes));
+		}
+		else
+		{
+			const CallSite& callSite = state.callSites[callSiteIndex];
+			AppendLine(output, "  [%s] %llu allocation(s), %llu bytes at %s(%d)", GetMemoryTagName(tag),
+				static_cast<unsigned long long>(group.count), static_cast<unsigned long long>(group.bytes), callSite.file, callSite.line);
+		}
+	}
+
+	AppendLine(output, "Live resources: %zu", state.resources.size());
+	for (const auto& [resource, record] : state.resources)
+	{
+		AppendLine(output, "  [%s] %s (%llu bytes) at %p", GetMemoryTagName(record.tag), record.name,
+			static_cast<unsigned long long>(record.size), resource);
+	}
+
+	return leakCount + state.resources.size();
+}
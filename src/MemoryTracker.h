@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BirdGame
+{
+	// Subsystems that own tracked memory. Keep in sync with kMemoryTagNames in MemoryTracker.cpp.
+	enum class MemoryTag : uint8_t
+	{
+		Application,
+		Renderer,
+		Texture,
+		Geometry,
+		Count
+	};
+
+	const char* GetMemoryTagName(MemoryTag tag);
+
+	// Where an allocation came from. Use BIRDGAME_CALL_SITE to fill this in.
+	struct CallSite
+	{
+		const char* file;
+		int line;
+	};
+
+	// Tracks live allocations and renderer resources per subsystem so anything still alive at shutdown can be reported.
+	// Only every kCallSiteSampleRate-th allocation records its call site to keep the bookkeeping cheap.
+	class MemoryTracker final
+	{
+	public:
+		static constexpr uint32_t kCallSiteSampleRate = 8;
+
+		static void* Allocate(size_t size, MemoryTag tag, const CallSite& callSite);
+		static void Free(void* memory);
+
+		// Memory we don't allocate through the tracker (GPU resources, arenas, ...) is tracked by address
+		static void TrackResource(const void* resource, const char* name, MemoryTag tag, uint64_t size);
+		static void UntrackResource(const void* resource);
+
+		static uint64_t GetCurrentBytes(MemoryTag tag);
+		static uint64_t GetPeakBytes(MemoryTag tag);
+
+		// Appends a human readable report to output and returns the number of leaked allocations and resources
+		static size_t WriteReport(std::string& output);
+
+	private:
+		MemoryTracker() = delete;
+	};
+
+	// Allocator that routes std containers through the MemoryTracker
+	template <typename T, MemoryTag Tag>
+	class TrackedAllocator
+	{
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = TrackedAllocator<U, Tag>;
+		};
+
+		TrackedAllocator() : mCallSite{ "unknown", 0 } {}
+		explicit TrackedAllocator(const CallSite& callSite) : mCallSite(callSite) {}
+
+		template <typename U>
+		TrackedAllocator(const TrackedAllocator<U, Tag>& other) : mCallSite(other.GetCallSite()) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(MemoryTracker::Allocate(count * sizeof(T), Tag, mCallSite)); }
+		void deallocate(T* memory, size_t /*count*/) { MemoryTracker::Free(memory); }
+
+		const CallSite& GetCallSite() const { return mCallSite; }
+
+		template <typename U>
+		bool operator==(const TrackedAllocator<U, Tag>&) const { return true; }
+		template <typename U>
+		bool operator!=(const TrackedAllocator<U, Tag>&) const { return false; }
+
+	private:
+		CallSite mCallSite;
+	};
+}
+
+#define BIRDGAME_CALL_SITE BirdGame::CallSite{ __FILE__, __LINE__ }
@@ -0,0 +1,357 @@
+#include "pch.h"
+#include "MipGenerator.h"
+
+#include "JobSystem.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BIRDGAME_MIP_SSE2 1
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BIRDGAME_MIP_AVX2 1
+#endif
+
+namespace
+{
+	constexpr uint32_t kKaiserTaps = 12;
+	constexpr int32_t kKaiserFirstTap = -5;   // Relative to 2x, so the taps are centered between texels 2x and 2x + 1
+	constexpr double kKaiserRadius = 3.0;     // In destination texels
+	constexpr double kKaiserBeta = 4.0;
+	constexpr double kPi = 3.14159265358979323846;
+
+	// Pixels per chunk of rows. Big enough to amortize handing out a chunk, small enough to balance small levels.
+	constexpr uint32_t kPixelsPerJob = 16384;
+
+	uint32_t GetRowsPerJob(uint32_t width)
+	{
+		return std::max(1u, kPixelsPerJob / std::max(1u, width));
+	}
+
+	// Modified Bessel function of the first kind, order 0, for the Kaiser window
+	double BesselI0(double x)
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; ++k)
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	// Four floats, one texel's channels. Compiles to one SSE register where available.
+#if defined(BIRDGAME_MIP_SSE2)
+	struct Vec4
+	{
+		__m128 v;
+	};
+
+	Vec4 Load(const float* values) { return { _mm_loadu_ps(values) }; }
+	void Store(const Vec4& a, float* values) { _mm_storeu_ps(values, a.v); }
+	Vec4 Zero() { return { _mm_setzero_ps() }; }
+	Vec4 Add(const Vec4& a, const Vec4& b) { return { _mm_add_ps(a.v, b.v) }; }
+	Vec4 MulAdd(const Vec4& accumulator, const Vec4& a, float weight) { return { _mm_add_ps(accumulator.v, _mm_mul_ps(a.v, _mm_set1_ps(weight))) }; }
+	Vec4 Scale(const Vec4& a, float scale) { return { _mm_mul_ps(a.v, _mm_set1_ps(scale)) }; }
+#else
+	struct Vec4
+	{
+		float v[4];
+	};
+
+	Vec4 Load(const float* values) { return { { values[0], values[1], values[2], values[3] } }; }
+	void Store(const Vec4& a, float* values) { for (int c = 0; c < 4; ++c) values[c] = a.v[c]; }
+	Vec4 Zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+	Vec4 Add(const Vec4& a, const Vec4& b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	Vec4 MulAdd(const Vec4& accumulator, const Vec4& a, float weight) { return { { accumulator.v[0] + a.v[0] * weight, accumulator.v[1] + a.v[1] * weight, accumulator.v[2] + a.v[2] * weight, accumulator.v[3] + a.v[3] * weight } }; }
+	Vec4 Scale(const Vec4& a, float scale) { return { { a.v[0] * scale, a.v[1] * scale, a.v[2] * scale, a.v[3] * scale } }; }
+#endif
+}
+
+BirdGame::MipGenerator::MipGenerator()
+{
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		const double value = i / 255.0;
+		mSrgbToLinear[i] = static_cast<float>((value <= 0.04045) ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+	}
+
+	// Fine enough that every 8 bit value survives a round trip
+	for (uint32_t i = 0; i < kLinearToSrgbSize; ++i)
+	{
+		const double value = static_cast<double>(i) / (kLinearToSrgbSize - 1);
+		const double srgb = (value <= 0.0031308) ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+		mLinearToSrgb[i] = static_cast<uint8_t>(std::clamp(srgb * 255.0 + 0.5, 0.0, 255.0));
+	}
+
+	// Every destination texel sees the source at the same offsets, so one set of weights serves all of them
+	double weights[kKaiserTaps];
+	double sum = 0.0;
+	for (uint32_t tap = 0; tap < kKaiserTaps; ++tap)
+	{
+		const double distance = (kKaiserFirstTap + static_cast<int32_t>(tap) - 0.5) * 0.5;
+		const double sinc = (distance == 0.0) ? 1.0 : std::sin(kPi * distance) / (kPi * distance);
+		const double window = distance / kKaiserRadius;
+		weights[tap] = sinc * BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - window * window))) / BesselI0(kKaiserBeta);
+		sum += weights[tap];
+	}
+	for (uint32_t tap = 0; tap < kKaiserTaps; ++tap)
+	{
+		mKaiserWeights[tap] = static_cast<float>(weights[tap] / sum);
+	}
+}
+
+uint32_t BirdGame::MipGenerator::GetFullMipCount(uint32_t width, uint32_t height)
+{
+	uint32_t count = 1;
+	for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+	{
+		++count;
+	}
+	return count;
+}
+
+void BirdGame::MipGenerator::Generate(const uint8_t* source, uint32_t width, uint32_t height, const Settings& settings, JobSystem& jobSystem, std::vector<Image>& mips) const
+{
+	const uint32_t fullCount = GetFullMipCount(width, height);
+	const uint32_t levelCount = (settings.maxLevels == 0) ? fullCount : std::min(settings.maxLevels, fullCount);
+	mips.resize(levelCount - 1);
+
+	Level level = { source, width, height };
+	for (Image& mip : mips)
+	{
+		mip.Resize(std::max(1u, level.width / 2), std::max(1u, level.height / 2));
+
+		// Levels depend on the one before, rows within a level don't
+		if (settings.filter == MipFilter::Kaiser)
+		{
+			DownsampleKaiser(level, settings.srgb, jobSystem, mip);
+		}
+		else
+		{
+			jobSystem.ParallelFor(mip.height, GetRowsPerJob(mip.width), [&](uint32_t, uint32_t begin, uint32_t end, uint32_t)
+			{
+				if (settings.srgb)
+				{
+					DownsampleBoxColor(level, mip, begin, end);
+				}
+				else
+				{
+					DownsampleBoxData(level, mip, begin, end);
+				}
+			});
+		}
+
+		level = { mip.pixels.data(), mip.width, mip.height };
+	}
+}
+
+void BirdGame::MipGenerator::DownsampleBoxData(const Level& source, Image& destination, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	const uint32_t sourcePitch = source.width * Image::kBytesPerPixel;
+	for (uint32_t y = rowBegin; y < rowEnd; ++y)
+	{
+		const uint8_t* row0 = source.pixels + static_cast<size_t>(std::min(2 * y, source.height - 1)) * sourcePitch;
+		const uint8_t* row1 = source.pixels + static_cast<size_t>(std::min(2 * y + 1, source.height - 1)) * sourcePitch;
+		uint8_t* out = destination.GetPixel(0, y);
+		uint32_t x = 0;
+
+		// The vector loops need two whole source texels per destination texel, which a width of 1 doesn't have
+		if (source.width >= 2)
+		{
+#if defined(BIRDGAME_MIP_AVX2)
+			// 16 source texels of both rows in, 8 destination texels out
+			const __m256i zero256 = _mm256_setzero_si256();
+			const __m256i round256 = _mm256_set1_epi16(2);
+			for (; x + 8 <= destination.width; x += 8)
+			{
+				const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8));
+				const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8 + 32));
+				const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8));
+				const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8 + 32));
+
+				// Vertical sums in 16 bits. Per 128 bit lane, lo holds texels 0-1 and hi texels 2-3 of that lane.
+				const __m256i aLo = _mm256_add_epi16(_mm256_unpacklo_epi8(a0, zero256), _mm256_unpacklo_epi8(a1, zero256));
+				const __m256i aHi = _mm256_add_epi16(_mm256_unpackhi_epi8(a0, zero256), _mm256_unpackhi_epi8(a1, zero256));
+				const __m256i bLo = _mm256_add_epi16(_mm256_unpacklo_epi8(b0, zero256), _mm256_unpacklo_epi8(b1, zero256));
+				const __m256i bHi = _mm256_add_epi16(_mm256_unpackhi_epi8(b0, zero256), _mm256_unpackhi_epi8(b1, zero256));
+
+				// Even texels plus odd texels gives the horizontal sums
+				const __m256i a = _mm256_add_epi16(_mm256_unpacklo_epi64(aLo, aHi), _mm256_unpackhi_epi64(aLo, aHi));
+				const __m256i b = _mm256_add_epi16(_mm256_unpacklo_epi64(bLo, bHi), _mm256_unpackhi_epi64(bLo, bHi));
+				const __m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(a, round256), 2), _mm256_srli_epi16(_mm256_add_epi16(b, round256), 2));
+
+				// Packing works per lane, which leaves the texels in the order 0 1 4 5 2 3 6 7
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x * 4), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+			}
+#endif
+
+#if defined(BIRDGAME_MIP_SSE2)
+			// 8 source texels of both rows in, 4 destination texels out
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i round = _mm_set1_epi16(2);
+			for (; x + 4 <= destination.width; x += 4)
+			{
+				const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+				const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 16));
+				const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+				const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 16));
+
+				// Vertical sums in 16 bits: texels 0-1, 2-3, 4-5 and 6-7
+				const __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(a1, zero));
+				const __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(a1, zero));
+				const __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(b0, zero), _mm_unpacklo_epi8(b1, zero));
+				const __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(b0, zero), _mm_unpackhi_epi8(b1, zero));
+
+				// Even texels plus odd texels gives the horizontal sums
+				const __m128i a = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+				const __m128i b = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+				const __m128i packed = _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(a, round), 2), _mm_srli_epi16(_mm_add_epi16(b, round), 2));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), packed);
+			}
+#endif
+		}
+
+		for (; x < destination.width; ++x)
+		{
+			const uint32_t x0 = std::min(2 * x, source.width - 1) * Image::kBytesPerPixel;
+			const uint32_t x1 = std::min(2 * x + 1, source.width - 1) * Image::kBytesPerPixel;
+			for (uint32_t c = 0; c < Image::kBytesPerPixel; ++c)
+			{
+				out[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+			}
+		}
+	}
+}
+
+void BirdGame::MipGenerator::DownsampleBoxColor(const Level& source, Image& destination, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	const uint32_t sourcePitch = source.width * Image::kBytesPerPixel;
+	std::vector<float> linear0(static_cast<size_t>(source.width) * 4);
+	std::vector<float> linear1(static_cast<size_t>(source.width) * 4);
+
+	for (uint32_t y = rowBegin; y < rowEnd; ++y)
+	{
+		DecodeRow(source.pixels + static_cast<size_t>(std::min(2 * y, source.height - 1)) * sourcePitch, source.width, true, linear0.data());
+		DecodeRow(source.pixels + static_cast<size_t>(std::min(2 * y + 1, source.height - 1)) * sourcePitch, source.width, true, linear1.data());
+
+		for (uint32_t x = 0; x < destination.width; ++x)
+		{
+			const size_t x0 = std::min(2 * x, source.width - 1) * 4;
+			const size_t x1 = std::min(2 * x + 1, source.width - 1) * 4;
+			const Vec4 sum = Add(Add(Load(&linear0[x0]), Load(&linear0[x1])), Add(Load(&linear1[x0]), Load(&linear1[x1])));
+
+			float average[4];
+			Store(Scale(sum, 0.25f), average);
+			EncodeTexel(average, true, destination.GetPixel(x, y));
+		}
+	}
+}
+
+void BirdGame::MipGenerator::DownsampleKaiser(const Level& source, bool srgb, JobSystem& jobSystem, Image& destination) const
+{
+	// Separable: filter every source row horizontally into linear floats, then the columns of that vertically
+	const uint32_t sourcePitch = source.width * Image::kBytesPerPixel;
+	const size_t horizontalPitch = static_cast<size_t>(destination.width) * 4;
+	std::vector<float> horizontal(horizontalPitch * source.height);
+
+	jobSystem.ParallelFor(source.height, GetRowsPerJob(source.width), [&](uint32_t, uint32_t begin, uint32_t end, uint32_t)
+	{
+		std::vector<float> linear(static_cast<size_t>(source.width) * 4);
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			DecodeRow(source.pixels + static_cast<size_t>(y) * sourcePitch, source.width, srgb, linear.data());
+			float* out = &horizontal[y * horizontalPitch];
+			for (uint32_t x = 0; x < destination.width; ++x)
+			{
+				Vec4 sum = Zero();
+				for (uint32_t tap = 0; tap < kKaiserTaps; ++tap)
+				{
+					const int32_t sourceX = std::clamp(static_cast<int32_t>(2 * x) + kKaiserFirstTap + static_cast<int32_t>(tap), 0, static_cast<int32_t>(source.width) - 1);
+					sum = MulAdd(sum, Load(&linear[sourceX * 4]), mKaiserWeights[tap]);
+				}
+				Store(sum, out + x * 4);
+			}
+		}
+	});
+
+	jobSystem.ParallelFor(destination.height, GetRowsPerJob(destination.width), [&](uint32_t, uint32_t begin, uint32_t end, uint32_t)
+	{
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			const float* rows[kKaiserTaps];
+			for (uint32_t tap = 0; tap < kKaiserTaps; ++tap)
+			{
+				const int32_t sourceY = std::clamp(static_cast<int32_t>(2 * y) + kKaiserFirstTap + static_cast<int32_t>(tap), 0, static_cast<int32_t>(source.height) - 1);
+				rows[tap] = &horizontal[sourceY * horizontalPitch];
+			}
+
+			for (uint32_t x = 0; x < destination.width; ++x)
+			{
+				Vec4 sum = Zero();
+				for (uint32_t tap = 0; tap < kKaiserTaps; ++tap)
+				{
+					sum = MulAdd(sum, Load(rows[tap] + x * 4), mKaiserWeights[tap]);
+				}
+
+				float filtered[4];
+				Store(sum, filtered);
+				EncodeTexel(filtered, srgb, destination.GetPixel(x, y));
+			}
+		}
+	});
+}
+
+void BirdGame::MipGenerator::DecodeRow(const uint8_t* texels, uint32_t count, bool srgb, float* linear) const
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const uint8_t* texel = texels + i * 4;
+		float* out = linear + i * 4;
+		if (srgb)
+		{
+			const float alpha = texel[3] / 255.0f;
+			out[0] = mSrgbToLinear[texel[0]] * alpha;
+			out[1] = mSrgbToLinear[texel[1]] * alpha;
+			out[2] = mSrgbToLinear[texel[2]] * alpha;
+			out[3] = alpha;
+		}
+		else
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				out[c] = texel[c] / 255.0f;
+			}
+		}
+	}
+}
+
+void BirdGame::MipGenerator::EncodeTexel(const float* linear, bool srgb, uint8_t* texel) const
+{
+	// The Kaiser filter's negative lobes can overshoot either way
+	const float alpha = std::clamp(linear[3], 0.0f, 1.0f);
+	texel[3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+
+	if (!srgb)
+	{
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			texel[c] = static_cast<uint8_t>(std::clamp(linear[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+		return;
+	}
+
+	// Undo the premultiplication. Fully transparent texels keep black, their color never shows.
+	const float inverseAlpha = (alpha > 0.0f) ? 1.0f / alpha : 0.0f;
+	for (uint32_t c = 0; c < 3; ++c)
+	{
+		const float value = std::clamp(linear[c] * inverseAlpha, 0.0f, 1.0f);
+		texel[c] = mLinearToSrgb[static_cast<uint32_t>(value * (kLinearToSrgbSize - 1) + 0.5f)];
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Image.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	class JobSystem;
+
+	enum class MipFilter : uint8_t
+	{
+		Box,    // Average of 2x2 texels. Cheap, slightly soft.
+		Kaiser  // Kaiser windowed sinc over 12x12 texels. Keeps minified sprites sharper, at the cost of a little ringing.
+	};
+
+	// Builds mip chains for RGBA8 images on the CPU. Every level is filtered from the one above it, with the rows of
+	// a level split across the JobSystem. Box filtering of plain data is done in 8 bit integer SIMD (SSE2, or AVX2
+	// when the build targets it), everything else in float SIMD with table based sRGB conversions.
+	class MipGenerator final
+	{
+	public:
+		struct Settings
+		{
+			MipFilter filter = MipFilter::Box;
+
+			// Color textures are averaged in linear light and weighted by alpha, so transparent texels don't darken
+			// the edges of sprites. Anything else, like distance fields, is averaged per channel as plain data.
+			bool srgb = true;
+
+			uint32_t maxLevels = 0; // Including the source image, 0 for a full chain down to 1x1
+		};
+
+		MipGenerator();
+
+		// Levels of a full chain, including the top level
+		static uint32_t GetFullMipCount(uint32_t width, uint32_t height);
+
+		// Replaces mips with levels 1 and up of source's chain. Every level is half the size of the one above,
+		// rounded down and at least 1. The last row or column of odd sized levels only contributes to the Kaiser filter.
+		void Generate(const uint8_t* source, uint32_t width, uint32_t height, const Settings& settings, JobSystem& jobSystem, std::vector<Image>& mips) const;
+
+		void Generate(const Image& source, const Settings& settings, JobSystem& jobSystem, std::vector<Image>& mips) const
+		{
+			Generate(source.pixels.data(), source.width, source.height, settings, jobSystem, mips);
+		}
+
+	private:
+		MipGenerator(const MipGenerator&) = delete;
+
+		static constexpr uint32_t kLinearToSrgbSize = 4096;
+
+		struct Level
+		{
+			const uint8_t* pixels;
+			uint32_t width;
+			uint32_t height;
+		};
+
+		void DownsampleBoxData(const Level& source, Image& destination, uint32_t rowBegin, uint32_t rowEnd) const;
+		void DownsampleBoxColor(const Level& source, Image& destination, uint32_t rowBegin, uint32_t rowEnd) const;
+		void DownsampleKaiser(const Level& source, bool srgb, JobSystem& jobSystem, Image& destination) const;
+
+		// Between texels and linear floats, premultiplied by alpha for color
+		void DecodeRow(const uint8_t* texels, uint32_t count, bool srgb, float* linear) const;
+		void EncodeTexel(const float* linear, bool srgb, uint8_t* texel) const;
+
+		float mSrgbToLinear[256];
+		uint8_t mLinearToSrgb[kLinearToSrgbSize];
+		float mKaiserWeights[12];
+	};
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "ParallelDrawRecorder.h"
+#include "JobSystem.h"
+
+#include <assert.h>
+#include <algorithm>
+
+BirdGame::ParallelDrawRecorder::ParallelDrawRecorder(JobSystem& jobSystem, uint32_t maxChunks, uint32_t minInstancesPerChunk) :
+	mJobSystem(jobSystem),
+	mMaxChunks(maxChunks),
+	mMinInstancesPerChunk(minInstancesPerChunk)
+{
+	assert(maxChunks > 0 && minInstancesPerChunk > 0);
+	mChunks.reserve(maxChunks);
+}
+
+uint32_t BirdGame::ParallelDrawRecorder::Record(const std::vector<DrawPacket>& packets, const RecordChunk& record)
+{
+	Split(packets, mMaxChunks, mMinInstancesPerChunk, mChunks);
+
+	const uint32_t chunkCount = static_cast<uint32_t>(mChunks.size());
+	mJobSystem.ParallelFor(chunkCount, 1, [&](uint32_t chunkIndex, uint32_t, uint32_t, uint32_t workerIndex)
+	{
+		record(chunkIndex, mChunks[chunkIndex], workerIndex);
+	});
+
+	return chunkCount;
+}
+
+void BirdGame::ParallelDrawRecorder::Split(const std::vector<DrawPacket>& packets, uint32_t maxChunks, uint32_t minInstancesPerChunk, std::vector<Chunk>& chunks)
+{
+	chunks.clear();
+
+	uint64_t totalInstances = 0;
+	for (const DrawPacket& packet : packets)
+	{
+		totalInstances += packet.instanceCount;
+	}
+
+	if (totalInstances == 0)
+	{
+		return;
+	}
+
+	const uint64_t chunkCount = std::min<uint64_t>(maxChunks, std::max<uint64_t>(1, totalInstances / minInstancesPerChunk));
+
+	size_t packetIndex = 0;
+	uint32_t offset = 0;
+	uint64_t chunkBegin = 0;
+	for (uint64_t chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		// Spread the remainder evenly instead of piling it onto the last chunk
+		const uint64_t chunkEnd = totalInstances * (chunk + 1) / chunkCount;
+		uint32_t remaining = static_cast<uint32_t>(chunkEnd - chunkBegin);
+		chunkBegin = chunkEnd;
+
+		// Don't start chunks on packets they don't draw anything from
+		while (packets[packetIndex].instanceCount == offset)
+		{
+			packetIndex++;
+			offset = 0;
+		}
+
+		chunks.push_back({ static_cast<uint32_t>(packetIndex), offset, remaining });
+
+		while (remaining > 0)
+		{
+			const uint32_t count = std::min(remaining, packets[packetIndex].instanceCount - offset);
+			remaining -= count;
+			offset += count;
+			if (offset == packets[packetIndex].instanceCount && remaining > 0)
+			{
+				packetIndex++;
+				offset = 0;
+			}
+		}
+	}
+}
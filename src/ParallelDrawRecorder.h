@@ -0,0 +1,71 @@
+#pragma once
+
+#include "RenderCommandBuffer.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace BirdGame
+{
+	class JobSystem;
+
+	// Splits a sorted packet stream into contiguous chunks of about the same number of instances and records them
+	// in parallel, one command list per chunk. Chunk i always goes into list i and the lists are submitted in
+	// index order, so the GPU sees exactly the commands single-threaded recording would produce, no matter which
+	// thread recorded which chunk. Large packets are split across chunks, since a whole layer of sprites usually
+	// ends up in a single packet.
+	class ParallelDrawRecorder final
+	{
+	public:
+		// Starts at instance beginOffset of packet beginPacket and continues through the following packets
+		struct Chunk
+		{
+			uint32_t beginPacket;
+			uint32_t beginOffset;
+			uint32_t instanceCount;
+		};
+
+		// Records a chunk into command list chunkIndex. workerIndex identifies the recording thread (see JobSystem).
+		using RecordChunk = std::function<void(uint32_t chunkIndex, const Chunk& chunk, uint32_t workerIndex)>;
+
+		// At most maxChunks command lists are used per stream. Streams are only split into chunks of at least
+		// minInstancesPerChunk instances, smaller ones aren't worth the overhead of another command list.
+		ParallelDrawRecorder(JobSystem& jobSystem, uint32_t maxChunks, uint32_t minInstancesPerChunk);
+
+		// Returns the number of command lists recorded into, 0 for empty streams
+		uint32_t Record(const std::vector<DrawPacket>& packets, const RecordChunk& record);
+
+		const std::vector<Chunk>& GetChunks() const { return mChunks; }
+
+		static void Split(const std::vector<DrawPacket>& packets, uint32_t maxChunks, uint32_t minInstancesPerChunk, std::vector<Chunk>& chunks);
+
+		// Calls draw(packet, firstInstance, instanceCount) for every piece of a packet that falls into the chunk
+		template<typename DrawFunction>
+		static void ForEachDraw(const std::vector<DrawPacket>& packets, const Chunk& chunk, DrawFunction draw)
+		{
+			uint32_t remaining = chunk.instanceCount;
+			uint32_t offset = chunk.beginOffset;
+			for (size_t packetIndex = chunk.beginPacket; remaining > 0; ++packetIndex)
+			{
+				const DrawPacket& packet = packets[packetIndex];
+				const uint32_t available = packet.instanceCount - offset;
+				const uint32_t count = (available < remaining) ? available : remaining;
+				if (count > 0)
+				{
+					draw(packet, packet.firstInstance + offset, count);
+				}
+				remaining -= count;
+				offset = 0;
+			}
+		}
+
+	private:
+		ParallelDrawRecorder(const ParallelDrawRecorder&) = delete;
+
+		JobSystem& mJobSystem;
+		uint32_t mMaxChunks;
+		uint32_t mMinInstancesPerChunk;
+		std::vector<Chunk> mChunks;
+	};
+}
@@ -0,0 +1,236 @@
+#include "pch.h"
+#include "PipelineCache.h"
+
+#include "Hash.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	constexpr uint32_t kMagic = 0x43504742; // "BGPC"
+
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t deviceKey;
+		uint64_t checksum;
+		uint32_t entryCount;
+		uint32_t reserved;
+	};
+	static_assert(sizeof(FileHeader) == 32, "FileHeader must not contain padding");
+
+	struct EntryHeader
+	{
+		uint64_t key;
+		uint64_t size;
+	};
+	static_assert(sizeof(EntryHeader) == 16, "EntryHeader must not contain padding");
+
+	template <typename T>
+	void Append(std::vector<uint8_t>& output, const T& value)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+		output.insert(output.end(), bytes, bytes + sizeof(T));
+	}
+}
+
+BirdGame::PipelineCache::PipelineCache(uint64_t deviceKey) :
+	mDeviceKey(deviceKey),
+	mDirty(false)
+{
+}
+
+BirdGame::PipelineCache::LoadResult BirdGame::PipelineCache::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		Clear();
+		mDirty = false;
+		return LoadResult::Missing;
+	}
+
+	const std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return Deserialize(contents.data(), contents.size());
+}
+
+BirdGame::PipelineCache::LoadResult BirdGame::PipelineCache::Deserialize(const uint8_t* data, size_t size)
+{
+	Clear();
+	const LoadResult result = Parse(data, size);
+	if (result != LoadResult::Loaded)
+	{
+		Clear();
+	}
+
+	// A rejected file has to be replaced by the next Save(), even if nothing gets stored before then
+	mDirty = (result != LoadResult::Loaded);
+	return result;
+}
+
+BirdGame::PipelineCache::LoadResult BirdGame::PipelineCache::Parse(const uint8_t* data, size_t size)
+{
+	FileHeader header = {};
+	if (size < sizeof(header))
+	{
+		return LoadResult::Corrupt;
+	}
+	memcpy(&header, data, sizeof(header));
+
+	if (header.magic != kMagic)
+	{
+		return LoadResult::Corrupt;
+	}
+	if (header.version != kFormatVersion)
+	{
+		return LoadResult::VersionMismatch;
+	}
+	if (header.deviceKey != mDeviceKey)
+	{
+		return LoadResult::DeviceMismatch;
+	}
+
+	const uint8_t* cursor = data + sizeof(header);
+	const uint8_t* end = data + size;
+	if (HashFnv1a(cursor, end - cursor) != header.checksum)
+	{
+		return LoadResult::Corrupt;
+	}
+
+	for (uint32_t i = 0; i < header.entryCount; ++i)
+	{
+		EntryHeader entry = {};
+		if (static_cast<size_t>(end - cursor) < sizeof(entry))
+		{
+			return LoadResult::Corrupt;
+		}
+		memcpy(&entry, cursor, sizeof(entry));
+		cursor += sizeof(entry);
+
+		if (static_cast<uint64_t>(end - cursor) < entry.size)
+		{
+			return LoadResult::Corrupt;
+		}
+		mEntries[entry.key].assign(cursor, cursor + entry.size);
+		cursor += entry.size;
+	}
+
+	if (cursor != end)
+	{
+		return LoadResult::Corrupt;
+	}
+
+	return LoadResult::Loaded;
+}
+
+bool BirdGame::PipelineCache::Save(const std::string& path)
+{
+	std::vector<uint8_t> contents;
+	Serialize(contents);
+
+	const std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+		if (!file)
+		{
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	mDirty = false;
+	return true;
+}
+
+void BirdGame::PipelineCache::Serialize(std::vector<uint8_t>& output) const
+{
+	// Sorted so the same contents always produce the same file
+	std::vector<uint64_t> keys;
+	keys.reserve(mEntries.size());
+	for (const auto& [key, blob] : mEntries)
+	{
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	output.clear();
+	output.resize(sizeof(FileHeader));
+	for (uint64_t key : keys)
+	{
+		const std::vector<uint8_t>& blob = mEntries.at(key);
+		Append(output, EntryHeader{ key, blob.size() });
+		output.insert(output.end(), blob.begin(), blob.end());
+	}
+
+	FileHeader header = {};
+	header.magic = kMagic;
+	header.version = kFormatVersion;
+	header.deviceKey = mDeviceKey;
+	header.checksum = HashFnv1a(output.data() + sizeof(header), output.size() - sizeof(header));
+	header.entryCount = static_cast<uint32_t>(keys.size());
+	memcpy(output.data(), &header, sizeof(header));
+}
+
+const std::vector<uint8_t>* BirdGame::PipelineCache::Find(uint64_t key) const
+{
+	auto it = mEntries.find(key);
+	return (it != mEntries.end()) ? &it->second : nullptr;
+}
+
+void BirdGame::PipelineCache::Store(uint64_t key, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	mEntries[key].assign(bytes, bytes + size);
+	mDirty = true;
+}
+
+void BirdGame::PipelineCache::Remove(uint64_t key)
+{
+	if (mEntries.erase(key) != 0)
+	{
+		mDirty = true;
+	}
+}
+
+void BirdGame::PipelineCache::Clear()
+{
+	if (!mEntries.empty())
+	{
+		mEntries.clear();
+		mDirty = true;
+	}
+}
+
+const char* BirdGame::PipelineCache::GetLoadResultName(LoadResult result)
+{
+	switch (result)
+	{
+		case LoadResult::Loaded:
+			return "Loaded";
+		case LoadResult::Missing:
+			return "Missing";
+		case LoadResult::Corrupt:
+			return "Corrupt";
+		case LoadResult::VersionMismatch:
+			return "VersionMismatch";
+		case LoadResult::DeviceMismatch:
+			return "DeviceMismatch";
+	}
+
+	assert(false && "Unknown LoadResult");
+	return "Unknown";
+}
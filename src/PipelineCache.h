@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BirdGame
+{
+	// Backend-neutral store of compiled pipeline blobs keyed by a hash of everything that went into the pipeline
+	// (see Hasher). The cache file is versioned and checksummed and tied to a device key that the backend
+	// derives from the GPU and driver, so a cache from another machine, driver or build is thrown away
+	// instead of being handed to the driver.
+	//
+	// File layout, little endian:
+	//   FileHeader
+	//   entryCount x { uint64_t key, uint64_t size, size bytes of data }
+	// The checksum covers everything after the header.
+	class PipelineCache final
+	{
+	public:
+		// Bump whenever the layout of the file or the way keys are computed changes
+		static constexpr uint32_t kFormatVersion = 1;
+
+		enum class LoadResult
+		{
+			Loaded,
+			Missing,            // No cache file yet
+			Corrupt,            // Truncated, bad magic or checksum mismatch
+			VersionMismatch,    // Written by a build with a different kFormatVersion
+			DeviceMismatch      // Written for a different GPU or driver
+		};
+
+		explicit PipelineCache(uint64_t deviceKey);
+
+		// On anything but Loaded the cache is left empty. A rejected file also leaves it dirty, so the next Save()
+		// replaces the file.
+		LoadResult Load(const std::string& path);
+		LoadResult Deserialize(const uint8_t* data, size_t size);
+
+		// Writes to a temporary file first so a crash while saving can't leave a half written cache behind
+		bool Save(const std::string& path);
+		void Serialize(std::vector<uint8_t>& output) const;
+
+		// nullptr if there is no blob for key
+		const std::vector<uint8_t>* Find(uint64_t key) const;
+
+		void Store(uint64_t key, const void* data, size_t size);
+		void Remove(uint64_t key);
+		void Clear();
+
+		// True if the contents changed since the last Load() or Save()
+		bool IsDirty() const { return mDirty; }
+		size_t GetEntryCount() const { return mEntries.size(); }
+		uint64_t GetDeviceKey() const { return mDeviceKey; }
+
+		static const char* GetLoadResultName(LoadResult result);
+
+	private:
+		PipelineCache(const PipelineCache&) = delete;
+
+		// Fills the entries from a cache file, Deserialize() handles clearing and the dirty flag
+		LoadResult Parse(const uint8_t* data, size_t size);
+
+		uint64_t mDeviceKey;
+		std::unordered_map<uint64_t, std::vector<uint8_t>> mEntries;
+		bool mDirty;
+	};
+}
@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "PipelineCacheDX.h"
+
+#include "DXHelpers.h"
+#include "Hash.h"
+
+#include <assert.h>
+#include <cstdarg>
+#include <cstdio>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	// Identifies the GPU and driver. Compiled pipelines are only valid for the exact combination they were built on.
+	uint64_t ComputeDeviceKey(ID3D12Device* device)
+	{
+		BirdGame::Hasher hasher;
+
+		ComPtr<IDXGIFactory4> factory;
+		ComPtr<IDXGIAdapter1> adapter;
+		if (SUCCEEDED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))) && SUCCEEDED(factory->EnumAdapterByLuid(device->GetAdapterLuid(), IID_PPV_ARGS(&adapter))))
+		{
+			DXGI_ADAPTER_DESC1 adapterDesc = {};
+			if (SUCCEEDED(adapter->GetDesc1(&adapterDesc)))
+			{
+				hasher.AddValue(adapterDesc.VendorId).AddValue(adapterDesc.DeviceId).AddValue(adapterDesc.SubSysId).AddValue(adapterDesc.Revision);
+			}
+
+			LARGE_INTEGER driverVersion = {};
+			if (SUCCEEDED(adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion)))
+			{
+				hasher.AddValue(driverVersion.QuadPart);
+			}
+		}
+
+		return hasher.Get();
+	}
+
+	void HashBytecode(BirdGame::Hasher& hasher, const D3D12_SHADER_BYTECODE& bytecode)
+	{
+		hasher.AddValue(static_cast<uint64_t>(bytecode.BytecodeLength)).AddBytes(bytecode.pShaderBytecode, bytecode.BytecodeLength);
+	}
+
+	// Every field is hashed on its own since some of the D3D12 structs have padding bytes with undefined contents,
+	// and pointers are followed so the key only depends on what they point to
+	uint64_t HashPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const void* rootSignatureBlob, size_t rootSignatureSize)
+	{
+		BirdGame::Hasher hasher;
+		hasher.AddValue(static_cast<uint64_t>(rootSignatureSize)).AddBytes(rootSignatureBlob, rootSignatureSize);
+
+		HashBytecode(hasher, desc.VS);
+		HashBytecode(hasher, desc.PS);
+		HashBytecode(hasher, desc.DS);
+		HashBytecode(hasher, desc.HS);
+		HashBytecode(hasher, desc.GS);
+
+		hasher.AddValue(desc.StreamOutput.NumEntries);
+		for (UINT i = 0; i < desc.StreamOutput.NumEntries; ++i)
+		{
+			const D3D12_SO_DECLARATION_ENTRY& entry = desc.StreamOutput.pSODeclaration[i];
+			hasher.AddValue(entry.Stream).AddString(entry.SemanticName).AddValue(entry.SemanticIndex)
+				.AddValue(entry.StartComponent).AddValue(entry.ComponentCount).AddValue(entry.OutputSlot);
+		}
+		hasher.AddValue(desc.StreamOutput.NumStrides).AddBytes(desc.StreamOutput.pBufferStrides, desc.StreamOutput.NumStrides * sizeof(UINT));
+		hasher.AddValue(desc.StreamOutput.RasterizedStream);
+
+		hasher.AddValue(desc.BlendState.AlphaToCoverageEnable).AddValue(desc.BlendState.IndependentBlendEnable);
+		for (const D3D12_RENDER_TARGET_BLEND_DESC& blend : desc.BlendState.RenderTarget)
+		{
+			hasher.AddValue(blend.BlendEnable).AddValue(blend.LogicOpEnable).AddValue(blend.SrcBlend).AddValue(blend.DestBlend)
+				.AddValue(blend.BlendOp).AddValue(blend.SrcBlendAlpha).AddValue(blend.DestBlendAlpha).AddValue(blend.BlendOpAlpha)
+				.AddValue(blend.LogicOp).AddValue(blend.RenderTargetWriteMask);
+		}
+		hasher.AddValue(desc.SampleMask);
+		hasher.AddValue(desc.RasterizerState); // Only 32-bit members, no padding
+
+		const D3D12_DEPTH_STENCIL_DESC& depthStencil = desc.DepthStencilState;
+		hasher.AddValue(depthStencil.DepthEnable).AddValue(depthStencil.DepthWriteMask).AddValue(depthStencil.DepthFunc)
+			.AddValue(depthStencil.StencilEnable).AddValue(depthStencil.StencilReadMask).AddValue(depthStencil.StencilWriteMask)
+			.AddValue(depthStencil.FrontFace).AddValue(depthStencil.BackFace);
+
+		hasher.AddValue(desc.InputLayout.NumElements);
+		for (UINT i = 0; i < desc.InputLayout.NumElements; ++i)
+		{
+			const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+			hasher.AddString(element.SemanticName).AddValue(element.SemanticIndex).AddValue(element.Format).AddValue(element.InputSlot)
+				.AddValue(element.AlignedByteOffset).AddValue(element.InputSlotClass).AddValue(element.InstanceDataStepRate);
+		}
+
+		hasher.AddValue(desc.IBStripCutValue).AddValue(desc.PrimitiveTopologyType).AddValue(desc.NumRenderTargets)
+			.AddValue(desc.RTVFormats).AddValue(desc.DSVFormat).AddValue(desc.SampleDesc).AddValue(desc.NodeMask).AddValue(desc.Flags);
+
+		return hasher.Get();
+	}
+
+	void DebugLog(const char* format, ...)
+	{
+		char buffer[256];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		va_end(args);
+		OutputDebugStringA(buffer);
+	}
+}
+
+BirdGame::PipelineCacheDX::PipelineCacheDX() :
+	mLibraryDirty(false)
+{
+}
+
+BirdGame::PipelineCacheDX::~PipelineCacheDX()
+{
+}
+
+void BirdGame::PipelineCacheDX::Initialize(ID3D12Device* device, const std::string& path)
+{
+	mDevice = device;
+	mPath = path;
+	mCache.reset(new PipelineCache(ComputeDeviceKey(device)));
+
+	const PipelineCache::LoadResult result = mCache->Load(path);
+	DebugLog("Pipeline cache %s: %s, %zu entries\n", path.c_str(), PipelineCache::GetLoadResultName(result), mCache->GetEntryCount());
+
+	ComPtr<ID3D12Device1> device1;
+	if (FAILED(device->QueryInterface(IID_PPV_ARGS(&device1))))
+	{
+		return;
+	}
+
+	if (const std::vector<uint8_t>* libraryData = mCache->Find(kLibraryKey))
+	{
+		mLibraryData = *libraryData;
+
+		// The driver validates the blob itself as well and refuses it after a driver update
+		if (FAILED(device1->CreatePipelineLibrary(mLibraryData.data(), mLibraryData.size(), IID_PPV_ARGS(&mLibrary))))
+		{
+			DebugLog("Pipeline library rejected by the driver, starting over\n");
+			mLibraryData.clear();
+			mCache->Clear();
+		}
+	}
+
+	if (mLibrary == nullptr)
+	{
+		// Fails with DXGI_ERROR_UNSUPPORTED on systems without pipeline library support, we use cached blobs then
+		if (SUCCEEDED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&mLibrary))))
+		{
+			mLibraryDirty = true;
+		}
+	}
+}
+
+void BirdGame::PipelineCacheDX::Destroy()
+{
+	mLibrary.Reset();
+	mLibraryData.clear();
+	mCache.reset();
+	mDevice.Reset();
+}
+
+ComPtr<ID3D12PipelineState> BirdGame::PipelineCacheDX::CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const void* rootSignatureBlob, size_t rootSignatureSize)
+{
+	assert(desc.CachedPSO.pCachedBlob == nullptr && "The cache provides the cached blob");
+
+	const uint64_t key = HashPipelineDesc(desc, rootSignatureBlob, rootSignatureSize);
+	ComPtr<ID3D12PipelineState> pipelineState;
+
+	if (mLibrary != nullptr)
+	{
+		wchar_t name[17];
+		swprintf_s(name, L"%016llx", static_cast<unsigned long long>(key));
+
+		// E_INVALIDARG means the library doesn't have it yet
+		if (SUCCEEDED(mLibrary->LoadGraphicsPipeline(name, &desc, IID_PPV_ARGS(&pipelineState))))
+		{
+			return pipelineState;
+		}
+
+		CheckHResult(mDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+		if (SUCCEEDED(mLibrary->StorePipeline(name, pipelineState.Get())))
+		{
+			mLibraryDirty = true;
+		}
+		return pipelineState;
+	}
+
+	if (const std::vector<uint8_t>* cachedBlob = mCache->Find(key))
+	{
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC cachedDesc = desc;
+		cachedDesc.CachedPSO.pCachedBlob = cachedBlob->data();
+		cachedDesc.CachedPSO.CachedBlobSizeInBytes = cachedBlob->size();
+		if (SUCCEEDED(mDevice->CreateGraphicsPipelineState(&cachedDesc, IID_PPV_ARGS(&pipelineState))))
+		{
+			return pipelineState;
+		}
+
+		// Stale blob, compile from scratch and replace it below
+		mCache->Remove(key);
+	}
+
+	CheckHResult(mDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+
+	ComPtr<ID3DBlob> blob;
+	if (SUCCEEDED(pipelineState->GetCachedBlob(&blob)))
+	{
+		mCache->Store(key, blob->GetBufferPointer(), blob->GetBufferSize());
+	}
+	return pipelineState;
+}
+
+void BirdGame::PipelineCacheDX::Save()
+{
+	if (mLibrary != nullptr && mLibraryDirty)
+	{
+		std::vector<uint8_t> serialized(mLibrary->GetSerializedSize());
+		if (SUCCEEDED(mLibrary->Serialize(serialized.data(), serialized.size())))
+		{
+			mCache->Store(kLibraryKey, serialized.data(), serialized.size());
+			mLibraryDirty = false;
+		}
+	}
+
+	if (mCache->IsDirty() && !mCache->Save(mPath))
+	{
+		// Not fatal, the pipelines just get compiled again next time
+		DebugLog("Failed to write pipeline cache %s\n", mPath.c_str());
+	}
+}
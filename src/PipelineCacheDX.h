@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PipelineCache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace BirdGame
+{
+	// Creates graphics pipelines through an ID3D12PipelineLibrary that is persisted in a PipelineCache file, so
+	// pipelines are only compiled by the driver the first time they are seen. Falls back to per-pipeline cached
+	// blobs (D3D12_CACHED_PIPELINE_STATE) on systems without pipeline library support.
+	class PipelineCacheDX final
+	{
+	public:
+		PipelineCacheDX();
+		~PipelineCacheDX();
+
+		void Initialize(ID3D12Device* device, const std::string& path);
+		void Destroy();
+
+		// rootSignatureBlob is the serialized root signature desc.pRootSignature was created from. The pipeline
+		// is keyed by it rather than the root signature object, which is different on every run.
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const void* rootSignatureBlob, size_t rootSignatureSize);
+
+		// Writes the cache file if any pipeline had to be compiled since it was loaded
+		void Save();
+
+	private:
+		PipelineCacheDX(const PipelineCacheDX&) = delete;
+
+		// Pipeline keys are hashes, so they won't collide with this in practice
+		static constexpr uint64_t kLibraryKey = 0;
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> mLibrary;
+		std::unique_ptr<PipelineCache> mCache;
+		std::string mPath;
+
+		// The library reads from this memory for as long as it exists
+		std::vector<uint8_t> mLibraryData;
+		bool mLibraryDirty;
+	};
+}
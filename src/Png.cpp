@@ -0,0 +1,844 @@
+#include "pch.h"
+#include "Png.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	constexpr uint8_t kPngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+	constexpr uint32_t kWindowSize = 32768;
+	constexpr uint32_t kHashBits = 15;
+	constexpr uint32_t kMinMatch = 3;
+	constexpr uint32_t kMaxMatch = 258;
+	constexpr uint32_t kMaxChainLength = 32; // Candidates tried per position. More compresses better, slower.
+
+	// Deflate length codes 257-285 and distance codes 0-29: the smallest value each covers and its extra bits
+	constexpr uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr uint8_t kLengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr uint8_t kDistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	enum PngFilter : uint8_t
+	{
+		kFilterNone = 0,
+		kFilterSub = 1,
+		kFilterUp = 2,
+		kFilterAverage = 3,
+		kFilterPaeth = 4
+	};
+
+	struct CrcTable
+	{
+		uint32_t entries[256];
+
+		CrcTable()
+		{
+			for (uint32_t n = 0; n < 256; ++n)
+			{
+				uint32_t c = n;
+				for (uint32_t bit = 0; bit < 8; ++bit)
+				{
+					c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				}
+				entries[n] = c;
+			}
+		}
+	};
+
+	uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+	{
+		static const CrcTable table;
+		crc = ~crc;
+		for (size_t i = 0; i < size; ++i)
+		{
+			crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	uint32_t Adler32(const uint8_t* data, size_t size)
+	{
+		// 5552 bytes is the most that can be summed before the 32 bit sums have to be reduced
+		uint32_t a = 1;
+		uint32_t b = 0;
+		while (size > 0)
+		{
+			const size_t count = std::min<size_t>(size, 5552);
+			for (size_t i = 0; i < count; ++i)
+			{
+				a += data[i];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+			data += count;
+			size -= count;
+		}
+		return (b << 16) | a;
+	}
+
+	void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back(static_cast<uint8_t>(value >> 24));
+		out.push_back(static_cast<uint8_t>(value >> 16));
+		out.push_back(static_cast<uint8_t>(value >> 8));
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	void AppendChunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, size_t size)
+	{
+		AppendBigEndian(png, static_cast<uint32_t>(size));
+		const size_t typeOffset = png.size();
+		png.insert(png.end(), type, type + 4);
+		png.insert(png.end(), data, data + size);
+		AppendBigEndian(png, Crc32(&png[typeOffset], size + 4));
+	}
+
+	uint8_t Paeth(uint8_t left, uint8_t up, uint8_t upLeft)
+	{
+		const int32_t estimate = left + up - upLeft;
+		const int32_t toLeft = std::abs(estimate - left);
+		const int32_t toUp = std::abs(estimate - up);
+		const int32_t toUpLeft = std::abs(estimate - upLeft);
+		if (toLeft <= toUp && toLeft <= toUpLeft)
+		{
+			return left;
+		}
+		return (toUp <= toUpLeft) ? up : upLeft;
+	}
+
+	// Deflate writes bits from the least significant end, Huffman codes from their most significant bit
+	class BitWriter final
+	{
+	public:
+		explicit BitWriter(std::vector<uint8_t>& out) : mOut(out), mBits(0), mCount(0) {}
+
+		void Write(uint32_t value, uint32_t count)
+		{
+			mBits |= static_cast<uint64_t>(value) << mCount;
+			mCount += count;
+			while (mCount >= 8)
+			{
+				mOut.push_back(static_cast<uint8_t>(mBits));
+				mBits >>= 8;
+				mCount -= 8;
+			}
+		}
+
+		void WriteCode(uint32_t code, uint32_t length)
+		{
+			uint32_t reversed = 0;
+			for (uint32_t bit = 0; bit < length; ++bit)
+			{
+				reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+			}
+			Write(reversed, length);
+		}
+
+		void Finish()
+		{
+			if (mCount > 0)
+			{
+				mOut.push_back(static_cast<uint8_t>(mBits));
+			}
+			mBits = 0;
+			mCount = 0;
+		}
+
+	private:
+		std::vector<uint8_t>& mOut;
+		uint64_t mBits;
+		uint32_t mCount;
+	};
+
+	// The fixed literal/length code of RFC 1951 3.2.6
+	void WriteLiteralOrLength(BitWriter& writer, uint32_t symbol)
+	{
+		if (symbol < 144)
+		{
+			writer.WriteCode(0x30 + symbol, 8);
+		}
+		else if (symbol < 256)
+		{
+			writer.WriteCode(0x190 + symbol - 144, 9);
+		}
+		else if (symbol < 280)
+		{
+			writer.WriteCode(symbol - 256, 7);
+		}
+		else
+		{
+			writer.WriteCode(0xc0 + symbol - 280, 8);
+		}
+	}
+
+	void WriteMatch(BitWriter& writer, uint32_t length, uint32_t distance)
+	{
+		uint32_t lengthCode = 28;
+		while (kLengthBase[lengthCode] > length)
+		{
+			--lengthCode;
+		}
+		WriteLiteralOrLength(writer, 257 + lengthCode);
+		writer.Write(length - kLengthBase[lengthCode], kLengthExtraBits[lengthCode]);
+
+		uint32_t distanceCode = 29;
+		while (kDistanceBase[distanceCode] > distance)
+		{
+			--distanceCode;
+		}
+		writer.WriteCode(distanceCode, 5);
+		writer.Write(distance - kDistanceBase[distanceCode], kDistanceExtraBits[distanceCode]);
+	}
+
+	uint32_t HashAt(const uint8_t* data)
+	{
+		const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+		return (value * 2654435761u) >> (32 - kHashBits);
+	}
+
+	// A zlib stream holding one fixed Huffman deflate block
+	void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		out.push_back(0x78); // 32K window, deflate
+		out.push_back(0x01); // No preset dictionary, fastest compression level; makes the header a multiple of 31
+
+		BitWriter writer(out);
+		writer.Write(1, 1); // Final block
+		writer.Write(1, 2); // Fixed Huffman codes
+
+		// Hash chains over the last kWindowSize positions. Positions are stored plus one so 0 means empty.
+		std::vector<uint32_t> head(static_cast<size_t>(1) << kHashBits, 0);
+		std::vector<uint32_t> previous(kWindowSize, 0);
+		auto insert = [&](size_t position)
+		{
+			const uint32_t hash = HashAt(data + position);
+			previous[position % kWindowSize] = head[hash];
+			head[hash] = static_cast<uint32_t>(position + 1);
+		};
+
+		size_t position = 0;
+		while (position < size)
+		{
+			uint32_t bestLength = 0;
+			uint32_t bestDistance = 0;
+			if (position + kMinMatch <= size)
+			{
+				const uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(kMaxMatch, size - position));
+				uint32_t candidate = head[HashAt(data + position)];
+				for (uint32_t chain = 0; chain < kMaxChainLength && candidate != 0; ++chain)
+				{
+					const size_t match = candidate - 1;
+					if (position - match > kWindowSize - 1)
+					{
+						break;
+					}
+
+					uint32_t length = 0;
+					while (length < maxLength && data[match + length] == data[position + length])
+					{
+						++length;
+					}
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = static_cast<uint32_t>(position - match);
+						if (length == maxLength)
+						{
+							break;
+						}
+					}
+					candidate = previous[match % kWindowSize];
+				}
+			}
+
+			if (bestLength >= kMinMatch)
+			{
+				WriteMatch(writer, bestLength, bestDistance);
+
+				// Positions inside the match are still worth matching against later
+				for (uint32_t i = 0; i < bestLength; ++i, ++position)
+				{
+					if (position + kMinMatch <= size)
+					{
+						insert(position);
+					}
+				}
+			}
+			else
+			{
+				WriteLiteralOrLength(writer, data[position]);
+				if (position + kMinMatch <= size)
+				{
+					insert(position);
+				}
+				++position;
+			}
+		}
+
+		WriteLiteralOrLength(writer, 256); // End of block
+		writer.Finish();
+		AppendBigEndian(out, Adler32(data, size));
+	}
+
+	uint32_t ReadBigEndian(const uint8_t* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+	}
+
+	// Reads deflate bits from the least significant end of each byte
+	class BitReader final
+	{
+	public:
+		BitReader(const uint8_t* data, size_t size) : mData(data), mSize(size), mPosition(0), mBits(0), mCount(0) {}
+
+		// Returns false when reading past the end of the data
+		bool Read(uint32_t count, uint32_t& value)
+		{
+			while (mCount < count)
+			{
+				if (mPosition == mSize)
+				{
+					return false;
+				}
+				mBits |= static_cast<uint64_t>(mData[mPosition++]) << mCount;
+				mCount += 8;
+			}
+			value = static_cast<uint32_t>(mBits & ((static_cast<uint64_t>(1) << count) - 1));
+			mBits >>= count;
+			mCount -= count;
+			return true;
+		}
+
+		// Stored blocks start at the next byte boundary
+		void AlignToByte()
+		{
+			mBits >>= mCount % 8;
+			mCount -= mCount % 8;
+		}
+
+	private:
+		const uint8_t* mData;
+		size_t mSize;
+		size_t mPosition;
+		uint64_t mBits;
+		uint32_t mCount;
+	};
+
+	// A canonical Huffman code (RFC 1951 3.2.2) stored as the number of codes of each length and the symbols
+	// sorted by code. Decoding walks the lengths one bit at a time, which is plenty for the images we read.
+	struct HuffmanCode
+	{
+		static constexpr uint32_t kMaxBits = 15;
+
+		uint16_t counts[kMaxBits + 1];
+		uint16_t symbols[288];
+
+		// Returns false for over-subscribed codes. Incomplete ones are fine, e.g. a single distance code.
+		bool Build(const uint8_t* lengths, uint32_t symbolCount)
+		{
+			std::fill(std::begin(counts), std::end(counts), static_cast<uint16_t>(0));
+			for (uint32_t symbol = 0; symbol < symbolCount; ++symbol)
+			{
+				counts[lengths[symbol]]++;
+			}
+			counts[0] = 0;
+
+			int32_t left = 1;
+			for (uint32_t length = 1; length <= kMaxBits; ++length)
+			{
+				left = left * 2 - counts[length];
+				if (left < 0)
+				{
+					return false;
+				}
+			}
+
+			uint16_t offsets[kMaxBits + 1] = {};
+			for (uint32_t length = 1; length < kMaxBits; ++length)
+			{
+				offsets[length + 1] = offsets[length] + counts[length];
+			}
+			for (uint32_t symbol = 0; symbol < symbolCount; ++symbol)
+			{
+				if (lengths[symbol] != 0)
+				{
+					symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+				}
+			}
+			return true;
+		}
+
+		bool Decode(BitReader& reader, uint32_t& symbol) const
+		{
+			// Codes of one length are consecutive, so each length only needs a range check
+			int32_t code = 0;
+			int32_t first = 0;
+			int32_t index = 0;
+			for (uint32_t length = 1; length <= kMaxBits; ++length)
+			{
+				uint32_t bit = 0;
+				if (!reader.Read(1, bit))
+				{
+					return false;
+				}
+				code |= static_cast<int32_t>(bit);
+
+				const int32_t count = counts[length];
+				if (code - first < count)
+				{
+					symbol = symbols[index + code - first];
+					return true;
+				}
+				index += count;
+				first = (first + count) << 1;
+				code <<= 1;
+			}
+			return false;
+		}
+	};
+
+	struct FixedHuffmanCodes
+	{
+		HuffmanCode literals;
+		HuffmanCode distances;
+
+		FixedHuffmanCodes()
+		{
+			uint8_t lengths[288];
+			std::fill(lengths, lengths + 144, static_cast<uint8_t>(8));
+			std::fill(lengths + 144, lengths + 256, static_cast<uint8_t>(9));
+			std::fill(lengths + 256, lengths + 280, static_cast<uint8_t>(7));
+			std::fill(lengths + 280, lengths + 288, static_cast<uint8_t>(8));
+			literals.Build(lengths, 288);
+
+			std::fill(lengths, lengths + 30, static_cast<uint8_t>(5));
+			distances.Build(lengths, 30);
+		}
+	};
+
+	bool InflateCompressedBlock(BitReader& reader, const HuffmanCode& literals, const HuffmanCode& distances, std::vector<uint8_t>& out)
+	{
+		for (;;)
+		{
+			uint32_t symbol = 0;
+			if (!literals.Decode(reader, symbol))
+			{
+				return false;
+			}
+
+			if (symbol < 256)
+			{
+				out.push_back(static_cast<uint8_t>(symbol));
+				continue;
+			}
+			if (symbol == 256)
+			{
+				return true;
+			}
+
+			const uint32_t lengthCode = symbol - 257;
+			uint32_t lengthExtra = 0;
+			uint32_t distanceCode = 0;
+			uint32_t distanceExtra = 0;
+			if (lengthCode >= 29 || !reader.Read(kLengthExtraBits[lengthCode], lengthExtra) ||
+				!distances.Decode(reader, distanceCode) || distanceCode >= 30 || !reader.Read(kDistanceExtraBits[distanceCode], distanceExtra))
+			{
+				return false;
+			}
+
+			const size_t length = kLengthBase[lengthCode] + lengthExtra;
+			const size_t distance = kDistanceBase[distanceCode] + distanceExtra;
+			if (distance > out.size())
+			{
+				return false;
+			}
+
+			// Byte by byte: the match may overlap the bytes it produces
+			size_t from = out.size() - distance;
+			for (size_t i = 0; i < length; ++i)
+			{
+				out.push_back(out[from++]);
+			}
+		}
+	}
+
+	// Reads the code length code and the literal/length and distance codes of a dynamic block (RFC 1951 3.2.7)
+	bool ReadDynamicCodes(BitReader& reader, HuffmanCode& literals, HuffmanCode& distances)
+	{
+		static constexpr uint8_t kCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		uint32_t literalCount = 0;
+		uint32_t distanceCount = 0;
+		uint32_t codeLengthCount = 0;
+		if (!reader.Read(5, literalCount) || !reader.Read(5, distanceCount) || !reader.Read(4, codeLengthCount))
+		{
+			return false;
+		}
+		literalCount += 257;
+		distanceCount += 1;
+		codeLengthCount += 4;
+		if (literalCount > 286 || distanceCount > 30)
+		{
+			return false;
+		}
+
+		uint8_t codeLengthLengths[19] = {};
+		for (uint32_t i = 0; i < codeLengthCount; ++i)
+		{
+			uint32_t length = 0;
+			if (!reader.Read(3, length))
+			{
+				return false;
+			}
+			codeLengthLengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(length);
+		}
+
+		HuffmanCode codeLengths;
+		if (!codeLengths.Build(codeLengthLengths, 19))
+		{
+			return false;
+		}
+
+		// Both codes are sent as one sequence of lengths, and repeats may cross from one into the other
+		uint8_t lengths[286 + 30] = {};
+		uint32_t index = 0;
+		while (index < literalCount + distanceCount)
+		{
+			uint32_t symbol = 0;
+			if (!codeLengths.Decode(reader, symbol))
+			{
+				return false;
+			}
+
+			if (symbol < 16)
+			{
+				lengths[index++] = static_cast<uint8_t>(symbol);
+				continue;
+			}
+
+			uint32_t repeat = 0;
+			uint8_t value = 0;
+			if (symbol == 16)
+			{
+				if (index == 0 || !reader.Read(2, repeat))
+				{
+					return false;
+				}
+				value = lengths[index - 1];
+				repeat += 3;
+			}
+			else if (symbol == 17)
+			{
+				if (!reader.Read(3, repeat))
+				{
+					return false;
+				}
+				repeat += 3;
+			}
+			else
+			{
+				if (!reader.Read(7, repeat))
+				{
+					return false;
+				}
+				repeat += 11;
+			}
+
+			if (index + repeat > literalCount + distanceCount)
+			{
+				return false;
+			}
+			std::fill(lengths + index, lengths + index + repeat, value);
+			index += repeat;
+		}
+
+		// A block without an end of block code could never finish
+		return lengths[256] != 0 && literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+	}
+
+	// Decompresses a zlib stream with stored, fixed and dynamic Huffman blocks and checks its Adler-32
+	bool Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		// Deflate with at most a 32K window, no preset dictionary and a header check that adds up
+		if (size < 6 || (data[0] & 0x0f) != 8 || (data[0] >> 4) > 7 || (data[1] & 0x20) != 0 || ((data[0] << 8) | data[1]) % 31 != 0)
+		{
+			return false;
+		}
+
+		static const FixedHuffmanCodes fixedCodes;
+		HuffmanCode literals;
+		HuffmanCode distances;
+
+		BitReader reader(data + 2, size - 6);
+		uint32_t finalBlock = 0;
+		do
+		{
+			uint32_t blockType = 0;
+			if (!reader.Read(1, finalBlock) || !reader.Read(2, blockType))
+			{
+				return false;
+			}
+
+			if (blockType == 0)
+			{
+				reader.AlignToByte();
+				uint32_t length = 0;
+				uint32_t lengthComplement = 0;
+				if (!reader.Read(16, length) || !reader.Read(16, lengthComplement) || (length ^ 0xffff) != lengthComplement)
+				{
+					return false;
+				}
+				for (uint32_t i = 0; i < length; ++i)
+				{
+					uint32_t value = 0;
+					if (!reader.Read(8, value))
+					{
+						return false;
+					}
+					out.push_back(static_cast<uint8_t>(value));
+				}
+			}
+			else if (blockType == 1)
+			{
+				if (!InflateCompressedBlock(reader, fixedCodes.literals, fixedCodes.distances, out))
+				{
+					return false;
+				}
+			}
+			else if (blockType == 2)
+			{
+				if (!ReadDynamicCodes(reader, literals, distances) || !InflateCompressedBlock(reader, literals, distances, out))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				return false;
+			}
+		} while (finalBlock == 0);
+
+		return ReadBigEndian(data + size - 4) == Adler32(out.data(), out.size());
+	}
+}
+
+void BirdGame::EncodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch, bool keepAlpha, std::vector<uint8_t>& png)
+{
+	const uint32_t channels = keepAlpha ? 4 : 3;
+	const size_t stride = static_cast<size_t>(width) * channels;
+
+	// Filtering works on the stored channels, so drop alpha first
+	std::vector<uint8_t> current(stride);
+	std::vector<uint8_t> above(stride, 0);
+	std::vector<uint8_t> candidates[5];
+	for (std::vector<uint8_t>& candidate : candidates)
+	{
+		candidate.resize(stride);
+	}
+
+	std::vector<uint8_t> filtered;
+	filtered.reserve((stride + 1) * height);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint8_t* row = pixels + static_cast<size_t>(y) * rowPitch;
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			for (uint32_t c = 0; c < channels; ++c)
+			{
+				current[x * channels + c] = row[x * 4 + c];
+			}
+		}
+
+		// The usual heuristic: the filter whose residuals, taken as signed bytes, have the smallest sum
+		uint32_t bestFilter = kFilterNone;
+		uint64_t bestSum = UINT64_MAX;
+		for (uint32_t filter = kFilterNone; filter <= kFilterPaeth; ++filter)
+		{
+			uint64_t sum = 0;
+			for (size_t i = 0; i < stride; ++i)
+			{
+				const uint8_t left = (i >= channels) ? current[i - channels] : 0;
+				const uint8_t upLeft = (i >= channels) ? above[i - channels] : 0;
+				uint8_t predicted = 0;
+				switch (filter)
+				{
+					case kFilterSub: predicted = left; break;
+					case kFilterUp: predicted = above[i]; break;
+					case kFilterAverage: predicted = static_cast<uint8_t>((left + above[i]) / 2); break;
+					case kFilterPaeth: predicted = Paeth(left, above[i], upLeft); break;
+					default: break;
+				}
+				const uint8_t residual = static_cast<uint8_t>(current[i] - predicted);
+				candidates[filter][i] = residual;
+				sum += (residual < 128) ? residual : 256 - residual;
+			}
+
+			if (sum < bestSum)
+			{
+				bestSum = sum;
+				bestFilter = filter;
+			}
+		}
+
+		filtered.push_back(static_cast<uint8_t>(bestFilter));
+		filtered.insert(filtered.end(), candidates[bestFilter].begin(), candidates[bestFilter].end());
+		std::swap(current, above);
+	}
+
+	png.assign(kPngSignature, kPngSignature + sizeof(kPngSignature));
+
+	std::vector<uint8_t> header;
+	AppendBigEndian(header, width);
+	AppendBigEndian(header, height);
+	header.push_back(8);                      // Bits per channel
+	header.push_back(keepAlpha ? 6 : 2);      // Truecolor with or without alpha
+	header.push_back(0);                      // Deflate
+	header.push_back(0);                      // Adaptive filtering
+	header.push_back(0);                      // Not interlaced
+	AppendChunk(png, "IHDR", header.data(), header.size());
+
+	std::vector<uint8_t> compressed;
+	Deflate(filtered.data(), filtered.size(), compressed);
+	AppendChunk(png, "IDAT", compressed.data(), compressed.size());
+	AppendChunk(png, "IEND", nullptr, 0);
+}
+
+bool BirdGame::WritePng(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch, bool keepAlpha)
+{
+	std::vector<uint8_t> png;
+	EncodePng(pixels, width, height, rowPitch, keepAlpha, png);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(png.data()), png.size());
+	return static_cast<bool>(file);
+}
+
+bool BirdGame::DecodePng(const uint8_t* data, size_t size, Image& image)
+{
+	if (size < sizeof(kPngSignature) || memcmp(data, kPngSignature, sizeof(kPngSignature)) != 0)
+	{
+		return false;
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t channels = 0;
+	std::vector<uint8_t> compressed;
+	bool ended = false;
+	for (size_t offset = sizeof(kPngSignature); !ended;)
+	{
+		// Length, type, data and a CRC over type and data
+		if (size - offset < 12)
+		{
+			return false;
+		}
+		const uint32_t length = ReadBigEndian(data + offset);
+		if (length > size - offset - 12)
+		{
+			return false;
+		}
+		const uint8_t* type = data + offset + 4;
+		const uint8_t* chunk = type + 4;
+		if (Crc32(type, length + 4) != ReadBigEndian(chunk + length))
+		{
+			return false;
+		}
+		offset += length + 12;
+
+		if (memcmp(type, "IHDR", 4) == 0)
+		{
+			if (length != 13)
+			{
+				return false;
+			}
+			width = ReadBigEndian(chunk);
+			height = ReadBigEndian(chunk + 4);
+
+			// Grayscale, truecolor, grayscale with alpha, truecolor with alpha
+			switch (chunk[9])
+			{
+				case 0: channels = 1; break;
+				case 2: channels = 3; break;
+				case 4: channels = 2; break;
+				case 6: channels = 4; break;
+				default: return false;
+			}
+
+			// 8 bits per channel, deflate, adaptive filtering, not interlaced
+			if (width == 0 || height == 0 || chunk[8] != 8 || chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0)
+			{
+				return false;
+			}
+		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+		{
+			compressed.insert(compressed.end(), chunk, chunk + length);
+		}
+		else if (memcmp(type, "IEND", 4) == 0)
+		{
+			ended = true;
+		}
+		else if ((type[0] & 0x20) == 0)
+		{
+			// Chunks we don't know about are only safe to skip if they are marked ancillary
+			return false;
+		}
+	}
+
+	const size_t stride = static_cast<size_t>(width) * channels;
+	std::vector<uint8_t> filtered;
+	filtered.reserve((stride + 1) * height);
+	if (channels == 0 || !Inflate(compressed.data(), compressed.size(), filtered) || filtered.size() != (stride + 1) * height)
+	{
+		return false;
+	}
+
+	image.Resize(width, height);
+	std::vector<uint8_t> above(stride, 0);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint8_t filter = filtered[y * (stride + 1)];
+		uint8_t* current = &filtered[y * (stride + 1) + 1];
+		for (size_t i = 0; i < stride; ++i)
+		{
+			const uint8_t left = (i >= channels) ? current[i - channels] : 0;
+			const uint8_t upLeft = (i >= channels) ? above[i - channels] : 0;
+			switch (filter)
+			{
+				case kFilterNone: break;
+				case kFilterSub: current[i] += left; break;
+				case kFilterUp: current[i] += above[i]; break;
+				case kFilterAverage: current[i] += static_cast<uint8_t>((left + above[i]) / 2); break;
+				case kFilterPaeth: current[i] += Paeth(left, above[i], upLeft); break;
+				default: return false;
+			}
+		}
+		above.assign(current, current + stride);
+
+		uint8_t* pixel = image.GetPixel(0, y);
+		for (uint32_t x = 0; x < width; ++x, pixel += Image::kBytesPerPixel)
+		{
+			const uint8_t* source = current + static_cast<size_t>(x) * channels;
+			const bool gray = channels < 3;
+			pixel[0] = source[0];
+			pixel[1] = gray ? source[0] : source[1];
+			pixel[2] = gray ? source[0] : source[2];
+			pixel[3] = (channels == 2 || channels == 4) ? source[channels - 1] : 0xff;
+		}
+	}
+
+	return true;
+}
+
+bool BirdGame::ReadPng(const char* path, Image& image)
+{
+	MappedFile file;
+	return file.Open(path) && DecodePng(file.GetData(), file.GetSize(), image);
+}
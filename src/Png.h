@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// Encodes RGBA8 rows rowPitch bytes apart as an 8 bit PNG. Without keepAlpha the alpha channel is dropped and
+	// the image is stored as RGB, which is what frame captures want: back buffer alpha is never shown.
+	// Every row gets the PNG filter that leaves the smallest residuals, then everything is deflated with fixed
+	// Huffman codes and a hash chain match finder. That's a good deal larger than zlib's best for photos, but close
+	// for flat colored game frames, and a lot faster.
+	void EncodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch, bool keepAlpha, std::vector<uint8_t>& png);
+
+	// EncodePng() into a file. Returns false if the file can't be written.
+	bool WritePng(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch, bool keepAlpha);
+
+	// Decodes an 8 bit, non-interlaced grayscale or truecolor PNG, with or without alpha, into RGBA8. That covers
+	// everything EncodePng() writes and what image editors save by default. Returns false for anything else or if
+	// the file is damaged. Checksums are verified, so a golden image that got mangled on its way through version
+	// control doesn't pass as a different picture.
+	bool DecodePng(const uint8_t* data, size_t size, Image& image);
+
+	// DecodePng() from a file. Returns false if the file can't be read or decoded.
+	bool ReadPng(const char* path, Image& image);
+}
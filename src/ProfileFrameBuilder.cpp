@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "ProfileFrameBuilder.h"
+
+#include <assert.h>
+
+BirdGame::ProfileFrameBuilder::ProfileFrameBuilder() :
+	mFrameNumber(0),
+	mInFrame(false)
+{
+	mScopes.reserve(kMaxScopes);
+	mOpenScopes.reserve(kMaxScopes);
+}
+
+void BirdGame::ProfileFrameBuilder::BeginFrame(uint64_t frameNumber)
+{
+	assert(!mInFrame && "EndFrame() was not called");
+	mFrameNumber = frameNumber;
+	mInFrame = true;
+	mScopes.clear();
+	mOpenScopes.clear();
+}
+
+void BirdGame::ProfileFrameBuilder::EndFrame()
+{
+	assert(mInFrame && "BeginFrame() was not called");
+	assert(mOpenScopes.empty() && "Every scope has to end within the frame it began in");
+	mInFrame = false;
+}
+
+uint32_t BirdGame::ProfileFrameBuilder::BeginScope(const char* name)
+{
+	uint32_t scope = kDroppedScope;
+	if (mInFrame && mScopes.size() < kMaxScopes)
+	{
+		// Once scopes are dropped the frame is full, so a scope's parent is never a dropped one
+		const uint32_t parent = mOpenScopes.empty() ? ProfileScopeResult::kNoParent : mOpenScopes.back();
+		scope = static_cast<uint32_t>(mScopes.size());
+		mScopes.push_back({ name, parent, static_cast<uint32_t>(mOpenScopes.size()) });
+	}
+
+	mOpenScopes.push_back(scope);
+	return scope;
+}
+
+uint32_t BirdGame::ProfileFrameBuilder::EndScope()
+{
+	assert(!mOpenScopes.empty() && "EndScope() without BeginScope()");
+	const uint32_t scope = mOpenScopes.back();
+	mOpenScopes.pop_back();
+	return scope;
+}
+
+void BirdGame::ProfileFrameBuilder::Resolve(const uint64_t* timestamps, uint64_t ticksPerSecond, ProfileFrame& frame) const
+{
+	const double millisecondsPerTick = 1000.0 / static_cast<double>(ticksPerSecond);
+
+	frame.frameNumber = mFrameNumber;
+	frame.scopes.resize(mScopes.size());
+	for (size_t i = 0; i < mScopes.size(); ++i)
+	{
+		const uint64_t begin = timestamps[i * 2];
+		const uint64_t end = timestamps[i * 2 + 1];
+
+		ProfileScopeResult& result = frame.scopes[i];
+		result.name = mScopes[i].name;
+		result.parent = mScopes[i].parent;
+		result.depth = mScopes[i].depth;
+		result.milliseconds = (end > begin) ? static_cast<double>(end - begin) * millisecondsPerTick : 0.0;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "IProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// Bookkeeping shared by the IProfiler implementations: tracks the scope tree of the frame being recorded and
+	// turns timestamps into a ProfileFrame once they are available. Scope i is timed by timestamps 2 * i and
+	// 2 * i + 1, so an implementation only has to take those two timestamps.
+	class ProfileFrameBuilder final
+	{
+	public:
+		static constexpr uint32_t kMaxScopes = 256; // Per frame
+		static constexpr uint32_t kMaxTimestamps = kMaxScopes * 2;
+		static constexpr uint32_t kDroppedScope = UINT32_MAX;
+
+		ProfileFrameBuilder();
+
+		void BeginFrame(uint64_t frameNumber);
+		void EndFrame();
+
+		// Returns the index of the new scope, or kDroppedScope outside of a frame and once kMaxScopes is reached.
+		// Dropped scopes still have to be ended.
+		uint32_t BeginScope(const char* name);
+
+		// Returns the index of the scope that ended, or kDroppedScope
+		uint32_t EndScope();
+
+		bool IsInFrame() const { return mInFrame; }
+		uint32_t GetScopeCount() const { return static_cast<uint32_t>(mScopes.size()); }
+		uint32_t GetTimestampCount() const { return GetScopeCount() * 2; }
+
+		// timestamps holds GetTimestampCount() values, in ticksPerSecond
+		void Resolve(const uint64_t* timestamps, uint64_t ticksPerSecond, ProfileFrame& frame) const;
+
+	private:
+		ProfileFrameBuilder(const ProfileFrameBuilder&) = delete;
+
+		struct Scope
+		{
+			const char* name;
+			uint32_t parent;
+			uint32_t depth;
+		};
+
+		uint64_t mFrameNumber;
+		bool mInFrame;
+		std::vector<Scope> mScopes;
+		std::vector<uint32_t> mOpenScopes;
+	};
+}
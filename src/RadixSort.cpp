@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "RadixSort.h"
+
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	constexpr uint32_t kRadixBits = 8;
+	constexpr uint32_t kRadixSize = 1 << kRadixBits;
+	constexpr uint32_t kNumPasses = 64 / kRadixBits;
+}
+
+void BirdGame::RadixSort(uint64_t* keys, uint32_t* values, uint64_t* scratchKeys, uint32_t* scratchValues, size_t count)
+{
+	if (count < 2)
+	{
+		return;
+	}
+
+	// Build the histograms for every pass in a single read over the keys
+	size_t histograms[kNumPasses][kRadixSize] = {};
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint64_t key = keys[i];
+		for (uint32_t pass = 0; pass < kNumPasses; ++pass)
+		{
+			histograms[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)]++;
+		}
+	}
+
+	uint64_t* sourceKeys = keys;
+	uint32_t* sourceValues = values;
+	uint64_t* destinationKeys = scratchKeys;
+	uint32_t* destinationValues = scratchValues;
+
+	for (uint32_t pass = 0; pass < kNumPasses; ++pass)
+	{
+		const uint32_t shift = pass * kRadixBits;
+		size_t* histogram = histograms[pass];
+
+		// All keys share this digit, so the pass wouldn't move anything
+		if (histogram[(sourceKeys[0] >> shift) & (kRadixSize - 1)] == count)
+		{
+			continue;
+		}
+
+		// Exclusive prefix sum turns the counts into output offsets
+		size_t offset = 0;
+		for (uint32_t digit = 0; digit < kRadixSize; ++digit)
+		{
+			const size_t digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t destination = histogram[(sourceKeys[i] >> shift) & (kRadixSize - 1)]++;
+			destinationKeys[destination] = sourceKeys[i];
+			destinationValues[destination] = sourceValues[i];
+		}
+
+		std::swap(sourceKeys, destinationKeys);
+		std::swap(sourceValues, destinationValues);
+	}
+
+	if (sourceKeys != keys)
+	{
+		memcpy(keys, sourceKeys, count * sizeof(uint64_t));
+		memcpy(values, sourceValues, count * sizeof(uint32_t));
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BirdGame
+{
+	// Stable LSD radix sort of 64-bit keys carrying 32-bit payloads, one byte per pass. Passes where every key
+	// has the same byte are skipped, so keys that only use a few of their bits are cheap to sort.
+	// The scratch arrays must hold count elements. The sorted result always ends up in keys/values.
+	void RadixSort(uint64_t* keys, uint32_t* values, uint64_t* scratchKeys, uint32_t* scratchValues, size_t count);
+}
@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "RenderCommandBuffer.h"
+
+#include "RadixSort.h"
+
+#include <assert.h>
+
+BirdGame::RenderCommandBuffer::RenderCommandBuffer(uint32_t maxPackets) :
+	mMaxPackets(maxPackets)
+{
+	mPackets.reserve(maxPackets);
+	mKeys.reserve(maxPackets);
+	mIndices.reserve(maxPackets);
+	mScratchKeys.reserve(maxPackets);
+	mScratchIndices.reserve(maxPackets);
+	mSorted.reserve(maxPackets);
+}
+
+void BirdGame::RenderCommandBuffer::Submit(const DrawPacket& packet)
+{
+	if (mPackets.size() >= mMaxPackets)
+	{
+		assert(false && "Too many draw packets submitted this frame");
+		return;
+	}
+
+	mPackets.push_back(packet);
+}
+
+void BirdGame::RenderCommandBuffer::Sort()
+{
+	const size_t count = mPackets.size();
+	mKeys.resize(count);
+	mIndices.resize(count);
+	mScratchKeys.resize(count);
+	mScratchIndices.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		mKeys[i] = mPackets[i].key;
+		mIndices[i] = static_cast<uint32_t>(i);
+	}
+
+	RadixSort(mKeys.data(), mIndices.data(), mScratchKeys.data(), mScratchIndices.data(), count);
+
+	mSorted.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSorted[i] = mPackets[mIndices[i]];
+	}
+	mPackets.swap(mSorted);
+}
+
+void BirdGame::RenderCommandBuffer::Clear()
+{
+	mPackets.clear();
+}
+
+bool BirdGame::RenderCommandBuffer::Validate(uint32_t instanceCount) const
+{
+	for (size_t i = 0; i < mPackets.size(); ++i)
+	{
+		const DrawPacket& packet = mPackets[i];
+		if (i > 0 && mPackets[i - 1].key > packet.key)
+		{
+			return false;
+		}
+
+		if (packet.instanceCount == 0 || static_cast<uint64_t>(packet.firstInstance) + packet.instanceCount > instanceCount)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+BirdGame::RenderCommandBuffer::Stats BirdGame::RenderCommandBuffer::ComputeStats() const
+{
+	Stats stats = {};
+	for (size_t i = 0; i < mPackets.size(); ++i)
+	{
+		const uint64_t key = mPackets[i].key;
+		if (i == 0 || SortKey::GetPipeline(key) != SortKey::GetPipeline(mPackets[i - 1].key) || SortKey::GetBlendMode(key) != SortKey::GetBlendMode(mPackets[i - 1].key))
+		{
+			stats.pipelineChanges++;
+		}
+		if (i == 0 || SortKey::GetTexture(key) != SortKey::GetTexture(mPackets[i - 1].key))
+		{
+			stats.textureChanges++;
+		}
+
+		stats.drawCount++;
+		stats.instanceCount += mPackets[i].instanceCount;
+	}
+
+	return stats;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	enum class BlendMode : uint8_t
+	{
+		Opaque,
+		Alpha,
+		Additive
+	};
+
+	// Pipelines the backends know how to draw with
+	enum class PipelineId : uint8_t
+	{
+		Sprite,
+		Text,    // Sprite instances whose texture is a signed distance field glyph atlas (see GlyphAtlas)
+		Upscale  // Fullscreen, recorded by its render graph pass rather than through the command stream
+	};
+
+	// 64-bit draw sort key, most significant field first:
+	// layer (8) | blend mode (2) | pipeline (6) | texture (24) | depth (24)
+	// Sorting by the whole key draws back to front by layer and groups draws sharing state within a layer.
+	namespace SortKey
+	{
+		constexpr uint32_t kLayerShift = 56;
+		constexpr uint32_t kBlendModeShift = 54;
+		constexpr uint32_t kPipelineShift = 48;
+		constexpr uint32_t kTextureShift = 24;
+		constexpr uint32_t kDepthShift = 0;
+
+		constexpr uint64_t kBlendModeMask = 0x3;
+		constexpr uint64_t kPipelineMask = 0x3f;
+		constexpr uint64_t kTextureMask = 0xffffff;
+		constexpr uint64_t kDepthMask = 0xffffff;
+
+		constexpr uint64_t Make(uint8_t layer, BlendMode blendMode, PipelineId pipeline, TextureHandle texture, uint32_t depth)
+		{
+			return (static_cast<uint64_t>(layer) << kLayerShift) |
+				((static_cast<uint64_t>(blendMode) & kBlendModeMask) << kBlendModeShift) |
+				((static_cast<uint64_t>(pipeline) & kPipelineMask) << kPipelineShift) |
+				((static_cast<uint64_t>(texture) & kTextureMask) << kTextureShift) |
+				((static_cast<uint64_t>(depth) & kDepthMask) << kDepthShift);
+		}
+
+		constexpr uint8_t GetLayer(uint64_t key) { return static_cast<uint8_t>(key >> kLayerShift); }
+		constexpr BlendMode GetBlendMode(uint64_t key) { return static_cast<BlendMode>((key >> kBlendModeShift) & kBlendModeMask); }
+		constexpr PipelineId GetPipeline(uint64_t key) { return static_cast<PipelineId>((key >> kPipelineShift) & kPipelineMask); }
+		constexpr TextureHandle GetTexture(uint64_t key) { return static_cast<TextureHandle>((key >> kTextureShift) & kTextureMask); }
+		constexpr uint32_t GetDepth(uint64_t key) { return static_cast<uint32_t>((key >> kDepthShift) & kDepthMask); }
+	}
+
+	// One instanced draw. Instances index into the frame's instance data (see SpriteBatch).
+	struct DrawPacket
+	{
+		uint64_t key;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	// Backend-neutral list of draws for a frame. Game code fills it without touching the graphics API, it is
+	// sorted once per frame and the backend then replays it in order.
+	class RenderCommandBuffer final
+	{
+	public:
+		struct Stats
+		{
+			uint32_t drawCount;
+			uint32_t instanceCount;
+			uint32_t pipelineChanges;
+			uint32_t textureChanges;
+		};
+
+		explicit RenderCommandBuffer(uint32_t maxPackets);
+
+		// Packets past maxPackets are dropped
+		void Submit(const DrawPacket& packet);
+
+		// Stable radix sort by key
+		void Sort();
+
+		void Clear();
+
+		const std::vector<DrawPacket>& GetPackets() const { return mPackets; }
+
+		// Checks that the stream is sorted and every packet only references instances below instanceCount
+		bool Validate(uint32_t instanceCount) const;
+
+		// Counts the state changes a backend needs to replay the stream in its current order
+		Stats ComputeStats() const;
+
+	private:
+		RenderCommandBuffer(const RenderCommandBuffer&) = delete;
+
+		uint32_t mMaxPackets;
+		std::vector<DrawPacket> mPackets;
+
+		// Sort scratch, kept around between frames
+		std::vector<uint64_t> mKeys;
+		std::vector<uint32_t> mIndices;
+		std::vector<uint64_t> mScratchKeys;
+		std::vector<uint32_t> mScratchIndices;
+		std::vector<DrawPacket> mSorted;
+	};
+}
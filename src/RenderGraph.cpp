@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "RenderGraph.h"
+
+#include "MathUtils.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <utility>
+
+BirdGame::RenderGraphResource BirdGame::RenderGraph::ImportResource(const char* name, ResourceState initialState, ResourceState finalState)
+{
+	Resource resource = {};
+	resource.name = name;
+	resource.imported = true;
+	resource.initialState = initialState;
+	resource.finalState = finalState;
+	mResources.push_back(resource);
+	return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+BirdGame::RenderGraphResource BirdGame::RenderGraph::CreateTransient(const char* name, const TextureDesc& desc)
+{
+	Resource resource = {};
+	resource.name = name;
+	resource.imported = false;
+	resource.desc = desc;
+	mResources.push_back(resource);
+	return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+BirdGame::RenderGraphPass BirdGame::RenderGraph::AddPass(const char* name, PassCallback execute, bool hasSideEffects)
+{
+	Pass pass = {};
+	pass.name = name;
+	pass.execute = std::move(execute);
+	pass.hasSideEffects = hasSideEffects;
+	mPasses.push_back(std::move(pass));
+	return static_cast<RenderGraphPass>(mPasses.size() - 1);
+}
+
+void BirdGame::RenderGraph::Read(RenderGraphPass pass, RenderGraphResource resource, ResourceState state)
+{
+	assert(!IsWriteState(state) && "Use Write() for write states");
+
+	// Multiple reads of the same resource in one pass are merged into one combined read state
+	for (Access& access : mPasses[pass].accesses)
+	{
+		if (access.resource == resource)
+		{
+			assert(!access.write && "A resource can't be read and written in one pass");
+			access.state = access.state | state;
+			return;
+		}
+	}
+
+	mPasses[pass].accesses.push_back({ resource, state, false });
+}
+
+void BirdGame::RenderGraph::Write(RenderGraphPass pass, RenderGraphResource resource, ResourceState state)
+{
+	for (Access& access : mPasses[pass].accesses)
+	{
+		if (access.resource == resource)
+		{
+			assert(access.write && access.state == state && "A resource can only be written in one state per pass");
+			return;
+		}
+	}
+
+	mPasses[pass].accesses.push_back({ resource, state, true });
+}
+
+void BirdGame::RenderGraph::Compile(const AllocationInfoCallback& allocationInfo)
+{
+	mCompiledPasses.clear();
+	mBarriers.clear();
+	mFinalBarrierStart = 0;
+	mTransientHeapSize = 0;
+
+	CullPasses();
+
+	for (RenderGraphPass pass = 0; pass < mPasses.size(); ++pass)
+	{
+		if (!mPasses[pass].culled)
+		{
+			mCompiledPasses.push_back({ pass, 0, 0 });
+		}
+	}
+
+	ComputeBarriers();
+	PlaceTransients(allocationInfo);
+}
+
+void BirdGame::RenderGraph::Clear()
+{
+	mPasses.clear();
+	mResources.clear();
+	mCompiledPasses.clear();
+	mBarriers.clear();
+	mFinalBarrierStart = 0;
+	mTransientHeapSize = 0;
+}
+
+void BirdGame::RenderGraph::CullPasses()
+{
+	// Reference counting flood fill: a pass is alive while something reads one of the resources it writes.
+	// Imported resources are read by whoever owns them after the graph, so they hold one extra reference.
+	std::vector<uint32_t> passReferences(mPasses.size(), 0);
+	std::vector<uint32_t> resourceReaders(mResources.size(), 0);
+
+	for (RenderGraphResource resource = 0; resource < mResources.size(); ++resource)
+	{
+		resourceReaders[resource] = mResources[resource].imported ? 1 : 0;
+	}
+
+	for (RenderGraphPass pass = 0; pass < mPasses.size(); ++pass)
+	{
+		mPasses[pass].culled = false;
+		for (const Access& access : mPasses[pass].accesses)
+		{
+			if (access.write)
+			{
+				passReferences[pass]++;
+			}
+			else
+			{
+				resourceReaders[access.resource]++;
+			}
+		}
+
+		if (mPasses[pass].hasSideEffects)
+		{
+			passReferences[pass]++;
+		}
+	}
+
+	std::vector<RenderGraphResource> unreferenced;
+	for (RenderGraphResource resource = 0; resource < mResources.size(); ++resource)
+	{
+		if (resourceReaders[resource] == 0)
+		{
+			unreferenced.push_back(resource);
+		}
+	}
+
+	while (!unreferenced.empty())
+	{
+		const RenderGraphResource resource = unreferenced.back();
+		unreferenced.pop_back();
+
+		for (RenderGraphPass pass = 0; pass < mPasses.size(); ++pass)
+		{
+			Pass& writer = mPasses[pass];
+			if (writer.culled)
+			{
+				continue;
+			}
+
+			for (const Access& access : writer.accesses)
+			{
+				if (access.resource == resource && access.write && --passReferences[pass] == 0)
+				{
+					// Nothing needs this pass anymore, so it no longer needs its inputs either
+					writer.culled = true;
+					for (const Access& input : writer.accesses)
+					{
+						if (!input.write && --resourceReaders[input.resource] == 0)
+						{
+							unreferenced.push_back(input.resource);
+						}
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
+BirdGame::ResourceState BirdGame::RenderGraph::GatherReadStates(RenderGraphResource resource, size_t start) const
+{
+	ResourceState states = ResourceState::Undefined;
+	for (size_t index = start; index < mCompiledPasses.size(); ++index)
+	{
+		for (const Access& access : mPasses[mCompiledPasses[index].pass].accesses)
+		{
+			if (access.resource == resource)
+			{
+				if (access.write)
+				{
+					return states;
+				}
+				states = states | access.state;
+			}
+		}
+	}
+
+	return states;
+}
+
+void BirdGame::RenderGraph::ComputeBarriers()
+{
+	std::vector<ResourceState> currentStates(mResources.size());
+	for (RenderGraphResource resource = 0; resource < mResources.size(); ++resource)
+	{
+		Resource& record = mResources[resource];
+		currentStates[resource] = record.imported ? record.initialState : ResourceState::Undefined;
+		record.firstUse = kNotUsed;
+		record.lastUse = kNotUsed;
+	}
+
+	for (size_t index = 0; index < mCompiledPasses.size(); ++index)
+	{
+		CompiledPass& compiledPass = mCompiledPasses[index];
+		compiledPass.firstBarrier = static_cast<uint32_t>(mBarriers.size());
+
+		for (const Access& access : mPasses[compiledPass.pass].accesses)
+		{
+			Resource& record = mResources[access.resource];
+			ResourceState& current = currentStates[access.resource];
+
+			// Going into a read state we also include every state the following read-only passes need,
+			// so a chain of readers costs one transition instead of one per pass
+			const ResourceState target = access.write ? access.state : GatherReadStates(access.resource, index);
+
+			if (record.firstUse == kNotUsed && !record.imported)
+			{
+				mBarriers.push_back({ access.resource, ResourceState::Undefined, target });
+				current = target;
+			}
+			else if (access.write ? (current != target) : (IsWriteState(current) || !HasAllStates(current, access.state)))
+			{
+				mBarriers.push_back({ access.resource, current, target });
+				current = target;
+			}
+
+			if (record.firstUse == kNotUsed)
+			{
+				record.firstUse = static_cast<uint32_t>(index);
+			}
+			record.lastUse = static_cast<uint32_t>(index);
+		}
+
+		compiledPass.barrierCount = static_cast<uint32_t>(mBarriers.size()) - compiledPass.firstBarrier;
+	}
+
+	// Hand imported resources back in the state their owner expects
+	mFinalBarrierStart = static_cast<uint32_t>(mBarriers.size());
+	for (RenderGraphResource resource = 0; resource < mResources.size(); ++resource)
+	{
+		const Resource& record = mResources[resource];
+		if (record.imported && currentStates[resource] != record.finalState)
+		{
+			mBarriers.push_back({ resource, currentStates[resource], record.finalState });
+		}
+	}
+}
+
+void BirdGame::RenderGraph::PlaceTransients(const AllocationInfoCallback& allocationInfo)
+{
+	struct Candidate
+	{
+		RenderGraphResource resource;
+		AllocationInfo info;
+	};
+
+	std::vector<Candidate> candidates;
+	for (RenderGraphResource resource = 0; resource < mResources.size(); ++resource)
+	{
+		Resource& record = mResources[resource];
+		record.placement = { 0, 0 };
+		if (!record.imported && record.firstUse != kNotUsed)
+		{
+			candidates.push_back({ resource, allocationInfo(record.desc) });
+		}
+	}
+
+	// Largest first gives the smaller resources a chance to fill the gaps
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+	{
+		return a.info.size > b.info.size;
+	});
+
+	std::vector<const Candidate*> placed;
+	for (const Candidate& candidate : candidates)
+	{
+		const Resource& record = mResources[candidate.resource];
+
+		// Only resources that are alive at the same time as this one constrain where it can go
+		std::vector<const Resource*> overlapping;
+		for (const Candidate* other : placed)
+		{
+			const Resource& otherRecord = mResources[other->resource];
+			if (otherRecord.firstUse <= record.lastUse && record.firstUse <= otherRecord.lastUse)
+			{
+				overlapping.push_back(&otherRecord);
+			}
+		}
+
+		// The best offset is either the start of the heap or right after one of the overlapping resources
+		uint64_t bestOffset = UINT64_MAX;
+		for (size_t i = 0; i <= overlapping.size(); ++i)
+		{
+			const uint64_t offset = (i == overlapping.size()) ? 0 : AlignUp(overlapping[i]->placement.offset + overlapping[i]->placement.size, candidate.info.alignment);
+			if (offset >= bestOffset)
+			{
+				continue;
+			}
+
+			const bool collides = std::any_of(overlapping.begin(), overlapping.end(), [&](const Resource* other)
+			{
+				return offset < other->placement.offset + other->placement.size && other->placement.offset < offset + candidate.info.size;
+			});
+
+			if (!collides)
+			{
+				bestOffset = offset;
+			}
+		}
+
+		mResources[candidate.resource].placement = { bestOffset, candidate.info.size };
+		mTransientHeapSize = std::max(mTransientHeapSize, bestOffset + candidate.info.size);
+		placed.push_back(&candidate);
+	}
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace BirdGame
+{
+	using RenderGraphResource = uint32_t;
+	using RenderGraphPass = uint32_t;
+
+	// Describes a frame as passes that declare which resources they read and write. Compile() culls passes whose
+	// results are never used, computes the minimal batched barriers between passes and places transient
+	// resources whose lifetimes don't overlap at the same heap offset. Backend-neutral: a backend executor
+	// turns the compiled barriers and placements into API calls (see RenderGraphDX).
+	class RenderGraph final
+	{
+	public:
+		using PassCallback = std::function<void()>;
+
+		// Size and alignment the backend needs to place a transient texture in a heap
+		struct AllocationInfo
+		{
+			uint64_t size;
+			uint64_t alignment;
+		};
+		using AllocationInfoCallback = std::function<AllocationInfo(const TextureDesc&)>;
+
+		// before == Undefined marks the first use of a transient resource: its memory may have been used by
+		// another resource, so the backend has to treat the contents as garbage (aliasing barrier, discard)
+		struct Barrier
+		{
+			RenderGraphResource resource;
+			ResourceState before;
+			ResourceState after;
+		};
+
+		// The barriers to issue, in one batch, before executing a pass
+		struct CompiledPass
+		{
+			RenderGraphPass pass;
+			uint32_t firstBarrier;
+			uint32_t barrierCount;
+		};
+
+		struct TransientPlacement
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		RenderGraph() = default;
+
+		// External resources such as the back buffer. They are in initialState when the graph starts and are
+		// transitioned to finalState at the end. Imported resources count as outputs, so passes writing them are never culled.
+		RenderGraphResource ImportResource(const char* name, ResourceState initialState, ResourceState finalState);
+
+		// Resources that only live within the graph. Their memory is owned by the executor and may be aliased.
+		RenderGraphResource CreateTransient(const char* name, const TextureDesc& desc);
+
+		// Passes execute in the order they were added. Passes with side effects (e.g. readbacks) are never culled.
+		RenderGraphPass AddPass(const char* name, PassCallback execute, bool hasSideEffects = false);
+		void Read(RenderGraphPass pass, RenderGraphResource resource, ResourceState state);
+		void Write(RenderGraphPass pass, RenderGraphResource resource, ResourceState state);
+
+		void Compile(const AllocationInfoCallback& allocationInfo);
+
+		// Removes all passes and resources
+		void Clear();
+
+		// Results of Compile()
+		const std::vector<CompiledPass>& GetCompiledPasses() const { return mCompiledPasses; }
+		const std::vector<Barrier>& GetBarriers() const { return mBarriers; }
+		uint32_t GetFinalBarrierStart() const { return mFinalBarrierStart; }
+		uint32_t GetFinalBarrierCount() const { return static_cast<uint32_t>(mBarriers.size()) - mFinalBarrierStart; }
+		uint64_t GetTransientHeapSize() const { return mTransientHeapSize; }
+		bool IsCulled(RenderGraphPass pass) const { return mPasses[pass].culled; }
+
+		void ExecutePass(RenderGraphPass pass) const { mPasses[pass].execute(); }
+
+		uint32_t GetResourceCount() const { return static_cast<uint32_t>(mResources.size()); }
+		const char* GetResourceName(RenderGraphResource resource) const { return mResources[resource].name; }
+		const char* GetPassName(RenderGraphPass pass) const { return mPasses[pass].name; }
+		bool IsTransient(RenderGraphResource resource) const { return !mResources[resource].imported; }
+		const TextureDesc& GetTransientDesc(RenderGraphResource resource) const { return mResources[resource].desc; }
+		const TransientPlacement& GetTransientPlacement(RenderGraphResource resource) const { return mResources[resource].placement; }
+
+	private:
+		RenderGraph(const RenderGraph&) = delete;
+
+		static constexpr uint32_t kNotUsed = UINT32_MAX;
+
+		struct Access
+		{
+			RenderGraphResource resource;
+			ResourceState state;
+			bool write;
+		};
+
+		struct Pass
+		{
+			const char* name;
+			PassCallback execute;
+			bool hasSideEffects;
+			bool culled;
+			std::vector<Access> accesses;
+		};
+
+		struct Resource
+		{
+			const char* name;
+			bool imported;
+			ResourceState initialState;
+			ResourceState finalState;
+			TextureDesc desc;
+			TransientPlacement placement;
+
+			// Lifetime in compiled pass indices, filled in by Compile()
+			uint32_t firstUse;
+			uint32_t lastUse;
+		};
+
+		void CullPasses();
+		void ComputeBarriers();
+		void PlaceTransients(const AllocationInfoCallback& allocationInfo);
+
+		// Union of the read states of the run of read-only accesses that starts at compiled pass index start
+		ResourceState GatherReadStates(RenderGraphResource resource, size_t start) const;
+
+		std::vector<Pass> mPasses;
+		std::vector<Resource> mResources;
+
+		std::vector<CompiledPass> mCompiledPasses;
+		std::vector<Barrier> mBarriers;
+		uint32_t mFinalBarrierStart = 0;
+		uint64_t mTransientHeapSize = 0;
+	};
+}
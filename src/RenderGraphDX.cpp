@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "RenderGraphDX.h"
+
+#include "DXHelpers.h"
+#include "IProfiler.h"
+#include "MemoryTracker.h"
+
+#include <assert.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	DXGI_FORMAT ToDXGIFormat(BirdGame::TextureFormat format)
+	{
+		switch (format)
+		{
+			case BirdGame::TextureFormat::RGBA8:
+				return DXGI_FORMAT_R8G8B8A8_UNORM;
+		}
+
+		assert(false && "Unknown texture format");
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// Transient textures are always render targets for now, that is all our passes write to
+	D3D12_RESOURCE_DESC MakeTransientDesc(const BirdGame::TextureDesc& desc)
+	{
+		return CD3DX12_RESOURCE_DESC::Tex2D(ToDXGIFormat(desc.format), desc.width, desc.height, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+	}
+}
+
+D3D12_RESOURCE_STATES BirdGame::ToD3D12ResourceStates(ResourceState state)
+{
+	D3D12_RESOURCE_STATES result = D3D12_RESOURCE_STATE_COMMON; // Same value as D3D12_RESOURCE_STATE_PRESENT
+	if (HasAllStates(state, ResourceState::RenderTarget))
+	{
+		result |= D3D12_RESOURCE_STATE_RENDER_TARGET;
+	}
+	if (HasAllStates(state, ResourceState::ShaderResource))
+	{
+		result |= D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+	}
+	if (HasAllStates(state, ResourceState::CopySource))
+	{
+		result |= D3D12_RESOURCE_STATE_COPY_SOURCE;
+	}
+	if (HasAllStates(state, ResourceState::CopyDest))
+	{
+		result |= D3D12_RESOURCE_STATE_COPY_DEST;
+	}
+	if (HasAllStates(state, ResourceState::UnorderedAccess))
+	{
+		result |= D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	}
+	if (HasAllStates(state, ResourceState::VertexBuffer))
+	{
+		result |= D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+	}
+	if (HasAllStates(state, ResourceState::IndexBuffer))
+	{
+		result |= D3D12_RESOURCE_STATE_INDEX_BUFFER;
+	}
+	return result;
+}
+
+BirdGame::RenderGraphDX::RenderGraphDX() :
+	mTransientHeapSize(0)
+{
+}
+
+BirdGame::RenderGraphDX::~RenderGraphDX()
+{
+}
+
+void BirdGame::RenderGraphDX::Initialize(ID3D12Device* device)
+{
+	mDevice = device;
+}
+
+void BirdGame::RenderGraphDX::Destroy()
+{
+	mResources.clear();
+	mTransientResources.clear();
+	mTransientStates.clear();
+
+	if (mTransientHeap != nullptr)
+	{
+		MemoryTracker::UntrackResource(mTransientHeap.Get());
+		mTransientHeap.Reset();
+		mTransientHeapSize = 0;
+	}
+
+	mDevice.Reset();
+}
+
+BirdGame::RenderGraph::AllocationInfo BirdGame::RenderGraphDX::GetAllocationInfo(const TextureDesc& desc) const
+{
+	const D3D12_RESOURCE_DESC resourceDesc = MakeTransientDesc(desc);
+	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = mDevice->GetResourceAllocationInfo(0, 1, &resourceDesc);
+	return { allocationInfo.SizeInBytes, allocationInfo.Alignment };
+}
+
+void BirdGame::RenderGraphDX::Prepare(const RenderGraph& graph)
+{
+	// Callers must make sure the GPU is no longer using the old transient resources
+	mTransientResources.clear();
+	mResources.assign(graph.GetResourceCount(), nullptr);
+	mTransientResources.resize(graph.GetResourceCount());
+	mTransientStates.assign(graph.GetResourceCount(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	// Only grow the heap, graphs tend to go back and forth between similar sizes
+	if (graph.GetTransientHeapSize() > mTransientHeapSize)
+	{
+		if (mTransientHeap != nullptr)
+		{
+			MemoryTracker::UntrackResource(mTransientHeap.Get());
+		}
+
+		D3D12_HEAP_DESC heapDesc = {};
+		heapDesc.SizeInBytes = graph.GetTransientHeapSize();
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		CheckHResult(mDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(&mTransientHeap)));
+		mTransientHeap->SetName(L"RenderGraphTransientHeap");
+
+		mTransientHeapSize = heapDesc.SizeInBytes;
+		MemoryTracker::TrackResource(mTransientHeap.Get(), "RenderGraphTransientHeap", MemoryTag::Renderer, mTransientHeapSize);
+	}
+
+	for (RenderGraphResource resource = 0; resource < graph.GetResourceCount(); ++resource)
+	{
+		const RenderGraph::TransientPlacement& placement = graph.GetTransientPlacement(resource);
+		if (!graph.IsTransient(resource) || placement.size == 0)
+		{
+			continue;
+		}
+
+		const D3D12_RESOURCE_DESC resourceDesc = MakeTransientDesc(graph.GetTransientDesc(resource));
+		CheckHResult(mDevice->CreatePlacedResource(
+			mTransientHeap.Get(),
+			placement.offset,
+			&resourceDesc,
+			mTransientStates[resource],
+			nullptr,
+			IID_PPV_ARGS(&mTransientResources[resource])));
+
+		mResources[resource] = mTransientResources[resource].Get();
+	}
+}
+
+void BirdGame::RenderGraphDX::SetImportedResource(RenderGraphResource resource, ID3D12Resource* d3dResource)
+{
+	mResources[resource] = d3dResource;
+}
+
+void BirdGame::RenderGraphDX::Execute(const RenderGraph& graph, const CommandListSource& commandList, IProfiler& profiler)
+{
+	for (const RenderGraph::CompiledPass& compiledPass : graph.GetCompiledPasses())
+	{
+		ProfileScope scope(profiler, graph.GetPassName(compiledPass.pass));
+		RecordBarriers(graph, compiledPass.firstBarrier, compiledPass.barrierCount, commandList());
+		graph.ExecutePass(compiledPass.pass);
+	}
+
+	RecordBarriers(graph, graph.GetFinalBarrierStart(), graph.GetFinalBarrierCount(), commandList());
+}
+
+void BirdGame::RenderGraphDX::RecordBarriers(const RenderGraph& graph, uint32_t firstBarrier, uint32_t barrierCount, ID3D12GraphicsCommandList* commandList)
+{
+	mBarrierScratch.clear();
+	mDiscardScratch.clear();
+
+	for (uint32_t i = firstBarrier; i < firstBarrier + barrierCount; ++i)
+	{
+		const RenderGraph::Barrier& barrier = graph.GetBarriers()[i];
+		ID3D12Resource* resource = mResources[barrier.resource];
+		assert(resource != nullptr && "Imported resource was not bound");
+
+		D3D12_RESOURCE_STATES before = ToD3D12ResourceStates(barrier.before);
+		const D3D12_RESOURCE_STATES after = ToD3D12ResourceStates(barrier.after);
+
+		if (graph.IsTransient(barrier.resource))
+		{
+			if (barrier.before == ResourceState::Undefined)
+			{
+				// The memory may have belonged to another transient until now. Aliased render targets have to be
+				// discarded (or cleared) before use, which the pass is free to do again if it wants a clear.
+				mBarrierScratch.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource));
+				if (barrier.after == ResourceState::RenderTarget)
+				{
+					mDiscardScratch.push_back(resource);
+				}
+			}
+
+			before = mTransientStates[barrier.resource];
+			mTransientStates[barrier.resource] = after;
+		}
+
+		if (before != after)
+		{
+			mBarrierScratch.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, before, after));
+		}
+	}
+
+	if (!mBarrierScratch.empty())
+	{
+		commandList->ResourceBarrier(static_cast<UINT>(mBarrierScratch.size()), mBarrierScratch.data());
+	}
+
+	for (ID3D12Resource* resource : mDiscardScratch)
+	{
+		commandList->DiscardResource(resource, nullptr);
+	}
+}
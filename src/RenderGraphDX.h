@@ -0,0 +1,62 @@
+#pragma once
+
+#include "RenderGraph.h"
+
+#include <functional>
+#include <vector>
+
+namespace BirdGame
+{
+	class IProfiler;
+
+	D3D12_RESOURCE_STATES ToD3D12ResourceStates(ResourceState state);
+
+	// Executes a compiled RenderGraph on a D3D12 command list. Owns the heap transient resources are placed in
+	// and turns the graph's barriers into one batched ResourceBarrier call per pass.
+	class RenderGraphDX final
+	{
+	public:
+		RenderGraphDX();
+		~RenderGraphDX();
+
+		void Initialize(ID3D12Device* device);
+		void Destroy();
+
+		// What a transient texture needs from the heap. Pass this to RenderGraph::Compile().
+		RenderGraph::AllocationInfo GetAllocationInfo(const TextureDesc& desc) const;
+
+		// (Re)creates the transient heap and placed resources. Call after every RenderGraph::Compile().
+		void Prepare(const RenderGraph& graph);
+
+		// Imported resources have to be bound before every Execute(), e.g. to the current back buffer
+		void SetImportedResource(RenderGraphResource resource, ID3D12Resource* d3dResource);
+
+		// The resource backing a graph resource, for use inside pass callbacks
+		ID3D12Resource* GetResource(RenderGraphResource resource) const { return mResources[resource]; }
+
+		// Passes may move recording on to another command list, e.g. to put lists recorded on other threads in
+		// between, so the list barriers go into is fetched again for every batch
+		using CommandListSource = std::function<ID3D12GraphicsCommandList*()>;
+		// Every pass is timed as a profiler scope named after the pass
+		void Execute(const RenderGraph& graph, const CommandListSource& commandList, IProfiler& profiler);
+
+	private:
+		RenderGraphDX(const RenderGraphDX&) = delete;
+
+		void RecordBarriers(const RenderGraph& graph, uint32_t firstBarrier, uint32_t barrierCount, ID3D12GraphicsCommandList* commandList);
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D12Heap> mTransientHeap;
+		uint64_t mTransientHeapSize;
+
+		// Indexed by RenderGraphResource
+		std::vector<ID3D12Resource*> mResources;
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mTransientResources;
+
+		// Placed resources keep their state across frames, so the first barrier of a frame has to start from it
+		std::vector<D3D12_RESOURCE_STATES> mTransientStates;
+
+		std::vector<D3D12_RESOURCE_BARRIER> mBarrierScratch;
+		std::vector<ID3D12Resource*> mDiscardScratch;
+	};
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BirdGame
+{
+	// Identifies a texture owned by the renderer
+	using TextureHandle = uint32_t;
+
+	// The checkerboard texture the renderer creates at startup until we load real assets
+	constexpr TextureHandle kDefaultTexture = 0;
+
+	struct Rect
+	{
+		float x;
+		float y;
+		float width;
+		float height;
+	};
+
+	// 8 bits per channel, laid out to match DXGI_FORMAT_R8G8B8A8_UNORM
+	struct Color
+	{
+		uint8_t r;
+		uint8_t g;
+		uint8_t b;
+		uint8_t a;
+	};
+
+	constexpr Color kWhite = { 0xff, 0xff, 0xff, 0xff };
+
+	enum class TextAlign : uint8_t
+	{
+		Left,
+		Center,
+		Right
+	};
+
+	struct TextStyle
+	{
+		float size;       // Font size in pixels
+		float wrapWidth;  // Lines break at spaces to stay within this many pixels, 0 to only break at '\n'
+		TextAlign align;  // Within wrapWidth, or within the widest line when not wrapping
+	};
+
+	enum class TextureFormat : uint8_t
+	{
+		RGBA8
+	};
+
+	struct TextureDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		TextureFormat format;
+	};
+
+	// Backend-neutral resource states. Read states can be combined, e.g. ShaderResource | CopySource.
+	enum class ResourceState : uint32_t
+	{
+		Undefined = 0,          // Contents don't matter, e.g. a transient resource before its first use
+		Present = 1 << 0,
+		RenderTarget = 1 << 1,
+		ShaderResource = 1 << 2,
+		CopySource = 1 << 3,
+		CopyDest = 1 << 4,
+		UnorderedAccess = 1 << 5,
+		VertexBuffer = 1 << 6,
+		IndexBuffer = 1 << 7
+	};
+
+	constexpr ResourceState operator|(ResourceState a, ResourceState b) { return static_cast<ResourceState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b)); }
+	constexpr ResourceState operator&(ResourceState a, ResourceState b) { return static_cast<ResourceState>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b)); }
+
+	constexpr bool HasAllStates(ResourceState state, ResourceState required) { return (state & required) == required; }
+
+	// States the GPU writes to can't be combined with anything else
+	constexpr bool IsWriteState(ResourceState state)
+	{
+		return (state & (ResourceState::RenderTarget | ResourceState::CopyDest | ResourceState::UnorderedAccess)) != ResourceState::Undefined;
+	}
+}
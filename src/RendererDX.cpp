@@ -1,8 +1,42 @@
 #include "pch.h"
 #include "RendererDX.h"
 
+#include "DescriptorHeapDX.h"
+#include "DXHelpers.h"
+#include "FenceDX.h"
+#include "FrameCapture.h"
+#include "FrameScheduler.h"
+#include "GlyphAtlas.h"
+#include "GpuProfilerDX.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "MemoryReservation.h"
+#include "MemoryTracker.h"
+#include "MipGenerator.h"
+#include "ParallelDrawRecorder.h"
+#include "PipelineCacheDX.h"
+#include "RenderCommandBuffer.h"
+#include "RenderGraph.h"
+#include "RenderGraphDX.h"
+#include "ResolutionController.h"
+#include "ResourceStateRegistryDX.h"
+#include "ResourceStateTrackerDX.h"
+#include "ShaderHotReloaderDX.h"
+#include "ShaderLibraryDX.h"
+#include "SpriteBatch.h"
+#include "TextLayout.h"
+#include "TextureCompression.h"
+#include "TextureTable.h"
+#include "TrueTypeFont.h"
+#include "UploadRingBuffer.h"
 #include "Window.h"
 
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
 // Note that while ComPtr is used to manage the lifetime of resources on the CPU,
 // it has no understanding of the lifetime of resources on the GPU. Apps must account
 // for the GPU lifetime of resources to avoid destroying objects that may still be
@@ -12,28 +46,95 @@ using Microsoft::WRL::ComPtr;
 
 namespace
 {
-	constexpr uint32_t kNumBufferFrames = 2;
+	constexpr uint32_t kMaxFramesInFlight = BirdGame::FrameScheduler::kMaxFramesInFlight;
 	constexpr uint32_t kTextureWidth = 256;
 	constexpr uint32_t kTextureHeight = 256;
 	constexpr uint32_t kTexturePixelSize = 4;    // The number of bytes used to represent a pixel in the texture.
+	constexpr size_t kScratchArenaSize = 32 * 1024 * 1024; // Temporary CPU side data such as texture data waiting to be uploaded
+	constexpr uint32_t kNumPersistentSrvDescriptors = 4096;  // Texture views
+	constexpr uint32_t kNumTransientSrvDescriptors = 4096;   // Per-frame descriptor tables
+	constexpr uint32_t kMaxTextures = 1024;                  // Size of the bindless texture table, part of the persistent SRVs
+	constexpr uint32_t kNumRtvDescriptors = 64;
+	constexpr uint32_t kQuadVertexCount = 4;
+	constexpr uint32_t kQuadIndexCount = 6;
+	constexpr uint32_t kMaxIndexedQuads = 16384; // 4 vertices each, so every index fits in 16 bits
+	constexpr uint32_t kMaxSprites = 65536;  // Per frame
+	constexpr uint32_t kMaxDrawPackets = 4096;
+	constexpr uint32_t kMaxRecordingThreads = 8;         // Including the render thread
+	constexpr uint32_t kMaxDrawCommandLists = 16;        // A few more than threads so uneven chunks still balance out
+	constexpr uint32_t kMinSpritesPerCommandList = 1024; // Below this another command list costs more than it saves
+	constexpr const char* kPipelineCachePath = "pipeline_cache.bin";
+	constexpr uint64_t kUploadBufferSize = 16 * 1024 * 1024; // Shared by all CPU -> GPU traffic: staging copies and per-frame data
+	constexpr const char* kCompiledShaderDirectory = "assets/shaders/compiled";
+	constexpr float kTargetGpuFrameMilliseconds = 14.0f; // Dynamic resolution aims for 60 Hz with some headroom
+	constexpr uint32_t kFirstAtlasCodepoint = 32;        // The glyph atlas holds printable ASCII
+	constexpr uint32_t kLastAtlasCodepoint = 126;
+	constexpr uint32_t kMaxCachedTextRuns = 256;
+	constexpr uint32_t kCaptureBufferCount = 4; // Frames waiting for the capture encoder before new ones are dropped
+	constexpr BirdGame::CompressionQuality kTextureCompressionQuality = BirdGame::CompressionQuality::Normal; // Textures are compressed at load
+
+	// The game doesn't ship a font yet, so fall back to ones every Windows install has
+	constexpr const char* kFontPaths[] = { "assets/fonts/default.ttf", "C:/Windows/Fonts/segoeui.ttf", "C:/Windows/Fonts/arial.ttf" };
+
+	// Every shader program the renderer uses. RendererDX::CompileShaders() builds all of them.
+	constexpr BirdGame::ShaderProgramDesc kSpriteVertexShader = { "assets/shaders/shaders.hlsl", "VSMain", "vs_5_1", nullptr, 0 };
+	constexpr BirdGame::ShaderProgramDesc kSpritePixelShader = { "assets/shaders/shaders.hlsl", "PSMain", "ps_5_1", nullptr, 0 };
+	constexpr BirdGame::ShaderProgramDesc kTextPixelShader = { "assets/shaders/shaders.hlsl", "PSText", "ps_5_1", nullptr, 0 };
+	constexpr BirdGame::ShaderProgramDesc kUpscaleVertexShader = { "assets/shaders/upscale.hlsl", "VSMain", "vs_5_1", nullptr, 0 };
+	constexpr BirdGame::ShaderProgramDesc kUpscalePixelShader = { "assets/shaders/upscale.hlsl", "PSMain", "ps_5_1", nullptr, 0 };
+	constexpr BirdGame::ShaderProgramDesc kShaderPrograms[] = { kSpriteVertexShader, kSpritePixelShader, kTextPixelShader, kUpscaleVertexShader, kUpscalePixelShader };
+
+	// Vertex input layout of the sprite pipeline. Slot 0 is the unit quad, slot 1 holds one SpriteInstance per instance.
+	const D3D12_INPUT_ELEMENT_DESC kSpriteInputLayout[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(BirdGame::SpriteInstance, rect), D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "UVRECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(BirdGame::SpriteInstance, uv), D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, offsetof(BirdGame::SpriteInstance, color), D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{ "TEXTURE", 0, DXGI_FORMAT_R32_UINT, 1, offsetof(BirdGame::SpriteInstance, texture), D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+	};
+
+	// Two triangles per quad over the vertices of quad i at 4i: top-left, top-right, bottom-left, bottom-right
+	void GenerateQuadIndices(uint16_t* indices, uint32_t quadCount)
+	{
+		static_assert(kMaxIndexedQuads * kQuadVertexCount <= UINT16_MAX + 1, "Quad indices have to fit in 16 bits");
+		assert(quadCount <= kMaxIndexedQuads);
+
+		for (uint32_t quad = 0; quad < quadCount; ++quad)
+		{
+			const uint16_t first = static_cast<uint16_t>(quad * kQuadVertexCount);
+			uint16_t* quadIndices = indices + quad * kQuadIndexCount;
+			quadIndices[0] = first;
+			quadIndices[1] = first + 1;
+			quadIndices[2] = first + 2;
+			quadIndices[3] = first + 2;
+			quadIndices[4] = first + 1;
+			quadIndices[5] = first + 3;
+		}
+	}
+
+	using TextureData = std::vector<uint8_t, BirdGame::ArenaAllocator<uint8_t>>;
 
-	void CheckHResult(HRESULT result)
+	DXGI_FORMAT GetTextureFormat(BirdGame::TextureCompression compression)
 	{
-		if (FAILED(result))
+		switch (compression)
 		{
-			throw std::exception("borked");
+			case BirdGame::TextureCompression::BC1: return DXGI_FORMAT_BC1_UNORM;
+			case BirdGame::TextureCompression::BC3: return DXGI_FORMAT_BC3_UNORM;
+			case BirdGame::TextureCompression::BC7: return DXGI_FORMAT_BC7_UNORM;
+			default: return DXGI_FORMAT_R8G8B8A8_UNORM;
 		}
 	}
 
 	// Generate a simple black and white checkerboard texture.
-	std::vector<uint8_t> GenerateTextureData()
+	TextureData GenerateTextureData(BirdGame::MemoryArena& arena)
 	{
 		const uint32_t rowPitch = kTextureWidth * kTexturePixelSize;
 		const uint32_t cellPitch = rowPitch >> 3;        // The width of a cell in the checkboard texture.
 		const uint32_t cellHeight = kTextureWidth >> 3;    // The height of a cell in the checkerboard texture.
 		const uint32_t textureSize = rowPitch * kTextureHeight;
 
-		std::vector<uint8_t> data(textureSize);
+		TextureData data(textureSize, 0, TextureData::allocator_type(arena));
 		uint8_t* pData = &data[0];
 
 		for (uint32_t n = 0; n < textureSize; n += kTexturePixelSize)
@@ -72,14 +173,14 @@ namespace BirdGame
 	class RendererImpl final
 	{
 	private:
+		// Corner of the unit quad that every sprite instance is expanded from
 		struct Vertex
 		{
-			DirectX::XMFLOAT3 position;
-			DirectX::XMFLOAT2 uv;
+			DirectX::XMFLOAT2 corner;
 		};
 
 	public:
-		RendererImpl();
+		RendererImpl(MemoryArena& scratchArena, const RendererDX::Settings& settings);
 		~RendererImpl();
 
 		// Initialization methods
@@ -87,15 +188,25 @@ namespace BirdGame
 		void LoadAssets();
 
 		// Render methods
+		// Waits until the GPU is done with the next frame slot. Everything between BeginFrame() and EndFrame()
+		// records into that slot's command allocator.
+		void BeginFrame();
 		void PopulateCommandList();
 		void CloseAndExecuteCommandList();
 		void Present();
+		void EndFrame();
 
-		// TODO apparently this is bad, look into the frame buffer DX sample project
-		void WaitForPreviousFrame();
+		// Blocks until the GPU has finished all submitted work
+		void WaitForGpu();
 
 		void Destroy();
 
+		void SubmitSprite(TextureHandle texture, const Rect& rect, const Rect& uv, Color color, uint8_t layer);
+		void SubmitText(const char* text, const TextStyle& style, float x, float y, Color color, uint8_t layer);
+
+		FrameCapture& GetFrameCapture() { return mFrameCapture; }
+		IProfiler& GetProfiler() { return mProfiler; }
+
 	private:
 		void Initialize(uint32_t width, uint32_t height);
 		void CreateDevice();
@@ -103,10 +214,64 @@ namespace BirdGame
 		void CreateSwapChain(HWND hwnd);
 
 		void LoadShaders();
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC GetSpritePipelineDesc(const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader) const;
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC GetUpscalePipelineDesc(const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader) const;
+
+		// The pipeline state used to draw with, or to record a reloaded version into
+		ComPtr<ID3D12PipelineState>& GetPipelineState(PipelineId pipeline);
+
+		// Swaps in pipelines the hot reloader rebuilt. Replaced pipelines are released once the GPU is done with them.
+		void UpdateHotReload();
+
+		// For the hot reloader. Returns null if the pipeline can't be created.
+		ComPtr<ID3D12PipelineState> CreateUncachedPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc) const;
+
+		// Feeds the latest GPU frame time to mResolutionController and sizes the scene viewport to match
+		void UpdateResolution();
 		void CreateCommandList();
-		void CreateVertexBuffer();
-		void CreateTexture();
-		void CreateFence();
+		void CreateUploadBuffer();
+		void CreateQuadBuffers();
+
+		// Creates a buffer in a default heap and records a copy of data into it through the upload ring. The buffer
+		// is registered with the state tracker and only transitioned to state when something first needs it.
+		TrackedResource CreateStaticBuffer(const void* data, uint64_t size, uint64_t alignment, ResourceState state, ComPtr<ID3D12Resource>& buffer, const wchar_t* debugName, const char* name);
+
+		// Creates a texture in a default heap from RGBA8 pixels, with the mip chain described by mipSettings and every
+		// level block compressed unless compression is None. Records the upload of all levels through the upload ring
+		// and gives the texture a slot in the texture table. It's registered with the state tracker like static buffers.
+		TextureHandle CreateTexture(const uint8_t* pixels, uint32_t width, uint32_t height, const MipGenerator::Settings& mipSettings, TextureCompression compression, ComPtr<ID3D12Resource>& texture, const wchar_t* debugName, const char* name);
+		void CreateDefaultTexture();
+
+		// Renders the glyph atlas from the first font in kFontPaths that loads. Without one text isn't drawn.
+		void LoadFont();
+		void BuildRenderGraph();
+
+		// Pass callbacks, called by mRenderGraphExecutor after the pass's barriers have been recorded
+		void RecordSpritePass();
+		void RecordUpscalePass();
+		void RecordCapturePass();
+
+		// Hands the back buffer copy made in frameSlot to mFrameCapture. The GPU has to be done with that frame.
+		void ResolveCapture(uint32_t frameSlot);
+
+		// Replays the sorted render command stream, split across mDrawCommandLists and recorded in parallel
+		void ExecuteRenderCommands();
+
+		// Sets up what every command list of the frame needs before recording: root signature and descriptor heaps.
+		// Command lists don't inherit any state from the lists executed before them.
+		void BeginCommandList(ID3D12GraphicsCommandList* commandList);
+
+		// Queues the list being recorded and the first listCount draw lists for submission, in that order, and
+		// continues recording in mTailCommandList. Can only happen once per frame.
+		void SubmitDrawCommandLists(uint32_t listCount);
+
+		// Register a resource with the MemoryTracker so it shows up in the shutdown report if it is never released
+		void TrackResource(ID3D12Resource* resource, const wchar_t* debugName, const char* name, MemoryTag tag);
+		void ReleaseResource(ComPtr<ID3D12Resource>& resource);
+
+		MemoryArena& mScratchArena;
+		bool mDevelopmentMode;
+		std::string mSourceRoot; // See RendererDX::Settings
 
 		CD3DX12_VIEWPORT mViewport;
 		CD3DX12_RECT mScissorRect;
@@ -114,37 +279,158 @@ namespace BirdGame
 		ComPtr<ID3D12Device> mDevice;
 		ComPtr<ID3D12CommandQueue> mCommandQueue;
 		ComPtr<IDXGISwapChain3> mSwapChain;
-		ComPtr<ID3D12CommandAllocator> mCommandAllocator;
+		ComPtr<ID3D12CommandAllocator> mCommandAllocators[kMaxFramesInFlight];
 
 		ComPtr<ID3D12RootSignature> mRootSignature;
 
-		ComPtr<ID3D12DescriptorHeap> mRtvHeap;
-		ComPtr<ID3D12DescriptorHeap> mSrvHeap;
-		uint32_t mRtvDescriptorSize;
+		DescriptorHeapDX mRtvDescriptors;
+		DescriptorHeapDX mSrvDescriptors;
+		uint32_t mRenderTargetViews[kMaxFramesInFlight];
+
+		// Every texture's view lives in one contiguous range starting at mTextureTableBase, at its TextureTable index
+		TextureTable mTextureTable;
+		uint32_t mTextureTableBase;
+		std::vector<TrackedResource> mTextureStates; // Indexed by TextureTable index
+		bool mLoggedInvalidTexture; // Invalid handles are logged once, not every frame they're drawn with
 
-		ComPtr<ID3D12Resource> mRenderTargets[kNumBufferFrames];
+		ComPtr<ID3D12Resource> mRenderTargets[kMaxFramesInFlight];
 		ComPtr<ID3D12GraphicsCommandList> mCommandList;
 
+		// Sprite draws are recorded on mJobSystem's threads, one list per chunk of the draw stream. Every
+		// recording thread has its own allocator per frame slot. The frame is submitted in one go: mCommandList,
+		// the draw lists in chunk order, then mTailCommandList with everything recorded after the draws.
+		JobSystem mJobSystem;
+		ParallelDrawRecorder mDrawRecorder;
+		ComPtr<ID3D12CommandAllocator> mDrawAllocators[kMaxFramesInFlight][kMaxRecordingThreads];
+		ComPtr<ID3D12GraphicsCommandList> mDrawCommandLists[kMaxDrawCommandLists];
+		ComPtr<ID3D12GraphicsCommandList> mTailCommandList;
+		ID3D12GraphicsCommandList* mRecordingList; // Where the render thread records right now
+		std::vector<ID3D12CommandList*> mSubmitLists; // Closed lists of this frame, in submission order
+
+		// The frame's lists only say which states they need resources in. The transitions from the states they
+		// are actually in are resolved at submit time and go into mPatchCommandList, which executes before them.
+		ResourceStateRegistryDX mResourceStates;
+		ResourceStateTrackerDX mStateTracker;
+		ComPtr<ID3D12GraphicsCommandList> mPatchCommandList;
+
+		ShaderLibraryDX mShaderLibrary;
+		PipelineCacheDX mPipelineCache;
 		ComPtr<ID3D12PipelineState> mPipelineState;
+		ComPtr<ID3D12PipelineState> mTextPipelineState;
+		ComPtr<ID3D12PipelineState> mUpscalePipelineState;
+
+		// Development mode only. Pipelines replaced by a reload stay alive until the last frame that used them completes.
+		struct RetiredPipeline
+		{
+			uint64_t fenceValue;
+			ComPtr<ID3D12PipelineState> pipelineState;
+		};
+		ShaderHotReloaderDX mShaderReloader;
+		std::vector<ShaderHotReloaderDX::ReloadedPipeline> mReloadedPipelines;
+		std::deque<RetiredPipeline> mRetiredPipelines;
 
 		// App resources.
+		// The unit quad and an index buffer with two triangles for each of kMaxIndexedQuads quads, shared by
+		// every quad draw. Both never change after load.
 		ComPtr<ID3D12Resource> mVertexBuffer;
 		D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+		TrackedResource mVertexBufferState;
+		ComPtr<ID3D12Resource> mIndexBuffer;
+		D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+		TrackedResource mIndexBufferState;
 		ComPtr<ID3D12Resource> mTexture;
-
+		MipGenerator mMipGenerator;
+
+		// Text is drawn as sprites with the text pipeline, one quad per glyph from a distance field atlas.
+		// Laid out text is cached, so text that doesn't change is only copied into the sprite batch.
+		GlyphAtlas mGlyphAtlas;
+		TextLayout mTextLayout;
+		ComPtr<ID3D12Resource> mFontResource;
+		TextureHandle mFontTexture;
+
+		// One persistently mapped upload heap, sub-allocated as a ring. Regions are handed back once the
+		// fence value of the frame that used them has completed.
+		ComPtr<ID3D12Resource> mUploadBuffer;
+		UploadRingBuffer mUploadRing;
+
+		SpriteBatch mSpriteBatch;
+		RenderCommandBuffer mRenderCommands;
+
+		// The frame is built once at load time; only the imported back buffer changes from frame to frame
+		RenderGraph mRenderGraph;
+		RenderGraphDX mRenderGraphExecutor;
+		RenderGraphResource mBackBufferResource;
+
+		// Dynamic resolution. Sprites are drawn into the top left mSceneViewport of a scene target sized for the
+		// largest scale, which the upscale pass stretches over the back buffer, so scale changes never have to
+		// reallocate anything. Sprite coordinates stay in window pixels, the viewport does the scaling.
+		ResolutionController mResolutionController;
+		uint64_t mLastTimedFrame;
+		RenderGraphResource mSceneResource;
+		uint32_t mSceneWidth;
+		uint32_t mSceneHeight;
+		uint32_t mSceneRenderTargetView;
+		uint32_t mSceneShaderResourceView;
+		CD3DX12_VIEWPORT mSceneViewport;
+		CD3DX12_RECT mSceneScissorRect;
+
+		// There are as many back buffers as frames in flight. mFrameIndex is the current back buffer,
+		// mFrameSlot the frame slot being recorded; the two don't have to match.
+		FenceDX mFence;
+		FrameScheduler mFrameScheduler;
 		uint32_t mFrameIndex;
-		ComPtr<ID3D12Fence> mFence;
-		HANDLE mFenceEvent;
-		uint64_t mFenceValue;
+		uint32_t mFrameSlot;
+
+		// Times the frame and every render graph pass on the GPU
+		GpuProfilerDX mProfiler;
+
+		// Frame capture, only part of the graph when enabled in the settings. The capture pass copies the back
+		// buffer into the frame slot's readback buffer, which is read once the slot comes around again, so the
+		// CPU never waits for the copy. Readback buffers are created on first use.
+		bool mFrameCaptureEnabled;
+		FrameCapture mFrameCapture;
+		ComPtr<ID3D12Resource> mReadbackBuffers[kMaxFramesInFlight];
+		FrameCapture::Request mReadbackRequests[kMaxFramesInFlight];
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT mReadbackFootprint;
 	};
 }
 
-BirdGame::RendererImpl::RendererImpl() :
-	mRtvDescriptorSize(0),
+BirdGame::RendererImpl::RendererImpl(MemoryArena& scratchArena, const RendererDX::Settings& settings) :
+	mScratchArena(scratchArena),
+	mDevelopmentMode(settings.developmentMode),
+	mSourceRoot(settings.sourceRoot),
+	mRtvDescriptors(kNumRtvDescriptors, 0),
+	mSrvDescriptors(kNumPersistentSrvDescriptors, kNumTransientSrvDescriptors),
+	mRenderTargetViews(),
+	mTextureTable(kMaxTextures),
+	mTextureTableBase(0),
+	mLoggedInvalidTexture(false),
+	mJobSystem(JobSystem::GetDefaultWorkerCount(kMaxRecordingThreads - 1)),
+	mDrawRecorder(mJobSystem, kMaxDrawCommandLists, kMinSpritesPerCommandList),
+	mRecordingList(nullptr),
+	mStateTracker(mResourceStates),
 	mVertexBufferView(),
+	mVertexBufferState(0),
+	mIndexBufferView(),
+	mIndexBufferState(0),
+	mTextLayout(kMaxCachedTextRuns),
+	mFontTexture(TextureTable::kInvalidHandle),
+	mSpriteBatch(kMaxSprites),
+	mRenderCommands(kMaxDrawPackets),
+	mBackBufferResource(0),
+	mResolutionController({ kTargetGpuFrameMilliseconds, settings.minResolutionScale, settings.maxResolutionScale, kMaxFramesInFlight + 1 }),
+	mLastTimedFrame(UINT64_MAX),
+	mSceneResource(0),
+	mSceneWidth(0),
+	mSceneHeight(0),
+	mSceneRenderTargetView(0),
+	mSceneShaderResourceView(0),
+	mFrameScheduler(mFence, settings.framesInFlight),
 	mFrameIndex(0),
-	mFenceEvent(NULL),
-	mFenceValue(0)
+	mFrameSlot(0),
+	mFrameCaptureEnabled(settings.frameCapture),
+	mFrameCapture(kCaptureBufferCount),
+	mReadbackFootprint()
 {
 }
 
@@ -161,62 +447,313 @@ void BirdGame::RendererImpl::LoadPipeline(HWND hwnd, uint32_t width, uint32_t he
 	CreateDevice();
 	CreateCommandQueue();
 	CreateSwapChain(hwnd);
+	mFence.Initialize(mDevice.Get(), mCommandQueue.Get());
+	mProfiler.Initialize(mDevice.Get(), mCommandQueue.Get(), [this]() { return mRecordingList; });
 }
 
 void BirdGame::RendererImpl::LoadAssets()
 {
+	// Shaders are compiled offline by the post-build step (RendererDX::CompileShaders()) and pipelines compiled
+	// on a previous run come out of the cache. New pipelines are written back right away.
+	mShaderLibrary.Initialize(kCompiledShaderDirectory, mDevelopmentMode);
+	mPipelineCache.Initialize(mDevice.Get(), kPipelineCachePath);
 	LoadShaders();
+	mPipelineCache.Save();
+
+	// Edited shaders are rebuilt in the background. Reloaded pipelines skip the pipeline cache, they're throwaway.
+	if (mDevelopmentMode)
+	{
+		mShaderReloader.AddPipeline(static_cast<uint32_t>(PipelineId::Sprite), kSpriteVertexShader, kSpritePixelShader,
+			[this](const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader)
+		{
+			return CreateUncachedPipeline(GetSpritePipelineDesc(vertexShader, pixelShader));
+		});
+		mShaderReloader.AddPipeline(static_cast<uint32_t>(PipelineId::Text), kSpriteVertexShader, kTextPixelShader,
+			[this](const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader)
+		{
+			return CreateUncachedPipeline(GetSpritePipelineDesc(vertexShader, pixelShader));
+		});
+		mShaderReloader.AddPipeline(static_cast<uint32_t>(PipelineId::Upscale), kUpscaleVertexShader, kUpscalePixelShader,
+			[this](const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader)
+		{
+			return CreateUncachedPipeline(GetUpscalePipelineDesc(vertexShader, pixelShader));
+		});
+		mShaderReloader.Start(mSourceRoot);
+	}
+
 	CreateCommandList();
-	CreateVertexBuffer(); // Set up the vertex buffers here for now since this shader is very basic and not doing anything interesting
-	CreateTexture();
+	CreateUploadBuffer();
+	CreateQuadBuffers();
+	CreateDefaultTexture();
+	LoadFont();
+	BuildRenderGraph();
 	CloseAndExecuteCommandList(); // Close the command list and execute it to begin the initial GPU setup.
-	CreateFence();
 }
 
-void BirdGame::RendererImpl::PopulateCommandList()
+void BirdGame::RendererImpl::BeginFrame()
 {
+	mFrameSlot = mFrameScheduler.BeginFrame();
+	ResolveCapture(mFrameSlot);
+
+	// The GPU has passed the fence of every frame up to the one that last used this slot
+	const uint64_t completedFence = mFrameScheduler.GetCompletedFenceValue();
+	mUploadRing.Retire(completedFence);
+	mSrvDescriptors.Retire(completedFence);
+	mTextureTable.Retire(completedFence);
+	mRtvDescriptors.Retire(completedFence);
+
+	if (mDevelopmentMode)
+	{
+		UpdateHotReload();
+	}
+
 	// Command list allocators can only be reset when the associated 
-	// command lists have finished execution on the GPU; apps should use 
-	// fences to determine GPU execution progress.
-	CheckHResult(mCommandAllocator->Reset());
+	// command lists have finished execution on the GPU, which BeginFrame() has waited for.
+	CheckHResult(mCommandAllocators[mFrameSlot]->Reset());
+	for (uint32_t thread = 0; thread < mJobSystem.GetThreadCount(); ++thread)
+	{
+		CheckHResult(mDrawAllocators[mFrameSlot][thread]->Reset());
+	}
+}
+
+void BirdGame::RendererImpl::UpdateHotReload()
+{
+	const uint64_t completedFence = mFrameScheduler.GetCompletedFenceValue();
+	while (!mRetiredPipelines.empty() && mRetiredPipelines.front().fenceValue <= completedFence)
+	{
+		mRetiredPipelines.pop_front();
+	}
+
+	// Nothing has been recorded for this frame yet, so every frame up to the last signalled one may still
+	// use the old pipeline and every frame from now on uses the new one
+	mReloadedPipelines.clear();
+	mShaderReloader.Update(mReloadedPipelines);
+	for (ShaderHotReloaderDX::ReloadedPipeline& reloaded : mReloadedPipelines)
+	{
+		ComPtr<ID3D12PipelineState>& pipelineState = GetPipelineState(static_cast<PipelineId>(reloaded.id));
+		mRetiredPipelines.push_back({ mFrameScheduler.GetLastSignalledFenceValue(), std::move(pipelineState) });
+		pipelineState = std::move(reloaded.pipelineState);
+		OutputDebugStringA("Shaders reloaded\n");
+	}
+}
+
+ComPtr<ID3D12PipelineState>& BirdGame::RendererImpl::GetPipelineState(PipelineId pipeline)
+{
+	switch (pipeline)
+	{
+		case PipelineId::Text:
+			return mTextPipelineState;
+		case PipelineId::Upscale:
+			return mUpscalePipelineState;
+		default:
+			assert(pipeline == PipelineId::Sprite);
+			return mPipelineState;
+	}
+}
+
+ComPtr<ID3D12PipelineState> BirdGame::RendererImpl::CreateUncachedPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc) const
+{
+	ComPtr<ID3D12PipelineState> pipelineState;
+	if (FAILED(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState))))
+	{
+		return ComPtr<ID3D12PipelineState>();
+	}
+	return pipelineState;
+}
+
+void BirdGame::RendererImpl::UpdateResolution()
+{
+	// GPU timings arrive a few frames late, only new ones count. The first scope is the whole frame.
+	const ProfileFrame* gpuFrame = mProfiler.GetLatestFrame();
+	if (gpuFrame != nullptr && !gpuFrame->scopes.empty() && gpuFrame->frameNumber != mLastTimedFrame)
+	{
+		mLastTimedFrame = gpuFrame->frameNumber;
+		mResolutionController.Update(gpuFrame->scopes[0].milliseconds);
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	mResolutionController.GetScaledSize(static_cast<uint32_t>(mViewport.Width), static_cast<uint32_t>(mViewport.Height), width, height);
+	width = std::min(width, mSceneWidth);
+	height = std::min(height, mSceneHeight);
+
+	mSceneViewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+	mSceneScissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(width), static_cast<LONG>(height));
+}
+
+void BirdGame::RendererImpl::PopulateCommandList()
+{
+	// Profiler frames are opened here rather than in BeginFrame(): the setup frame Initialize() submits is never
+	// rendered, so nothing would close its profiler frame. This also picks up the GPU timings of this slot's last
+	// frame before the resolution is chosen from them.
+	mProfiler.BeginFrame(mFrameSlot);
+	UpdateResolution();
 
 	// However, when ExecuteCommandList() is called on a particular command 
 	// list, that command list can then be reset at any time and must be before 
 	// re-recording.
-	CheckHResult(mCommandList->Reset(mCommandAllocator.Get(), mPipelineState.Get()));
+	CheckHResult(mCommandList->Reset(mCommandAllocators[mFrameSlot].Get(), mPipelineState.Get()));
+	mRecordingList = mCommandList.Get();
+
+	// Views created since the last frame have to reach the shader visible heap before anything uses them
+	mSrvDescriptors.FlushCopies();
 
-	// Set necessary state.
-	mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+	BeginCommandList(mCommandList.Get());
 
-	ID3D12DescriptorHeap* ppHeaps[] = { mSrvHeap.Get() };
-	mCommandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+	// The graph takes care of the back buffer's PRESENT <-> RENDER_TARGET transitions
+	mProfiler.BeginScope("Frame");
+	mRenderGraphExecutor.SetImportedResource(mBackBufferResource, mRenderTargets[mFrameIndex].Get());
+	mRenderGraphExecutor.Execute(mRenderGraph, [this]() { return mRecordingList; }, mProfiler);
+	mProfiler.EndScope();
+	mProfiler.EndFrame(mRecordingList);
+}
 
-	mCommandList->SetGraphicsRootDescriptorTable(0, mSrvHeap->GetGPUDescriptorHandleForHeapStart());
-	mCommandList->RSSetViewports(1, &mViewport);
-	mCommandList->RSSetScissorRects(1, &mScissorRect);
+void BirdGame::RendererImpl::BeginCommandList(ID3D12GraphicsCommandList* commandList)
+{
+	commandList->SetGraphicsRootSignature(mRootSignature.Get());
 
-	// Indicate that the back buffer will be used as a render target.
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRenderTargets[mFrameIndex].Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
+	ID3D12DescriptorHeap* ppHeaps[] = { mSrvDescriptors.GetHeap() };
+	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mFrameIndex, mRtvDescriptorSize);
-	mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+void BirdGame::RendererImpl::RecordSpritePass()
+{
+	const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = mRtvDescriptors.GetCpuHandle(mSceneRenderTargetView);
+	mRecordingList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
 
-	// Record commands.
+	// Only the part of the scene target in use this frame gets sampled by the upscale pass
 	const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
-	mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
-	mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
-	mCommandList->DrawInstanced(3, 1, 0, 0);
+	mRecordingList->ClearRenderTargetView(rtvHandle, clearColor, 1, &mSceneScissorRect);
+
+	// Build this frame's draw stream from the sprites in view, sort it once and replay it
+	mSpriteBatch.Build(mRenderCommands, { mViewport.TopLeftX, mViewport.TopLeftY, mViewport.Width, mViewport.Height });
+	mRenderCommands.Sort();
+	assert(mRenderCommands.Validate(mSpriteBatch.GetVisibleCount()));
+	ExecuteRenderCommands();
+	mRenderCommands.Clear();
+	mSpriteBatch.Clear();
+}
+
+void BirdGame::RendererImpl::RecordUpscalePass()
+{
+	const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = mRtvDescriptors.GetCpuHandle(mRenderTargetViews[mFrameIndex]);
+	mRecordingList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+	mRecordingList->RSSetViewports(1, &mViewport);
+	mRecordingList->RSSetScissorRects(1, &mScissorRect);
+	mRecordingList->SetPipelineState(mUpscalePipelineState.Get());
+
+	// UpscaleConstants in upscale.hlsl: the UV scale of the rendered area and the clamp half a texel inside it
+	const float upscaleConstants[4] =
+	{
+		mSceneViewport.Width / mSceneWidth,
+		mSceneViewport.Height / mSceneHeight,
+		(mSceneViewport.Width - 0.5f) / mSceneWidth,
+		(mSceneViewport.Height - 0.5f) / mSceneHeight
+	};
+	mRecordingList->SetGraphicsRoot32BitConstants(1, _countof(upscaleConstants), upscaleConstants, 0);
+	mRecordingList->SetGraphicsRootDescriptorTable(0, mSrvDescriptors.GetGpuHandle(mSceneShaderResourceView));
+
+	// A single triangle covering the screen, generated in the vertex shader
+	mRecordingList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mRecordingList->DrawInstanced(3, 1, 0, 0);
+}
+
+void BirdGame::RendererImpl::RecordCapturePass()
+{
+	// Whatever is captured is decided now, while the frame is recorded, not when its copy is read back
+	FrameCapture::Request& request = mReadbackRequests[mFrameSlot];
+	request = mFrameCapture.TakeRequest();
+	if (!request.HasFrame())
+	{
+		return;
+	}
+
+	ID3D12Resource* backBuffer = mRenderTargets[mFrameIndex].Get();
+	ComPtr<ID3D12Resource>& readbackBuffer = mReadbackBuffers[mFrameSlot];
+	if (readbackBuffer == nullptr)
+	{
+		const D3D12_RESOURCE_DESC backBufferDesc = backBuffer->GetDesc();
+		uint64_t readbackSize = 0;
+		mDevice->GetCopyableFootprints(&backBufferDesc, 0, 1, 0, &mReadbackFootprint, nullptr, nullptr, &readbackSize);
+
+		// Readback heaps can only be copied into, so the buffer stays in COPY_DEST and the state tracker never sees it
+		CheckHResult(mDevice->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(readbackSize),
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(&readbackBuffer)));
+		TrackResource(readbackBuffer.Get(), L"CaptureReadback", "mReadbackBuffers", MemoryTag::Renderer);
+	}
 
-	// Indicate that the back buffer will now be used to present.
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mRenderTargets[mFrameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+	const CD3DX12_TEXTURE_COPY_LOCATION destination(readbackBuffer.Get(), mReadbackFootprint);
+	const CD3DX12_TEXTURE_COPY_LOCATION source(backBuffer, 0);
+	mRecordingList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+}
+
+void BirdGame::RendererImpl::ResolveCapture(uint32_t frameSlot)
+{
+	FrameCapture::Request& request = mReadbackRequests[frameSlot];
+	if (request.IsEmpty())
+	{
+		return;
+	}
+
+	// Only ends a video, nothing was copied
+	if (!request.HasFrame())
+	{
+		mFrameCapture.Submit(request, nullptr, 0, 0, 0);
+		request = FrameCapture::Request();
+		return;
+	}
+
+	// FrameCapture copies the pixels out before Submit() returns, so the buffer is only mapped for that long
+	uint8_t* data = nullptr;
+	const CD3DX12_RANGE readRange(static_cast<SIZE_T>(mReadbackFootprint.Offset), static_cast<SIZE_T>(mReadbackFootprint.Offset + static_cast<uint64_t>(mReadbackFootprint.Footprint.RowPitch) * mReadbackFootprint.Footprint.Height));
+	CheckHResult(mReadbackBuffers[frameSlot]->Map(0, &readRange, reinterpret_cast<void**>(&data)));
+	mFrameCapture.Submit(request, data + mReadbackFootprint.Offset, mReadbackFootprint.Footprint.Width, mReadbackFootprint.Footprint.Height, mReadbackFootprint.Footprint.RowPitch);
+	const CD3DX12_RANGE writeRange(0, 0);
+	mReadbackBuffers[frameSlot]->Unmap(0, &writeRange);
+
+	request = FrameCapture::Request();
 }
 
 void BirdGame::RendererImpl::CloseAndExecuteCommandList()
 {
-	CheckHResult(mCommandList->Close());
-	ID3D12CommandList* ppCommandLists[] = { mCommandList.Get() };
-	mCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+	// Transitions nothing has needed yet still have to happen before the last list ends
+	mStateTracker.FlushBarriers(mRecordingList);
+	CheckHResult(mRecordingList->Close());
+	mSubmitLists.push_back(mRecordingList);
+
+	// Everything submitted before these lists is known now, and with it the states they start from
+	CheckHResult(mPatchCommandList->Reset(mCommandAllocators[mFrameSlot].Get(), nullptr));
+	if (mStateTracker.ResolveInitialBarriers(mPatchCommandList.Get()))
+	{
+		mSubmitLists.insert(mSubmitLists.begin(), mPatchCommandList.Get());
+	}
+	CheckHResult(mPatchCommandList->Close());
+
+	mCommandQueue->ExecuteCommandLists(static_cast<UINT>(mSubmitLists.size()), mSubmitLists.data());
+	mSubmitLists.clear();
+	mStateTracker.Commit();
+}
+
+void BirdGame::RendererImpl::SubmitDrawCommandLists(uint32_t listCount)
+{
+	assert(mRecordingList == mCommandList.Get() && "The draw lists can only be inserted once per frame");
+
+	CheckHResult(mRecordingList->Close());
+	mSubmitLists.push_back(mRecordingList);
+	for (uint32_t list = 0; list < listCount; ++list)
+	{
+		mSubmitLists.push_back(mDrawCommandLists[list].Get());
+	}
+
+	// mCommandList is closed now, so the tail can use the same allocator
+	CheckHResult(mTailCommandList->Reset(mCommandAllocators[mFrameSlot].Get(), mPipelineState.Get()));
+	BeginCommandList(mTailCommandList.Get());
+	mRecordingList = mTailCommandList.Get();
 }
 
 void BirdGame::RendererImpl::Present()
@@ -225,36 +762,119 @@ void BirdGame::RendererImpl::Present()
 	CheckHResult(mSwapChain->Present(1, 0));
 }
 
-void BirdGame::RendererImpl::WaitForPreviousFrame()
+void BirdGame::RendererImpl::EndFrame()
 {
-	// WAITING FOR THE FRAME TO COMPLETE BEFORE CONTINUING IS NOT BEST PRACTICE.
-	// This is code implemented as such for simplicity. The D3D12HelloFrameBuffering
-	// sample illustrates how to use fences for efficient resource usage and to
-	// maximize GPU utilization.
+	// Everything this frame uploaded or freed is in use until the GPU reaches this fence.
+	// The CPU carries on with the next frame without waiting for it.
+	const uint64_t fence = mFrameScheduler.EndFrame();
+	mUploadRing.EndFrame(fence);
+	mSrvDescriptors.EndFrame(fence);
+	mTextureTable.EndFrame(fence);
+	mRtvDescriptors.EndFrame(fence);
 
-	// Signal and increment the fence value.
-	const UINT64 fence = mFenceValue;
-	CheckHResult(mCommandQueue->Signal(mFence.Get(), fence));
-	mFenceValue++;
+	mFrameIndex = mSwapChain->GetCurrentBackBufferIndex();
+}
 
-	// Wait until the previous frame is finished.
-	if (mFence->GetCompletedValue() < fence)
-	{
-		CheckHResult(mFence->SetEventOnCompletion(fence, mFenceEvent));
-		WaitForSingleObject(mFenceEvent, INFINITE);
-	}
+void BirdGame::RendererImpl::WaitForGpu()
+{
+	mFrameScheduler.WaitForIdle();
 
-	mFrameIndex = mSwapChain->GetCurrentBackBufferIndex();
+	const uint64_t completedFence = mFrameScheduler.GetCompletedFenceValue();
+	mUploadRing.Retire(completedFence);
+	mSrvDescriptors.Retire(completedFence);
+	mTextureTable.Retire(completedFence);
+	mRtvDescriptors.Retire(completedFence);
 }
 
 void BirdGame::RendererImpl::Destroy()
 {
+	// Stop rebuilding pipelines before the device they're created on goes away
+	mShaderReloader.Stop();
+
 	// Ensure that the GPU is no longer referencing resources that are about to be
 	// cleaned up by the destructor.
-	WaitForPreviousFrame();
+	WaitForGpu();
+
+	// Frames still waiting for their readback are captured too, oldest first, and everything gets written out
+	for (uint32_t slot = 1; slot <= mFrameScheduler.GetFramesInFlight(); ++slot)
+	{
+		ResolveCapture((mFrameSlot + slot) % mFrameScheduler.GetFramesInFlight());
+	}
+	mFrameCapture.Flush();
+	if (mFrameCapture.GetDroppedFrameCount() > 0 || mFrameCapture.GetWriteErrorCount() > 0)
+	{
+		const std::string message = "Frame capture dropped " + std::to_string(mFrameCapture.GetDroppedFrameCount()) + " frames, " + std::to_string(mFrameCapture.GetWriteErrorCount()) + " files couldn't be written\n";
+		OutputDebugStringA(message.c_str());
+	}
 
-	CloseHandle(mFenceEvent);
-	mFenceEvent = NULL;
+	// Release everything we track explicitly so the shutdown report only lists real leaks
+	mRenderGraphExecutor.Destroy();
+	mRenderGraph.Clear();
+	for (TrackedResource textureState : mTextureStates)
+	{
+		mResourceStates.Unregister(textureState);
+	}
+	mTextureStates.clear();
+	mResourceStates.Unregister(mVertexBufferState);
+	mResourceStates.Unregister(mIndexBufferState);
+	ReleaseResource(mTexture);
+	for (ComPtr<ID3D12Resource>& readbackBuffer : mReadbackBuffers)
+	{
+		ReleaseResource(readbackBuffer);
+	}
+	mTextLayout.Clear();
+	ReleaseResource(mFontResource);
+	ReleaseResource(mVertexBuffer);
+	ReleaseResource(mIndexBuffer);
+	for (UINT n = 0; n < kMaxFramesInFlight; n++)
+	{
+		ReleaseResource(mRenderTargets[n]);
+		mCommandAllocators[n].Reset();
+		for (uint32_t thread = 0; thread < kMaxRecordingThreads; ++thread)
+		{
+			mDrawAllocators[n][thread].Reset();
+		}
+	}
+
+	if (mUploadBuffer != nullptr)
+	{
+		mUploadBuffer->Unmap(0, nullptr);
+		mUploadRing.Initialize(nullptr, 0);
+		ReleaseResource(mUploadBuffer);
+	}
+
+	mProfiler.Destroy();
+	mFence.Destroy();
+	mPipelineState.Reset();
+	mTextPipelineState.Reset();
+	mUpscalePipelineState.Reset();
+	mRetiredPipelines.clear();
+	mPipelineCache.Destroy();
+	mShaderLibrary.Destroy();
+	mRecordingList = nullptr;
+	mCommandList.Reset();
+	mTailCommandList.Reset();
+	for (ComPtr<ID3D12GraphicsCommandList>& drawCommandList : mDrawCommandLists)
+	{
+		drawCommandList.Reset();
+	}
+	mPatchCommandList.Reset();
+	mSrvDescriptors.Destroy();
+	mRtvDescriptors.Destroy();
+	mRootSignature.Reset();
+	mSwapChain.Reset();
+	mCommandQueue.Reset();
+
+#if defined(_DEBUG)
+	// Anything other than the device itself that is still alive here has leaked. The debug layer prints the details to the debugger output.
+	ComPtr<ID3D12DebugDevice> debugDevice;
+	if (SUCCEEDED(mDevice.As(&debugDevice)))
+	{
+		debugDevice->ReportLiveDeviceObjects(D3D12_RLDO_DETAIL | D3D12_RLDO_IGNORE_INTERNAL);
+	}
+#endif
+
+	mDevice.Reset();
 }
 
 void BirdGame::RendererImpl::Initialize(uint32_t width, uint32_t height)
@@ -323,7 +943,7 @@ void BirdGame::RendererImpl::CreateSwapChain(HWND hwnd)
 
 		// Describe and create the swap chain.
 		DXGI_SWAP_CHAIN_DESC1 swapChainDesc = { 0 };
-		swapChainDesc.BufferCount = kNumBufferFrames;
+		swapChainDesc.BufferCount = mFrameScheduler.GetFramesInFlight();
 		swapChainDesc.Width = static_cast<UINT>(mViewport.Width);
 		swapChainDesc.Height = static_cast<UINT>(mViewport.Height);
 		swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -350,42 +970,57 @@ void BirdGame::RendererImpl::CreateSwapChain(HWND hwnd)
 
 	// Create descriptor heaps
 	{
-		// Describe and create a render target view (RTV) descriptor heap
-		D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-		rtvHeapDesc.NumDescriptors = kNumBufferFrames;
-		rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-		rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-		CheckHResult(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRtvHeap)));
+		// Render target views (RTV) are only written by the CPU
+		mRtvDescriptors.Initialize(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, false, L"RtvHeap");
 
-		// Describe and create a shader resource view (SRV) heap for the texture.
-		D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-		srvHeapDesc.NumDescriptors = 1;
-		srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-		srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-		CheckHResult(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSrvHeap)));
+		// One big shader visible heap for every shader resource view (SRV)
+		mSrvDescriptors.Initialize(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true, L"SrvHeap");
 
-		mRtvDescriptorSize = mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+		// The texture table starts out as null views, which read as transparent black
+		D3D12_SHADER_RESOURCE_VIEW_DESC nullDesc = {};
+		nullDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		nullDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		nullDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		nullDesc.Texture2D.MipLevels = 1;
+
+		mTextureTableBase = mSrvDescriptors.AllocatePersistent(kMaxTextures);
+		for (uint32_t i = 0; i < kMaxTextures; ++i)
+		{
+			mDevice->CreateShaderResourceView(nullptr, &nullDesc, mSrvDescriptors.GetWriteHandle(mTextureTableBase + i));
+		}
+		mSrvDescriptors.MarkDirty(mTextureTableBase, kMaxTextures);
 	}
 
 	// Create frame resources
 	{
-		D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = mRtvHeap->GetCPUDescriptorHandleForHeapStart();
-
 		// Create a RTV for each frame
-		for (UINT n = 0; n < kNumBufferFrames; n++)
+		for (UINT n = 0; n < mFrameScheduler.GetFramesInFlight(); n++)
 		{
 			CheckHResult(mSwapChain->GetBuffer(n, IID_PPV_ARGS(&mRenderTargets[n])));
-			mDevice->CreateRenderTargetView(mRenderTargets[n].Get(), nullptr, rtvHandle);
-			rtvHandle.ptr += mRtvDescriptorSize;
+			TrackResource(mRenderTargets[n].Get(), L"RenderTarget", "mRenderTargets", MemoryTag::Renderer);
+			mRenderTargetViews[n] = mRtvDescriptors.AllocatePersistent();
+			mDevice->CreateRenderTargetView(mRenderTargets[n].Get(), nullptr, mRtvDescriptors.GetWriteHandle(mRenderTargetViews[n]));
 		}
 	}
 
-	// Create the command allocator
-	CheckHResult(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocator)));
+	// Create a command allocator per frame in flight, the GPU may still be executing commands from the others
+	for (UINT n = 0; n < mFrameScheduler.GetFramesInFlight(); n++)
+	{
+		CheckHResult(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[n])));
+
+		// An allocator can only back one list being recorded at a time, so the draw lists get one per recording thread
+		for (uint32_t thread = 0; thread < mJobSystem.GetThreadCount(); ++thread)
+		{
+			CheckHResult(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mDrawAllocators[n][thread])));
+		}
+	}
 }
 
 void BirdGame::RendererImpl::LoadShaders()
 {
+	// Kept around since the pipeline cache keys pipelines by the serialized root signature
+	ComPtr<ID3DBlob> signature;
+
 	// Create the root signature.
 	{
 		D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
@@ -398,130 +1033,237 @@ void BirdGame::RendererImpl::LoadShaders()
 			featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
 		}
 
+		// Unbounded SRV ranges need resource binding tier 2, tier 1 caps descriptor tables at 128 SRVs
+		D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+		CheckHResult(mDevice->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+		if (options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+		{
+			throw std::runtime_error("The bindless texture table needs a GPU with resource binding tier 2");
+		}
+
+		// The bindless texture table. Views of textures are created and freed while earlier frames are still
+		// pending, so the descriptors are volatile. What they point to doesn't change during a frame.
 		CD3DX12_DESCRIPTOR_RANGE1 ranges[1] = {};
-		ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
+		ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
 
-		CD3DX12_ROOT_PARAMETER1 rootParameters[1] = {};
+		CD3DX12_ROOT_PARAMETER1 rootParameters[2] = {};
 		rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
-
-		D3D12_STATIC_SAMPLER_DESC sampler = {};
-		sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-		sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-		sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-		sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-		sampler.MipLODBias = 0;
-		sampler.MaxAnisotropy = 0;
-		sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-		sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
-		sampler.MinLOD = 0.0f;
-		sampler.MaxLOD = D3D12_FLOAT32_MAX;
-		sampler.ShaderRegister = 0;
-		sampler.RegisterSpace = 0;
-		sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+		rootParameters[1].InitAsConstants(4, 0, 0, D3D12_SHADER_VISIBILITY_ALL); // FrameConstants in shaders.hlsl, UpscaleConstants in upscale.hlsl
+
+		D3D12_STATIC_SAMPLER_DESC samplers[2] = {};
+		// Crisp when magnified, filtered through the mip chain when sprites are drawn smaller than their texture
+		samplers[0].Filter = D3D12_FILTER_MIN_LINEAR_MAG_POINT_MIP_LINEAR;
+		samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+		samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+		samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+		samplers[0].MipLODBias = 0;
+		samplers[0].MaxAnisotropy = 0;
+		samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+		samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+		samplers[0].MinLOD = 0.0f;
+		samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+		samplers[0].ShaderRegister = 0;
+		samplers[0].RegisterSpace = 0;
+		samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+		// Bilinear, for the upscale pass and distance field text
+		samplers[1] = samplers[0];
+		samplers[1].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+		samplers[1].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		samplers[1].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		samplers[1].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		samplers[1].ShaderRegister = 1;
 
 		CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
-		rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, 1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+		rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, _countof(samplers), samplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
-		ComPtr<ID3DBlob> signature;
 		ComPtr<ID3DBlob> error;
 		CheckHResult(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &signature, &error));
 		CheckHResult(mDevice->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
 	}
 
-	// Create the pipeline state, which includes compiling and loading shaders.
+	// Create the pipeline state from the precompiled shaders. The driver side compilation is skipped when the pipeline is cached.
 	{
-		ComPtr<ID3DBlob> vertexShader;
-		ComPtr<ID3DBlob> pixelShader;
+		const D3D12_SHADER_BYTECODE vertexShader = mShaderLibrary.GetBytecode(kSpriteVertexShader);
+		const D3D12_SHADER_BYTECODE pixelShader = mShaderLibrary.GetBytecode(kSpritePixelShader);
 
-#if defined(_DEBUG)
-		// Enable better shader debugging with the graphics debugging tools.
-		UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#else
-		UINT compileFlags = 0;
-#endif
+		const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = GetSpritePipelineDesc(vertexShader, pixelShader);
+		mPipelineState = mPipelineCache.CreateGraphicsPipeline(psoDesc, signature->GetBufferPointer(), signature->GetBufferSize());
+	}
 
-		CheckHResult(D3DCompileFromFile(L"assets/shaders/shaders.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &vertexShader, nullptr));
-		CheckHResult(D3DCompileFromFile(L"assets/shaders/shaders.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShader, nullptr));
+	// Text shares everything with sprites but the pixel shader
+	{
+		const D3D12_SHADER_BYTECODE vertexShader = mShaderLibrary.GetBytecode(kSpriteVertexShader);
+		const D3D12_SHADER_BYTECODE pixelShader = mShaderLibrary.GetBytecode(kTextPixelShader);
 
-		// Define the vertex input layout.
-		D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
-		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-		};
+		const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = GetSpritePipelineDesc(vertexShader, pixelShader);
+		mTextPipelineState = mPipelineCache.CreateGraphicsPipeline(psoDesc, signature->GetBufferPointer(), signature->GetBufferSize());
+	}
 
-		// Describe and create the graphics pipeline state object (PSO).
-		D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-		psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
-		psoDesc.pRootSignature = mRootSignature.Get();
-		psoDesc.VS = CD3DX12_SHADER_BYTECODE(vertexShader.Get());
-		psoDesc.PS = CD3DX12_SHADER_BYTECODE(pixelShader.Get());
-		psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-		psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-		psoDesc.DepthStencilState.DepthEnable = FALSE;
-		psoDesc.DepthStencilState.StencilEnable = FALSE;
-		psoDesc.SampleMask = UINT_MAX;
-		psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-		psoDesc.NumRenderTargets = 1;
-		psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-		psoDesc.SampleDesc.Count = 1;
+	{
+		const D3D12_SHADER_BYTECODE vertexShader = mShaderLibrary.GetBytecode(kUpscaleVertexShader);
+		const D3D12_SHADER_BYTECODE pixelShader = mShaderLibrary.GetBytecode(kUpscalePixelShader);
 
-		CheckHResult(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+		const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = GetUpscalePipelineDesc(vertexShader, pixelShader);
+		mUpscalePipelineState = mPipelineCache.CreateGraphicsPipeline(psoDesc, signature->GetBufferPointer(), signature->GetBufferSize());
 	}
 }
 
+D3D12_GRAPHICS_PIPELINE_STATE_DESC BirdGame::RendererImpl::GetSpritePipelineDesc(const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader) const
+{
+	// Straight alpha blending for sprites
+	CD3DX12_BLEND_DESC blendDesc(D3D12_DEFAULT);
+	blendDesc.RenderTarget[0].BlendEnable = TRUE;
+	blendDesc.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blendDesc.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blendDesc.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+	blendDesc.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+
+	// Sprites can be mirrored with a negative width or height, so don't cull either winding
+	CD3DX12_RASTERIZER_DESC rasterizerDesc(D3D12_DEFAULT);
+	rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+
+	// Describe the graphics pipeline state object (PSO).
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+	psoDesc.InputLayout = { kSpriteInputLayout, _countof(kSpriteInputLayout) };
+	psoDesc.pRootSignature = mRootSignature.Get();
+	psoDesc.VS = vertexShader;
+	psoDesc.PS = pixelShader;
+	psoDesc.RasterizerState = rasterizerDesc;
+	psoDesc.BlendState = blendDesc;
+	psoDesc.DepthStencilState.DepthEnable = FALSE;
+	psoDesc.DepthStencilState.StencilEnable = FALSE;
+	psoDesc.SampleMask = UINT_MAX;
+	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	psoDesc.NumRenderTargets = 1;
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	psoDesc.SampleDesc.Count = 1;
+	return psoDesc;
+}
+
+D3D12_GRAPHICS_PIPELINE_STATE_DESC BirdGame::RendererImpl::GetUpscalePipelineDesc(const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader) const
+{
+	// Overwrites every pixel of the back buffer, no blending and no vertex input
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+	psoDesc.pRootSignature = mRootSignature.Get();
+	psoDesc.VS = vertexShader;
+	psoDesc.PS = pixelShader;
+	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+	psoDesc.DepthStencilState.DepthEnable = FALSE;
+	psoDesc.DepthStencilState.StencilEnable = FALSE;
+	psoDesc.SampleMask = UINT_MAX;
+	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	psoDesc.NumRenderTargets = 1;
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	psoDesc.SampleDesc.Count = 1;
+	return psoDesc;
+}
+
 void BirdGame::RendererImpl::CreateCommandList()
 {
 	// Create the command list.
-	CheckHResult(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCommandAllocator.Get(), mPipelineState.Get(), IID_PPV_ARGS(&mCommandList)));
+	CheckHResult(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCommandAllocators[mFrameSlot].Get(), mPipelineState.Get(), IID_PPV_ARGS(&mCommandList)));
+	mRecordingList = mCommandList.Get();
+
+	// Lists can be reset as soon as they have been submitted, only the allocators have to wait for the GPU,
+	// so a single set of lists serves every frame slot
+	for (ComPtr<ID3D12GraphicsCommandList>& drawCommandList : mDrawCommandLists)
+	{
+		CheckHResult(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mDrawAllocators[mFrameSlot][0].Get(), nullptr, IID_PPV_ARGS(&drawCommandList)));
+		CheckHResult(drawCommandList->Close());
+	}
+	CheckHResult(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCommandAllocators[mFrameSlot].Get(), nullptr, IID_PPV_ARGS(&mTailCommandList)));
+	CheckHResult(mTailCommandList->Close());
+	mSubmitLists.reserve(kMaxDrawCommandLists + 3);
+
+	// Recorded at submit time, after the frame's other lists were closed, so it can share their allocator
+	CheckHResult(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCommandAllocators[mFrameSlot].Get(), nullptr, IID_PPV_ARGS(&mPatchCommandList)));
+	CheckHResult(mPatchCommandList->Close());
 }
 
-void BirdGame::RendererImpl::CreateVertexBuffer()
+void BirdGame::RendererImpl::CreateQuadBuffers()
 {
-	// Define the geometry for a triangle.
-	float aspectRatio = mViewport.Width / mViewport.Height;
-	Vertex triangleVertices[] =
+	// The unit quad. Every sprite instance scales and offsets it in the vertex shader.
+	const Vertex quadVertices[kQuadVertexCount] =
 	{
-        { { 0.0f, 0.25f * aspectRatio, 0.0f }, { 0.5f, 0.0f } },
-        { { 0.25f, -0.25f * aspectRatio, 0.0f }, { 1.0f, 1.0f } },
-        { { -0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 1.0f } }
+		{ { 0.0f, 0.0f } },
+		{ { 1.0f, 0.0f } },
+		{ { 0.0f, 1.0f } },
+		{ { 1.0f, 1.0f } }
 	};
 
-	const UINT vertexBufferSize = sizeof(triangleVertices);
+	mVertexBufferState = CreateStaticBuffer(quadVertices, sizeof(quadVertices), alignof(Vertex), ResourceState::VertexBuffer, mVertexBuffer, L"VertexBuffer", "mVertexBuffer");
+	mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+	mVertexBufferView.StrideInBytes = sizeof(Vertex);
+	mVertexBufferView.SizeInBytes = sizeof(quadVertices);
+
+	// Indexed quads only need 4 vertices each instead of 6. Instanced draws use the first quad,
+	// batches of quads built on the CPU can use as many as they need.
+	ArenaScope scratchScope(mScratchArena);
+	const uint32_t indexBufferSize = kMaxIndexedQuads * kQuadIndexCount * sizeof(uint16_t);
+	uint16_t* indices = mScratchArena.AllocateArray<uint16_t>(kMaxIndexedQuads * kQuadIndexCount);
+	GenerateQuadIndices(indices, kMaxIndexedQuads);
+
+	mIndexBufferState = CreateStaticBuffer(indices, indexBufferSize, alignof(uint16_t), ResourceState::IndexBuffer, mIndexBuffer, L"QuadIndexBuffer", "mIndexBuffer");
+	mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+	mIndexBufferView.Format = DXGI_FORMAT_R16_UINT;
+	mIndexBufferView.SizeInBytes = indexBufferSize;
+}
 
-	// Note: using upload heaps to transfer static data like vert buffers is not 
-	// recommended. Every time the GPU needs it, the upload heap will be marshalled 
-	// over. Please read up on Default Heap usage. An upload heap is used here for 
-	// code simplicity and because there are very few verts to actually transfer.
+BirdGame::TrackedResource BirdGame::RendererImpl::CreateStaticBuffer(const void* data, uint64_t size, uint64_t alignment, ResourceState state, ComPtr<ID3D12Resource>& buffer, const wchar_t* debugName, const char* name)
+{
 	CheckHResult(mDevice->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
+		&CD3DX12_RESOURCE_DESC::Buffer(size),
+		D3D12_RESOURCE_STATE_COPY_DEST,
 		nullptr,
-		IID_PPV_ARGS(&mVertexBuffer)));
-
-	// Copy the triangle data to the vertex buffer.
-	uint8_t* pVertexDataBegin = nullptr;
-	CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
-	CheckHResult(mVertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-	memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
-	mVertexBuffer->Unmap(0, nullptr);
-
-	// Initialize the vertex buffer view.
-	mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
-	mVertexBufferView.StrideInBytes = sizeof(Vertex);
-	mVertexBufferView.SizeInBytes = vertexBufferSize;
+		IID_PPV_ARGS(&buffer)));
+	TrackResource(buffer.Get(), debugName, name, MemoryTag::Geometry);
+	const TrackedResource trackedBuffer = mResourceStates.Register(buffer.Get(), ResourceState::CopyDest);
+
+	// The staging region stays reserved in the upload ring until the copy has finished executing on the GPU
+	const UploadRingBuffer::Allocation staging = mUploadRing.Allocate(size, alignment);
+	memcpy(staging.cpuAddress, data, size);
+	mStateTracker.Require(trackedBuffer, ResourceState::CopyDest);
+	mStateTracker.FlushBarriers(mCommandList.Get());
+	mCommandList->CopyBufferRegion(buffer.Get(), 0, mUploadBuffer.Get(), staging.offset, size);
+
+	// Not transitioned until something needs it, so it shares a barrier batch with whatever comes next
+	mStateTracker.Require(trackedBuffer, state);
+	return trackedBuffer;
 }
 
-void BirdGame::RendererImpl::CreateTexture()
+BirdGame::TextureHandle BirdGame::RendererImpl::CreateTexture(const uint8_t* pixels, uint32_t width, uint32_t height, const MipGenerator::Settings& mipSettings, TextureCompression compression, ComPtr<ID3D12Resource>& texture, const wchar_t* debugName, const char* name)
 {
+	// The draw recording threads are idle while assets load
+	std::vector<Image> mips;
+	mMipGenerator.Generate(pixels, width, height, mipSettings, mJobSystem, mips);
+	const uint32_t mipCount = static_cast<uint32_t>(mips.size()) + 1;
+
+	// Block compressed textures need a top level of whole blocks. Smaller levels may end in partial blocks.
+	if (compression != TextureCompression::None && (width % 4 != 0 || height % 4 != 0))
+	{
+		OutputDebugStringA("Texture size isn't a multiple of 4, uploading it uncompressed\n");
+		compression = TextureCompression::None;
+	}
+
+	std::vector<std::vector<uint8_t>> compressedMips(compression != TextureCompression::None ? mipCount : 0);
+	for (uint32_t mip = 0; mip < compressedMips.size(); ++mip)
+	{
+		const uint8_t* mipPixels = (mip == 0) ? pixels : mips[mip - 1].pixels.data();
+		const uint32_t mipWidth = (mip == 0) ? width : mips[mip - 1].width;
+		const uint32_t mipHeight = (mip == 0) ? height : mips[mip - 1].height;
+		CompressTexture(mipPixels, mipWidth, mipHeight, compression, kTextureCompressionQuality, mJobSystem, compressedMips[mip]);
+	}
+
 	// Describe and create a Texture2D
 	D3D12_RESOURCE_DESC textureDesc = {};
-	textureDesc.MipLevels = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	textureDesc.Width = kTextureWidth;
-	textureDesc.Height = kTextureHeight;
+	textureDesc.MipLevels = static_cast<UINT16>(mipCount);
+	textureDesc.Format = GetTextureFormat(compression);
+	textureDesc.Width = width;
+	textureDesc.Height = height;
 	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 	textureDesc.DepthOrArraySize = 1;
 	textureDesc.SampleDesc.Count = 1;
@@ -534,64 +1276,295 @@ void BirdGame::RendererImpl::CreateTexture()
 		&textureDesc,
 		D3D12_RESOURCE_STATE_COPY_DEST,
 		nullptr,
-		IID_PPV_ARGS(&mTexture)));
+		IID_PPV_ARGS(&texture)));
+	TrackResource(texture.Get(), debugName, name, MemoryTag::Texture);
+	const TrackedResource textureState = mResourceStates.Register(texture.Get(), ResourceState::CopyDest);
+
+	// The staging region stays reserved in the upload ring until the copy has finished executing on the GPU
+	const uint64_t stagingSize = GetRequiredIntermediateSize(texture.Get(), 0, mipCount);
+	const UploadRingBuffer::Allocation staging = mUploadRing.Allocate(stagingSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+	std::vector<D3D12_SUBRESOURCE_DATA> textureData(mipCount);
+	for (uint32_t mip = 0; mip < mipCount; ++mip)
+	{
+		const uint32_t mipWidth = (mip == 0) ? width : mips[mip - 1].width;
+		const uint32_t mipHeight = (mip == 0) ? height : mips[mip - 1].height;
+		if (compression != TextureCompression::None)
+		{
+			textureData[mip].pData = compressedMips[mip].data();
+			textureData[mip].RowPitch = static_cast<LONG_PTR>(GetCompressedRowPitch(compression, mipWidth));
+			textureData[mip].SlicePitch = static_cast<LONG_PTR>(GetCompressedSize(compression, mipWidth, mipHeight));
+		}
+		else
+		{
+			textureData[mip].pData = (mip == 0) ? pixels : mips[mip - 1].pixels.data();
+			textureData[mip].RowPitch = static_cast<LONG_PTR>(mipWidth) * static_cast<LONG_PTR>(kTexturePixelSize);
+			textureData[mip].SlicePitch = textureData[mip].RowPitch * mipHeight;
+		}
+	}
+
+	// This is a helper function in d3dx12.h that copies data to a default heap (used by the texture) via the upload heap using CopyTextureRegion.
+	mStateTracker.Require(textureState, ResourceState::CopyDest);
+	mStateTracker.FlushBarriers(mCommandList.Get());
+	// All levels go through one call, which lays them out in the staging region and records one copy per level
+	UpdateSubresources(mCommandList.Get(), texture.Get(), mUploadBuffer.Get(), staging.offset, 0, mipCount, textureData.data());
+	mStateTracker.Require(textureState, ResourceState::ShaderResource);
+
+	// Describe and create a SRV for the texture.
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Format = textureDesc.Format;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = mipCount;
+	const TextureHandle handle = mTextureTable.Allocate();
+	const uint32_t tableIndex = TextureTable::GetIndex(handle);
+	mDevice->CreateShaderResourceView(texture.Get(), &srvDesc, mSrvDescriptors.GetWriteHandle(mTextureTableBase + tableIndex));
+	mSrvDescriptors.MarkDirty(mTextureTableBase + tableIndex);
+
+	if (mTextureStates.size() <= tableIndex)
+	{
+		mTextureStates.resize(tableIndex + 1);
+	}
+	mTextureStates[tableIndex] = textureState;
+	return handle;
+}
+
+void BirdGame::RendererImpl::CreateDefaultTexture()
+{
+	// The CPU side copy is only needed until UpdateSubresources has copied it into the upload heap.
+	ArenaScope scratchScope(mScratchArena);
+	TextureData texture = GenerateTextureData(mScratchArena);
+
+	MipGenerator::Settings mipSettings;
+	mipSettings.filter = MipFilter::Box;
+	mipSettings.srgb = true;
+	// Opaque with at most two colors per block, which BC1 keeps without visible loss
+	const TextureHandle handle = CreateTexture(&texture[0], kTextureWidth, kTextureHeight, mipSettings, TextureCompression::BC1, mTexture, L"Texture", "mTexture");
+	assert(handle == kDefaultTexture && "The checkerboard is the default texture");
+	(void)handle;
+}
+
+void BirdGame::RendererImpl::LoadFont()
+{
+	// The atlas has everything text needs, so the font file is only mapped while building it
+	MappedFile fontFile;
+	TrueTypeFont font;
+	bool loaded = false;
+	for (const char* path : kFontPaths)
+	{
+		if (fontFile.Open(path) && font.Load(fontFile.GetData(), fontFile.GetSize()))
+		{
+			loaded = true;
+			break;
+		}
+		fontFile.Close();
+	}
+
+	if (!loaded)
+	{
+		OutputDebugStringA("No font could be loaded, text won't be drawn\n");
+		return;
+	}
+
+	uint32_t codepoints[kLastAtlasCodepoint - kFirstAtlasCodepoint + 1];
+	for (uint32_t codepoint = kFirstAtlasCodepoint; codepoint <= kLastAtlasCodepoint; ++codepoint)
+	{
+		codepoints[codepoint - kFirstAtlasCodepoint] = codepoint;
+	}
 
-	const uint64_t uploadBufferSize = GetRequiredIntermediateSize(mTexture.Get(), 0, 1);
+	// The distance transforms run on the draw recording threads, which are idle during loading
+	mGlyphAtlas.Build(font, codepoints, _countof(codepoints), GlyphAtlas::Settings(), mJobSystem);
+	const Image& atlas = mGlyphAtlas.GetImage();
 
-	// Create the GPU upload buffer
-	// Use raw pointer here instead of ComPtr because we want this to exist until it has finished executing on the GPU (during WaitForNextFrame)
-	// Probably should find a better solution since this is never released currently
-	ID3D12Resource* textureUploadHeap;
+	// Glyphs are packed with only a few texels between them, which smaller levels would blur together.
+	// The distance field needs every bit of alpha precision for smooth edges, so it isn't compressed either.
+	MipGenerator::Settings mipSettings;
+	mipSettings.srgb = false;
+	mipSettings.maxLevels = 1;
+	mFontTexture = CreateTexture(atlas.pixels.data(), atlas.width, atlas.height, mipSettings, TextureCompression::None, mFontResource, L"GlyphAtlas", "mFontResource");
+}
+
+void BirdGame::RendererImpl::CreateUploadBuffer()
+{
 	CheckHResult(mDevice->CreateCommittedResource(
 		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
 		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+		&CD3DX12_RESOURCE_DESC::Buffer(kUploadBufferSize),
 		D3D12_RESOURCE_STATE_GENERIC_READ,
 		nullptr,
-		IID_PPV_ARGS(&textureUploadHeap)));
+		IID_PPV_ARGS(&mUploadBuffer)));
+	TrackResource(mUploadBuffer.Get(), L"UploadBuffer", "mUploadBuffer", MemoryTag::Renderer);
 
-	// Copy data to the intermediate upload heap and then schedule a copy 
-	// from the upload heap to the Texture2D.
-	std::vector<uint8_t> texture = GenerateTextureData();
+	// Upload heaps can stay mapped for their whole lifetime
+	uint8_t* mappedData = nullptr;
+	CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
+	CheckHResult(mUploadBuffer->Map(0, &readRange, reinterpret_cast<void**>(&mappedData)));
+	mUploadRing.Initialize(mappedData, kUploadBufferSize);
+}
 
-	D3D12_SUBRESOURCE_DATA textureData = {};
-	textureData.pData = &texture[0];
-	textureData.RowPitch = static_cast<LONG_PTR>(kTextureWidth) * static_cast<LONG_PTR>(kTexturePixelSize);
-	textureData.SlicePitch = textureData.RowPitch * kTextureHeight;
+void BirdGame::RendererImpl::BuildRenderGraph()
+{
+	mRenderGraphExecutor.Initialize(mDevice.Get());
 
-	// This is a helper function in d3dx12.h that copies data to a default heap (used by the texture) via the upload heap using CopyTextureRegion.
-	UpdateSubresources(mCommandList.Get(), mTexture.Get(), textureUploadHeap, 0, 0, 1, &textureData);
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mTexture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	mBackBufferResource = mRenderGraph.ImportResource("BackBuffer", ResourceState::Present, ResourceState::Present);
 
-	// Describe and create a SRV for the texture.
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.Format = textureDesc.Format;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = 1;
-	mDevice->CreateShaderResourceView(mTexture.Get(), &srvDesc, mSrvHeap->GetCPUDescriptorHandleForHeapStart());
+	mSceneWidth = std::max(1u, static_cast<uint32_t>(std::ceil(mViewport.Width * mResolutionController.GetMaxScale())));
+	mSceneHeight = std::max(1u, static_cast<uint32_t>(std::ceil(mViewport.Height * mResolutionController.GetMaxScale())));
+	mSceneResource = mRenderGraph.CreateTransient("Scene", { mSceneWidth, mSceneHeight, TextureFormat::RGBA8 });
+
+	const RenderGraphPass spritePass = mRenderGraph.AddPass("Sprites", [this]() { RecordSpritePass(); });
+	mRenderGraph.Write(spritePass, mSceneResource, ResourceState::RenderTarget);
+
+	const RenderGraphPass upscalePass = mRenderGraph.AddPass("Upscale", [this]() { RecordUpscalePass(); });
+	mRenderGraph.Read(upscalePass, mSceneResource, ResourceState::ShaderResource);
+	mRenderGraph.Write(upscalePass, mBackBufferResource, ResourceState::RenderTarget);
+
+	// Costs a back buffer transition every frame, captured or not, so it's only there when capture is enabled
+	if (mFrameCaptureEnabled)
+	{
+		const RenderGraphPass capturePass = mRenderGraph.AddPass("Capture", [this]() { RecordCapturePass(); }, true);
+		mRenderGraph.Read(capturePass, mBackBufferResource, ResourceState::CopySource);
+	}
+
+	mRenderGraph.Compile([this](const TextureDesc& desc) { return mRenderGraphExecutor.GetAllocationInfo(desc); });
+	mRenderGraphExecutor.Prepare(mRenderGraph);
+
+	// The graph never changes, so the scene target and its views live as long as the renderer
+	ID3D12Resource* scene = mRenderGraphExecutor.GetResource(mSceneResource);
+	mSceneRenderTargetView = mRtvDescriptors.AllocatePersistent();
+	mDevice->CreateRenderTargetView(scene, nullptr, mRtvDescriptors.GetWriteHandle(mSceneRenderTargetView));
+	mSceneShaderResourceView = mSrvDescriptors.AllocatePersistent();
+	mDevice->CreateShaderResourceView(scene, nullptr, mSrvDescriptors.GetWriteHandle(mSceneShaderResourceView));
+	mSrvDescriptors.MarkDirty(mSceneShaderResourceView);
+
+	UpdateResolution();
 }
 
-// A fence is a synchronization primitive that we can use to signal that the GPU is done rendering a frame
-void BirdGame::RendererImpl::CreateFence()
+void BirdGame::RendererImpl::SubmitSprite(TextureHandle texture, const Rect& rect, const Rect& uv, Color color, uint8_t layer)
 {
-	// Create synchronization objects and wait until assets have been uploaded to the GPU.
-	CheckHResult(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
-	mFenceValue = 1;
+	if (!mLoggedInvalidTexture && !mTextureTable.IsValid(texture))
+	{
+		OutputDebugStringA("Sprite submitted with an invalid texture handle, drawing it with the default texture\n");
+		mLoggedInvalidTexture = true;
+	}
+
+	mSpriteBatch.Submit(mTextureTable.GetIndexOrDefault(texture), rect, uv, color, layer, PipelineId::Sprite);
+}
+
+void BirdGame::RendererImpl::SubmitText(const char* text, const TextStyle& style, float x, float y, Color color, uint8_t layer)
+{
+	if (mFontTexture == TextureTable::kInvalidHandle)
+	{
+		return;
+	}
 
-	// Create an event handle to use for frame synchronization.
-	mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-	if (mFenceEvent == nullptr)
+	const uint32_t textureIndex = TextureTable::GetIndex(mFontTexture);
+	const TextRun& run = mTextLayout.Layout(mGlyphAtlas, text, style);
+	for (const PositionedGlyph& glyph : run.glyphs)
 	{
-		CheckHResult(HRESULT_FROM_WIN32(GetLastError()));
+		const Rect rect = { x + glyph.rect.x, y + glyph.rect.y, glyph.rect.width, glyph.rect.height };
+		mSpriteBatch.Submit(textureIndex, rect, glyph.uv, color, layer, PipelineId::Text);
+	}
+}
+
+void BirdGame::RendererImpl::ExecuteRenderCommands()
+{
+	const std::vector<SpriteInstance>& instances = mSpriteBatch.GetInstances();
+	if (instances.empty())
+	{
+		return;
+	}
+
+	const uint64_t instanceDataSize = instances.size() * sizeof(SpriteInstance);
+	const UploadRingBuffer::Allocation instanceData = mUploadRing.Allocate(instanceDataSize, alignof(SpriteInstance));
+	memcpy(instanceData.cpuAddress, instances.data(), instanceDataSize);
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[2] = { mVertexBufferView, {} };
+	vertexBufferViews[1].BufferLocation = mUploadBuffer->GetGPUVirtualAddress() + instanceData.offset;
+	vertexBufferViews[1].StrideInBytes = sizeof(SpriteInstance);
+	vertexBufferViews[1].SizeInBytes = static_cast<UINT>(instanceDataSize);
+
+	const float pixelToClip[2] = { 2.0f / mViewport.Width, 2.0f / mViewport.Height };
+	const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = mRtvDescriptors.GetCpuHandle(mSceneRenderTargetView);
+
+	// Everything the draws may read goes into one barrier batch on the render thread's list, before any draw list
+	mStateTracker.Require(mVertexBufferState, ResourceState::VertexBuffer);
+	mStateTracker.Require(mIndexBufferState, ResourceState::IndexBuffer);
+	for (TrackedResource textureState : mTextureStates)
+	{
+		mStateTracker.Require(textureState, ResourceState::ShaderResource);
+	}
+	mStateTracker.FlushBarriers(mRecordingList);
+
+	const std::vector<DrawPacket>& packets = mRenderCommands.GetPackets();
+	const uint32_t listCount = mDrawRecorder.Record(packets, [&](uint32_t chunkIndex, const ParallelDrawRecorder::Chunk& chunk, uint32_t workerIndex)
+	{
+		// Reset() binds the sprite pipeline, draws switch when their packet needs another one
+		ID3D12GraphicsCommandList* commandList = mDrawCommandLists[chunkIndex].Get();
+		CheckHResult(commandList->Reset(mDrawAllocators[mFrameSlot][workerIndex].Get(), mPipelineState.Get()));
+		BeginCommandList(commandList);
+
+		commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+		commandList->RSSetViewports(1, &mSceneViewport);
+		commandList->RSSetScissorRects(1, &mSceneScissorRect);
+		commandList->SetGraphicsRoot32BitConstants(1, _countof(pixelToClip), pixelToClip, 0);
+		commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		commandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+		commandList->IASetIndexBuffer(&mIndexBufferView);
+
+		// Instances pick their texture from the whole table, so it is bound once for all draws
+		commandList->SetGraphicsRootDescriptorTable(0, mSrvDescriptors.GetGpuHandle(mTextureTableBase));
+
+		PipelineId boundPipeline = PipelineId::Sprite;
+		ParallelDrawRecorder::ForEachDraw(packets, chunk, [&](const DrawPacket& packet, uint32_t firstInstance, uint32_t instanceCount)
+		{
+			const PipelineId pipeline = SortKey::GetPipeline(packet.key);
+			assert(pipeline == PipelineId::Sprite || pipeline == PipelineId::Text);
+			if (pipeline != boundPipeline)
+			{
+				commandList->SetPipelineState(GetPipelineState(pipeline).Get());
+				boundPipeline = pipeline;
+			}
+			commandList->DrawIndexedInstanced(kQuadIndexCount, instanceCount, 0, 0, firstInstance);
+		});
+
+		CheckHResult(commandList->Close());
+	});
+
+	SubmitDrawCommandLists(listCount);
+}
+
+void BirdGame::RendererImpl::TrackResource(ID3D12Resource* resource, const wchar_t* debugName, const char* name, MemoryTag tag)
+{
+	// Name the resource so it is also identifiable in the debug layer's live object report
+	resource->SetName(debugName);
+
+	const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = mDevice->GetResourceAllocationInfo(0, 1, &desc);
+	MemoryTracker::TrackResource(resource, name, tag, allocationInfo.SizeInBytes);
+}
+
+void BirdGame::RendererImpl::ReleaseResource(ComPtr<ID3D12Resource>& resource)
+{
+	if (resource != nullptr)
+	{
+		MemoryTracker::UntrackResource(resource.Get());
+		resource.Reset();
 	}
 }
 
 #pragma endregion
 
 // ------------------------------------------------------------------------------------------------
-BirdGame::RendererDX::RendererDX()
+BirdGame::RendererDX::RendererDX(MemoryReservation& memory, const Settings& settings) :
+	mMemory(memory),
+	mSettings(settings)
+{
+}
+
+bool BirdGame::RendererDX::CompileShaders()
 {
+	return ShaderLibraryDX::CompileOffline(kShaderPrograms, _countof(kShaderPrograms), kCompiledShaderDirectory);
 }
 
 BirdGame::RendererDX::~RendererDX()
@@ -600,14 +1573,16 @@ BirdGame::RendererDX::~RendererDX()
 
 void BirdGame::RendererDX::Initialize(Window& window)
 {
-	mImpl.reset(new RendererImpl());
+	mImpl.reset(new RendererImpl(mMemory.CarveArena("RendererScratch", MemoryTag::Renderer, kScratchArenaSize, false), mSettings));
 	mImpl->LoadPipeline(window.GetHandle(), window.GetWidth(), window.GetHeight());
+
+	// The initial GPU setup is recorded and submitted like a regular frame
+	mImpl->BeginFrame();
 	mImpl->LoadAssets();
+	mImpl->EndFrame();
 
-	// Wait for the command list to execute; we are reusing the same command 
-	// list in our main loop but for now, we just want to wait for setup to 
-	// complete before continuing.
-	mImpl->WaitForPreviousFrame();
+	// Wait for setup to complete before continuing.
+	mImpl->WaitForGpu();
 }
 
 void BirdGame::RendererDX::Shutdown()
@@ -615,10 +1590,41 @@ void BirdGame::RendererDX::Shutdown()
 	mImpl->Destroy();
 }
 
+void BirdGame::RendererDX::SubmitSprite(TextureHandle texture, const Rect& rect, const Rect& uv, Color color, uint8_t layer)
+{
+	mImpl->SubmitSprite(texture, rect, uv, color, layer);
+}
+
+void BirdGame::RendererDX::SubmitText(const char* text, const TextStyle& style, float x, float y, Color color, uint8_t layer)
+{
+	mImpl->SubmitText(text, style, x, y, color, layer);
+}
+
+void BirdGame::RendererDX::CaptureScreenshot(const char* path)
+{
+	mImpl->GetFrameCapture().RequestScreenshot(path);
+}
+
+void BirdGame::RendererDX::BeginVideoCapture(const char* path, uint32_t framesPerSecond)
+{
+	mImpl->GetFrameCapture().BeginVideo(path, framesPerSecond);
+}
+
+void BirdGame::RendererDX::EndVideoCapture()
+{
+	mImpl->GetFrameCapture().EndVideo();
+}
+
+BirdGame::IProfiler& BirdGame::RendererDX::GetProfiler()
+{
+	return mImpl->GetProfiler();
+}
+
 void BirdGame::RendererDX::Render()
 {
+	mImpl->BeginFrame();
 	mImpl->PopulateCommandList();
 	mImpl->CloseAndExecuteCommandList();
 	mImpl->Present();
-	mImpl->WaitForPreviousFrame();
+	mImpl->EndFrame();
 }
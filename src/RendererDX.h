@@ -2,24 +2,51 @@
 
 #include "IRenderer.h"
 
+#include <string>
+
 namespace BirdGame
 {
+	class MemoryReservation;
 	class RendererImpl;
 
 	class RendererDX final : public IRenderer
 	{
 	public:
-		RendererDX();
+		struct Settings
+		{
+			uint32_t framesInFlight;  // How many frames the CPU may record ahead of the GPU, clamped to 2-3
+			bool developmentMode;     // Recompile shaders whose source changed since their bytecode was built, and hot reload them
+			float minResolutionScale; // Dynamic resolution bounds, relative to the window size
+			float maxResolutionScale;
+			bool frameCapture;        // Read back frames for CaptureScreenshot() and BeginVideoCapture()
+			std::string sourceRoot;   // Development mode hot reloads the shaders under this directory, see ShaderHotReloaderDX::Start()
+		};
+
+		RendererDX(MemoryReservation& memory, const Settings& settings);
 		~RendererDX();
 
+		// Builds the precompiled shader bytecode the renderer loads at startup. Returns false if any shader failed.
+		static bool CompileShaders();
+
 		virtual void Initialize(Window& window) override;
 		virtual void Shutdown() override;
 
+		virtual void SubmitSprite(TextureHandle texture, const Rect& rect, const Rect& uv, Color color, uint8_t layer) override;
+		virtual void SubmitText(const char* text, const TextStyle& style, float x, float y, Color color, uint8_t layer) override;
+
 		virtual void Render() override;
 
+		virtual void CaptureScreenshot(const char* path) override;
+		virtual void BeginVideoCapture(const char* path, uint32_t framesPerSecond) override;
+		virtual void EndVideoCapture() override;
+
+		virtual IProfiler& GetProfiler() override;
+
 	private:
 		RendererDX(const RendererDX&) = delete;
 
+		MemoryReservation& mMemory;
+		Settings mSettings;
 		std::unique_ptr<RendererImpl> mImpl;
 	};
 }
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "ResolutionController.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Weight of a new measurement in the moving average. Spikes over budget skip the average, see Update().
+	constexpr double kSmoothing = 0.1;
+
+	// Only scale up while frames take less than this fraction of the target
+	constexpr double kIncreaseThreshold = 0.85;
+
+	// The largest increase in one go, so a few cheap frames can't push the scale way past what's sustainable
+	constexpr float kMaxIncrease = 4.0f * BirdGame::ResolutionController::kScaleStep;
+}
+
+BirdGame::ResolutionController::ResolutionController(const Settings& settings) :
+	mSettings(settings),
+	mScale(settings.maxScale),
+	mSmoothedMilliseconds(0.0),
+	mFramesToSkip(0)
+{
+	assert(settings.targetMilliseconds > 0.0f);
+	assert(settings.minScale > 0.0f && settings.minScale <= settings.maxScale);
+}
+
+float BirdGame::ResolutionController::Update(double frameMilliseconds)
+{
+	if (mFramesToSkip > 0)
+	{
+		mFramesToSkip--;
+		return mScale;
+	}
+
+	const double target = mSettings.targetMilliseconds;
+	mSmoothedMilliseconds = (mSmoothedMilliseconds == 0.0) ? frameMilliseconds : mSmoothedMilliseconds + (frameMilliseconds - mSmoothedMilliseconds) * kSmoothing;
+
+	// A frame well over budget is a real drop, don't wait for the average to catch up with it
+	const double measured = (frameMilliseconds > target * 1.25) ? std::max(frameMilliseconds, mSmoothedMilliseconds) : mSmoothedMilliseconds;
+	if (measured <= 0.0)
+	{
+		return mScale;
+	}
+
+	const float ideal = mScale * static_cast<float>(std::sqrt(target / measured));
+	if (measured > target)
+	{
+		// Round down, rounding up would leave us over budget
+		SetScale(std::floor(ideal / kScaleStep) * kScaleStep);
+	}
+	else if (measured < target * kIncreaseThreshold)
+	{
+		// Aim below the target, an increase that lands right on it would be undone by the next slow frame
+		const float sustainable = mScale * static_cast<float>(std::sqrt(target * kIncreaseThreshold / measured));
+		const float increased = std::floor(std::min(sustainable, mScale + kMaxIncrease) / kScaleStep) * kScaleStep;
+		if (increased > mScale)
+		{
+			SetScale(increased);
+		}
+	}
+
+	return mScale;
+}
+
+void BirdGame::ResolutionController::GetScaledSize(uint32_t width, uint32_t height, uint32_t& scaledWidth, uint32_t& scaledHeight) const
+{
+	scaledWidth = std::max(1u, static_cast<uint32_t>(width * mScale + 0.5f));
+	scaledHeight = std::max(1u, static_cast<uint32_t>(height * mScale + 0.5f));
+}
+
+void BirdGame::ResolutionController::SetScale(float scale)
+{
+	scale = std::min(std::max(scale, mSettings.minScale), mSettings.maxScale);
+	if (scale == mScale)
+	{
+		return;
+	}
+
+	mScale = scale;
+	mSmoothedMilliseconds = 0.0;
+	mFramesToSkip = mSettings.settleFrames;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BirdGame
+{
+	// Picks the render resolution scale from measured frame times. Fill cost grows with the pixel count, i.e.
+	// with the square of the scale, so the scale moves by the square root of how far off the frame time is.
+	// Drops are applied right away, increases are limited per step and only made with some headroom left, so the
+	// scale doesn't oscillate around the target. Scales are quantized to kScaleStep so small changes in frame
+	// time don't change the resolution every frame.
+	class ResolutionController final
+	{
+	public:
+		static constexpr float kScaleStep = 1.0f / 32.0f;
+
+		struct Settings
+		{
+			float targetMilliseconds;
+			float minScale;
+			float maxScale;
+
+			// Measurements to skip after a change. They may still come from frames recorded at the old scale,
+			// e.g. GPU timings that arrive a few frames late.
+			uint32_t settleFrames;
+		};
+
+		explicit ResolutionController(const Settings& settings);
+
+		// Feeds the time of one frame and returns the scale to render at from now on
+		float Update(double frameMilliseconds);
+
+		float GetScale() const { return mScale; }
+		float GetMaxScale() const { return mSettings.maxScale; }
+
+		// Scaled size of a width x height target, at least 1 x 1 pixel
+		void GetScaledSize(uint32_t width, uint32_t height, uint32_t& scaledWidth, uint32_t& scaledHeight) const;
+
+	private:
+		ResolutionController(const ResolutionController&) = delete;
+
+		void SetScale(float scale);
+
+		Settings mSettings;
+		float mScale;
+		double mSmoothedMilliseconds; // 0 until the first measurement after a change
+		uint32_t mFramesToSkip;
+	};
+}
@@ -0,0 +1,34 @@
+#include "pch.h"
+#include "ResourceStateRegistry.h"
+
+#include <assert.h>
+
+BirdGame::TrackedResource BirdGame::ResourceStateRegistry::Register(ResourceState initialState)
+{
+	TrackedResource resource;
+	if (!mFreeIds.empty())
+	{
+		resource = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	else
+	{
+		resource = static_cast<TrackedResource>(mStates.size());
+		mStates.push_back(ResourceState::Undefined);
+		mRegistered.push_back(false);
+	}
+
+	mStates[resource] = initialState;
+	mRegistered[resource] = true;
+	mRegisteredCount++;
+	return resource;
+}
+
+void BirdGame::ResourceStateRegistry::Unregister(TrackedResource resource)
+{
+	assert(IsRegistered(resource));
+
+	mRegistered[resource] = false;
+	mFreeIds.push_back(resource);
+	mRegisteredCount--;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	using TrackedResource = uint32_t;
+
+	// The state every tracked resource is in once all submitted command lists have executed. Command lists don't
+	// read this while recording: ResourceStateTracker patches their first uses against it at submit time and
+	// writes the states they leave resources in back.
+	class ResourceStateRegistry final
+	{
+	public:
+		ResourceStateRegistry() = default;
+
+		TrackedResource Register(ResourceState initialState);
+
+		// Ids are reused, so the resource must not be used by any command list that hasn't been submitted yet
+		void Unregister(TrackedResource resource);
+
+		ResourceState GetState(TrackedResource resource) const { return mStates[resource]; }
+		void SetState(TrackedResource resource, ResourceState state) { mStates[resource] = state; }
+
+		bool IsRegistered(TrackedResource resource) const { return resource < mRegistered.size() && mRegistered[resource]; }
+		uint32_t GetRegisteredCount() const { return mRegisteredCount; }
+
+	private:
+		ResourceStateRegistry(const ResourceStateRegistry&) = delete;
+
+		std::vector<ResourceState> mStates;
+		std::vector<bool> mRegistered;
+		std::vector<TrackedResource> mFreeIds;
+		uint32_t mRegisteredCount = 0;
+	};
+}
@@ -0,0 +1,24 @@
+#include "pch.h"
+#include "ResourceStateRegistryDX.h"
+
+#include <assert.h>
+
+BirdGame::TrackedResource BirdGame::ResourceStateRegistryDX::Register(ID3D12Resource* resource, ResourceState initialState)
+{
+	assert(resource != nullptr);
+
+	const TrackedResource id = mStates.Register(initialState);
+	if (id >= mResources.size())
+	{
+		mResources.resize(id + 1, nullptr);
+	}
+
+	mResources[id] = resource;
+	return id;
+}
+
+void BirdGame::ResourceStateRegistryDX::Unregister(TrackedResource resource)
+{
+	mStates.Unregister(resource);
+	mResources[resource] = nullptr;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ResourceStateRegistry.h"
+
+#include <vector>
+
+namespace BirdGame
+{
+	// ResourceStateRegistry plus the D3D12 resource behind each tracked id. Resources are registered in the
+	// state they were created in.
+	class ResourceStateRegistryDX final
+	{
+	public:
+		ResourceStateRegistryDX() = default;
+
+		TrackedResource Register(ID3D12Resource* resource, ResourceState initialState);
+		void Unregister(TrackedResource resource);
+
+		ID3D12Resource* GetResource(TrackedResource resource) const { return mResources[resource]; }
+		ResourceStateRegistry& GetStates() { return mStates; }
+		const ResourceStateRegistry& GetStates() const { return mStates; }
+
+	private:
+		ResourceStateRegistryDX(const ResourceStateRegistryDX&) = delete;
+
+		ResourceStateRegistry mStates;
+		std::vector<ID3D12Resource*> mResources; // Indexed by TrackedResource, not owned
+	};
+}
@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "ResourceStateTracker.h"
+
+#include <assert.h>
+
+namespace
+{
+	bool NeedsTransition(BirdGame::ResourceState current, BirdGame::ResourceState required)
+	{
+		// A read is satisfied by any combined read state that includes it. Writes need the exact state.
+		if (BirdGame::IsWriteState(required))
+		{
+			return current != required;
+		}
+		return BirdGame::IsWriteState(current) || !BirdGame::HasAllStates(current, required);
+	}
+}
+
+void BirdGame::ResourceStateTracker::Require(TrackedResource resource, ResourceState state)
+{
+	assert(state != ResourceState::Undefined && "Resources can't be required in the undefined state");
+
+	if (resource >= mCurrentStates.size())
+	{
+		mCurrentStates.resize(resource + 1, ResourceState::Undefined);
+	}
+
+	ResourceState& current = mCurrentStates[resource];
+	if (current == ResourceState::Undefined)
+	{
+		// First use in this list, the state before it is only known at submit time
+		mFirstUses.push_back({ resource, state });
+		current = state;
+		return;
+	}
+
+	if (!NeedsTransition(current, state))
+	{
+		return;
+	}
+
+	// Transitions that haven't been flushed yet can still be folded: A -> B followed by B -> C is A -> C
+	for (auto it = mPendingBarriers.rbegin(); it != mPendingBarriers.rend(); ++it)
+	{
+		if (it->resource == resource)
+		{
+			it->after = state;
+			current = state;
+			return;
+		}
+	}
+
+	mPendingBarriers.push_back({ resource, current, state });
+	current = state;
+}
+
+void BirdGame::ResourceStateTracker::FlushBarriers(std::vector<Barrier>& barriers)
+{
+	for (const Barrier& barrier : mPendingBarriers)
+	{
+		if (barrier.before != barrier.after)
+		{
+			barriers.push_back(barrier);
+		}
+	}
+
+	mPendingBarriers.clear();
+}
+
+void BirdGame::ResourceStateTracker::ResolveInitialBarriers(const ResourceStateRegistry& registry, std::vector<Barrier>& barriers) const
+{
+	assert(mPendingBarriers.empty() && "Flush the barriers before closing the command list");
+
+	for (const Use& use : mFirstUses)
+	{
+		assert(registry.IsRegistered(use.resource));
+
+		// The list starts from exactly the state it first asked for, even if the registry state already allows the
+		// access. Barriers the list recorded afterwards have that state as their before state.
+		const ResourceState registryState = registry.GetState(use.resource);
+		if (registryState != use.state)
+		{
+			barriers.push_back({ use.resource, registryState, use.state });
+		}
+	}
+}
+
+void BirdGame::ResourceStateTracker::Commit(ResourceStateRegistry& registry)
+{
+	for (const Use& use : mFirstUses)
+	{
+		registry.SetState(use.resource, mCurrentStates[use.resource]);
+	}
+
+	Reset();
+}
+
+void BirdGame::ResourceStateTracker::Reset()
+{
+	// Only the entries this list touched are dirty
+	for (const Use& use : mFirstUses)
+	{
+		mCurrentStates[use.resource] = ResourceState::Undefined;
+	}
+
+	mFirstUses.clear();
+	mPendingBarriers.clear();
+}
+
+BirdGame::ResourceState BirdGame::ResourceStateTracker::GetFinalState(TrackedResource resource) const
+{
+	return (resource < mCurrentStates.size()) ? mCurrentStates[resource] : ResourceState::Undefined;
+}
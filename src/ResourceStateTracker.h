@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ResourceStateRegistry.h"
+
+#include <vector>
+
+namespace BirdGame
+{
+	// Tracks resource states within one command list. Code recording the list only says which state it needs a
+	// resource in (Require()); the tracker works out the transitions and batches them until FlushBarriers(), which
+	// the backend calls right before recording work that depends on them.
+	//
+	// The state a resource is in when the list starts executing isn't known while recording, since other lists may
+	// be submitted first. The first use of each resource is kept aside and resolved against the
+	// ResourceStateRegistry at submit time by ResolveInitialBarriers(), which the backend records into a small list
+	// executed just before this one.
+	class ResourceStateTracker final
+	{
+	public:
+		struct Barrier
+		{
+			TrackedResource resource;
+			ResourceState before;
+			ResourceState after;
+		};
+
+		ResourceStateTracker() = default;
+
+		void Require(TrackedResource resource, ResourceState state);
+
+		// Moves the transitions required so far to barriers and clears them. Consecutive transitions of the same
+		// resource are folded into one, transitions that end up where they started are dropped.
+		void FlushBarriers(std::vector<Barrier>& barriers);
+		bool HasPendingBarriers() const { return !mPendingBarriers.empty(); }
+
+		// At submit time, after the list has been closed: the barriers that take every resource from its registry
+		// state to the state the list first needs it in
+		void ResolveInitialBarriers(const ResourceStateRegistry& registry, std::vector<Barrier>& barriers) const;
+
+		// Writes the states the list leaves resources in back to the registry and resets the tracker for the next list
+		void Commit(ResourceStateRegistry& registry);
+
+		void Reset();
+
+		// The state the list leaves a resource in, or Undefined if the list hasn't used it
+		ResourceState GetFinalState(TrackedResource resource) const;
+
+	private:
+		ResourceStateTracker(const ResourceStateTracker&) = delete;
+
+		struct Use
+		{
+			TrackedResource resource;
+			ResourceState state;
+		};
+
+		// Indexed by resource, grows on demand. Undefined means not used by this list.
+		std::vector<ResourceState> mCurrentStates;
+
+		std::vector<Use> mFirstUses;
+		std::vector<Barrier> mPendingBarriers;
+	};
+}
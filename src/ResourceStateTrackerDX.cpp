@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "ResourceStateTrackerDX.h"
+
+#include "RenderGraphDX.h"
+#include "ResourceStateRegistryDX.h"
+
+BirdGame::ResourceStateTrackerDX::ResourceStateTrackerDX(ResourceStateRegistryDX& registry) :
+	mRegistry(registry)
+{
+}
+
+void BirdGame::ResourceStateTrackerDX::FlushBarriers(ID3D12GraphicsCommandList* commandList)
+{
+	if (!mTracker.HasPendingBarriers())
+	{
+		return;
+	}
+
+	mBarrierScratch.clear();
+	mTracker.FlushBarriers(mBarrierScratch);
+	RecordBarriers(commandList);
+}
+
+bool BirdGame::ResourceStateTrackerDX::ResolveInitialBarriers(ID3D12GraphicsCommandList* patchCommandList)
+{
+	mBarrierScratch.clear();
+	mTracker.ResolveInitialBarriers(mRegistry.GetStates(), mBarrierScratch);
+	if (mBarrierScratch.empty())
+	{
+		return false;
+	}
+
+	return RecordBarriers(patchCommandList);
+}
+
+void BirdGame::ResourceStateTrackerDX::Commit()
+{
+	mTracker.Commit(mRegistry.GetStates());
+}
+
+bool BirdGame::ResourceStateTrackerDX::RecordBarriers(ID3D12GraphicsCommandList* commandList)
+{
+	mD3DBarrierScratch.clear();
+	for (const ResourceStateTracker::Barrier& barrier : mBarrierScratch)
+	{
+		const D3D12_RESOURCE_STATES before = ToD3D12ResourceStates(barrier.before);
+		const D3D12_RESOURCE_STATES after = ToD3D12ResourceStates(barrier.after);
+
+		// Different neutral states can map to the same D3D12 state, e.g. Present and Undefined
+		if (before != after)
+		{
+			mD3DBarrierScratch.push_back(CD3DX12_RESOURCE_BARRIER::Transition(mRegistry.GetResource(barrier.resource), before, after));
+		}
+	}
+
+	if (mD3DBarrierScratch.empty())
+	{
+		return false;
+	}
+
+	commandList->ResourceBarrier(static_cast<UINT>(mD3DBarrierScratch.size()), mD3DBarrierScratch.data());
+	return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ResourceStateTracker.h"
+
+#include <vector>
+
+namespace BirdGame
+{
+	class ResourceStateRegistryDX;
+
+	// ResourceStateTracker for one D3D12 command list. Require() states while recording, FlushBarriers() before
+	// draws, copies and before closing the list. At submit time ResolveInitialBarriers() records the transitions
+	// from the registry states into a patch list that has to execute right before the tracked list, then Commit().
+	class ResourceStateTrackerDX final
+	{
+	public:
+		explicit ResourceStateTrackerDX(ResourceStateRegistryDX& registry);
+
+		void Require(TrackedResource resource, ResourceState state) { mTracker.Require(resource, state); }
+
+		// Records all transitions required so far in one ResourceBarrier call
+		void FlushBarriers(ID3D12GraphicsCommandList* commandList);
+
+		// Returns false, without recording anything, if the tracked list can start from the registry states as they are
+		bool ResolveInitialBarriers(ID3D12GraphicsCommandList* patchCommandList);
+
+		void Commit();
+
+	private:
+		ResourceStateTrackerDX(const ResourceStateTrackerDX&) = delete;
+
+		// Returns false if none of mBarrierScratch needed a D3D12 barrier
+		bool RecordBarriers(ID3D12GraphicsCommandList* commandList);
+
+		ResourceStateRegistryDX& mRegistry;
+		ResourceStateTracker mTracker;
+
+		std::vector<ResourceStateTracker::Barrier> mBarrierScratch;
+		std::vector<D3D12_RESOURCE_BARRIER> mD3DBarrierScratch;
+	};
+}
@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "ShaderHotReloaderDX.h"
+
+#include "ShaderLibraryDX.h"
+
+#include <assert.h>
+#include <algorithm>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	// Editors tend to write a file in several steps, so don't look more often than this
+	constexpr std::chrono::milliseconds kPollInterval(250);
+
+	void DebugLog(const std::string& message)
+	{
+		OutputDebugStringA((message + "\n").c_str());
+	}
+}
+
+BirdGame::ShaderHotReloaderDX::ShaderHotReloaderDX() :
+	mWatcher(kPollInterval),
+	mStopping(false)
+{
+}
+
+BirdGame::ShaderHotReloaderDX::~ShaderHotReloaderDX()
+{
+	Stop();
+}
+
+void BirdGame::ShaderHotReloaderDX::AddPipeline(uint32_t id, const ShaderProgramDesc& vertexShader, const ShaderProgramDesc& pixelShader, BuildPipeline build)
+{
+	assert(!mWorker.joinable() && "Pipelines can't be added while the reloader is running");
+
+	mPipelines.push_back({ id, vertexShader, pixelShader, std::move(build) });
+}
+
+void BirdGame::ShaderHotReloaderDX::Start(const std::string& sourceRoot)
+{
+	assert(!mWorker.joinable());
+
+	mSourceRoot = sourceRoot;
+	for (const Pipeline& pipeline : mPipelines)
+	{
+		mWatcher.Watch(GetSourcePath(pipeline.vertexShader));
+		mWatcher.Watch(GetSourcePath(pipeline.pixelShader));
+	}
+	DebugLog("Watching shader sources in " + (mSourceRoot.empty() ? std::string("the working directory") : mSourceRoot));
+
+	mStopping = false;
+	mWorker = std::thread(&ShaderHotReloaderDX::WorkerMain, this);
+}
+
+void BirdGame::ShaderHotReloaderDX::Stop()
+{
+	if (!mWorker.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+		mPending.clear();
+	}
+	mWorkAvailable.notify_one();
+	mWorker.join();
+
+	mFinished.clear();
+}
+
+void BirdGame::ShaderHotReloaderDX::Update(std::vector<ReloadedPipeline>& reloaded)
+{
+	mChangedFiles.clear();
+	if (mWatcher.Poll(mChangedFiles))
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (size_t index = 0; index < mPipelines.size(); ++index)
+		{
+			const Pipeline& pipeline = mPipelines[index];
+			const bool changed = std::any_of(mChangedFiles.begin(), mChangedFiles.end(), [&](const std::string& path)
+			{
+				return path == GetSourcePath(pipeline.vertexShader) || path == GetSourcePath(pipeline.pixelShader);
+			});
+
+			if (changed && std::find(mPending.begin(), mPending.end(), index) == mPending.end())
+			{
+				mPending.push_back(index);
+			}
+		}
+	}
+
+	bool workQueued = false;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		workQueued = !mPending.empty();
+		for (ReloadedPipeline& pipeline : mFinished)
+		{
+			reloaded.push_back(std::move(pipeline));
+		}
+		mFinished.clear();
+	}
+
+	if (workQueued)
+	{
+		mWorkAvailable.notify_one();
+	}
+}
+
+void BirdGame::ShaderHotReloaderDX::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (;;)
+	{
+		mWorkAvailable.wait(lock, [this]() { return mStopping || !mPending.empty(); });
+		if (mStopping)
+		{
+			return;
+		}
+
+		const size_t index = mPending.front();
+		mPending.erase(mPending.begin());
+
+		// Compiling takes a while, don't hold up the render thread meanwhile
+		lock.unlock();
+		Rebuild(mPipelines[index]);
+		lock.lock();
+	}
+}
+
+void BirdGame::ShaderHotReloaderDX::Rebuild(const Pipeline& pipeline)
+{
+	ComPtr<ID3DBlob> vertexShader;
+	ComPtr<ID3DBlob> pixelShader;
+	std::string errors;
+
+	if (!ShaderLibraryDX::CompileFromSource(pipeline.vertexShader, GetSourcePath(pipeline.vertexShader), vertexShader, errors) ||
+		!ShaderLibraryDX::CompileFromSource(pipeline.pixelShader, GetSourcePath(pipeline.pixelShader), pixelShader, errors))
+	{
+		DebugLog("Shader reload failed, keeping the previous pipeline:\n" + errors);
+		return;
+	}
+
+	ComPtr<ID3D12PipelineState> pipelineState = pipeline.build(CD3DX12_SHADER_BYTECODE(vertexShader.Get()), CD3DX12_SHADER_BYTECODE(pixelShader.Get()));
+	if (pipelineState == nullptr)
+	{
+		DebugLog("Shader reload failed, the pipeline couldn't be created. Keeping the previous pipeline.");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFinished.push_back({ pipeline.id, std::move(pipelineState) });
+}
+
+std::string BirdGame::ShaderHotReloaderDX::GetSourcePath(const ShaderProgramDesc& program) const
+{
+	return mSourceRoot.empty() ? std::string(program.sourcePath) : mSourceRoot + "/" + program.sourcePath;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "FileWatcher.h"
+#include "ShaderManifest.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BirdGame
+{
+	// Development tool: watches the shader sources of registered pipelines and rebuilds a pipeline on a worker
+	// thread when one of its sources changes. Finished pipelines are handed out by Update(), which the renderer
+	// calls at a frame boundary to swap them in. Compile errors are logged and the old pipeline is kept.
+	// Sources are watched under a source root, normally the checkout: the assets next to the executable are a copy
+	// the build mirrors over on every build, so edits there would be lost.
+	class ShaderHotReloaderDX final
+	{
+	public:
+		// Called on the worker thread with the new bytecode. Returns the new pipeline, or null if it couldn't be created.
+		using BuildPipeline = std::function<Microsoft::WRL::ComPtr<ID3D12PipelineState>(const D3D12_SHADER_BYTECODE& vertexShader, const D3D12_SHADER_BYTECODE& pixelShader)>;
+
+		struct ReloadedPipeline
+		{
+			uint32_t id;
+			Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState;
+		};
+
+		ShaderHotReloaderDX();
+		~ShaderHotReloaderDX();
+
+		// Pipelines have to be added before Start()
+		void AddPipeline(uint32_t id, const ShaderProgramDesc& vertexShader, const ShaderProgramDesc& pixelShader, BuildPipeline build);
+
+		// Watches and compiles the shader sources under sourceRoot, e.g. "C:/code/bird-game" for
+		// "C:/code/bird-game/assets/shaders/shaders.hlsl". Empty watches the copies in the working directory.
+		void Start(const std::string& sourceRoot);
+
+		// Waits for the rebuild in progress, if any. Pipelines that haven't been picked up by Update() are dropped.
+		void Stop();
+
+		// Queues rebuilds for pipelines whose sources changed and appends the pipelines finished since the last call
+		void Update(std::vector<ReloadedPipeline>& reloaded);
+
+	private:
+		ShaderHotReloaderDX(const ShaderHotReloaderDX&) = delete;
+
+		struct Pipeline
+		{
+			uint32_t id;
+			ShaderProgramDesc vertexShader;
+			ShaderProgramDesc pixelShader;
+			BuildPipeline build;
+		};
+
+		void WorkerMain();
+		void Rebuild(const Pipeline& pipeline);
+
+		// Where the source of program is read from
+		std::string GetSourcePath(const ShaderProgramDesc& program) const;
+
+		std::string mSourceRoot; // Not modified while the worker is running
+		FileWatcher mWatcher;
+		std::vector<std::string> mChangedFiles;
+
+		// Not modified while the worker is running, so the worker reads it without locking
+		std::vector<Pipeline> mPipelines;
+
+		std::thread mWorker;
+		std::mutex mMutex;
+		std::condition_variable mWorkAvailable;
+
+		// Guarded by mMutex
+		std::vector<size_t> mPending; // Indices into mPipelines
+		std::vector<ReloadedPipeline> mFinished;
+		bool mStopping;
+	};
+}
@@ -0,0 +1,205 @@
+#include "pch.h"
+#include "ShaderLibraryDX.h"
+
+#include "MappedFile.h"
+
+#include <assert.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	constexpr const char* kManifestFileName = "manifest.txt";
+
+	void DebugLog(const std::string& message)
+	{
+		OutputDebugStringA((message + "\n").c_str());
+	}
+
+	std::string Describe(const BirdGame::ShaderProgramDesc& program)
+	{
+		return std::string(program.sourcePath) + " (" + program.entryPoint + ", " + program.profile + ")";
+	}
+
+	// Compiles from the mapped source rather than the path so the result always matches the hash taken from it.
+	// sourceName is where the source was read from, which is where #includes are looked up.
+	HRESULT CompileProgram(const BirdGame::ShaderProgramDesc& program, const char* sourceName, const BirdGame::MappedFile& source, UINT flags, ComPtr<ID3DBlob>& bytecode, std::string& errors)
+	{
+		std::vector<D3D_SHADER_MACRO> macros;
+		for (uint32_t i = 0; i < program.defineCount; ++i)
+		{
+			macros.push_back({ program.defines[i].name, program.defines[i].value });
+		}
+		macros.push_back({ nullptr, nullptr });
+
+		ComPtr<ID3DBlob> errorBlob;
+		const HRESULT result = D3DCompile(source.GetData(), source.GetSize(), sourceName, macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+			program.entryPoint, program.profile, flags, 0, &bytecode, &errorBlob);
+
+		errors.clear();
+		if (errorBlob != nullptr)
+		{
+			errors.assign(static_cast<const char*>(errorBlob->GetBufferPointer()), errorBlob->GetBufferSize());
+		}
+
+		return result;
+	}
+
+#if defined(_DEBUG)
+	// Enable better shader debugging with the graphics debugging tools.
+	constexpr UINT kRuntimeCompileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	constexpr UINT kRuntimeCompileFlags = 0;
+#endif
+}
+
+BirdGame::ShaderLibraryDX::ShaderLibraryDX() :
+	mCheckSources(false)
+{
+}
+
+BirdGame::ShaderLibraryDX::~ShaderLibraryDX()
+{
+}
+
+void BirdGame::ShaderLibraryDX::Initialize(const std::string& compiledDirectory, bool checkSources)
+{
+	mCompiledDirectory = compiledDirectory;
+	mCheckSources = checkSources;
+
+	if (!mManifest.Load(mCompiledDirectory + "/" + kManifestFileName))
+	{
+		DebugLog("No usable shader manifest in " + mCompiledDirectory);
+	}
+}
+
+void BirdGame::ShaderLibraryDX::Destroy()
+{
+	mPrograms.clear();
+}
+
+D3D12_SHADER_BYTECODE BirdGame::ShaderLibraryDX::GetBytecode(const ShaderProgramDesc& program)
+{
+	const uint64_t programKey = ShaderManifest::ComputeProgramKey(program);
+
+	auto it = mPrograms.find(programKey);
+	if (it == mPrograms.end())
+	{
+		Program loaded;
+		const ShaderManifest::Entry* entry = mManifest.Find(programKey);
+
+		// Shipping builds trust the manifest. Only development builds pay for reading and hashing the source.
+		MappedFile source;
+		bool stale = false;
+		if (mCheckSources)
+		{
+			if (!source.Open(program.sourcePath))
+			{
+				throw std::runtime_error("Can't open shader source " + std::string(program.sourcePath));
+			}
+			stale = (entry != nullptr) && (entry->sourceHash != ShaderManifest::HashSource(source.GetData(), source.GetSize()));
+		}
+
+		if (entry != nullptr && !stale)
+		{
+			loaded.file.reset(new MappedFile());
+			if (!loaded.file->Open((mCompiledDirectory + "/" + entry->blobFile).c_str()))
+			{
+				loaded.file.reset();
+			}
+		}
+
+		if (loaded.file == nullptr)
+		{
+			// The post-build step compiles everything, so outside development a missing blob is a broken install
+			if (!mCheckSources)
+			{
+				throw std::runtime_error("No precompiled bytecode for " + Describe(program) + ". Run the game with -compileshaders to build it.");
+			}
+
+			DebugLog("Compiling " + Describe(program) + " at runtime, its precompiled bytecode is " + (stale ? "out of date" : "missing"));
+
+			std::string errors;
+			if (FAILED(CompileProgram(program, program.sourcePath, source, kRuntimeCompileFlags, loaded.blob, errors)))
+			{
+				throw std::runtime_error("Failed to compile " + Describe(program) + "\n" + errors);
+			}
+		}
+
+		it = mPrograms.emplace(programKey, std::move(loaded)).first;
+	}
+
+	const Program& loaded = it->second;
+	if (loaded.file != nullptr)
+	{
+		return { loaded.file->GetData(), loaded.file->GetSize() };
+	}
+	return { loaded.blob->GetBufferPointer(), loaded.blob->GetBufferSize() };
+}
+
+bool BirdGame::ShaderLibraryDX::CompileFromSource(const ShaderProgramDesc& program, const std::string& sourcePath, ComPtr<ID3DBlob>& bytecode, std::string& errors)
+{
+	MappedFile source;
+	if (!source.Open(sourcePath.c_str()))
+	{
+		errors = "Can't open shader source " + sourcePath;
+		return false;
+	}
+
+	return SUCCEEDED(CompileProgram(program, sourcePath.c_str(), source, kRuntimeCompileFlags, bytecode, errors));
+}
+
+bool BirdGame::ShaderLibraryDX::CompileOffline(const ShaderProgramDesc* programs, uint32_t programCount, const std::string& compiledDirectory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(compiledDirectory, error);
+
+	ShaderManifest manifest;
+	bool succeeded = true;
+	for (uint32_t i = 0; i < programCount; ++i)
+	{
+		const ShaderProgramDesc& program = programs[i];
+
+		MappedFile source;
+		if (!source.Open(program.sourcePath))
+		{
+			DebugLog("Can't open shader source " + std::string(program.sourcePath));
+			succeeded = false;
+			continue;
+		}
+
+		ComPtr<ID3DBlob> bytecode;
+		std::string errors;
+		if (FAILED(CompileProgram(program, program.sourcePath, source, D3DCOMPILE_OPTIMIZATION_LEVEL3, bytecode, errors)))
+		{
+			DebugLog("Failed to compile " + Describe(program) + "\n" + errors);
+			succeeded = false;
+			continue;
+		}
+
+		const uint64_t programKey = ShaderManifest::ComputeProgramKey(program);
+		const uint64_t sourceHash = ShaderManifest::HashSource(source.GetData(), source.GetSize());
+		manifest.Set(programKey, sourceHash, program);
+
+		std::ofstream blob(compiledDirectory + "/" + manifest.Find(programKey)->blobFile, std::ios::binary | std::ios::trunc);
+		blob.write(static_cast<const char*>(bytecode->GetBufferPointer()), bytecode->GetBufferSize());
+		if (!blob)
+		{
+			DebugLog("Failed to write bytecode for " + Describe(program));
+			succeeded = false;
+		}
+	}
+
+	// Only replace the manifest once everything built, so a broken shader doesn't take the working blobs with it
+	if (succeeded)
+	{
+		succeeded = manifest.Save(compiledDirectory + "/" + kManifestFileName);
+	}
+
+	DebugLog(succeeded ? "Shaders compiled" : "Shader compilation failed");
+	return succeeded;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ShaderManifest.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace BirdGame
+{
+	class MappedFile;
+
+	// Hands out shader bytecode that was compiled ahead of time by CompileOffline(). Blobs are memory-mapped
+	// straight from disk. With checkSources, programs whose blob is missing or whose source changed since they
+	// were compiled are compiled from source at runtime instead; that costs reading and hashing every source, so
+	// only development builds do it. Other builds only ever load precompiled bytecode.
+	class ShaderLibraryDX final
+	{
+	public:
+		ShaderLibraryDX();
+		~ShaderLibraryDX();
+
+		void Initialize(const std::string& compiledDirectory, bool checkSources);
+		void Destroy();
+
+		// The bytecode stays valid until Destroy(). Throws if the program isn't available.
+		D3D12_SHADER_BYTECODE GetBytecode(const ShaderProgramDesc& program);
+
+		// Compiles the source at sourcePath, a copy of program.sourcePath that may live elsewhere (e.g. in the source
+		// tree), with the development settings without touching the library or throwing. Includes are resolved next
+		// to sourcePath. Safe to call from any thread. errors receives the compiler output, including warnings on success.
+		static bool CompileFromSource(const ShaderProgramDesc& program, const std::string& sourcePath, Microsoft::WRL::ComPtr<ID3DBlob>& bytecode, std::string& errors);
+
+		// Compiles every program with full optimizations and writes the blobs and the manifest to compiledDirectory.
+		// Returns false if anything failed to compile, after trying all of them.
+		static bool CompileOffline(const ShaderProgramDesc* programs, uint32_t programCount, const std::string& compiledDirectory);
+
+	private:
+		ShaderLibraryDX(const ShaderLibraryDX&) = delete;
+
+		// Exactly one of the two is set, depending on where the bytecode came from
+		struct Program
+		{
+			std::unique_ptr<MappedFile> file;
+			Microsoft::WRL::ComPtr<ID3DBlob> blob;
+		};
+
+		std::string mCompiledDirectory;
+		bool mCheckSources;
+		ShaderManifest mManifest;
+		std::unordered_map<uint64_t, Program> mPrograms;
+	};
+}
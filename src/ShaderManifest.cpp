@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "ShaderManifest.h"
+
+#include "Hash.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	constexpr const char* kHeader = "BirdGameShaderManifest";
+
+	// The whole field has to be a hex number. Unlike std::stoull, never throws.
+	bool ParseHex(const std::string& field, uint64_t& value)
+	{
+		const char* end = field.data() + field.size();
+		const std::from_chars_result result = std::from_chars(field.data(), end, value, 16);
+		return result.ec == std::errc() && result.ptr == end;
+	}
+}
+
+uint64_t BirdGame::ShaderManifest::ComputeProgramKey(const ShaderProgramDesc& program)
+{
+	Hasher hasher;
+	hasher.AddString(program.sourcePath).AddString(program.entryPoint).AddString(program.profile);
+
+	// Define order doesn't change the compiled result, so don't let it change the key either
+	std::vector<std::pair<std::string, std::string>> defines;
+	for (uint32_t i = 0; i < program.defineCount; ++i)
+	{
+		defines.emplace_back(program.defines[i].name, program.defines[i].value != nullptr ? program.defines[i].value : "");
+	}
+	std::sort(defines.begin(), defines.end());
+
+	hasher.AddValue(program.defineCount);
+	for (const auto& [name, value] : defines)
+	{
+		hasher.AddString(name.c_str()).AddString(value.c_str());
+	}
+
+	return hasher.Get();
+}
+
+uint64_t BirdGame::ShaderManifest::HashSource(const void* source, size_t size)
+{
+	return HashFnv1a(source, size);
+}
+
+std::string BirdGame::ShaderManifest::MakeBlobFileName(uint64_t programKey, uint64_t sourceHash)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "%016" PRIx64 "_%016" PRIx64 ".cso", programKey, sourceHash);
+	return name;
+}
+
+bool BirdGame::ShaderManifest::Load(const std::string& path)
+{
+	mEntries.clear();
+
+	std::ifstream file(path);
+	std::string header;
+	uint32_t version = 0;
+	if (!(file >> header >> version) || header != kHeader || version != kFormatVersion)
+	{
+		return false;
+	}
+
+	std::string line;
+	std::getline(file, line); // Rest of the header line
+	while (std::getline(file, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+
+		std::istringstream fields(line);
+		std::string programKeyField;
+		std::string sourceHashField;
+		uint64_t programKey = 0;
+		Entry entry;
+		if (!(fields >> programKeyField >> sourceHashField >> entry.blobFile) || !ParseHex(programKeyField, programKey) || !ParseHex(sourceHashField, entry.sourceHash))
+		{
+			mEntries.clear();
+			return false;
+		}
+
+		std::getline(fields >> std::ws, entry.description);
+		mEntries[programKey] = entry;
+	}
+
+	return true;
+}
+
+bool BirdGame::ShaderManifest::Save(const std::string& path) const
+{
+	// Sorted so rebuilding the same shaders gives the same file
+	std::vector<uint64_t> keys;
+	for (const auto& [key, entry] : mEntries)
+	{
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::ofstream file(path, std::ios::trunc);
+	file << kHeader << ' ' << kFormatVersion << '\n';
+	for (uint64_t key : keys)
+	{
+		const Entry& entry = mEntries.at(key);
+		char hashes[64];
+		snprintf(hashes, sizeof(hashes), "%016" PRIx64 " %016" PRIx64, key, entry.sourceHash);
+		file << hashes << ' ' << entry.blobFile << ' ' << entry.description << '\n';
+	}
+
+	return static_cast<bool>(file);
+}
+
+const BirdGame::ShaderManifest::Entry* BirdGame::ShaderManifest::Find(uint64_t programKey) const
+{
+	auto it = mEntries.find(programKey);
+	return (it != mEntries.end()) ? &it->second : nullptr;
+}
+
+void BirdGame::ShaderManifest::Set(uint64_t programKey, uint64_t sourceHash, const ShaderProgramDesc& program)
+{
+	Entry& entry = mEntries[programKey];
+	entry.sourceHash = sourceHash;
+	entry.blobFile = MakeBlobFileName(programKey, sourceHash);
+	entry.description = std::string(program.sourcePath) + ' ' + program.entryPoint + ' ' + program.profile;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace BirdGame
+{
+	struct ShaderDefine
+	{
+		const char* name;
+		const char* value;
+	};
+
+	// One entry point of one shader source file compiled for one target profile with a set of defines
+	struct ShaderProgramDesc
+	{
+		const char* sourcePath;
+		const char* entryPoint;
+		const char* profile;        // e.g. "vs_5_0"
+		const ShaderDefine* defines;
+		uint32_t defineCount;
+	};
+
+	// Maps shader programs to the precompiled bytecode blobs the offline shader build wrote next to the manifest.
+	// Entries are looked up by program key (source path, entry point, profile and defines) and remember the hash
+	// of the source they were compiled from, so a development build can tell that a blob is stale.
+	// The manifest is a text file so it diffs and merges nicely:
+	//   BirdGameShaderManifest <version>
+	//   <program key> <source hash> <blob file> <source path> <entry point> <profile>
+	class ShaderManifest final
+	{
+	public:
+		static constexpr uint32_t kFormatVersion = 1;
+
+		struct Entry
+		{
+			uint64_t sourceHash;
+			std::string blobFile;   // Relative to the manifest
+			std::string description;
+		};
+
+		ShaderManifest() = default;
+
+		static uint64_t ComputeProgramKey(const ShaderProgramDesc& program);
+
+		// Only hashes the file itself. Programs that #include other files have to be rebuilt by hand when those change.
+		static uint64_t HashSource(const void* source, size_t size);
+
+		// Blob names include the source hash so blobs from different versions of a shader never overwrite each other
+		static std::string MakeBlobFileName(uint64_t programKey, uint64_t sourceHash);
+
+		// Returns false and leaves the manifest empty if the file is missing, malformed or of a different version
+		bool Load(const std::string& path);
+		bool Save(const std::string& path) const;
+
+		const Entry* Find(uint64_t programKey) const;
+		void Set(uint64_t programKey, uint64_t sourceHash, const ShaderProgramDesc& program);
+
+		size_t GetEntryCount() const { return mEntries.size(); }
+
+	private:
+		ShaderManifest(const ShaderManifest&) = delete;
+
+		std::unordered_map<uint64_t, Entry> mEntries;
+	};
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "SignedDistanceField.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Flattened quadratics may deviate this many pixels from the real curve
+	constexpr float kFlatteningTolerance = 0.1f;
+	constexpr uint32_t kMaxSubdivisions = 16;
+
+	struct Edge
+	{
+		float x0, y0;
+		float x1, y1;
+	};
+
+	struct Crossing
+	{
+		float x;
+		int32_t winding;
+	};
+
+	void FlattenOutline(const BirdGame::GlyphOutline& outline, const BirdGame::SdfPlacement& placement, std::vector<Edge>& edges)
+	{
+		for (const BirdGame::OutlineSegment& segment : outline.segments)
+		{
+			const float x0 = segment.x0 * placement.scale + placement.originX;
+			const float y0 = placement.originY - segment.y0 * placement.scale;
+			const float cx = segment.cx * placement.scale + placement.originX;
+			const float cy = placement.originY - segment.cy * placement.scale;
+			const float x1 = segment.x1 * placement.scale + placement.originX;
+			const float y1 = placement.originY - segment.y1 * placement.scale;
+
+			// A quadratic split into n lines is off by at most |p0 - 2c + p1| / (8 n^2)
+			const float curvature = std::hypot(x0 - 2.0f * cx + x1, y0 - 2.0f * cy + y1);
+			const float subdivisions = std::ceil(std::sqrt(curvature / (8.0f * kFlatteningTolerance)));
+			const uint32_t count = std::clamp(static_cast<uint32_t>(subdivisions), 1u, kMaxSubdivisions);
+
+			float previousX = x0;
+			float previousY = y0;
+			for (uint32_t i = 1; i <= count; ++i)
+			{
+				const float t = static_cast<float>(i) / count;
+				const float u = 1.0f - t;
+				const float x = u * u * x0 + 2.0f * u * t * cx + t * t * x1;
+				const float y = u * u * y0 + 2.0f * u * t * cy + t * t * y1;
+				edges.push_back({ previousX, previousY, x, y });
+				previousX = x;
+				previousY = y;
+			}
+		}
+	}
+
+	float SquaredDistanceToEdge(float px, float py, const Edge& edge)
+	{
+		const float dx = edge.x1 - edge.x0;
+		const float dy = edge.y1 - edge.y0;
+		const float lengthSquared = dx * dx + dy * dy;
+		float t = 0.0f;
+		if (lengthSquared > 0.0f)
+		{
+			t = std::clamp(((px - edge.x0) * dx + (py - edge.y0) * dy) / lengthSquared, 0.0f, 1.0f);
+		}
+
+		const float ex = edge.x0 + t * dx - px;
+		const float ey = edge.y0 + t * dy - py;
+		return ex * ex + ey * ey;
+	}
+}
+
+void BirdGame::GenerateSignedDistanceField(const GlyphOutline& outline, const SdfPlacement& placement, float range, Image& image)
+{
+	std::vector<Edge> edges;
+	FlattenOutline(outline, placement, edges);
+
+	std::vector<Crossing> crossings;
+	for (uint32_t y = 0; y < image.height; ++y)
+	{
+		const float py = y + 0.5f;
+
+		// Nonzero winding along the row: collect where edges cross it, then sweep left to right
+		crossings.clear();
+		for (const Edge& edge : edges)
+		{
+			const bool down = edge.y0 <= py && py < edge.y1;
+			const bool up = edge.y1 <= py && py < edge.y0;
+			if (down || up)
+			{
+				const float t = (py - edge.y0) / (edge.y1 - edge.y0);
+				crossings.push_back({ edge.x0 + t * (edge.x1 - edge.x0), down ? 1 : -1 });
+			}
+		}
+		std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b)
+		{
+			return a.x < b.x;
+		});
+
+		size_t nextCrossing = 0;
+		int32_t winding = 0;
+		for (uint32_t x = 0; x < image.width; ++x)
+		{
+			const float px = x + 0.5f;
+			for (; nextCrossing < crossings.size() && crossings[nextCrossing].x <= px; ++nextCrossing)
+			{
+				winding += crossings[nextCrossing].winding;
+			}
+
+			float nearest = FLT_MAX;
+			for (const Edge& edge : edges)
+			{
+				nearest = std::min(nearest, SquaredDistanceToEdge(px, py, edge));
+			}
+
+			const float distance = (winding != 0) ? std::sqrt(nearest) : -std::sqrt(nearest);
+			const float value = std::clamp(0.5f + distance / (2.0f * range), 0.0f, 1.0f);
+
+			uint8_t* pixel = image.GetPixel(x, y);
+			pixel[0] = 255;
+			pixel[1] = 255;
+			pixel[2] = 255;
+			pixel[3] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+		}
+	}
+}
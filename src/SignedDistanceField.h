@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Image.h"
+#include "TrueTypeFont.h"
+
+namespace BirdGame
+{
+	// Maps outline coordinates (font units, y up) to pixels (y down): px = x * scale + originX, py = originY - y * scale
+	struct SdfPlacement
+	{
+		float scale;
+		float originX;
+		float originY;
+	};
+
+	// Renders an outline into image as a signed distance field sampled at pixel centers. The distance to the
+	// nearest edge is stored in alpha, mapped so 128 is the edge, 255 is range pixels or more inside and 0 is range
+	// pixels or more outside. RGB is white so the atlas also works with the regular sprite shader for debugging.
+	// The image keeps its size; an empty outline produces a field that is entirely outside.
+	void GenerateSignedDistanceField(const GlyphOutline& outline, const SdfPlacement& placement, float range, Image& image);
+}
@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+
+#include "RenderCommandBuffer.h"
+#include "SpriteBatch.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Point sample of the top level with D3D12_TEXTURE_ADDRESS_MODE_BORDER and a transparent black border. The GPU
+	// sampler filters minified sprites through the mip chain, so the two only match for sprites drawn at or above texture size.
+	void SampleTexture(const BirdGame::Image* texture, float u, float v, float outTexel[4])
+	{
+		if (texture != nullptr && u >= 0.0f && u < 1.0f && v >= 0.0f && v < 1.0f)
+		{
+			const uint32_t x = std::min(static_cast<uint32_t>(u * texture->width), texture->width - 1);
+			const uint32_t y = std::min(static_cast<uint32_t>(v * texture->height), texture->height - 1);
+			const uint8_t* texel = texture->GetPixel(x, y);
+			for (int c = 0; c < 4; ++c)
+			{
+				outTexel[c] = texel[c] / 255.0f;
+			}
+		}
+		else
+		{
+			outTexel[0] = outTexel[1] = outTexel[2] = outTexel[3] = 0.0f;
+		}
+	}
+
+	// Bilinear sample of the alpha channel with D3D12_TEXTURE_ADDRESS_MODE_CLAMP, like g_linearSampler in shaders.hlsl
+	float SampleDistance(const BirdGame::Image* texture, float u, float v)
+	{
+		if (texture == nullptr)
+		{
+			return 0.0f;
+		}
+
+		const float x = std::clamp(u * texture->width - 0.5f, 0.0f, static_cast<float>(texture->width - 1));
+		const float y = std::clamp(v * texture->height - 0.5f, 0.0f, static_cast<float>(texture->height - 1));
+		const uint32_t x0 = static_cast<uint32_t>(x);
+		const uint32_t y0 = static_cast<uint32_t>(y);
+		const uint32_t x1 = std::min(x0 + 1, texture->width - 1);
+		const uint32_t y1 = std::min(y0 + 1, texture->height - 1);
+		const float fx = x - x0;
+		const float fy = y - y0;
+
+		const float top = texture->GetPixel(x0, y0)[3] * (1.0f - fx) + texture->GetPixel(x1, y0)[3] * fx;
+		const float bottom = texture->GetPixel(x0, y1)[3] * (1.0f - fx) + texture->GetPixel(x1, y1)[3] * fx;
+		return (top * (1.0f - fy) + bottom * fy) / 255.0f;
+	}
+
+	float Smoothstep(float edge0, float edge1, float value)
+	{
+		const float t = std::clamp((value - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	uint8_t ToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+}
+
+BirdGame::SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height)
+{
+	mFramebuffer.Resize(width, height);
+}
+
+void BirdGame::SoftwareRasterizer::Clear(Color color)
+{
+	for (size_t i = 0; i < mFramebuffer.pixels.size(); i += Image::kBytesPerPixel)
+	{
+		mFramebuffer.pixels[i] = color.r;
+		mFramebuffer.pixels[i + 1] = color.g;
+		mFramebuffer.pixels[i + 2] = color.b;
+		mFramebuffer.pixels[i + 3] = color.a;
+	}
+}
+
+void BirdGame::SoftwareRasterizer::Execute(const RenderCommandBuffer& commands, const SpriteInstance* instances, const TextureLookup& textureLookup)
+{
+	for (const DrawPacket& packet : commands.GetPackets())
+	{
+		// Both pipelines blend the same way and only differ in the pixel shader
+		const PipelineId pipeline = SortKey::GetPipeline(packet.key);
+		assert(pipeline == PipelineId::Sprite || pipeline == PipelineId::Text);
+
+		// Like the GPU, every instance picks its own texture. Consecutive sprites mostly share one.
+		uint32_t textureIndex = UINT32_MAX;
+		const Image* texture = nullptr;
+		for (uint32_t i = packet.firstInstance; i < packet.firstInstance + packet.instanceCount; ++i)
+		{
+			const SpriteInstance& sprite = instances[i];
+			if (sprite.texture != textureIndex)
+			{
+				textureIndex = sprite.texture;
+				texture = textureLookup(textureIndex);
+			}
+
+			const float color[4] = { sprite.color.r / 255.0f, sprite.color.g / 255.0f, sprite.color.b / 255.0f, sprite.color.a / 255.0f };
+
+			// Same coverage rule as the GPU: a pixel is covered if its center is inside the rect (top-left rule)
+			const int32_t minX = std::max(0, static_cast<int32_t>(std::ceil(sprite.rect.x - 0.5f)));
+			const int32_t minY = std::max(0, static_cast<int32_t>(std::ceil(sprite.rect.y - 0.5f)));
+			const int32_t maxX = std::min(static_cast<int32_t>(mFramebuffer.width), static_cast<int32_t>(std::ceil(sprite.rect.x + sprite.rect.width - 0.5f)));
+			const int32_t maxY = std::min(static_cast<int32_t>(mFramebuffer.height), static_cast<int32_t>(std::ceil(sprite.rect.y + sprite.rect.height - 0.5f)));
+
+			// Texture coordinates change linearly across the rect, so the screen space derivatives are constant
+			const float uStep = sprite.uv.width / sprite.rect.width;
+			const float vStep = sprite.uv.height / sprite.rect.height;
+
+			for (int32_t y = minY; y < maxY; ++y)
+			{
+				const float v = sprite.uv.y + sprite.uv.height * ((y + 0.5f - sprite.rect.y) / sprite.rect.height);
+				for (int32_t x = minX; x < maxX; ++x)
+				{
+					const float u = sprite.uv.x + sprite.uv.width * ((x + 0.5f - sprite.rect.x) / sprite.rect.width);
+
+					float source[4];
+					if (pipeline == PipelineId::Text)
+					{
+						// PSText: the fwidth() of the distance from forward differences to the neighboring pixels
+						const float distance = SampleDistance(texture, u, v);
+						const float width = std::max(std::abs(SampleDistance(texture, u + uStep, v) - distance) + std::abs(SampleDistance(texture, u, v + vStep) - distance), 1e-4f);
+						source[0] = color[0];
+						source[1] = color[1];
+						source[2] = color[2];
+						source[3] = color[3] * Smoothstep(0.5f - width, 0.5f + width, distance);
+					}
+					else
+					{
+						SampleTexture(texture, u, v, source);
+						for (int c = 0; c < 4; ++c)
+						{
+							source[c] *= color[c];
+						}
+					}
+
+					// SRC_ALPHA, INV_SRC_ALPHA for color. ONE, INV_SRC_ALPHA for alpha.
+					uint8_t* destination = mFramebuffer.GetPixel(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+					const float alpha = source[3];
+					for (int c = 0; c < 3; ++c)
+					{
+						destination[c] = ToUnorm8(source[c] * alpha + (destination[c] / 255.0f) * (1.0f - alpha));
+					}
+					destination[3] = ToUnorm8(alpha + (destination[3] / 255.0f) * (1.0f - alpha));
+				}
+			}
+		}
+	}
+}
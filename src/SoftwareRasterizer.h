@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Image.h"
+#include "RenderTypes.h"
+
+#include <functional>
+
+namespace BirdGame
+{
+	class RenderCommandBuffer;
+	struct SpriteInstance;
+
+	// CPU reference implementation of the sprite and text pipelines: point sampling with a transparent black border
+	// and color modulation, or signed distance field text, with straight alpha blending, matching shaders.hlsl and
+	// the PSOs in RendererDX.cpp.
+	// Used to validate sprite batches and render command streams without a GPU.
+	class SoftwareRasterizer final
+	{
+	public:
+		// Maps a texture table index (SpriteInstance::texture) to its image. Returns nullptr for unknown textures,
+		// which are then sampled as transparent black.
+		using TextureLookup = std::function<const Image*(uint32_t textureIndex)>;
+
+		SoftwareRasterizer(uint32_t width, uint32_t height);
+
+		void Clear(Color color);
+
+		// Replays a sorted command stream the same way the GPU does: packet by packet, instance by instance
+		void Execute(const RenderCommandBuffer& commands, const SpriteInstance* instances, const TextureLookup& textureLookup);
+
+		const Image& GetFramebuffer() const { return mFramebuffer; }
+
+	private:
+		SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+
+		Image mFramebuffer;
+	};
+}
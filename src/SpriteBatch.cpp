@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "SpriteBatch.h"
+
+#include "RadixSort.h"
+
+#include <assert.h>
+
+BirdGame::SpriteBatch::SpriteBatch(uint32_t maxSprites) :
+	mMaxSprites(maxSprites),
+	mCuller(maxSprites)
+{
+	mSubmitted.reserve(maxSprites);
+	mSubmittedKeys.reserve(maxSprites);
+	mSorted.reserve(maxSprites);
+	mSortKeys.reserve(maxSprites);
+	mSortIndices.reserve(maxSprites);
+	mScratchKeys.reserve(maxSprites);
+	mScratchIndices.reserve(maxSprites);
+}
+
+void BirdGame::SpriteBatch::Submit(uint32_t textureIndex, const Rect& rect, const Rect& uv, Color color, uint8_t layer, PipelineId pipeline)
+{
+	if (mSubmitted.size() >= mMaxSprites)
+	{
+		assert(false && "Too many sprites submitted this frame");
+		return;
+	}
+
+	// The texture stays out of the key, the shader picks it per instance
+	mSubmittedKeys.push_back(SortKey::Make(layer, BlendMode::Alpha, pipeline, 0, 0));
+	mSubmitted.push_back({ rect, uv, color, textureIndex });
+	mCuller.Add(rect);
+}
+
+void BirdGame::SpriteBatch::Build(RenderCommandBuffer& commands, const Rect& view)
+{
+	// Visible indices come out in submission order, which the stable sort below relies on
+	mCuller.Cull(view, mSortIndices);
+
+	const size_t count = mSortIndices.size();
+	mSortKeys.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSortKeys[i] = mSubmittedKeys[mSortIndices[i]];
+	}
+
+	mScratchKeys.resize(count);
+	mScratchIndices.resize(count);
+
+	// Radix sort is stable, so sprites with the same key keep their submission order
+	RadixSort(mSortKeys.data(), mSortIndices.data(), mScratchKeys.data(), mScratchIndices.data(), count);
+
+	mSorted.resize(count);
+	size_t batchStart = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSorted[i] = mSubmitted[mSortIndices[i]];
+
+		// Close the batch once the next sprite needs different state
+		if (i + 1 == count || mSortKeys[i + 1] != mSortKeys[i])
+		{
+			commands.Submit({ mSortKeys[i], static_cast<uint32_t>(batchStart), static_cast<uint32_t>(i + 1 - batchStart) });
+			batchStart = i + 1;
+		}
+	}
+}
+
+void BirdGame::SpriteBatch::Clear()
+{
+	mSubmitted.clear();
+	mSubmittedKeys.clear();
+	mCuller.Clear();
+	mSorted.clear();
+	mSortKeys.clear();
+	mSortIndices.clear();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "RenderCommandBuffer.h"
+#include "RenderTypes.h"
+#include "SpriteCuller.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// Per-instance data consumed by the sprite vertex shader. Keep in sync with the input layout in RendererDX.cpp.
+	struct SpriteInstance
+	{
+		Rect rect;        // Screen space, in pixels
+		Rect uv;          // Normalized texture coordinates
+		Color color;      // Multiplied with the texture
+		uint32_t texture; // Slot in the bindless texture table, see TextureTable::GetIndex()
+	};
+
+	// Collects sprites for a frame and turns them into draw packets that each draw every sprite of a pipeline in a
+	// layer with one instanced draw. Textures are indexed per instance, so they don't split batches. Sprites outside the view
+	// are culled before sorting, so they cost neither sort time nor instance data. Backend-neutral: the
+	// renderer copies GetInstances() into its instance buffer and replays the packets.
+	class SpriteBatch final
+	{
+	public:
+		explicit SpriteBatch(uint32_t maxSprites);
+
+		// Sprites are drawn back to front by layer and in submission order within a layer, except that within a
+		// layer all PipelineId::Sprite draws come before all PipelineId::Text draws. Sprites past maxSprites are dropped.
+		void Submit(uint32_t textureIndex, const Rect& rect, const Rect& uv, Color color, uint8_t layer, PipelineId pipeline);
+
+		// Culls the submitted sprites against view, sorts the visible ones and submits one draw packet per batch.
+		// Call once per frame after all sprites were submitted.
+		void Build(RenderCommandBuffer& commands, const Rect& view);
+
+		// Call once the frame has been recorded. Keeps the allocated memory around for the next frame.
+		void Clear();
+
+		uint32_t GetSpriteCount() const { return static_cast<uint32_t>(mSubmitted.size()); }
+		uint32_t GetVisibleCount() const { return static_cast<uint32_t>(mSorted.size()); }
+		uint32_t GetMaxSprites() const { return mMaxSprites; }
+
+		// Valid after Build(). Draw packets index into this.
+		const std::vector<SpriteInstance>& GetInstances() const { return mSorted; }
+
+	private:
+		SpriteBatch(const SpriteBatch&) = delete;
+
+		uint32_t mMaxSprites;
+
+		std::vector<SpriteInstance> mSubmitted;
+		std::vector<uint64_t> mSubmittedKeys; // See SortKey
+		SpriteCuller mCuller;
+		std::vector<SpriteInstance> mSorted;
+
+		// Sort keys and submission indices of the visible sprites, plus radix sort scratch
+		std::vector<uint64_t> mSortKeys;
+		std::vector<uint32_t> mSortIndices;
+		std::vector<uint64_t> mScratchKeys;
+		std::vector<uint32_t> mScratchIndices;
+	};
+}
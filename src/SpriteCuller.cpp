@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "SpriteCuller.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BIRDGAME_CULL_SSE2 1
+#endif
+
+BirdGame::SpriteCuller::SpriteCuller(uint32_t maxRects)
+{
+	mMinX.reserve(maxRects);
+	mMinY.reserve(maxRects);
+	mMaxX.reserve(maxRects);
+	mMaxY.reserve(maxRects);
+}
+
+void BirdGame::SpriteCuller::Add(const Rect& rect)
+{
+	mMinX.push_back(std::min(rect.x, rect.x + rect.width));
+	mMinY.push_back(std::min(rect.y, rect.y + rect.height));
+	mMaxX.push_back(std::max(rect.x, rect.x + rect.width));
+	mMaxY.push_back(std::max(rect.y, rect.y + rect.height));
+}
+
+void BirdGame::SpriteCuller::Cull(const Rect& view, std::vector<uint32_t>& visible) const
+{
+	const uint32_t count = GetCount();
+	const float viewMinX = view.x;
+	const float viewMinY = view.y;
+	const float viewMaxX = view.x + view.width;
+	const float viewMaxY = view.y + view.height;
+
+	// Every index is written and the output position only advances past visible ones, so there are no branches
+	// on the test results. Worst case everything is visible, which is what the vector is sized for.
+	visible.resize(count);
+	uint32_t* out = visible.data();
+	uint32_t visibleCount = 0;
+	uint32_t i = 0;
+
+#if defined(BIRDGAME_CULL_SSE2)
+	const __m128 minX = _mm_set1_ps(viewMinX);
+	const __m128 minY = _mm_set1_ps(viewMinY);
+	const __m128 maxX = _mm_set1_ps(viewMaxX);
+	const __m128 maxY = _mm_set1_ps(viewMaxY);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 overlapX = _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(&mMaxX[i]), minX), _mm_cmplt_ps(_mm_loadu_ps(&mMinX[i]), maxX));
+		const __m128 overlapY = _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(&mMaxY[i]), minY), _mm_cmplt_ps(_mm_loadu_ps(&mMinY[i]), maxY));
+		const int mask = _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+
+		out[visibleCount] = i;
+		visibleCount += mask & 1;
+		out[visibleCount] = i + 1;
+		visibleCount += (mask >> 1) & 1;
+		out[visibleCount] = i + 2;
+		visibleCount += (mask >> 2) & 1;
+		out[visibleCount] = i + 3;
+		visibleCount += (mask >> 3) & 1;
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const bool overlaps = mMaxX[i] > viewMinX && mMinX[i] < viewMaxX && mMaxY[i] > viewMinY && mMinY[i] < viewMaxY;
+		out[visibleCount] = i;
+		visibleCount += overlaps ? 1 : 0;
+	}
+
+	visible.resize(visibleCount);
+}
+
+void BirdGame::SpriteCuller::Clear()
+{
+	mMinX.clear();
+	mMinY.clear();
+	mMaxX.clear();
+	mMaxY.clear();
+}
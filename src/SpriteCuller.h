@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// Tests sprite bounds against a view rectangle. Bounds are kept as structure of arrays so four sprites are
+	// tested at once with SSE2 (with a scalar fallback elsewhere), and the indices of the visible ones are
+	// written out densely, in the order they were added.
+	class SpriteCuller final
+	{
+	public:
+		explicit SpriteCuller(uint32_t maxRects);
+
+		// Negative sizes (mirrored sprites) are fine
+		void Add(const Rect& rect);
+
+		// Sets visible to the indices of the rects that overlap view. Rects that only touch its edge are culled.
+		void Cull(const Rect& view, std::vector<uint32_t>& visible) const;
+
+		void Clear();
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(mMinX.size()); }
+
+	private:
+		SpriteCuller(const SpriteCuller&) = delete;
+
+		std::vector<float> mMinX;
+		std::vector<float> mMinY;
+		std::vector<float> mMaxX;
+		std::vector<float> mMaxY;
+	};
+}
@@ -0,0 +1,250 @@
+#include "pch.h"
+#include "TextLayout.h"
+
+#include "GlyphAtlas.h"
+#include "Hash.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+	constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+	// Decodes one code point and advances text past it. Malformed sequences decode to U+FFFD one byte at a time.
+	uint32_t DecodeUtf8(const char*& text)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text);
+		uint32_t length = 0;
+		uint32_t codepoint = 0;
+		if (bytes[0] < 0x80)
+		{
+			length = 1;
+			codepoint = bytes[0];
+		}
+		else if ((bytes[0] & 0xE0) == 0xC0)
+		{
+			length = 2;
+			codepoint = bytes[0] & 0x1F;
+		}
+		else if ((bytes[0] & 0xF0) == 0xE0)
+		{
+			length = 3;
+			codepoint = bytes[0] & 0x0F;
+		}
+		else if ((bytes[0] & 0xF8) == 0xF0)
+		{
+			length = 4;
+			codepoint = bytes[0] & 0x07;
+		}
+		else
+		{
+			++text;
+			return kReplacementCharacter;
+		}
+
+		for (uint32_t i = 1; i < length; ++i)
+		{
+			// Also stops at the terminator, which isn't a continuation byte
+			if ((bytes[i] & 0xC0) != 0x80)
+			{
+				++text;
+				return kReplacementCharacter;
+			}
+			codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+		}
+
+		text += length;
+		return codepoint;
+	}
+
+	bool SameStyle(const BirdGame::TextStyle& a, const BirdGame::TextStyle& b)
+	{
+		return a.size == b.size && a.wrapWidth == b.wrapWidth && a.align == b.align;
+	}
+}
+
+BirdGame::TextLayout::TextLayout(uint32_t maxCachedRuns) :
+	mMaxCachedRuns(maxCachedRuns)
+{
+	assert(maxCachedRuns > 0);
+	mLookup.reserve(maxCachedRuns);
+}
+
+const BirdGame::TextRun& BirdGame::TextLayout::Layout(const GlyphAtlas& font, const char* text, const TextStyle& style)
+{
+	const uint64_t hash = Hasher().AddString(text).AddValue(&font).AddValue(style.size).AddValue(style.wrapWidth).AddValue(style.align).Get();
+
+	auto range = mLookup.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		Entry& entry = *it->second;
+		if (entry.font == &font && SameStyle(entry.style, style) && entry.text == text)
+		{
+			mEntries.splice(mEntries.begin(), mEntries, it->second);
+			return entry.run;
+		}
+	}
+
+	// Reuse the least recently used entry once the cache is full, along with its memory
+	if (mEntries.size() >= mMaxCachedRuns)
+	{
+		EntryList::iterator oldest = std::prev(mEntries.end());
+		auto oldRange = mLookup.equal_range(oldest->hash);
+		for (auto it = oldRange.first; it != oldRange.second; ++it)
+		{
+			if (it->second == oldest)
+			{
+				mLookup.erase(it);
+				break;
+			}
+		}
+		mEntries.splice(mEntries.begin(), mEntries, oldest);
+	}
+	else
+	{
+		mEntries.emplace_front();
+	}
+
+	Entry& entry = mEntries.front();
+	entry.hash = hash;
+	entry.font = &font;
+	entry.style = style;
+	entry.text = text;
+	mLookup.emplace(hash, mEntries.begin());
+
+	mCodepoints.clear();
+	for (const char* character = text; *character != '\0';)
+	{
+		mCodepoints.push_back(DecodeUtf8(character));
+	}
+	Build(font, style, entry.run);
+	return entry.run;
+}
+
+void BirdGame::TextLayout::Clear()
+{
+	mEntries.clear();
+	mLookup.clear();
+}
+
+void BirdGame::TextLayout::Build(const GlyphAtlas& font, const TextStyle& style, TextRun& run)
+{
+	const float size = style.size;
+	const bool wrap = style.wrapWidth > 0.0f;
+	run.glyphs.clear();
+	mLineStarts.assign(1, 0);
+	mLineWidths.clear();
+
+	// Glyphs are placed relative to the start of their line's baseline first, then moved into place per line.
+	// The last space of the line is where it breaks when the next word doesn't fit.
+	float pen = 0.0f;
+	float lineWidth = 0.0f;         // Up to the end of the last non-space glyph
+	uint32_t previous = 0;
+	bool hasBreak = false;
+	uint32_t breakGlyph = 0;        // First glyph after the break
+	float breakPen = 0.0f;          // Where the text after the break starts
+	float breakWidth = 0.0f;        // Width of the line when broken there
+
+	auto newLine = [&](uint32_t firstGlyph, float width)
+	{
+		mLineWidths.push_back(width);
+		mLineStarts.push_back(firstGlyph);
+		hasBreak = false;
+		previous = 0;
+	};
+
+	for (uint32_t codepoint : mCodepoints)
+	{
+		if (codepoint == '\n')
+		{
+			newLine(static_cast<uint32_t>(run.glyphs.size()), lineWidth);
+			pen = 0.0f;
+			lineWidth = 0.0f;
+			continue;
+		}
+
+		const GlyphAtlas::Glyph* glyph = font.Find(codepoint);
+		if (glyph == nullptr)
+		{
+			codepoint = '?';
+			glyph = font.Find(codepoint);
+			if (glyph == nullptr)
+			{
+				continue;
+			}
+		}
+
+		if (codepoint == ' ')
+		{
+			if (previous != ' ')
+			{
+				breakWidth = lineWidth;
+			}
+			pen += (font.GetKerning(previous, codepoint) + glyph->advance) * size;
+			hasBreak = true;
+			breakGlyph = static_cast<uint32_t>(run.glyphs.size());
+			breakPen = pen;
+			previous = codepoint;
+			continue;
+		}
+
+		float x = pen + font.GetKerning(previous, codepoint) * size;
+		if (wrap && x + glyph->advance * size > style.wrapWidth)
+		{
+			if (hasBreak)
+			{
+				// Move the word started after the last space to a new line
+				for (uint32_t i = breakGlyph; i < run.glyphs.size(); ++i)
+				{
+					run.glyphs[i].rect.x -= breakPen;
+				}
+				newLine(breakGlyph, breakWidth);
+				x -= breakPen;
+			}
+			else if (lineWidth > 0.0f)
+			{
+				// A single word wider than the line breaks wherever it has to
+				newLine(static_cast<uint32_t>(run.glyphs.size()), lineWidth);
+				x = 0.0f;
+			}
+		}
+
+		if (glyph->visible)
+		{
+			const Rect rect = { x + glyph->plane.x * size, glyph->plane.y * size, glyph->plane.width * size, glyph->plane.height * size };
+			run.glyphs.push_back({ rect, glyph->uv });
+		}
+		pen = x + glyph->advance * size;
+		lineWidth = pen;
+		previous = codepoint;
+	}
+	mLineWidths.push_back(lineWidth);
+
+	run.lineCount = static_cast<uint32_t>(mLineWidths.size());
+	run.width = *std::max_element(mLineWidths.begin(), mLineWidths.end());
+	run.height = run.lineCount * font.GetLineHeight() * size;
+
+	const float boxWidth = wrap ? style.wrapWidth : run.width;
+	mLineStarts.push_back(static_cast<uint32_t>(run.glyphs.size()));
+	for (uint32_t line = 0; line < run.lineCount; ++line)
+	{
+		float offset = 0.0f;
+		if (style.align == TextAlign::Center)
+		{
+			offset = (boxWidth - mLineWidths[line]) * 0.5f;
+		}
+		else if (style.align == TextAlign::Right)
+		{
+			offset = boxWidth - mLineWidths[line];
+		}
+
+		const float baseline = (font.GetAscender() + line * font.GetLineHeight()) * size;
+		for (uint32_t i = mLineStarts[line]; i < mLineStarts[line + 1]; ++i)
+		{
+			run.glyphs[i].rect.x += offset;
+			run.glyphs[i].rect.y += baseline;
+		}
+	}
+}
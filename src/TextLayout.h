@@ -0,0 +1,72 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BirdGame
+{
+	class GlyphAtlas;
+
+	// One glyph quad of laid out text, relative to the top left of the text box
+	struct PositionedGlyph
+	{
+		Rect rect;
+		Rect uv;
+	};
+
+	struct TextRun
+	{
+		std::vector<PositionedGlyph> glyphs;
+		float width;        // Of the widest line, in pixels
+		float height;       // Of all lines, in pixels
+		uint32_t lineCount;
+	};
+
+	// Turns UTF-8 strings into positioned glyph quads with kerning, line breaking at spaces when a line gets wider
+	// than the style's wrap width, and alignment. Runs are kept in an LRU cache keyed by string, font, size, wrap
+	// width and alignment, so text that stays the same from frame to frame, like a score that hasn't changed, is only
+	// laid out once. Backend-neutral: renderers offset the quads and draw them with the font's atlas.
+	class TextLayout final
+	{
+	public:
+		explicit TextLayout(uint32_t maxCachedRuns);
+
+		// The run stays valid until the next Layout() or Clear(). Code points the font doesn't have are drawn as '?',
+		// or skipped if it doesn't have that either.
+		const TextRun& Layout(const GlyphAtlas& font, const char* text, const TextStyle& style);
+
+		// Drops every cached run. Has to be called before a font used with Layout() is rebuilt or destroyed.
+		void Clear();
+
+		uint32_t GetCachedRunCount() const { return static_cast<uint32_t>(mEntries.size()); }
+
+	private:
+		TextLayout(const TextLayout&) = delete;
+
+		struct Entry
+		{
+			uint64_t hash;
+			const GlyphAtlas* font;
+			TextStyle style;
+			std::string text;
+			TextRun run;
+		};
+
+		using EntryList = std::list<Entry>;
+
+		void Build(const GlyphAtlas& font, const TextStyle& style, TextRun& run);
+
+		uint32_t mMaxCachedRuns;
+		EntryList mEntries; // Most recently used first
+		std::unordered_multimap<uint64_t, EntryList::iterator> mLookup;
+
+		// Scratch for Build()
+		std::vector<uint32_t> mCodepoints;
+		std::vector<uint32_t> mLineStarts;
+		std::vector<float> mLineWidths;
+	};
+}
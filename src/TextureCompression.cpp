@@ -0,0 +1,972 @@
+#include "pch.h"
+#include "TextureCompression.h"
+
+#include "JobSystem.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BIRDGAME_BC_SSE2 1
+#endif
+
+namespace
+{
+	using BirdGame::CompressionQuality;
+
+	constexpr uint32_t kBlockTexels = 16;
+
+	// Blocks per chunk handed to the JobSystem
+	constexpr uint32_t kBlocksPerJob = 256;
+
+	// BC7 interpolation weights for 4 bit indices, in 64ths
+	constexpr uint32_t kBc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// One block in structure of arrays layout, 0-255 per channel, so four texels fill one SSE register
+	struct BlockTexels
+	{
+		alignas(16) float channels[4][kBlockTexels];
+
+		// 0 for texels that don't count towards the fit, like the transparent texels of a BC1 block
+		alignas(16) float weights[kBlockTexels];
+	};
+
+	struct Endpoints
+	{
+		float values[2][4];
+	};
+
+	// Up to 16 colors a block can choose from, in the same layout as BlockTexels' channels
+	struct Palette
+	{
+		float colors[16][4];
+		uint32_t count;
+	};
+
+	uint32_t GetRefinementCount(CompressionQuality quality)
+	{
+		switch (quality)
+		{
+			case CompressionQuality::Fast: return 0;
+			case CompressionQuality::Normal: return 1;
+			default: return 3;
+		}
+	}
+
+	// Picks the nearest palette entry for every texel, comparing the channels with a nonzero channel weight, and
+	// returns the texel weighted squared error. This is where encoding spends its time, so it runs four texels at once.
+	float SelectIndices(const BlockTexels& texels, const Palette& palette, const float channelWeights[4], uint8_t indices[kBlockTexels])
+	{
+		float error = 0.0f;
+#if defined(BIRDGAME_BC_SSE2)
+		for (uint32_t group = 0; group < kBlockTexels; group += 4)
+		{
+			__m128 channels[4];
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				channels[c] = _mm_load_ps(&texels.channels[c][group]);
+			}
+
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+			for (uint32_t entry = 0; entry < palette.count; ++entry)
+			{
+				__m128 distance = _mm_setzero_ps();
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					const __m128 delta = _mm_sub_ps(channels[c], _mm_set1_ps(palette.colors[entry][c]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_mul_ps(delta, delta), _mm_set1_ps(channelWeights[c])));
+				}
+
+				const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+				best = _mm_min_ps(distance, best);
+				bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(entry))), _mm_andnot_si128(closer, bestIndex));
+			}
+
+			alignas(16) float distances[4];
+			alignas(16) int32_t groupIndices[4];
+			_mm_store_ps(distances, _mm_mul_ps(best, _mm_load_ps(&texels.weights[group])));
+			_mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				indices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+				error += distances[i];
+			}
+		}
+#else
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			float best = FLT_MAX;
+			uint8_t bestIndex = 0;
+			for (uint32_t entry = 0; entry < palette.count; ++entry)
+			{
+				float distance = 0.0f;
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					const float delta = texels.channels[c][texel] - palette.colors[entry][c];
+					distance += delta * delta * channelWeights[c];
+				}
+
+				if (distance < best)
+				{
+					best = distance;
+					bestIndex = static_cast<uint8_t>(entry);
+				}
+			}
+
+			indices[texel] = bestIndex;
+			error += best * texels.weights[texel];
+		}
+#endif
+		return error;
+	}
+
+	// A line through the texels of the block, as the two extremes of their projection onto the fit axis.
+	// Fast uses the diagonal of the bounding box, oriented by the sign of the covariances, the others the principal
+	// axis from a few power iterations of the covariance matrix.
+	Endpoints FitEndpoints(const BlockTexels& texels, const float channelWeights[4], CompressionQuality quality)
+	{
+		float mean[4] = {};
+		float totalWeight = 0.0f;
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				mean[c] += texels.channels[c][texel] * texels.weights[texel];
+			}
+			totalWeight += texels.weights[texel];
+		}
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			mean[c] = (channelWeights[c] > 0.0f) ? mean[c] / totalWeight : 0.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			float delta[4];
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				delta[c] = (channelWeights[c] > 0.0f) ? (texels.channels[c][texel] - mean[c]) * texels.weights[texel] : 0.0f;
+			}
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+				{
+					covariance[row][column] += delta[row] * delta[column];
+				}
+			}
+		}
+
+		// Start from the channel that varies most, which is also what the bounding box diagonal is oriented by
+		uint32_t widest = 0;
+		for (uint32_t c = 1; c < 4; ++c)
+		{
+			if (covariance[c][c] > covariance[widest][widest])
+			{
+				widest = c;
+			}
+		}
+
+		float axis[4] = {};
+		if (quality == CompressionQuality::Fast)
+		{
+			float minimum[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+			float maximum[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+			{
+				if (texels.weights[texel] > 0.0f)
+				{
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						minimum[c] = std::min(minimum[c], texels.channels[c][texel]);
+						maximum[c] = std::max(maximum[c], texels.channels[c][texel]);
+					}
+				}
+			}
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				const float extent = (channelWeights[c] > 0.0f) ? maximum[c] - minimum[c] : 0.0f;
+				axis[c] = (covariance[widest][c] < 0.0f) ? -extent : extent;
+			}
+		}
+		else
+		{
+			axis[widest] = 1.0f;
+			for (uint32_t iteration = 0; iteration < 8; ++iteration)
+			{
+				float next[4] = {};
+				float length = 0.0f;
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					for (uint32_t column = 0; column < 4; ++column)
+					{
+						next[row] += covariance[row][column] * axis[column];
+					}
+					length = std::max(length, std::fabs(next[row]));
+				}
+				if (length <= 0.0f)
+				{
+					break;
+				}
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					axis[c] = next[c] / length;
+				}
+			}
+		}
+
+		float lengthSquared = 0.0f;
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			lengthSquared += axis[c] * axis[c];
+		}
+
+		Endpoints endpoints;
+		if (lengthSquared <= 0.0f)
+		{
+			// All texels that count are the same
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				endpoints.values[0][c] = mean[c];
+				endpoints.values[1][c] = mean[c];
+			}
+			return endpoints;
+		}
+
+		float low = FLT_MAX;
+		float high = -FLT_MAX;
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			if (texels.weights[texel] > 0.0f)
+			{
+				float projection = 0.0f;
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					projection += (texels.channels[c][texel] - mean[c]) * axis[c];
+				}
+				low = std::min(low, projection);
+				high = std::max(high, projection);
+			}
+		}
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			endpoints.values[0][c] = std::clamp(mean[c] + axis[c] * low / lengthSquared, 0.0f, 255.0f);
+			endpoints.values[1][c] = std::clamp(mean[c] + axis[c] * high / lengthSquared, 0.0f, 255.0f);
+		}
+		return endpoints;
+	}
+
+	// Least squares endpoints for fixed indices, where index i sits at positions[i] along the line between them.
+	// Returns false if the indices don't pin down a line, e.g. when every texel uses the same one.
+	bool RefineEndpoints(const BlockTexels& texels, const uint8_t indices[kBlockTexels], const float* positions, Endpoints& endpoints)
+	{
+		float a = 0.0f;
+		float b = 0.0f;
+		float c = 0.0f;
+		float x0[4] = {};
+		float x1[4] = {};
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			const float weight = texels.weights[texel];
+			const float t = positions[indices[texel]];
+			a += (1.0f - t) * (1.0f - t) * weight;
+			b += t * (1.0f - t) * weight;
+			c += t * t * weight;
+			for (uint32_t channel = 0; channel < 4; ++channel)
+			{
+				x0[channel] += (1.0f - t) * texels.channels[channel][texel] * weight;
+				x1[channel] += t * texels.channels[channel][texel] * weight;
+			}
+		}
+
+		const float determinant = a * c - b * b;
+		if (std::fabs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			endpoints.values[0][channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.0f, 255.0f);
+			endpoints.values[1][channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	void LoadBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockTexels& texels)
+	{
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			const uint32_t x = std::min(blockX * 4 + texel % 4, width - 1);
+			const uint32_t y = std::min(blockY * 4 + texel / 4, height - 1);
+			const uint8_t* pixel = pixels + (static_cast<size_t>(y) * width + x) * BirdGame::Image::kBytesPerPixel;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				texels.channels[c][texel] = pixel[c];
+			}
+			texels.weights[texel] = 1.0f;
+		}
+	}
+
+	// Little endian bit packing, for the index bits of every format and all of a BC7 block
+	class BitWriter final
+	{
+	public:
+		explicit BitWriter(uint8_t* bytes) : mBytes(bytes), mPosition(0) {}
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t bit = 0; bit < bitCount; ++bit, ++mPosition)
+			{
+				mBytes[mPosition / 8] |= static_cast<uint8_t>(((value >> bit) & 1) << (mPosition % 8));
+			}
+		}
+
+	private:
+		uint8_t* mBytes;
+		uint32_t mPosition;
+	};
+
+	class BitReader final
+	{
+	public:
+		explicit BitReader(const uint8_t* bytes) : mBytes(bytes), mPosition(0) {}
+
+		uint32_t Read(uint32_t bitCount)
+		{
+			uint32_t value = 0;
+			for (uint32_t bit = 0; bit < bitCount; ++bit, ++mPosition)
+			{
+				value |= ((mBytes[mPosition / 8] >> (mPosition % 8)) & 1u) << bit;
+			}
+			return value;
+		}
+
+	private:
+		const uint8_t* mBytes;
+		uint32_t mPosition;
+	};
+
+	// BC1 color block
+
+	uint16_t QuantizeRgb565(const float color[4])
+	{
+		const uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+		const uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+		const uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void ExpandRgb565(uint16_t color, uint8_t out[4])
+	{
+		const uint32_t r = (color >> 11) & 31;
+		const uint32_t g = (color >> 5) & 63;
+		const uint32_t b = color & 31;
+		out[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+		out[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+		out[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+		out[3] = 255;
+	}
+
+	// The four colors a BC1 block decodes to. BC3 color blocks are always in four color mode.
+	void DecodeColorPalette(uint16_t color0, uint16_t color1, bool alwaysFourColors, uint8_t palette[4][4])
+	{
+		ExpandRgb565(color0, palette[0]);
+		ExpandRgb565(color1, palette[1]);
+		if (color0 > color1 || alwaysFourColors)
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+				palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+			}
+			palette[2][3] = 255;
+			palette[3][3] = 255;
+		}
+		else
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+				palette[3][c] = 0;
+			}
+			palette[2][3] = 255;
+			palette[3][3] = 0;
+		}
+	}
+
+	struct ColorCandidate
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint8_t indices[kBlockTexels];
+		float error;
+	};
+
+	// Quantizes endpoints the way the block stores them and picks the best indices for the result.
+	// Four color mode needs color0 > color1 and three color mode the opposite, so the endpoints may swap.
+	ColorCandidate EvaluateColorEndpoints(const BlockTexels& texels, const Endpoints& endpoints, bool threeColor, bool alwaysFourColors)
+	{
+		static const float kRgbWeights[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+
+		ColorCandidate candidate;
+		candidate.color0 = QuantizeRgb565(endpoints.values[0]);
+		candidate.color1 = QuantizeRgb565(endpoints.values[1]);
+		if ((candidate.color0 < candidate.color1) != threeColor)
+		{
+			std::swap(candidate.color0, candidate.color1);
+		}
+
+		uint8_t colors[4][4];
+		DecodeColorPalette(candidate.color0, candidate.color1, alwaysFourColors, colors);
+
+		Palette palette;
+		if (candidate.color0 == candidate.color1)
+		{
+			// Decodes as three color mode, where only the first three entries are this color
+			palette.count = 1;
+		}
+		else
+		{
+			palette.count = threeColor ? 3 : 4;
+		}
+		for (uint32_t entry = 0; entry < palette.count; ++entry)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				palette.colors[entry][c] = colors[entry][c];
+			}
+		}
+
+		candidate.error = SelectIndices(texels, palette, kRgbWeights, candidate.indices);
+		return candidate;
+	}
+
+	void EncodeColorBlock(const BlockTexels& source, bool allowTransparent, CompressionQuality quality, uint8_t* block)
+	{
+		static const float kRgbWeights[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+		static const float kFourColorPositions[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		static const float kThreeColorPositions[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+		// Texels with alpha below the cut out threshold are left to the transparent entry of three color mode
+		BlockTexels texels = source;
+		bool threeColor = false;
+		bool anyOpaque = false;
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			if (allowTransparent && texels.channels[3][texel] < 128.0f)
+			{
+				texels.weights[texel] = 0.0f;
+				threeColor = true;
+			}
+			else
+			{
+				anyOpaque = true;
+			}
+		}
+
+		std::memset(block, 0, 8);
+		if (!anyOpaque)
+		{
+			// Three color mode with both colors black, every texel on the transparent entry
+			std::memset(block + 4, 0xff, 4);
+			return;
+		}
+
+		Endpoints endpoints = FitEndpoints(texels, kRgbWeights, quality);
+		ColorCandidate best = EvaluateColorEndpoints(texels, endpoints, threeColor, !allowTransparent);
+		ColorCandidate current = best;
+		for (uint32_t refinement = 0; refinement < GetRefinementCount(quality); ++refinement)
+		{
+			// The candidate's colors may have swapped relative to endpoints, so refine from its own quantized colors
+			uint8_t colors[4][4];
+			ExpandRgb565(current.color0, colors[0]);
+			ExpandRgb565(current.color1, colors[1]);
+			Endpoints refined;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				refined.values[0][c] = colors[0][c];
+				refined.values[1][c] = colors[1][c];
+			}
+
+			if (!RefineEndpoints(texels, current.indices, threeColor ? kThreeColorPositions : kFourColorPositions, refined))
+			{
+				break;
+			}
+
+			current = EvaluateColorEndpoints(texels, refined, threeColor, !allowTransparent);
+			if (current.error < best.error)
+			{
+				best = current;
+			}
+		}
+
+		block[0] = static_cast<uint8_t>(best.color0);
+		block[1] = static_cast<uint8_t>(best.color0 >> 8);
+		block[2] = static_cast<uint8_t>(best.color1);
+		block[3] = static_cast<uint8_t>(best.color1 >> 8);
+
+		BitWriter writer(block + 4);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			writer.Write(texels.weights[texel] > 0.0f ? best.indices[texel] : 3, 2);
+		}
+	}
+
+	void DecodeColorBlock(const uint8_t* block, bool alwaysFourColors, uint8_t texels[kBlockTexels][4])
+	{
+		const uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		const uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+		uint8_t palette[4][4];
+		DecodeColorPalette(color0, color1, alwaysFourColors, palette);
+
+		BitReader reader(block + 4);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			std::memcpy(texels[texel], palette[reader.Read(2)], 4);
+		}
+	}
+
+	// BC3 alpha block
+
+	void DecodeAlphaPalette(uint8_t alpha0, uint8_t alpha1, uint8_t palette[8])
+	{
+		palette[0] = alpha0;
+		palette[1] = alpha1;
+		if (alpha0 > alpha1)
+		{
+			for (uint32_t i = 1; i < 7; ++i)
+			{
+				palette[i + 1] = static_cast<uint8_t>(((7 - i) * alpha0 + i * alpha1 + 3) / 7);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 1; i < 5; ++i)
+			{
+				palette[i + 1] = static_cast<uint8_t>(((5 - i) * alpha0 + i * alpha1 + 2) / 5);
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	float EvaluateAlphaEndpoints(const BlockTexels& texels, uint8_t alpha0, uint8_t alpha1, uint8_t indices[kBlockTexels])
+	{
+		static const float kAlphaWeights[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+		uint8_t values[8];
+		DecodeAlphaPalette(alpha0, alpha1, values);
+
+		Palette palette = {};
+		palette.count = 8;
+		for (uint32_t entry = 0; entry < palette.count; ++entry)
+		{
+			palette.colors[entry][3] = values[entry];
+		}
+		return SelectIndices(texels, palette, kAlphaWeights, indices);
+	}
+
+	void EncodeAlphaBlock(const BlockTexels& texels, CompressionQuality quality, uint8_t* block)
+	{
+		// Index i of eight alpha mode as a position between alpha0 and alpha1
+		static const float kAlphaPositions[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+		float minimum = 255.0f;
+		float maximum = 0.0f;
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			minimum = std::min(minimum, texels.channels[3][texel]);
+			maximum = std::max(maximum, texels.channels[3][texel]);
+		}
+
+		// The extremes are exact in eight alpha mode. When they're equal it's six alpha mode with every index on alpha0.
+		uint8_t alpha0 = static_cast<uint8_t>(maximum);
+		uint8_t alpha1 = static_cast<uint8_t>(minimum);
+		uint8_t indices[kBlockTexels];
+		float error = EvaluateAlphaEndpoints(texels, alpha0, alpha1, indices);
+
+		// The extremes are often not the best endpoints for the values in between
+		for (uint32_t refinement = 0; alpha0 != alpha1 && refinement + 1 < GetRefinementCount(quality); ++refinement)
+		{
+			Endpoints refined = {};
+			if (!RefineEndpoints(texels, indices, kAlphaPositions, refined))
+			{
+				break;
+			}
+
+			const uint8_t refined0 = static_cast<uint8_t>(refined.values[0][3] + 0.5f);
+			const uint8_t refined1 = static_cast<uint8_t>(refined.values[1][3] + 0.5f);
+			if (refined0 <= refined1)
+			{
+				break;
+			}
+
+			uint8_t refinedIndices[kBlockTexels];
+			const float refinedError = EvaluateAlphaEndpoints(texels, refined0, refined1, refinedIndices);
+			if (refinedError >= error)
+			{
+				break;
+			}
+
+			alpha0 = refined0;
+			alpha1 = refined1;
+			error = refinedError;
+			std::memcpy(indices, refinedIndices, sizeof(indices));
+		}
+
+		std::memset(block, 0, 8);
+		block[0] = alpha0;
+		block[1] = alpha1;
+		BitWriter writer(block + 2);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			writer.Write(indices[texel], 3);
+		}
+	}
+
+	void DecodeAlphaBlock(const uint8_t* block, uint8_t texels[kBlockTexels][4])
+	{
+		uint8_t palette[8];
+		DecodeAlphaPalette(block[0], block[1], palette);
+
+		BitReader reader(block + 2);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			texels[texel][3] = palette[reader.Read(3)];
+		}
+	}
+
+	// BC7 mode 6: one subset, RGBA endpoints of 7 bits plus a shared low bit (p-bit) per endpoint, 4 bit indices
+
+	void InterpolateBc7Palette(const uint8_t endpoint0[4], const uint8_t endpoint1[4], uint8_t palette[16][4])
+	{
+#if defined(BIRDGAME_BC_SSE2)
+		// Two palette entries per register, all four channels of both in 16 bit lanes
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i e0 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(endpoint0[0] | (endpoint0[1] << 8) | (endpoint0[2] << 16) | (static_cast<uint32_t>(endpoint0[3]) << 24))), zero);
+		const __m128i e1 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(endpoint1[0] | (endpoint1[1] << 8) | (endpoint1[2] << 16) | (static_cast<uint32_t>(endpoint1[3]) << 24))), zero);
+		const __m128i round = _mm_set1_epi16(32);
+		for (uint32_t entry = 0; entry < 16; entry += 2)
+		{
+			const __m128i w1 = _mm_set_epi16(
+				static_cast<short>(kBc7Weights[entry + 1]), static_cast<short>(kBc7Weights[entry + 1]), static_cast<short>(kBc7Weights[entry + 1]), static_cast<short>(kBc7Weights[entry + 1]),
+				static_cast<short>(kBc7Weights[entry]), static_cast<short>(kBc7Weights[entry]), static_cast<short>(kBc7Weights[entry]), static_cast<short>(kBc7Weights[entry]));
+			const __m128i w0 = _mm_sub_epi16(_mm_set1_epi16(64), w1);
+			const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(e0, w0), _mm_mullo_epi16(e1, w1)), round);
+			const __m128i packed = _mm_packus_epi16(_mm_srli_epi16(sum, 6), zero);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(palette[entry]), packed);
+		}
+#else
+		for (uint32_t entry = 0; entry < 16; ++entry)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				palette[entry][c] = static_cast<uint8_t>(((64 - kBc7Weights[entry]) * endpoint0[c] + kBc7Weights[entry] * endpoint1[c] + 32) >> 6);
+			}
+		}
+#endif
+	}
+
+	struct Bc7Candidate
+	{
+		uint8_t endpoints[2][4]; // 7 bits
+		uint8_t pBits[2];
+		uint8_t indices[kBlockTexels];
+		float error;
+	};
+
+	void QuantizeBc7Endpoint(const float value[4], uint32_t pBit, uint8_t quantized[4])
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			const float stored = (value[c] - static_cast<float>(pBit)) * 0.5f + 0.5f;
+			quantized[c] = static_cast<uint8_t>(std::clamp(stored, 0.0f, 127.0f));
+		}
+	}
+
+	void ExpandBc7Endpoint(const uint8_t quantized[4], uint32_t pBit, uint8_t expanded[4])
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			expanded[c] = static_cast<uint8_t>((quantized[c] << 1) | pBit);
+		}
+	}
+
+	Bc7Candidate EvaluateBc7Endpoints(const BlockTexels& texels, const Endpoints& endpoints, uint32_t pBit0, uint32_t pBit1)
+	{
+		static const float kRgbaWeights[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		Bc7Candidate candidate;
+		candidate.pBits[0] = static_cast<uint8_t>(pBit0);
+		candidate.pBits[1] = static_cast<uint8_t>(pBit1);
+		QuantizeBc7Endpoint(endpoints.values[0], pBit0, candidate.endpoints[0]);
+		QuantizeBc7Endpoint(endpoints.values[1], pBit1, candidate.endpoints[1]);
+
+		uint8_t expanded[2][4];
+		ExpandBc7Endpoint(candidate.endpoints[0], pBit0, expanded[0]);
+		ExpandBc7Endpoint(candidate.endpoints[1], pBit1, expanded[1]);
+
+		uint8_t colors[16][4];
+		InterpolateBc7Palette(expanded[0], expanded[1], colors);
+
+		Palette palette;
+		palette.count = 16;
+		for (uint32_t entry = 0; entry < palette.count; ++entry)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				palette.colors[entry][c] = colors[entry][c];
+			}
+		}
+
+		candidate.error = SelectIndices(texels, palette, kRgbaWeights, candidate.indices);
+		return candidate;
+	}
+
+	// The p-bit that loses the least when quantizing an endpoint on its own
+	uint32_t ChooseBc7PBit(const float value[4])
+	{
+		float errors[2] = {};
+		for (uint32_t pBit = 0; pBit < 2; ++pBit)
+		{
+			uint8_t quantized[4];
+			uint8_t expanded[4];
+			QuantizeBc7Endpoint(value, pBit, quantized);
+			ExpandBc7Endpoint(quantized, pBit, expanded);
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				errors[pBit] += (value[c] - expanded[c]) * (value[c] - expanded[c]);
+			}
+		}
+		return (errors[1] < errors[0]) ? 1 : 0;
+	}
+
+	Bc7Candidate SearchBc7PBits(const BlockTexels& texels, const Endpoints& endpoints, CompressionQuality quality)
+	{
+		if (quality != CompressionQuality::High)
+		{
+			return EvaluateBc7Endpoints(texels, endpoints, ChooseBc7PBit(endpoints.values[0]), ChooseBc7PBit(endpoints.values[1]));
+		}
+
+		Bc7Candidate best = EvaluateBc7Endpoints(texels, endpoints, 0, 0);
+		for (uint32_t pBits = 1; pBits < 4; ++pBits)
+		{
+			const Bc7Candidate candidate = EvaluateBc7Endpoints(texels, endpoints, pBits & 1, pBits >> 1);
+			if (candidate.error < best.error)
+			{
+				best = candidate;
+			}
+		}
+		return best;
+	}
+
+	void EncodeBc7Block(const BlockTexels& texels, CompressionQuality quality, uint8_t* block)
+	{
+		static const float kRgbaWeights[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float positions[16];
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			positions[i] = kBc7Weights[i] / 64.0f;
+		}
+
+		const Endpoints endpoints = FitEndpoints(texels, kRgbaWeights, quality);
+		Bc7Candidate best = SearchBc7PBits(texels, endpoints, quality);
+		Bc7Candidate current = best;
+		for (uint32_t refinement = 0; refinement < GetRefinementCount(quality); ++refinement)
+		{
+			Endpoints refined;
+			if (!RefineEndpoints(texels, current.indices, positions, refined))
+			{
+				break;
+			}
+
+			current = SearchBc7PBits(texels, refined, quality);
+			if (current.error < best.error)
+			{
+				best = current;
+			}
+		}
+
+		// The first texel's index is stored without its top bit, which has to be 0. Swapping the endpoints flips every index.
+		if (best.indices[0] >= 8)
+		{
+			std::swap(best.endpoints[0], best.endpoints[1]);
+			std::swap(best.pBits[0], best.pBits[1]);
+			for (uint8_t& index : best.indices)
+			{
+				index = static_cast<uint8_t>(15 - index);
+			}
+		}
+
+		std::memset(block, 0, 16);
+		BitWriter writer(block);
+		writer.Write(1 << 6, 7);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			writer.Write(best.endpoints[0][c], 7);
+			writer.Write(best.endpoints[1][c], 7);
+		}
+		writer.Write(best.pBits[0], 1);
+		writer.Write(best.pBits[1], 1);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			writer.Write(best.indices[texel], (texel == 0) ? 3 : 4);
+		}
+	}
+
+	// Only reads mode 6, the one mode EncodeBc7Block() writes, so it checks the encoder rather than decoding BC7 in general
+	void DecodeBc7Mode6Block(const uint8_t* block, uint8_t texels[kBlockTexels][4])
+	{
+		// The mode is the number of 0 bits before the first 1, 6 is stored as 0000001 in the low 7 bits
+		if ((block[0] & 0x7f) != (1 << 6))
+		{
+			assert(false && "Not a mode 6 block, only blocks from CompressTexture() can be decoded");
+			std::memset(texels, 0, kBlockTexels * 4);
+			return;
+		}
+
+		BitReader reader(block);
+		reader.Read(7);
+
+		uint8_t quantized[2][4];
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			quantized[0][c] = static_cast<uint8_t>(reader.Read(7));
+			quantized[1][c] = static_cast<uint8_t>(reader.Read(7));
+		}
+
+		uint8_t endpoints[2][4];
+		const uint32_t pBit0 = reader.Read(1);
+		const uint32_t pBit1 = reader.Read(1);
+		ExpandBc7Endpoint(quantized[0], pBit0, endpoints[0]);
+		ExpandBc7Endpoint(quantized[1], pBit1, endpoints[1]);
+
+		uint8_t palette[16][4];
+		InterpolateBc7Palette(endpoints[0], endpoints[1], palette);
+		for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+		{
+			std::memcpy(texels[texel], palette[reader.Read((texel == 0) ? 3 : 4)], 4);
+		}
+	}
+
+	void EncodeBlock(const BlockTexels& texels, BirdGame::TextureCompression compression, CompressionQuality quality, uint8_t* block)
+	{
+		switch (compression)
+		{
+			case BirdGame::TextureCompression::BC1:
+				EncodeColorBlock(texels, true, quality, block);
+				break;
+			case BirdGame::TextureCompression::BC3:
+				EncodeAlphaBlock(texels, quality, block);
+				EncodeColorBlock(texels, false, quality, block + 8);
+				break;
+			case BirdGame::TextureCompression::BC7:
+				EncodeBc7Block(texels, quality, block);
+				break;
+			default:
+				assert(false && "Not a block compressed format");
+				break;
+		}
+	}
+
+	void DecodeBlock(const uint8_t* block, BirdGame::TextureCompression compression, uint8_t texels[kBlockTexels][4])
+	{
+		switch (compression)
+		{
+			case BirdGame::TextureCompression::BC1:
+				DecodeColorBlock(block, false, texels);
+				break;
+			case BirdGame::TextureCompression::BC3:
+				DecodeColorBlock(block + 8, true, texels);
+				DecodeAlphaBlock(block, texels);
+				break;
+			case BirdGame::TextureCompression::BC7:
+				DecodeBc7Mode6Block(block, texels);
+				break;
+			default:
+				assert(false && "Not a block compressed format");
+				break;
+		}
+	}
+}
+
+uint32_t BirdGame::GetCompressedBlockSize(TextureCompression compression)
+{
+	switch (compression)
+	{
+		case TextureCompression::BC1: return 8;
+		case TextureCompression::BC3: return 16;
+		case TextureCompression::BC7: return 16;
+		default: return 0;
+	}
+}
+
+uint32_t BirdGame::GetCompressedRowPitch(TextureCompression compression, uint32_t width)
+{
+	return (width + 3) / 4 * GetCompressedBlockSize(compression);
+}
+
+size_t BirdGame::GetCompressedSize(TextureCompression compression, uint32_t width, uint32_t height)
+{
+	return static_cast<size_t>(GetCompressedRowPitch(compression, width)) * ((height + 3) / 4);
+}
+
+void BirdGame::CompressTexture(const uint8_t* pixels, uint32_t width, uint32_t height, TextureCompression compression, CompressionQuality quality, JobSystem& jobSystem, std::vector<uint8_t>& blocks)
+{
+	assert(compression != TextureCompression::None && "Nothing to compress to");
+
+	const uint32_t blocksWide = (width + 3) / 4;
+	const uint32_t blocksHigh = (height + 3) / 4;
+	const uint32_t blockSize = GetCompressedBlockSize(compression);
+	blocks.resize(GetCompressedSize(compression, width, height));
+
+	// Blocks are independent, so every chunk encodes whole rows of them without sharing anything
+	jobSystem.ParallelFor(blocksHigh, std::max(1u, kBlocksPerJob / blocksWide), [&](uint32_t, uint32_t begin, uint32_t end, uint32_t)
+	{
+		BlockTexels texels;
+		for (uint32_t blockY = begin; blockY < end; ++blockY)
+		{
+			for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+			{
+				LoadBlock(pixels, width, height, blockX, blockY, texels);
+				EncodeBlock(texels, compression, quality, &blocks[(static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize]);
+			}
+		}
+	});
+}
+
+void BirdGame::DecompressForValidation(const uint8_t* blocks, TextureCompression compression, uint32_t width, uint32_t height, Image& image)
+{
+	assert(compression != TextureCompression::None && "Nothing to decompress from");
+
+	const uint32_t blocksWide = (width + 3) / 4;
+	const uint32_t blockSize = GetCompressedBlockSize(compression);
+	image.Resize(width, height);
+
+	for (uint32_t blockY = 0; blockY < (height + 3) / 4; ++blockY)
+	{
+		for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+		{
+			uint8_t texels[kBlockTexels][4];
+			DecodeBlock(blocks + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize, compression, texels);
+
+			// Texels of partial blocks past the edges are dropped
+			for (uint32_t texel = 0; texel < kBlockTexels; ++texel)
+			{
+				const uint32_t x = blockX * 4 + texel % 4;
+				const uint32_t y = blockY * 4 + texel / 4;
+				if (x < width && y < height)
+				{
+					std::memcpy(image.GetPixel(x, y), texels[texel], 4);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	class JobSystem;
+
+	// Block compressed formats, each storing 4x4 texel blocks at a fixed size
+	enum class TextureCompression : uint8_t
+	{
+		None, // RGBA8
+		BC1,  // 8 bytes per block: RGB with optional 1 bit alpha. Opaque or cut out sprites.
+		BC3,  // 16 bytes per block: BC1 color with a separate 8 bit alpha block. Smooth alpha.
+		BC7   // 16 bytes per block: RGBA, encoded as mode 6 only. The best quality, the slowest to encode.
+	};
+
+	// How hard the encoder searches for endpoints. Fast takes the bounding box of the block, Normal its principal
+	// axis with one least squares refinement, High refines further and, for BC7, tries every p-bit combination.
+	enum class CompressionQuality : uint8_t
+	{
+		Fast,
+		Normal,
+		High
+	};
+
+	// Bytes per 4x4 block, 0 for None
+	uint32_t GetCompressedBlockSize(TextureCompression compression);
+
+	// Row pitch and total size of a compressed level. Partial blocks at the right and bottom edges are whole blocks.
+	uint32_t GetCompressedRowPitch(TextureCompression compression, uint32_t width);
+	size_t GetCompressedSize(TextureCompression compression, uint32_t width, uint32_t height);
+
+	// Encodes a tightly packed RGBA8 level into blocks, with rows of blocks split across the JobSystem. Texels past
+	// the edges of partial blocks repeat the last row and column.
+	void CompressTexture(const uint8_t* pixels, uint32_t width, uint32_t height, TextureCompression compression, CompressionQuality quality, JobSystem& jobSystem, std::vector<uint8_t>& blocks);
+
+	// Decodes blocks written by CompressTexture() back into image, to measure and test the encoder. BC1 and BC3 blocks
+	// decode in full, BC7 only in mode 6, the one mode the encoder writes. Other BC7 modes are valid but not supported.
+	void DecompressForValidation(const uint8_t* blocks, TextureCompression compression, uint32_t width, uint32_t height, Image& image);
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "TextureTable.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <functional>
+#include <new>
+
+BirdGame::TextureTable::TextureTable(uint32_t capacity) :
+	mCapacity(capacity),
+	mLiveCount(0)
+{
+	assert(capacity > 0 && capacity <= kIndexMask);
+	mGenerations.reserve(capacity);
+	mLive.reserve(capacity);
+}
+
+BirdGame::TextureHandle BirdGame::TextureTable::Allocate()
+{
+	uint32_t index;
+	if (!mFreeIndices.empty())
+	{
+		index = mFreeIndices.back();
+		mFreeIndices.pop_back();
+	}
+	else if (mGenerations.size() < mCapacity)
+	{
+		index = static_cast<uint32_t>(mGenerations.size());
+		mGenerations.push_back(0);
+		mLive.push_back(false);
+	}
+	else
+	{
+		assert(false && "Texture table is full");
+		throw std::bad_alloc();
+	}
+
+	mLive[index] = true;
+	mLiveCount++;
+	return (mGenerations[index] << kIndexBits) | index;
+}
+
+void BirdGame::TextureTable::Free(TextureHandle texture)
+{
+	assert(IsValid(texture));
+
+	const uint32_t index = GetIndex(texture);
+	mLive[index] = false;
+	mGenerations[index] = (mGenerations[index] + 1) & kGenerationMask;
+	mFreedThisFrame.push_back(index);
+	mLiveCount--;
+}
+
+void BirdGame::TextureTable::EndFrame(uint64_t fenceValue)
+{
+	for (uint32_t index : mFreedThisFrame)
+	{
+		mPendingFrees.push_back({ fenceValue, index });
+	}
+	mFreedThisFrame.clear();
+}
+
+void BirdGame::TextureTable::Retire(uint64_t completedFenceValue)
+{
+	bool released = false;
+	while (!mPendingFrees.empty() && mPendingFrees.front().fenceValue <= completedFenceValue)
+	{
+		mFreeIndices.push_back(mPendingFrees.front().index);
+		mPendingFrees.pop_front();
+		released = true;
+	}
+
+	// Reusing low slots first keeps the part of the table the GPU touches small
+	if (released)
+	{
+		std::sort(mFreeIndices.begin(), mFreeIndices.end(), std::greater<uint32_t>());
+	}
+}
+
+bool BirdGame::TextureTable::IsValid(TextureHandle texture) const
+{
+	const uint32_t index = GetIndex(texture);
+	return texture != kInvalidHandle && index < mGenerations.size() && mLive[index] && mGenerations[index] == GetGeneration(texture);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "RenderTypes.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace BirdGame
+{
+	// Assigns textures slots in the bindless texture table: one big descriptor range the shaders index with a
+	// per-instance texture index. A TextureHandle is the slot index plus a generation that changes every time
+	// the slot is freed, so stale handles can be detected instead of silently drawing whatever texture reuses
+	// the slot. Only deals in indices, the renderer creates the views.
+	class TextureTable final
+	{
+	public:
+		static constexpr uint32_t kIndexBits = 20;
+		static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+		static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+		static constexpr TextureHandle kInvalidHandle = UINT32_MAX;
+
+		// capacity must be below 2^kIndexBits, so kInvalidHandle never names a real slot
+		explicit TextureTable(uint32_t capacity);
+
+		// Slots are handed out lowest first, so the first texture allocated gets kDefaultTexture.
+		// Throws std::bad_alloc if the table is full.
+		TextureHandle Allocate();
+
+		// The handle is invalid right away, but the GPU may still read the slot, so it is only reused once the
+		// fence of the current frame is retired
+		void Free(TextureHandle texture);
+
+		// Tags everything freed since the last EndFrame() with the fence value the GPU signals when done with it
+		void EndFrame(uint64_t fenceValue);
+		void Retire(uint64_t completedFenceValue);
+
+		bool IsValid(TextureHandle texture) const;
+
+		// The slot to draw texture with: its own, or kDefaultTexture's if the handle is invalid or stale, since a
+		// stale handle's slot may already hold another texture
+		uint32_t GetIndexOrDefault(TextureHandle texture) const { return GetIndex(IsValid(texture) ? texture : kDefaultTexture); }
+
+		// The slot in the descriptor range, which is what the shaders index with
+		static constexpr uint32_t GetIndex(TextureHandle texture) { return texture & kIndexMask; }
+		static constexpr uint32_t GetGeneration(TextureHandle texture) { return texture >> kIndexBits; }
+
+		uint32_t GetCapacity() const { return mCapacity; }
+		uint32_t GetLiveCount() const { return mLiveCount; }
+
+	private:
+		TextureTable(const TextureTable&) = delete;
+
+		struct PendingFree
+		{
+			uint64_t fenceValue;
+			uint32_t index;
+		};
+
+		uint32_t mCapacity;
+		uint32_t mLiveCount;
+
+		// Indexed by slot, grown as slots are first used
+		std::vector<uint32_t> mGenerations;
+		std::vector<bool> mLive;
+
+		std::vector<uint32_t> mFreeIndices; // Kept sorted highest first, so the lowest free slot is at the back
+		std::vector<uint32_t> mFreedThisFrame;
+		std::deque<PendingFree> mPendingFrees;
+	};
+}
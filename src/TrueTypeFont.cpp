@@ -0,0 +1,694 @@
+#include "pch.h"
+#include "TrueTypeFont.h"
+
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t kMaxCompositeDepth = 8;
+
+	// Composite glyph component flags
+	constexpr uint16_t kArgsAreWords = 0x0001;
+	constexpr uint16_t kArgsAreOffsets = 0x0002;
+	constexpr uint16_t kHasScale = 0x0008;
+	constexpr uint16_t kMoreComponents = 0x0020;
+	constexpr uint16_t kHasXYScale = 0x0040;
+	constexpr uint16_t kHasTwoByTwo = 0x0080;
+
+	// Simple glyph point flags
+	constexpr uint8_t kOnCurve = 0x01;
+	constexpr uint8_t kXIsByte = 0x02;
+	constexpr uint8_t kYIsByte = 0x04;
+	constexpr uint8_t kRepeat = 0x08;
+	constexpr uint8_t kXSameOrPositive = 0x10;
+	constexpr uint8_t kYSameOrPositive = 0x20;
+
+	// TrueType is big endian throughout
+	uint16_t ReadU16(const uint8_t* data)
+	{
+		return static_cast<uint16_t>((data[0] << 8) | data[1]);
+	}
+
+	int16_t ReadI16(const uint8_t* data)
+	{
+		return static_cast<int16_t>(ReadU16(data));
+	}
+
+	uint32_t ReadU32(const uint8_t* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+	}
+
+	// 2.14 fixed point, used for component scales
+	float ReadF2Dot14(const uint8_t* data)
+	{
+		return ReadI16(data) / 16384.0f;
+	}
+
+	struct OutlinePoint
+	{
+		float x;
+		float y;
+		bool onCurve;
+	};
+
+	OutlinePoint Midpoint(const OutlinePoint& a, const OutlinePoint& b)
+	{
+		return { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, true };
+	}
+
+	// Turns one contour of on- and off-curve points into quadratic segments. Two consecutive off-curve points
+	// imply an on-curve point halfway between them.
+	void AppendContour(const OutlinePoint* points, uint32_t count, BirdGame::GlyphOutline& outline)
+	{
+		if (count < 2)
+		{
+			return;
+		}
+
+		uint32_t firstOnCurve = count;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (points[i].onCurve)
+			{
+				firstOnCurve = i;
+				break;
+			}
+		}
+
+		const OutlinePoint start = (firstOnCurve < count) ? points[firstOnCurve] : Midpoint(points[count - 1], points[0]);
+		OutlinePoint pen = start;
+		OutlinePoint control = {};
+		bool hasControl = false;
+
+		auto visit = [&](const OutlinePoint& point)
+		{
+			if (point.onCurve)
+			{
+				if (hasControl)
+				{
+					outline.segments.push_back({ pen.x, pen.y, control.x, control.y, point.x, point.y });
+				}
+				else if (point.x != pen.x || point.y != pen.y)
+				{
+					outline.segments.push_back({ pen.x, pen.y, (pen.x + point.x) * 0.5f, (pen.y + point.y) * 0.5f, point.x, point.y });
+				}
+				pen = point;
+				hasControl = false;
+			}
+			else
+			{
+				if (hasControl)
+				{
+					const OutlinePoint middle = Midpoint(control, point);
+					outline.segments.push_back({ pen.x, pen.y, control.x, control.y, middle.x, middle.y });
+					pen = middle;
+				}
+				control = point;
+				hasControl = true;
+			}
+		};
+
+		if (firstOnCurve < count)
+		{
+			// Walk all the way around, ending on the start point which closes the contour
+			for (uint32_t i = 1; i <= count; ++i)
+			{
+				visit(points[(firstOnCurve + i) % count]);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				visit(points[i]);
+			}
+			visit(start);
+		}
+	}
+}
+
+BirdGame::TrueTypeFont::TrueTypeFont()
+	: mData(nullptr)
+	, mSize(0)
+	, mUnitsPerEm(0)
+	, mAscender(0)
+	, mDescender(0)
+	, mLineGap(0)
+	, mGlyphCount(0)
+	, mLongLocaOffsets(false)
+	, mHorizontalMetricCount(0)
+	, mCharacterMap(0)
+	, mLoca(0)
+	, mGlyf(0)
+	, mGlyfLength(0)
+	, mHmtx(0)
+	, mKernPairs(0)
+	, mKernPairCount(0)
+{
+}
+
+bool BirdGame::TrueTypeFont::Load(const uint8_t* data, size_t size)
+{
+	mData = data;
+	mSize = size;
+	mCharacterMap = 0;
+	mKernPairs = 0;
+	mKernPairCount = 0;
+
+	if (data == nullptr || size < 12)
+	{
+		return false;
+	}
+
+	uint32_t offset = 0;
+	uint32_t length = 0;
+
+	if (!FindTable("head", offset, length) || length < 54)
+	{
+		return false;
+	}
+	mUnitsPerEm = ReadU16(mData + offset + 18);
+	mLongLocaOffsets = ReadI16(mData + offset + 50) != 0;
+	if (mUnitsPerEm == 0)
+	{
+		return false;
+	}
+
+	if (!FindTable("maxp", offset, length) || length < 6)
+	{
+		return false;
+	}
+	mGlyphCount = ReadU16(mData + offset + 4);
+
+	if (!FindTable("hhea", offset, length) || length < 36)
+	{
+		return false;
+	}
+	mAscender = ReadI16(mData + offset + 4);
+	mDescender = ReadI16(mData + offset + 6);
+	mLineGap = ReadI16(mData + offset + 8);
+	mHorizontalMetricCount = ReadU16(mData + offset + 34);
+
+	if (!FindTable("hmtx", offset, length) || mHorizontalMetricCount == 0 || mHorizontalMetricCount > mGlyphCount || length < mHorizontalMetricCount * 4u)
+	{
+		return false;
+	}
+	mHmtx = offset;
+
+	if (!FindTable("loca", offset, length) || length < (mGlyphCount + 1u) * (mLongLocaOffsets ? 4u : 2u))
+	{
+		return false;
+	}
+	mLoca = offset;
+
+	if (!FindTable("glyf", mGlyf, mGlyfLength))
+	{
+		return false;
+	}
+
+	if (!FindTable("cmap", offset, length) || !LoadCharacterMap(offset, length))
+	{
+		return false;
+	}
+
+	// Kerning is optional. Only the Microsoft table version with a horizontal format 0 subtable is supported.
+	if (FindTable("kern", offset, length) && length >= 18 && ReadU16(mData + offset) == 0 && ReadU16(mData + offset + 2) > 0)
+	{
+		const uint32_t subtable = offset + 4;
+		const uint16_t coverage = ReadU16(mData + subtable + 4);
+		const uint16_t pairCount = ReadU16(mData + subtable + 6);
+		const bool horizontal = (coverage & 0x0001) != 0;
+		const uint32_t format = coverage >> 8;
+		if (format == 0 && horizontal && 18u + pairCount * 6u <= length)
+		{
+			mKernPairs = subtable + 14;
+			mKernPairCount = pairCount;
+		}
+	}
+
+	return true;
+}
+
+uint16_t BirdGame::TrueTypeFont::GetGlyphIndex(uint32_t codepoint) const
+{
+	if (mCharacterMap == 0 || codepoint > 0xFFFF)
+	{
+		return 0;
+	}
+
+	const uint32_t segmentCount = ReadU16(mData + mCharacterMap + 6) / 2;
+	const uint32_t endCodes = mCharacterMap + 14;
+	const uint32_t startCodes = endCodes + segmentCount * 2 + 2;
+	const uint32_t idDeltas = startCodes + segmentCount * 2;
+	const uint32_t idRangeOffsets = idDeltas + segmentCount * 2;
+
+	// Segments are sorted by end code, find the first one that ends at or after the code point
+	uint32_t low = 0;
+	uint32_t high = segmentCount;
+	while (low < high)
+	{
+		const uint32_t middle = (low + high) / 2;
+		if (ReadU16(mData + endCodes + middle * 2) < codepoint)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if (low == segmentCount)
+	{
+		return 0;
+	}
+
+	const uint32_t startCode = ReadU16(mData + startCodes + low * 2);
+	if (codepoint < startCode)
+	{
+		return 0;
+	}
+
+	const uint16_t idDelta = ReadU16(mData + idDeltas + low * 2);
+	const uint32_t idRangeOffset = ReadU16(mData + idRangeOffsets + low * 2);
+	if (idRangeOffset == 0)
+	{
+		return static_cast<uint16_t>(codepoint + idDelta);
+	}
+
+	// The range offset is relative to its own position in the table
+	const size_t glyphIdAddress = idRangeOffsets + low * 2 + idRangeOffset + (codepoint - startCode) * 2;
+	if (glyphIdAddress + 2 > mSize)
+	{
+		return 0;
+	}
+
+	const uint16_t glyph = ReadU16(mData + glyphIdAddress);
+	return (glyph != 0) ? static_cast<uint16_t>(glyph + idDelta) : 0;
+}
+
+BirdGame::TrueTypeFont::GlyphMetrics BirdGame::TrueTypeFont::GetGlyphMetrics(uint16_t glyph) const
+{
+	GlyphMetrics metrics = {};
+	if (glyph >= mGlyphCount)
+	{
+		glyph = 0;
+	}
+
+	// Glyphs past the last full metric share its advance and only store their side bearing
+	if (glyph < mHorizontalMetricCount)
+	{
+		metrics.advance = ReadU16(mData + mHmtx + glyph * 4);
+		metrics.leftSideBearing = ReadI16(mData + mHmtx + glyph * 4 + 2);
+	}
+	else
+	{
+		metrics.advance = ReadU16(mData + mHmtx + (mHorizontalMetricCount - 1) * 4);
+		const size_t bearing = mHmtx + mHorizontalMetricCount * 4 + (glyph - mHorizontalMetricCount) * 2;
+		metrics.leftSideBearing = (bearing + 2 <= mSize) ? ReadI16(mData + bearing) : 0;
+	}
+
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	if (GetGlyphRange(glyph, offset, length) && length >= 10)
+	{
+		metrics.xMin = ReadI16(mData + offset + 2);
+		metrics.yMin = ReadI16(mData + offset + 4);
+		metrics.xMax = ReadI16(mData + offset + 6);
+		metrics.yMax = ReadI16(mData + offset + 8);
+	}
+
+	return metrics;
+}
+
+int16_t BirdGame::TrueTypeFont::GetKerning(uint16_t left, uint16_t right) const
+{
+	if (mKernPairCount == 0)
+	{
+		return 0;
+	}
+
+	// Pairs are sorted by the combined glyph indices
+	const uint32_t key = (static_cast<uint32_t>(left) << 16) | right;
+	uint32_t low = 0;
+	uint32_t high = mKernPairCount;
+	while (low < high)
+	{
+		const uint32_t middle = (low + high) / 2;
+		const uint32_t pairKey = ReadU32(mData + mKernPairs + middle * 6);
+		if (pairKey == key)
+		{
+			return ReadI16(mData + mKernPairs + middle * 6 + 4);
+		}
+
+		if (pairKey < key)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return 0;
+}
+
+bool BirdGame::TrueTypeFont::GetOutline(uint16_t glyph, GlyphOutline& outline) const
+{
+	outline.segments.clear();
+	const Transform identity = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+	if (!AppendGlyph(glyph, identity, 0, outline))
+	{
+		outline.segments.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool BirdGame::TrueTypeFont::FindTable(const char* tag, uint32_t& offset, uint32_t& length) const
+{
+	const uint32_t tableCount = ReadU16(mData + 4);
+	if (12 + tableCount * 16u > mSize)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < tableCount; ++i)
+	{
+		const uint8_t* record = mData + 12 + i * 16;
+		if (memcmp(record, tag, 4) == 0)
+		{
+			offset = ReadU32(record + 8);
+			length = ReadU32(record + 12);
+			return static_cast<uint64_t>(offset) + length <= mSize;
+		}
+	}
+
+	return false;
+}
+
+bool BirdGame::TrueTypeFont::LoadCharacterMap(uint32_t offset, uint32_t length)
+{
+	if (length < 4)
+	{
+		return false;
+	}
+
+	const uint32_t subtableCount = ReadU16(mData + offset + 2);
+	if (4 + subtableCount * 8u > length)
+	{
+		return false;
+	}
+
+	// Prefer Windows Unicode BMP, but any Unicode format 4 subtable maps the same way
+	uint32_t best = 0;
+	for (uint32_t i = 0; i < subtableCount; ++i)
+	{
+		const uint8_t* record = mData + offset + 4 + i * 8;
+		const uint16_t platform = ReadU16(record);
+		const uint16_t encoding = ReadU16(record + 2);
+		const uint32_t subtable = ReadU32(record + 4);
+		const bool unicode = (platform == 0) || (platform == 3 && encoding == 1);
+		if (!unicode || subtable + 14 > length || ReadU16(mData + offset + subtable) != 4)
+		{
+			continue;
+		}
+
+		const uint32_t segmentCount = ReadU16(mData + offset + subtable + 6) / 2;
+		if (subtable + 16 + segmentCount * 8u > length)
+		{
+			continue;
+		}
+
+		if (best == 0 || platform == 3)
+		{
+			best = offset + subtable;
+		}
+	}
+
+	mCharacterMap = best;
+	return best != 0;
+}
+
+bool BirdGame::TrueTypeFont::GetGlyphRange(uint16_t glyph, uint32_t& offset, uint32_t& length) const
+{
+	if (glyph >= mGlyphCount)
+	{
+		return false;
+	}
+
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	if (mLongLocaOffsets)
+	{
+		begin = ReadU32(mData + mLoca + glyph * 4);
+		end = ReadU32(mData + mLoca + glyph * 4 + 4);
+	}
+	else
+	{
+		begin = ReadU16(mData + mLoca + glyph * 2) * 2u;
+		end = ReadU16(mData + mLoca + glyph * 2 + 2) * 2u;
+	}
+
+	if (end < begin || end > mGlyfLength)
+	{
+		return false;
+	}
+
+	offset = mGlyf + begin;
+	length = end - begin;
+	return true;
+}
+
+bool BirdGame::TrueTypeFont::AppendGlyph(uint16_t glyph, const Transform& transform, uint32_t depth, GlyphOutline& outline) const
+{
+	uint32_t offset = 0;
+	uint32_t length = 0;
+	if (depth > kMaxCompositeDepth || !GetGlyphRange(glyph, offset, length))
+	{
+		return false;
+	}
+
+	if (length == 0)
+	{
+		return true;
+	}
+
+	if (length < 10)
+	{
+		return false;
+	}
+
+	const int16_t contourCount = ReadI16(mData + offset);
+	if (contourCount >= 0)
+	{
+		return AppendSimpleGlyph(offset + 10, offset + length, contourCount, transform, outline);
+	}
+
+	return AppendCompositeGlyph(offset + 10, offset + length, transform, depth, outline);
+}
+
+bool BirdGame::TrueTypeFont::AppendSimpleGlyph(uint32_t offset, uint32_t end, int16_t contourCount, const Transform& transform, GlyphOutline& outline) const
+{
+	if (contourCount == 0)
+	{
+		return true;
+	}
+
+	uint32_t cursor = offset;
+	if (cursor + contourCount * 2u + 2 > end)
+	{
+		return false;
+	}
+
+	std::vector<uint16_t> contourEnds(contourCount);
+	for (int16_t i = 0; i < contourCount; ++i)
+	{
+		contourEnds[i] = ReadU16(mData + cursor + i * 2);
+		if (i > 0 && contourEnds[i] <= contourEnds[i - 1])
+		{
+			return false;
+		}
+	}
+	cursor += contourCount * 2;
+
+	const uint32_t pointCount = contourEnds.back() + 1u;
+	const uint32_t instructionLength = ReadU16(mData + cursor);
+	cursor += 2 + instructionLength;
+
+	std::vector<uint8_t> flags(pointCount);
+	for (uint32_t i = 0; i < pointCount;)
+	{
+		if (cursor >= end)
+		{
+			return false;
+		}
+
+		const uint8_t flag = mData[cursor++];
+		uint32_t repeat = 1;
+		if (flag & kRepeat)
+		{
+			if (cursor >= end)
+			{
+				return false;
+			}
+			repeat += mData[cursor++];
+		}
+
+		for (; repeat > 0 && i < pointCount; --repeat)
+		{
+			flags[i++] = flag;
+		}
+	}
+
+	// Coordinates are deltas from the previous point, either a byte with a separate sign bit or a signed word
+	auto readCoordinates = [&](uint8_t byteFlag, uint8_t sameOrPositiveFlag, std::vector<int32_t>& values)
+	{
+		int32_t value = 0;
+		for (uint32_t i = 0; i < pointCount; ++i)
+		{
+			if (flags[i] & byteFlag)
+			{
+				if (cursor + 1 > end)
+				{
+					return false;
+				}
+				const int32_t delta = mData[cursor++];
+				value += (flags[i] & sameOrPositiveFlag) ? delta : -delta;
+			}
+			else if (!(flags[i] & sameOrPositiveFlag))
+			{
+				if (cursor + 2 > end)
+				{
+					return false;
+				}
+				value += ReadI16(mData + cursor);
+				cursor += 2;
+			}
+			values[i] = value;
+		}
+		return true;
+	};
+
+	std::vector<int32_t> xs(pointCount);
+	std::vector<int32_t> ys(pointCount);
+	if (!readCoordinates(kXIsByte, kXSameOrPositive, xs) || !readCoordinates(kYIsByte, kYSameOrPositive, ys))
+	{
+		return false;
+	}
+
+	std::vector<OutlinePoint> points(pointCount);
+	for (uint32_t i = 0; i < pointCount; ++i)
+	{
+		const float x = static_cast<float>(xs[i]);
+		const float y = static_cast<float>(ys[i]);
+		points[i].x = transform.a * x + transform.c * y + transform.dx;
+		points[i].y = transform.b * x + transform.d * y + transform.dy;
+		points[i].onCurve = (flags[i] & kOnCurve) != 0;
+	}
+
+	uint32_t first = 0;
+	for (uint16_t contourEnd : contourEnds)
+	{
+		AppendContour(points.data() + first, contourEnd + 1u - first, outline);
+		first = contourEnd + 1u;
+	}
+
+	return true;
+}
+
+bool BirdGame::TrueTypeFont::AppendCompositeGlyph(uint32_t offset, uint32_t end, const Transform& transform, uint32_t depth, GlyphOutline& outline) const
+{
+	uint32_t cursor = offset;
+	uint16_t flags = 0;
+	do
+	{
+		if (cursor + 4 > end)
+		{
+			return false;
+		}
+		flags = ReadU16(mData + cursor);
+		const uint16_t component = ReadU16(mData + cursor + 2);
+		cursor += 4;
+
+		Transform local = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+		if (flags & kArgsAreWords)
+		{
+			if (cursor + 4 > end)
+			{
+				return false;
+			}
+			local.dx = ReadI16(mData + cursor);
+			local.dy = ReadI16(mData + cursor + 2);
+			cursor += 4;
+		}
+		else
+		{
+			if (cursor + 2 > end)
+			{
+				return false;
+			}
+			local.dx = static_cast<int8_t>(mData[cursor]);
+			local.dy = static_cast<int8_t>(mData[cursor + 1]);
+			cursor += 2;
+		}
+
+		// Components positioned by matching point numbers are rare in practice and placed at the origin
+		if (!(flags & kArgsAreOffsets))
+		{
+			local.dx = 0.0f;
+			local.dy = 0.0f;
+		}
+
+		if (flags & kHasScale)
+		{
+			if (cursor + 2 > end)
+			{
+				return false;
+			}
+			local.a = local.d = ReadF2Dot14(mData + cursor);
+			cursor += 2;
+		}
+		else if (flags & kHasXYScale)
+		{
+			if (cursor + 4 > end)
+			{
+				return false;
+			}
+			local.a = ReadF2Dot14(mData + cursor);
+			local.d = ReadF2Dot14(mData + cursor + 2);
+			cursor += 4;
+		}
+		else if (flags & kHasTwoByTwo)
+		{
+			if (cursor + 8 > end)
+			{
+				return false;
+			}
+			local.a = ReadF2Dot14(mData + cursor);
+			local.b = ReadF2Dot14(mData + cursor + 2);
+			local.c = ReadF2Dot14(mData + cursor + 4);
+			local.d = ReadF2Dot14(mData + cursor + 6);
+			cursor += 8;
+		}
+
+		// The component's transform applies first, then the parent's
+		Transform combined;
+		combined.a = transform.a * local.a + transform.c * local.b;
+		combined.b = transform.b * local.a + transform.d * local.b;
+		combined.c = transform.a * local.c + transform.c * local.d;
+		combined.d = transform.b * local.c + transform.d * local.d;
+		combined.dx = transform.a * local.dx + transform.c * local.dy + transform.dx;
+		combined.dy = transform.b * local.dx + transform.d * local.dy + transform.dy;
+
+		if (!AppendGlyph(component, combined, depth + 1, outline))
+		{
+			return false;
+		}
+	} while (flags & kMoreComponents);
+
+	return true;
+}
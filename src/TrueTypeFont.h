@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BirdGame
+{
+	// One piece of a glyph outline in font units. Straight lines are stored as quadratics with the control
+	// point halfway, so consumers only deal with one kind of segment.
+	struct OutlineSegment
+	{
+		float x0, y0;
+		float cx, cy;
+		float x1, y1;
+	};
+
+	// All closed contours of a glyph. Filled areas follow the nonzero winding rule.
+	struct GlyphOutline
+	{
+		std::vector<OutlineSegment> segments;
+	};
+
+	// Minimal TrueType reader: character mapping (cmap format 4), glyph outlines (loca, glyf, including composite
+	// glyphs), horizontal metrics (hhea, hmtx) and pair kerning (kern format 0). Works on the file in memory, which
+	// has to outlive the font, so a MappedFile is the natural source. Everything is in font units, y up.
+	class TrueTypeFont final
+	{
+	public:
+		struct GlyphMetrics
+		{
+			uint16_t advance;
+			int16_t leftSideBearing;
+			int16_t xMin;
+			int16_t yMin;
+			int16_t xMax;
+			int16_t yMax;
+		};
+
+		TrueTypeFont();
+
+		// Returns false if required tables are missing or malformed
+		bool Load(const uint8_t* data, size_t size);
+
+		uint16_t GetUnitsPerEm() const { return mUnitsPerEm; }
+		int16_t GetAscender() const { return mAscender; }
+		int16_t GetDescender() const { return mDescender; } // Negative, below the baseline
+		int16_t GetLineGap() const { return mLineGap; }
+		uint16_t GetGlyphCount() const { return mGlyphCount; }
+
+		// Returns 0 (the missing glyph) for unmapped code points
+		uint16_t GetGlyphIndex(uint32_t codepoint) const;
+
+		GlyphMetrics GetGlyphMetrics(uint16_t glyph) const;
+
+		// Adjustment of the advance between two glyphs, 0 without a kern table
+		int16_t GetKerning(uint16_t left, uint16_t right) const;
+
+		// Replaces outline with the glyph's contours. Returns false for malformed glyph data. Glyphs without
+		// contours (e.g. space) succeed with an empty outline.
+		bool GetOutline(uint16_t glyph, GlyphOutline& outline) const;
+
+	private:
+		TrueTypeFont(const TrueTypeFont&) = delete;
+
+		// Transform of a composite glyph's component: x' = a * x + c * y + dx, y' = b * x + d * y + dy
+		struct Transform
+		{
+			float a, b, c, d;
+			float dx, dy;
+		};
+
+		bool FindTable(const char* tag, uint32_t& offset, uint32_t& length) const;
+		bool LoadCharacterMap(uint32_t offset, uint32_t length);
+		bool GetGlyphRange(uint16_t glyph, uint32_t& offset, uint32_t& length) const;
+		bool AppendGlyph(uint16_t glyph, const Transform& transform, uint32_t depth, GlyphOutline& outline) const;
+		bool AppendSimpleGlyph(uint32_t offset, uint32_t end, int16_t contourCount, const Transform& transform, GlyphOutline& outline) const;
+		bool AppendCompositeGlyph(uint32_t offset, uint32_t end, const Transform& transform, uint32_t depth, GlyphOutline& outline) const;
+
+		const uint8_t* mData;
+		size_t mSize;
+
+		uint16_t mUnitsPerEm;
+		int16_t mAscender;
+		int16_t mDescender;
+		int16_t mLineGap;
+		uint16_t mGlyphCount;
+		bool mLongLocaOffsets;
+		uint16_t mHorizontalMetricCount;
+
+		uint32_t mCharacterMap;  // Offset of the format 4 subtable
+		uint32_t mLoca;
+		uint32_t mGlyf;
+		uint32_t mGlyfLength;
+		uint32_t mHmtx;
+		uint32_t mKernPairs;     // Offset of the first pair of the format 0 subtable, 0 without one
+		uint16_t mKernPairCount;
+	};
+}
@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "UploadRingBuffer.h"
+
+#include "MathUtils.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <new>
+
+BirdGame::UploadRingBuffer::UploadRingBuffer() :
+	mBase(nullptr),
+	mCapacity(0),
+	mHead(0),
+	mTail(0),
+	mUsed(0),
+	mPeakUsed(0),
+	mCurrentFrameSize(0)
+{
+}
+
+void BirdGame::UploadRingBuffer::Initialize(uint8_t* mappedBase, uint64_t capacity)
+{
+	mBase = mappedBase;
+	mCapacity = capacity;
+	mHead = 0;
+	mTail = 0;
+	mUsed = 0;
+	mPeakUsed = 0;
+	mCurrentFrameSize = 0;
+	mFrames.clear();
+}
+
+bool BirdGame::UploadRingBuffer::TryAllocate(uint64_t size, uint64_t alignment, Allocation& allocation)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two");
+
+	const bool full = (mHead == mTail && mUsed != 0);
+	uint64_t offset = AlignUp(mHead, alignment);
+	uint64_t end = 0;
+
+	if (mHead >= mTail && !full)
+	{
+		// Free space is [mHead, mCapacity) followed by [0, mTail)
+		if (offset + size <= mCapacity)
+		{
+			end = offset + size;
+		}
+		else if (size <= mTail)
+		{
+			// Skip the rest of the buffer, allocations never straddle the end
+			offset = 0;
+			end = size;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Free space is [mHead, mTail)
+		if (full || offset + size > mTail)
+		{
+			return false;
+		}
+		end = offset + size;
+	}
+
+	// Space consumed including padding and the skipped end of the buffer, all of it is freed with the frame
+	const uint64_t consumed = (offset >= mHead) ? end - mHead : (mCapacity - mHead) + end;
+	mUsed += consumed;
+	mCurrentFrameSize += consumed;
+	mPeakUsed = std::max(mPeakUsed, mUsed);
+	mHead = (end == mCapacity) ? 0 : end;
+
+	allocation.offset = offset;
+	allocation.cpuAddress = (mBase != nullptr) ? mBase + offset : nullptr;
+	return true;
+}
+
+BirdGame::UploadRingBuffer::Allocation BirdGame::UploadRingBuffer::Allocate(uint64_t size, uint64_t alignment)
+{
+	Allocation allocation = {};
+	if (!TryAllocate(size, alignment, allocation))
+	{
+		assert(false && "UploadRingBuffer is out of space, increase its size");
+		throw std::bad_alloc();
+	}
+	return allocation;
+}
+
+void BirdGame::UploadRingBuffer::EndFrame(uint64_t fenceValue)
+{
+	assert((mFrames.empty() || mFrames.back().fenceValue <= fenceValue) && "Fence values must not go backwards");
+
+	if (mCurrentFrameSize != 0)
+	{
+		mFrames.push_back({ fenceValue, mHead, mCurrentFrameSize });
+		mCurrentFrameSize = 0;
+	}
+}
+
+void BirdGame::UploadRingBuffer::Retire(uint64_t completedFenceValue)
+{
+	while (!mFrames.empty() && mFrames.front().fenceValue <= completedFenceValue)
+	{
+		const Frame& frame = mFrames.front();
+		assert(mUsed >= frame.size);
+		mTail = frame.end;
+		mUsed -= frame.size;
+		mFrames.pop_front();
+	}
+
+	// Nothing in flight, so start over at the beginning to get the largest contiguous block
+	if (mUsed == 0)
+	{
+		mHead = 0;
+		mTail = 0;
+	}
+}
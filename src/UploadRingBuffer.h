@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace BirdGame
+{
+	// Ring allocator over one persistently mapped upload buffer. Allocations made between two EndFrame() calls
+	// form a region tagged with the fence value that signals the GPU is done with them; Retire() hands regions
+	// back once their fence has completed. Only deals in offsets, so it works with any mapped GPU buffer.
+	class UploadRingBuffer final
+	{
+	public:
+		struct Allocation
+		{
+			uint64_t offset;    // From the start of the buffer, add to the buffer's GPU address
+			uint8_t* cpuAddress;
+		};
+
+		UploadRingBuffer();
+
+		// mappedBase may be null if only offsets are needed
+		void Initialize(uint8_t* mappedBase, uint64_t capacity);
+
+		// Returns false if there is no contiguous space left until the GPU retires older frames.
+		// alignment must be a power of two.
+		bool TryAllocate(uint64_t size, uint64_t alignment, Allocation& allocation);
+
+		// Throws std::bad_alloc if the ring is full since that means one frame needs more than the whole buffer
+		Allocation Allocate(uint64_t size, uint64_t alignment);
+
+		// Tags everything allocated since the last EndFrame() with the fence value the GPU signals when done with it
+		void EndFrame(uint64_t fenceValue);
+
+		// Frees the regions of all frames whose fence value is <= completedFenceValue
+		void Retire(uint64_t completedFenceValue);
+
+		uint64_t GetCapacity() const { return mCapacity; }
+		uint64_t GetUsed() const { return mUsed; }
+		uint64_t GetPeakUsed() const { return mPeakUsed; }
+		size_t GetPendingFrameCount() const { return mFrames.size(); }
+
+	private:
+		UploadRingBuffer(const UploadRingBuffer&) = delete;
+
+		struct Frame
+		{
+			uint64_t fenceValue;
+			uint64_t end;   // Where the tail moves to when the frame retires
+			uint64_t size;  // Including alignment padding and space skipped when wrapping
+		};
+
+		uint8_t* mBase;
+		uint64_t mCapacity;
+
+		// Allocations are made at mHead, the oldest in flight data starts at mTail.
+		// mHead == mTail is ambiguous, so mUsed tells full from empty.
+		uint64_t mHead;
+		uint64_t mTail;
+		uint64_t mUsed;
+		uint64_t mPeakUsed;
+		uint64_t mCurrentFrameSize;
+
+		std::deque<Frame> mFrames;
+	};
+}
@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "VirtualMemory.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fstream>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+	// Large pages need the "Lock pages in memory" privilege. Returns false if the user doesn't have it.
+	bool EnableLockMemoryPrivilege()
+	{
+		HANDLE token = NULL;
+		if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+		{
+			return false;
+		}
+
+		TOKEN_PRIVILEGES privileges = {};
+		privileges.PrivilegeCount = 1;
+		privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+		bool enabled = false;
+		if (LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid))
+		{
+			// AdjustTokenPrivileges succeeds even if the privilege wasn't granted, so check the last error too
+			enabled = AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && (GetLastError() == ERROR_SUCCESS);
+		}
+
+		CloseHandle(token);
+		return enabled;
+	}
+#else
+	// Reads the default explicit huge page size from /proc/meminfo, or 0 if there are no huge pages configured
+	size_t ReadHugePageSize()
+	{
+		std::ifstream meminfo("/proc/meminfo");
+		std::string key;
+		size_t hugePagesTotal = 0;
+		size_t hugePageSizeKb = 0;
+		while (meminfo >> key)
+		{
+			if (key == "HugePages_Total:")
+			{
+				meminfo >> hugePagesTotal;
+			}
+			else if (key == "Hugepagesize:")
+			{
+				meminfo >> hugePageSizeKb;
+			}
+		}
+
+		return (hugePagesTotal > 0) ? hugePageSizeKb * 1024 : 0;
+	}
+#endif
+}
+
+size_t BirdGame::VirtualMemory::GetPageSize()
+{
+#if defined(_WIN32)
+	SYSTEM_INFO systemInfo = {};
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwPageSize;
+#else
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+size_t BirdGame::VirtualMemory::GetLargePageSize()
+{
+	static const size_t sLargePageSize = []() -> size_t
+	{
+#if defined(_WIN32)
+		return EnableLockMemoryPrivilege() ? GetLargePageMinimum() : 0;
+#else
+		return ReadHugePageSize();
+#endif
+	}();
+
+	return sLargePageSize;
+}
+
+void* BirdGame::VirtualMemory::Reserve(size_t size)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void* address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return (address == MAP_FAILED) ? nullptr : address;
+#endif
+}
+
+void* BirdGame::VirtualMemory::ReserveLargePages(size_t size)
+{
+	const size_t largePageSize = GetLargePageSize();
+	if (largePageSize == 0 || size % largePageSize != 0)
+	{
+		return nullptr;
+	}
+
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#else
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	return (address == MAP_FAILED) ? nullptr : address;
+#endif
+}
+
+bool BirdGame::VirtualMemory::Commit(void* address, size_t size)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+	if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0)
+	{
+		return false;
+	}
+
+#if defined(MADV_HUGEPAGE)
+	// Only a hint; fails harmlessly if transparent huge pages are disabled
+	madvise(address, size, MADV_HUGEPAGE);
+#endif
+	return true;
+#endif
+}
+
+void BirdGame::VirtualMemory::Prefault(void* address, size_t size)
+{
+#if defined(MADV_POPULATE_WRITE)
+	// Faults the whole range in with a single syscall on Linux 5.14+
+	if (madvise(address, size, MADV_POPULATE_WRITE) == 0)
+	{
+		return;
+	}
+#endif
+
+	const size_t pageSize = GetPageSize();
+	volatile uint8_t* bytes = static_cast<volatile uint8_t*>(address);
+	for (size_t offset = 0; offset < size; offset += pageSize)
+	{
+		bytes[offset] = 0;
+	}
+}
+
+void BirdGame::VirtualMemory::Release(void* address, size_t size)
+{
+#if defined(_WIN32)
+	(void)size;
+	VirtualFree(address, 0, MEM_RELEASE);
+#else
+	munmap(address, size);
+#endif
+}
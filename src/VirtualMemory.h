@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace BirdGame
+{
+	// Thin wrapper over the OS virtual memory API (VirtualAlloc on Windows, mmap on Linux)
+	namespace VirtualMemory
+	{
+		size_t GetPageSize();
+
+		// Size of a large/huge page, or 0 if large pages can't be used by this process
+		size_t GetLargePageSize();
+
+		// Reserves address space without backing it with memory. Returns nullptr on failure.
+		void* Reserve(size_t size);
+
+		// Reserves and commits memory backed by explicit large pages in one go, since Windows requires large pages
+		// to be committed at reservation time. size must be a multiple of GetLargePageSize(). Returns nullptr on failure.
+		void* ReserveLargePages(size_t size);
+
+		// Backs part of a reservation with memory. On Linux this also asks for transparent huge pages.
+		bool Commit(void* address, size_t size);
+
+		// Touches every page of a committed range so page faults happen now instead of on first use
+		void Prefault(void* address, size_t size);
+
+		void Release(void* address, size_t size);
+	}
+}
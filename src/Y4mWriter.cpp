@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "Y4mWriter.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <string>
+
+BirdGame::Y4mWriter::Y4mWriter() :
+	mWidth(0),
+	mHeight(0)
+{
+}
+
+bool BirdGame::Y4mWriter::Open(const char* path, uint32_t width, uint32_t height, uint32_t framesPerSecond)
+{
+	Close();
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+	if (!mFile)
+	{
+		mFile.close();
+		return false;
+	}
+
+	mWidth = width;
+	mHeight = height;
+
+	// Chroma planes round up for odd sizes. Black is Y 16 and neutral chroma.
+	const size_t lumaSize = static_cast<size_t>(width) * height;
+	const size_t chromaSize = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+	mPlanes.assign(lumaSize + 2 * chromaSize, 128);
+	std::fill(mPlanes.begin(), mPlanes.begin() + lumaSize, static_cast<uint8_t>(16));
+
+	const std::string header = "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height) + " F" + std::to_string(framesPerSecond) + ":1 Ip A1:1 C420jpeg\n";
+	mFile.write(header.data(), header.size());
+	return static_cast<bool>(mFile);
+}
+
+void BirdGame::Y4mWriter::Close()
+{
+	if (mFile.is_open())
+	{
+		mFile.close();
+	}
+	mWidth = 0;
+	mHeight = 0;
+}
+
+void BirdGame::Y4mWriter::WriteFrame(const uint8_t* pixels, uint32_t rowPitch)
+{
+	assert(IsOpen());
+
+	const uint32_t chromaWidth = (mWidth + 1) / 2;
+	const uint32_t chromaHeight = (mHeight + 1) / 2;
+	uint8_t* luma = mPlanes.data();
+	uint8_t* blueDifference = luma + static_cast<size_t>(mWidth) * mHeight;
+	uint8_t* redDifference = blueDifference + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+	// Integer BT.601 studio swing, chroma from the average of each 2x2 quad
+	for (uint32_t y = 0; y < mHeight; ++y)
+	{
+		const uint8_t* row = pixels + static_cast<size_t>(y) * rowPitch;
+		for (uint32_t x = 0; x < mWidth; ++x)
+		{
+			const int32_t r = row[x * 4];
+			const int32_t g = row[x * 4 + 1];
+			const int32_t b = row[x * 4 + 2];
+			luma[static_cast<size_t>(y) * mWidth + x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+		}
+	}
+
+	for (uint32_t y = 0; y < chromaHeight; ++y)
+	{
+		const uint8_t* row0 = pixels + static_cast<size_t>(2 * y) * rowPitch;
+		const uint8_t* row1 = pixels + static_cast<size_t>(std::min(2 * y + 1, mHeight - 1)) * rowPitch;
+		for (uint32_t x = 0; x < chromaWidth; ++x)
+		{
+			const uint32_t x0 = 2 * x * 4;
+			const uint32_t x1 = std::min(2 * x + 1, mWidth - 1) * 4;
+			const int32_t r = (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2;
+			const int32_t g = (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2;
+			const int32_t b = (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2;
+			blueDifference[static_cast<size_t>(y) * chromaWidth + x] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			redDifference[static_cast<size_t>(y) * chromaWidth + x] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	AppendFrame();
+}
+
+void BirdGame::Y4mWriter::RepeatFrame()
+{
+	assert(IsOpen());
+	AppendFrame();
+}
+
+void BirdGame::Y4mWriter::AppendFrame()
+{
+	// Flushed right away so a crash or a kill loses at most the frame being written
+	mFile.write("FRAME\n", 6);
+	mFile.write(reinterpret_cast<const char*>(mPlanes.data()), mPlanes.size());
+	mFile.flush();
+}
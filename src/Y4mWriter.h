@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace BirdGame
+{
+	// Writes an uncompressed YUV4MPEG2 video: 8 bit 4:2:0 in limited range BT.601, which ffmpeg and most players
+	// read as is. There is no index or trailer, so a file cut off mid way still plays up to its last whole frame.
+	class Y4mWriter final
+	{
+	public:
+		Y4mWriter();
+
+		// Width and height are fixed for the whole stream. Returns false if the file can't be created.
+		bool Open(const char* path, uint32_t width, uint32_t height, uint32_t framesPerSecond);
+		void Close();
+
+		bool IsOpen() const { return mFile.is_open(); }
+		uint32_t GetWidth() const { return mWidth; }
+		uint32_t GetHeight() const { return mHeight; }
+
+		// Converts RGBA8 rows rowPitch bytes apart, sized like the stream, and appends them as a frame. Alpha is ignored.
+		void WriteFrame(const uint8_t* pixels, uint32_t rowPitch);
+
+		// Appends the last frame again, black if there wasn't one. Stands in for frames that couldn't be captured,
+		// so the video keeps its timing.
+		void RepeatFrame();
+
+	private:
+		Y4mWriter(const Y4mWriter&) = delete;
+
+		void AppendFrame();
+
+		std::ofstream mFile;
+		uint32_t mWidth;
+		uint32_t mHeight;
+
+		// The last frame's Y, U and V planes, back to back
+		std::vector<uint8_t> mPlanes;
+	};
+}
@@ -1,10 +1,66 @@
 #include "pch.h"
 
 #include "Application.h"
+#include "CommandLine.h"
+#include "GoldenImageHarness.h"
+#include "RendererDX.h"
+
+namespace
+{
+	// The game is a windowed app without a console of its own. Writes to the stdout it was started with, e.g. a
+	// redirect in a build script, or failing that to the console of the command prompt it was started from.
+	void WriteToStandardOutput(const std::string& text)
+	{
+		HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+		HANDLE console = INVALID_HANDLE_VALUE;
+		if ((output == NULL || output == INVALID_HANDLE_VALUE) && AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			console = CreateFileW(L"CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, NULL);
+			output = console;
+		}
+
+		if (output != NULL && output != INVALID_HANDLE_VALUE)
+		{
+			DWORD written = 0;
+			WriteFile(output, text.data(), static_cast<DWORD>(text.size()), &written, nullptr);
+		}
+
+		if (console != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(console);
+		}
+	}
+}
 
 _Use_decl_annotations_
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/, LPWSTR /*lpCmdLine*/, int nShowCmd)
 {
-	BirdGame::Application::Initialize(hInstance, nShowCmd);
-	return BirdGame::Application::Instance().Run();
+	const BirdGame::CommandLine commandLine;
+
+	// -compileshaders only builds the shader bytecode the game loads at startup and exits
+	if (commandLine.HasOption(L"-compileshaders"))
+	{
+		return BirdGame::RendererDX::CompileShaders() ? 0 : 1;
+	}
+
+	// -golden checks the sprite and text pipelines against the golden images and timings and exits, failing if any
+	// are missing. Only -goldenupdate records new ones. The report goes to stdout, the debugger output and
+	// golden_output/report.txt.
+	if (commandLine.HasOption(L"-golden") || commandLine.HasOption(L"-goldenupdate"))
+	{
+		BirdGame::GoldenImageHarness::Settings settings;
+		settings.update = commandLine.HasOption(L"-goldenupdate");
+		BirdGame::GoldenImageHarness harness(settings);
+
+		std::string report;
+		const uint32_t failureCount = harness.Run(report);
+		OutputDebugStringA(report.c_str());
+		WriteToStandardOutput(report);
+		return (failureCount == 0) ? 0 : 1;
+	}
+
+	BirdGame::Application::Initialize(hInstance, nShowCmd, commandLine);
+	const int exitCode = BirdGame::Application::Instance().Run();
+	const int shutdownCode = BirdGame::Application::Shutdown();
+	return (exitCode != 0) ? exitCode : shutdownCode;
 }
@@ -1,5 +1,9 @@
 #pragma once
 
+// Platform specific headers are only pulled in on Windows so that the platform independent
+// parts of the engine (memory, batching, ...) can also be compiled on other platforms.
+#if defined(_WIN32)
+
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers.
 #endif
@@ -16,6 +20,8 @@
 #include <dxcapi.h>
 #include <dxgi1_4.h>
 
+#endif
+
 // Standard libraries
 #include <cstdint>
 #include <memory>
@@ -0,0 +1,107 @@
+#include "TestFramework.h"
+
+#include "DescriptorAllocator.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+BIRDGAME_TEST(DescriptorAllocatorAllocatesFirstFit)
+{
+	DescriptorAllocator allocator(16, 0);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(4) == 0);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(2) == 4);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(4) == 6);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 6);
+
+	// Free [4, 6), leaving holes of 2 at 4 and 6 at 10
+	allocator.FreePersistent(4, 2);
+	allocator.EndFrame(1);
+	allocator.Retire(1);
+
+	// Holes too small are skipped, otherwise the lowest hole that fits is used
+	BIRDGAME_CHECK(allocator.AllocatePersistent(3) == 10);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(2) == 4);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(1) == 13);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 2);
+}
+
+BIRDGAME_TEST(DescriptorAllocatorMergesFreedRanges)
+{
+	DescriptorAllocator allocator(12, 0);
+	const uint32_t first = allocator.AllocatePersistent(4);
+	const uint32_t second = allocator.AllocatePersistent(4);
+	const uint32_t third = allocator.AllocatePersistent(4);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 0);
+
+	// Freed out of order, the ranges have to merge with the neighbour before, after and on both sides
+	allocator.FreePersistent(third, 4);
+	allocator.FreePersistent(first, 4);
+	allocator.FreePersistent(second, 4);
+	allocator.EndFrame(1);
+	allocator.Retire(1);
+
+	// Only one merged range can hold all of them
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 12);
+	BIRDGAME_CHECK(allocator.AllocatePersistent(12) == 0);
+}
+
+BIRDGAME_TEST(DescriptorAllocatorDefersReuseUntilFenceRetires)
+{
+	DescriptorAllocator allocator(4, 0);
+	const uint32_t index = allocator.AllocatePersistent(4);
+
+	// The GPU may still read the descriptors of frames 1 and 2
+	allocator.FreePersistent(index, 2);
+	allocator.EndFrame(1);
+	allocator.FreePersistent(index + 2, 2);
+	allocator.EndFrame(2);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 0);
+
+	allocator.Retire(0);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 0);
+	allocator.Retire(1);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 2);
+	allocator.Retire(2);
+	BIRDGAME_CHECK(allocator.GetPersistentFreeCount() == 4);
+}
+
+BIRDGAME_TEST(DescriptorAllocatorWrapsTransientRing)
+{
+	// Transient indices come after the persistent region
+	DescriptorAllocator allocator(8, 10);
+	BIRDGAME_CHECK(allocator.AllocateTransient(4) == 8);
+	allocator.EndFrame(1);
+	BIRDGAME_CHECK(allocator.AllocateTransient(4) == 12);
+	allocator.EndFrame(2);
+
+	// Two descriptors are left at the end, too few for a table of three, so it wraps once frame 1 is done
+	allocator.Retire(1);
+	BIRDGAME_CHECK(allocator.AllocateTransient(3) == 8);
+	allocator.EndFrame(3);
+
+	allocator.Retire(3);
+	BIRDGAME_CHECK(allocator.AllocateTransient(10) == 8);
+}
+
+BIRDGAME_TEST(DescriptorAllocatorMergesStagedCopies)
+{
+	DescriptorAllocator allocator(8, 8);
+	allocator.StageCopy(0, 100, 2);
+	allocator.StageCopy(2, 102, 1); // Continues both ranges
+	allocator.StageCopy(3, 110, 1); // Source jumps
+	allocator.StageCopy(5, 111, 1); // Destination jumps
+	allocator.StageCopy(6, 112, 2);
+
+	const std::vector<DescriptorAllocator::CopyRange>& copies = allocator.GetStagedCopies();
+	BIRDGAME_CHECK(copies.size() == 3);
+	if (copies.size() == 3)
+	{
+		BIRDGAME_CHECK(copies[0].destination == 0 && copies[0].source == 100 && copies[0].count == 3);
+		BIRDGAME_CHECK(copies[1].destination == 3 && copies[1].source == 110 && copies[1].count == 1);
+		BIRDGAME_CHECK(copies[2].destination == 5 && copies[2].source == 111 && copies[2].count == 3);
+	}
+
+	allocator.ClearStagedCopies();
+	BIRDGAME_CHECK(allocator.GetStagedCopies().empty());
+}
@@ -0,0 +1,172 @@
+#include "TestFramework.h"
+
+#include "FrameScheduler.h"
+#include "IFence.h"
+
+#include <cstddef>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	// Stands in for a GPU fence. The test decides when the "GPU" finishes work with Complete(), and a wait
+	// completes the fence up to the value waited for, as the GPU eventually would.
+	class SimulatedFence final : public IFence
+	{
+	public:
+		SimulatedFence() : mSignalled(0), mCompleted(0) {}
+
+		void Signal(uint64_t value) override
+		{
+			BIRDGAME_CHECK(value > mSignalled);
+			mSignalled = value;
+		}
+
+		uint64_t GetCompletedValue() const override { return mCompleted; }
+
+		void WaitForValue(uint64_t value) override
+		{
+			BIRDGAME_CHECK(value <= mSignalled); // Waiting for a value that was never signalled would hang
+			mWaits.push_back(value);
+			if (mCompleted < value)
+			{
+				mCompleted = value;
+			}
+		}
+
+		void Complete(uint64_t value)
+		{
+			BIRDGAME_CHECK(value <= mSignalled);
+			mCompleted = value;
+		}
+
+		uint64_t GetSignalledValue() const { return mSignalled; }
+		const std::vector<uint64_t>& GetWaits() const { return mWaits; }
+
+	private:
+		uint64_t mSignalled;
+		uint64_t mCompleted;
+		std::vector<uint64_t> mWaits;
+	};
+}
+
+BIRDGAME_TEST(FrameSchedulerClampsFramesInFlight)
+{
+	SimulatedFence fence;
+	BIRDGAME_CHECK(FrameScheduler(fence, 0).GetFramesInFlight() == FrameScheduler::kMinFramesInFlight);
+	BIRDGAME_CHECK(FrameScheduler(fence, 2).GetFramesInFlight() == 2);
+	BIRDGAME_CHECK(FrameScheduler(fence, 3).GetFramesInFlight() == 3);
+	BIRDGAME_CHECK(FrameScheduler(fence, 10).GetFramesInFlight() == FrameScheduler::kMaxFramesInFlight);
+}
+
+BIRDGAME_TEST(FrameSchedulerDoesNotWaitWhileSlotsAreFree)
+{
+	SimulatedFence fence;
+	FrameScheduler scheduler(fence, 3);
+
+	// The GPU hasn't finished anything, but every frame gets a slot nobody has used yet
+	for (uint32_t frame = 0; frame < 3; ++frame)
+	{
+		BIRDGAME_CHECK(scheduler.BeginFrame() == frame);
+		BIRDGAME_CHECK(scheduler.GetSlotState(frame) == FrameScheduler::SlotState::Recording);
+		BIRDGAME_CHECK(scheduler.EndFrame() == frame + 1);
+		BIRDGAME_CHECK(scheduler.GetSlotState(frame) == FrameScheduler::SlotState::InFlight);
+	}
+
+	BIRDGAME_CHECK(fence.GetSignalledValue() == 3);
+	BIRDGAME_CHECK(fence.GetWaits().empty());
+	BIRDGAME_CHECK(scheduler.GetWaitCount() == 0);
+}
+
+BIRDGAME_TEST(FrameSchedulerReusesCompletedSlotWithoutWaiting)
+{
+	SimulatedFence fence;
+	FrameScheduler scheduler(fence, 2);
+	scheduler.BeginFrame();
+	scheduler.EndFrame();
+	scheduler.BeginFrame();
+	scheduler.EndFrame();
+
+	// The GPU finished the first frame, so its slot can be recorded into straight away
+	fence.Complete(1);
+	BIRDGAME_CHECK(scheduler.BeginFrame() == 0);
+	BIRDGAME_CHECK(fence.GetWaits().empty());
+	BIRDGAME_CHECK(scheduler.GetWaitCount() == 0);
+	BIRDGAME_CHECK(scheduler.EndFrame() == 3);
+}
+
+BIRDGAME_TEST(FrameSchedulerWaitsOnIncompleteFence)
+{
+	SimulatedFence fence;
+	FrameScheduler scheduler(fence, 2);
+	scheduler.BeginFrame();
+	scheduler.EndFrame();
+	scheduler.BeginFrame();
+	scheduler.EndFrame();
+
+	// Slot 0 is still in flight with fence value 1, so reusing it has to wait for exactly that value
+	BIRDGAME_CHECK(scheduler.BeginFrame() == 0);
+	BIRDGAME_CHECK(fence.GetWaits().size() == 1);
+	BIRDGAME_CHECK(!fence.GetWaits().empty() && fence.GetWaits()[0] == 1);
+	BIRDGAME_CHECK(scheduler.GetWaitCount() == 1);
+	BIRDGAME_CHECK(scheduler.GetCompletedFenceValue() >= 1);
+	scheduler.EndFrame();
+}
+
+BIRDGAME_TEST(FrameSchedulerWrapsAroundSlots)
+{
+	for (uint32_t framesInFlight = FrameScheduler::kMinFramesInFlight; framesInFlight <= FrameScheduler::kMaxFramesInFlight; ++framesInFlight)
+	{
+		SimulatedFence fence;
+		FrameScheduler scheduler(fence, framesInFlight);
+
+		// The GPU only gets anywhere when the CPU waits on it, so every reused slot has to wait for the frame
+		// recorded into it framesInFlight frames earlier
+		const uint32_t frameCount = 10 * framesInFlight + 1;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			BIRDGAME_CHECK(scheduler.BeginFrame() == frame % framesInFlight);
+			if (frame >= framesInFlight)
+			{
+				BIRDGAME_CHECK(fence.GetCompletedValue() == frame + 1 - framesInFlight);
+			}
+			BIRDGAME_CHECK(scheduler.EndFrame() == frame + 1);
+		}
+
+		const std::vector<uint64_t>& waits = fence.GetWaits();
+		BIRDGAME_CHECK(waits.size() == frameCount - framesInFlight);
+		for (size_t i = 0; i < waits.size(); ++i)
+		{
+			BIRDGAME_CHECK(waits[i] == i + 1);
+		}
+		BIRDGAME_CHECK(scheduler.GetWaitCount() == frameCount - framesInFlight);
+		BIRDGAME_CHECK(scheduler.GetFrameCount() == frameCount);
+		BIRDGAME_CHECK(scheduler.GetLastSignalledFenceValue() == frameCount);
+	}
+}
+
+BIRDGAME_TEST(FrameSchedulerWaitForIdleWaitsForLastFrame)
+{
+	SimulatedFence fence;
+	FrameScheduler scheduler(fence, 3);
+	for (uint32_t frame = 0; frame < 5; ++frame)
+	{
+		scheduler.BeginFrame();
+		scheduler.EndFrame();
+	}
+
+	fence.Complete(2);
+	scheduler.WaitForIdle();
+	BIRDGAME_CHECK(!fence.GetWaits().empty() && fence.GetWaits().back() == 5);
+	BIRDGAME_CHECK(fence.GetCompletedValue() == 5);
+	for (uint32_t slot = 0; slot < scheduler.GetFramesInFlight(); ++slot)
+	{
+		BIRDGAME_CHECK(scheduler.GetSlotState(slot) == FrameScheduler::SlotState::Available);
+	}
+
+	// Once idle nothing is waited on again
+	const size_t waitCount = fence.GetWaits().size();
+	scheduler.WaitForIdle();
+	BIRDGAME_CHECK(fence.GetWaits().size() == waitCount);
+}
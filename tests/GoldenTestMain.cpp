@@ -0,0 +1,26 @@
+#include "GoldenImageHarness.h"
+
+#include <cstdio>
+#include <string>
+
+// Checks the golden images on any platform: BirdGameGoldenTests <golden directory>. Failed scenes and the report go
+// to golden_output in the working directory. Timings are left out, they only hold on the machine that recorded them;
+// record new goldens with the game's -goldenupdate.
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		printf("Usage: %s <golden directory>\n", argv[0]);
+		return 1;
+	}
+
+	BirdGame::GoldenImageHarness::Settings settings;
+	settings.goldenDirectory = argv[1];
+	settings.checkTimings = false;
+	BirdGame::GoldenImageHarness harness(settings);
+
+	std::string report;
+	const uint32_t failureCount = harness.Run(report);
+	printf("%s", report.c_str());
+	return (failureCount == 0) ? 0 : 1;
+}
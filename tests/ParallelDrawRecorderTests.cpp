@@ -0,0 +1,254 @@
+#include "TestFramework.h"
+
+#include "JobSystem.h"
+#include "ParallelDrawRecorder.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	struct Draw
+	{
+		uint64_t key;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+
+		bool operator==(const Draw& other) const { return key == other.key && firstInstance == other.firstInstance && instanceCount == other.instanceCount; }
+	};
+
+	// Stands in for a command list: remembers the draws recorded into it
+	using RecordedList = std::vector<Draw>;
+
+	// Packets back to back in instance order, like SpriteBatch::Build() produces them
+	std::vector<DrawPacket> MakePackets(const std::vector<uint32_t>& instanceCounts)
+	{
+		std::vector<DrawPacket> packets;
+		uint32_t firstInstance = 0;
+		for (size_t i = 0; i < instanceCounts.size(); ++i)
+		{
+			packets.push_back({ i, firstInstance, instanceCounts[i] });
+			firstInstance += instanceCounts[i];
+		}
+		return packets;
+	}
+
+	// Every instance each chunk draws, in order
+	std::vector<uint32_t> ExpandChunks(const std::vector<DrawPacket>& packets, const std::vector<ParallelDrawRecorder::Chunk>& chunks)
+	{
+		std::vector<uint32_t> instances;
+		for (const ParallelDrawRecorder::Chunk& chunk : chunks)
+		{
+			ParallelDrawRecorder::ForEachDraw(packets, chunk, [&](const DrawPacket&, uint32_t firstInstance, uint32_t instanceCount)
+			{
+				for (uint32_t i = 0; i < instanceCount; ++i)
+				{
+					instances.push_back(firstInstance + i);
+				}
+			});
+		}
+		return instances;
+	}
+
+	// What recording the whole stream on one thread into one list would produce, merging the pieces of a packet
+	RecordedList Flatten(const std::vector<RecordedList>& lists)
+	{
+		RecordedList flattened;
+		for (const RecordedList& list : lists)
+		{
+			for (const Draw& draw : list)
+			{
+				if (!flattened.empty() && flattened.back().key == draw.key && flattened.back().firstInstance + flattened.back().instanceCount == draw.firstInstance)
+				{
+					flattened.back().instanceCount += draw.instanceCount;
+				}
+				else
+				{
+					flattened.push_back(draw);
+				}
+			}
+		}
+		return flattened;
+	}
+}
+
+BIRDGAME_TEST(ParallelDrawRecorderSplitCoversEveryInstanceOnce)
+{
+	std::mt19937 random(42);
+	for (uint32_t iteration = 0; iteration < 200; ++iteration)
+	{
+		std::vector<uint32_t> instanceCounts(random() % 12);
+		uint32_t totalInstances = 0;
+		for (uint32_t& count : instanceCounts)
+		{
+			count = (random() % 4 == 0) ? 0 : random() % 300;
+			totalInstances += count;
+		}
+		const std::vector<DrawPacket> packets = MakePackets(instanceCounts);
+
+		std::vector<ParallelDrawRecorder::Chunk> chunks;
+		const uint32_t maxChunks = 1 + random() % 8;
+		const uint32_t minInstancesPerChunk = 1 + random() % 100;
+		ParallelDrawRecorder::Split(packets, maxChunks, minInstancesPerChunk, chunks);
+
+		BIRDGAME_CHECK(chunks.size() <= maxChunks);
+		BIRDGAME_CHECK((totalInstances == 0) == chunks.empty());
+
+		// Instances are numbered consecutively, so covering each once in order means counting up from 0
+		const std::vector<uint32_t> instances = ExpandChunks(packets, chunks);
+		bool inOrder = (instances.size() == totalInstances);
+		for (size_t i = 0; inOrder && i < instances.size(); ++i)
+		{
+			inOrder = (instances[i] == i);
+		}
+		BIRDGAME_CHECK(inOrder);
+
+		for (const ParallelDrawRecorder::Chunk& chunk : chunks)
+		{
+			BIRDGAME_CHECK(chunk.instanceCount > 0);
+			BIRDGAME_CHECK(chunk.beginOffset < packets[chunk.beginPacket].instanceCount);
+		}
+	}
+}
+
+BIRDGAME_TEST(ParallelDrawRecorderSplitsPacketsAcrossChunks)
+{
+	// A whole layer of sprites in one packet still spreads over every list
+	const std::vector<DrawPacket> packets = MakePackets({ 1000 });
+	std::vector<ParallelDrawRecorder::Chunk> chunks;
+	ParallelDrawRecorder::Split(packets, 4, 100, chunks);
+
+	BIRDGAME_CHECK(chunks.size() == 4);
+	for (uint32_t i = 0; i < chunks.size(); ++i)
+	{
+		BIRDGAME_CHECK(chunks[i].beginPacket == 0 && chunks[i].beginOffset == i * 250 && chunks[i].instanceCount == 250);
+	}
+
+	// The remainder is spread out instead of landing on the last chunk
+	ParallelDrawRecorder::Split(MakePackets({ 5, 5 }), 3, 1, chunks);
+	BIRDGAME_CHECK(chunks.size() == 3);
+	if (chunks.size() == 3)
+	{
+		BIRDGAME_CHECK(chunks[0].beginPacket == 0 && chunks[0].beginOffset == 0 && chunks[0].instanceCount == 3);
+		BIRDGAME_CHECK(chunks[1].beginPacket == 0 && chunks[1].beginOffset == 3 && chunks[1].instanceCount == 3);
+		BIRDGAME_CHECK(chunks[2].beginPacket == 1 && chunks[2].beginOffset == 1 && chunks[2].instanceCount == 4);
+	}
+
+	// Streams too small to be worth splitting stay in one list
+	ParallelDrawRecorder::Split(MakePackets({ 30, 40 }), 4, 100, chunks);
+	BIRDGAME_CHECK(chunks.size() == 1 && chunks[0].instanceCount == 70);
+}
+
+BIRDGAME_TEST(ParallelDrawRecorderOrderDoesNotDependOnWorkers)
+{
+	const std::vector<DrawPacket> packets = MakePackets({ 700, 3, 0, 129, 1500, 64, 1 });
+	const uint32_t kMaxChunks = 6;
+
+	RecordedList expected;
+	for (const DrawPacket& packet : packets)
+	{
+		if (packet.instanceCount > 0)
+		{
+			expected.push_back({ packet.key, packet.firstInstance, packet.instanceCount });
+		}
+	}
+
+	std::vector<RecordedList> singleThreadedLists;
+	for (uint32_t workerCount : { 0u, 1u, 3u, 7u })
+	{
+		JobSystem jobSystem(workerCount);
+		ParallelDrawRecorder recorder(jobSystem, kMaxChunks, 32);
+
+		// Run it a few times so the chunks land on different threads
+		for (uint32_t run = 0; run < 20; ++run)
+		{
+			std::vector<RecordedList> lists(kMaxChunks);
+			std::atomic<uint32_t> badWorkerIndices(0);
+			const uint32_t listCount = recorder.Record(packets, [&](uint32_t chunkIndex, const ParallelDrawRecorder::Chunk& chunk, uint32_t workerIndex)
+			{
+				if (workerIndex >= jobSystem.GetThreadCount())
+				{
+					badWorkerIndices++;
+				}
+				ParallelDrawRecorder::ForEachDraw(packets, chunk, [&](const DrawPacket& packet, uint32_t firstInstance, uint32_t instanceCount)
+				{
+					lists[chunkIndex].push_back({ packet.key, firstInstance, instanceCount });
+				});
+			});
+
+			BIRDGAME_CHECK(listCount == kMaxChunks);
+			BIRDGAME_CHECK(badWorkerIndices.load() == 0);
+			BIRDGAME_CHECK(Flatten(lists) == expected);
+
+			// Every list holds the same commands whichever thread recorded it
+			if (singleThreadedLists.empty())
+			{
+				singleThreadedLists = lists;
+			}
+			BIRDGAME_CHECK(lists == singleThreadedLists);
+		}
+	}
+}
+
+BIRDGAME_TEST(JobSystemRunsInlineWithoutWorkers)
+{
+	JobSystem jobSystem(0);
+	BIRDGAME_CHECK(jobSystem.GetThreadCount() == 1);
+
+	std::vector<uint32_t> chunks;
+	jobSystem.ParallelFor(10, 4, [&](uint32_t chunkIndex, uint32_t begin, uint32_t end, uint32_t workerIndex)
+	{
+		BIRDGAME_CHECK(workerIndex == 0);
+		BIRDGAME_CHECK(begin == chunkIndex * 4 && end == ((chunkIndex == 2) ? 10u : begin + 4));
+		chunks.push_back(chunkIndex);
+	});
+	BIRDGAME_CHECK(chunks == std::vector<uint32_t>({ 0, 1, 2 }));
+
+	bool called = false;
+	jobSystem.ParallelFor(0, 4, [&](uint32_t, uint32_t, uint32_t, uint32_t) { called = true; });
+	BIRDGAME_CHECK(!called);
+}
+
+BIRDGAME_TEST(JobSystemRunsEveryItemOnceWithWorkers)
+{
+	JobSystem jobSystem(4);
+	BIRDGAME_CHECK(jobSystem.GetThreadCount() == 5);
+
+	// Back to back jobs, which is where a worker still busy with the previous job could claim a chunk of the next
+	const uint32_t kCount = 1000;
+	std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[kCount]);
+	for (uint32_t job = 0; job < 500; ++job)
+	{
+		for (uint32_t i = 0; i < kCount; ++i)
+		{
+			visits[i].store(0);
+		}
+
+		const uint32_t grainSize = 1 + job % 37;
+		std::atomic<uint32_t> badRanges(0);
+		jobSystem.ParallelFor(kCount, grainSize, [&](uint32_t chunkIndex, uint32_t begin, uint32_t end, uint32_t workerIndex)
+		{
+			if (begin != chunkIndex * grainSize || end > kCount || end <= begin || workerIndex >= jobSystem.GetThreadCount())
+			{
+				badRanges++;
+				return;
+			}
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				visits[i]++;
+			}
+		});
+
+		BIRDGAME_CHECK(badRanges.load() == 0);
+		uint32_t wrongVisits = 0;
+		for (uint32_t i = 0; i < kCount; ++i)
+		{
+			wrongVisits += (visits[i].load() != 1) ? 1 : 0;
+		}
+		BIRDGAME_CHECK(wrongVisits == 0);
+	}
+}
@@ -0,0 +1,145 @@
+#include "TestFramework.h"
+
+#include "PipelineCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	constexpr uint64_t kDeviceKey = 0x1234;
+	constexpr size_t kVersionOffset = 4; // FileHeader::version
+
+	void FillCache(PipelineCache& cache)
+	{
+		const uint8_t first[] = { 1, 2, 3 };
+		const uint8_t second[] = { 4, 5, 6, 7, 8 };
+		cache.Store(20, first, sizeof(first));
+		cache.Store(10, second, sizeof(second));
+		cache.Store(30, nullptr, 0);
+	}
+
+	std::vector<uint8_t> SerializeFilledCache()
+	{
+		PipelineCache cache(kDeviceKey);
+		FillCache(cache);
+		std::vector<uint8_t> data;
+		cache.Serialize(data);
+		return data;
+	}
+}
+
+BIRDGAME_TEST(PipelineCacheRoundTrips)
+{
+	const std::vector<uint8_t> data = SerializeFilledCache();
+
+	PipelineCache cache(kDeviceKey);
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size()) == PipelineCache::LoadResult::Loaded);
+	BIRDGAME_CHECK(cache.GetEntryCount() == 3);
+	BIRDGAME_CHECK(cache.Find(10) != nullptr && *cache.Find(10) == std::vector<uint8_t>({ 4, 5, 6, 7, 8 }));
+	BIRDGAME_CHECK(cache.Find(20) != nullptr && *cache.Find(20) == std::vector<uint8_t>({ 1, 2, 3 }));
+	BIRDGAME_CHECK(cache.Find(30) != nullptr && cache.Find(30)->empty());
+	BIRDGAME_CHECK(cache.Find(40) == nullptr);
+
+	// Entries are written sorted, so the same contents give the same bytes whatever order they were stored in
+	std::vector<uint8_t> reserialized;
+	cache.Serialize(reserialized);
+	BIRDGAME_CHECK(reserialized == data);
+}
+
+BIRDGAME_TEST(PipelineCacheRejectsCorruptFiles)
+{
+	const std::vector<uint8_t> data = SerializeFilledCache();
+	PipelineCache cache(kDeviceKey);
+
+	// Cut off inside the header and inside the entries
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), 16) == PipelineCache::LoadResult::Corrupt);
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size() - 1) == PipelineCache::LoadResult::Corrupt);
+	BIRDGAME_CHECK(cache.GetEntryCount() == 0);
+
+	// Flipped bit in an entry no longer matches the checksum
+	std::vector<uint8_t> flipped = data;
+	flipped.back() ^= 0x01;
+	BIRDGAME_CHECK(cache.Deserialize(flipped.data(), flipped.size()) == PipelineCache::LoadResult::Corrupt);
+
+	std::vector<uint8_t> badMagic = data;
+	badMagic[0] ^= 0xff;
+	BIRDGAME_CHECK(cache.Deserialize(badMagic.data(), badMagic.size()) == PipelineCache::LoadResult::Corrupt);
+	BIRDGAME_CHECK(cache.GetEntryCount() == 0);
+}
+
+BIRDGAME_TEST(PipelineCacheRejectsOtherVersions)
+{
+	std::vector<uint8_t> data = SerializeFilledCache();
+	const uint32_t version = PipelineCache::kFormatVersion + 1;
+	memcpy(&data[kVersionOffset], &version, sizeof(version));
+
+	PipelineCache cache(kDeviceKey);
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size()) == PipelineCache::LoadResult::VersionMismatch);
+	BIRDGAME_CHECK(cache.GetEntryCount() == 0);
+}
+
+BIRDGAME_TEST(PipelineCacheRejectsOtherDevices)
+{
+	const std::vector<uint8_t> data = SerializeFilledCache();
+
+	PipelineCache cache(kDeviceKey + 1);
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size()) == PipelineCache::LoadResult::DeviceMismatch);
+	BIRDGAME_CHECK(cache.GetEntryCount() == 0);
+}
+
+BIRDGAME_TEST(PipelineCacheTracksDirtyState)
+{
+	const std::vector<uint8_t> data = SerializeFilledCache();
+	PipelineCache cache(kDeviceKey);
+	BIRDGAME_CHECK(!cache.IsDirty());
+
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size()) == PipelineCache::LoadResult::Loaded);
+	BIRDGAME_CHECK(!cache.IsDirty());
+
+	// Removing what isn't there changes nothing
+	cache.Remove(40);
+	BIRDGAME_CHECK(!cache.IsDirty());
+	cache.Remove(10);
+	BIRDGAME_CHECK(cache.IsDirty());
+
+	// Serializing alone doesn't clean it, only a successful Save() or Load() does
+	std::vector<uint8_t> output;
+	cache.Serialize(output);
+	BIRDGAME_CHECK(cache.IsDirty());
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), data.size()) == PipelineCache::LoadResult::Loaded);
+	BIRDGAME_CHECK(!cache.IsDirty());
+
+	// A rejected file has to be replaced, even if no pipeline gets stored afterwards
+	PipelineCache otherDevice(kDeviceKey + 1);
+	otherDevice.Deserialize(data.data(), data.size());
+	BIRDGAME_CHECK(otherDevice.IsDirty());
+	BIRDGAME_CHECK(cache.Deserialize(data.data(), 8) == PipelineCache::LoadResult::Corrupt);
+	BIRDGAME_CHECK(cache.IsDirty());
+}
+
+BIRDGAME_TEST(PipelineCacheSavesAndLoadsFiles)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "birdgame_pipeline_cache_test.bin";
+	std::error_code error;
+	std::filesystem::remove(path, error);
+
+	PipelineCache missing(kDeviceKey);
+	BIRDGAME_CHECK(missing.Load(path.string()) == PipelineCache::LoadResult::Missing);
+	BIRDGAME_CHECK(!missing.IsDirty());
+
+	PipelineCache saved(kDeviceKey);
+	FillCache(saved);
+	BIRDGAME_CHECK(saved.Save(path.string()));
+	BIRDGAME_CHECK(!saved.IsDirty());
+	BIRDGAME_CHECK(!std::filesystem::exists(path.string() + ".tmp"));
+
+	PipelineCache loaded(kDeviceKey);
+	BIRDGAME_CHECK(loaded.Load(path.string()) == PipelineCache::LoadResult::Loaded);
+	BIRDGAME_CHECK(loaded.GetEntryCount() == 3);
+
+	std::filesystem::remove(path, error);
+}
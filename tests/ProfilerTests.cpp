@@ -0,0 +1,146 @@
+#include "TestFramework.h"
+
+#include "CpuProfiler.h"
+#include "ProfileFrameBuilder.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	bool ScopeEquals(const ProfileScopeResult& scope, const char* name, uint32_t parent, uint32_t depth)
+	{
+		return strcmp(scope.name, name) == 0 && scope.parent == parent && scope.depth == depth;
+	}
+}
+
+BIRDGAME_TEST(ProfileFrameBuilderBuildsScopeTree)
+{
+	ProfileFrameBuilder builder;
+	builder.BeginFrame(7);
+	BIRDGAME_CHECK(builder.BeginScope("Frame") == 0);
+	BIRDGAME_CHECK(builder.BeginScope("Scene") == 1);
+	BIRDGAME_CHECK(builder.BeginScope("Sprites") == 2);
+	BIRDGAME_CHECK(builder.EndScope() == 2);
+	BIRDGAME_CHECK(builder.EndScope() == 1);
+	BIRDGAME_CHECK(builder.BeginScope("Hud") == 3);
+	BIRDGAME_CHECK(builder.EndScope() == 3);
+	BIRDGAME_CHECK(builder.EndScope() == 0);
+	BIRDGAME_CHECK(builder.BeginScope("Present") == 4);
+	BIRDGAME_CHECK(builder.EndScope() == 4);
+	builder.EndFrame();
+	BIRDGAME_CHECK(builder.GetScopeCount() == 5 && builder.GetTimestampCount() == 10);
+
+	// Scope i runs from timestamp 2 * i to 2 * i + 1, at 1000 ticks per second one tick is a millisecond
+	const uint64_t timestamps[] = { 0, 100, 10, 60, 20, 50, 70, 90, 100, 100 };
+	ProfileFrame frame;
+	builder.Resolve(timestamps, 1000, frame);
+
+	BIRDGAME_CHECK(frame.frameNumber == 7);
+	BIRDGAME_CHECK(frame.scopes.size() == 5);
+	if (frame.scopes.size() == 5)
+	{
+		BIRDGAME_CHECK(ScopeEquals(frame.scopes[0], "Frame", ProfileScopeResult::kNoParent, 0));
+		BIRDGAME_CHECK(ScopeEquals(frame.scopes[1], "Scene", 0, 1));
+		BIRDGAME_CHECK(ScopeEquals(frame.scopes[2], "Sprites", 1, 2));
+		BIRDGAME_CHECK(ScopeEquals(frame.scopes[3], "Hud", 0, 1));
+		BIRDGAME_CHECK(ScopeEquals(frame.scopes[4], "Present", ProfileScopeResult::kNoParent, 0));
+		BIRDGAME_CHECK(frame.scopes[0].milliseconds == 100.0);
+		BIRDGAME_CHECK(frame.scopes[1].milliseconds == 50.0);
+		BIRDGAME_CHECK(frame.scopes[2].milliseconds == 30.0);
+		BIRDGAME_CHECK(frame.scopes[3].milliseconds == 20.0);
+		BIRDGAME_CHECK(frame.scopes[4].milliseconds == 0.0);
+	}
+}
+
+BIRDGAME_TEST(ProfileFrameBuilderClampsBackwardsTimestamps)
+{
+	ProfileFrameBuilder builder;
+	builder.BeginFrame(0);
+	builder.BeginScope("Backwards");
+	builder.EndScope();
+	builder.EndFrame();
+
+	// A timestamp pair out of order, e.g. from a query that wasn't written, reads as zero rather than wrapping
+	const uint64_t timestamps[] = { 500, 400 };
+	ProfileFrame frame;
+	builder.Resolve(timestamps, 1000000, frame);
+	BIRDGAME_CHECK(frame.scopes.size() == 1 && frame.scopes[0].milliseconds == 0.0);
+}
+
+BIRDGAME_TEST(ProfileFrameBuilderDropsScopesPastLimit)
+{
+	ProfileFrameBuilder builder;
+
+	// Outside a frame everything is dropped, but still has to be balanced
+	BIRDGAME_CHECK(builder.BeginScope("Early") == ProfileFrameBuilder::kDroppedScope);
+	BIRDGAME_CHECK(builder.EndScope() == ProfileFrameBuilder::kDroppedScope);
+
+	builder.BeginFrame(1);
+	BIRDGAME_CHECK(builder.BeginScope("Outer") == 0);
+	for (uint32_t i = 1; i < ProfileFrameBuilder::kMaxScopes; ++i)
+	{
+		builder.BeginScope("Inner");
+		builder.EndScope();
+	}
+	BIRDGAME_CHECK(builder.GetScopeCount() == ProfileFrameBuilder::kMaxScopes);
+
+	// Full: new scopes are dropped, nested ones too, and ending them pops the right entries
+	BIRDGAME_CHECK(builder.BeginScope("Dropped") == ProfileFrameBuilder::kDroppedScope);
+	BIRDGAME_CHECK(builder.BeginScope("DroppedChild") == ProfileFrameBuilder::kDroppedScope);
+	BIRDGAME_CHECK(builder.EndScope() == ProfileFrameBuilder::kDroppedScope);
+	BIRDGAME_CHECK(builder.EndScope() == ProfileFrameBuilder::kDroppedScope);
+	BIRDGAME_CHECK(builder.EndScope() == 0);
+	builder.EndFrame();
+	BIRDGAME_CHECK(builder.GetScopeCount() == ProfileFrameBuilder::kMaxScopes);
+
+	std::vector<uint64_t> timestamps(builder.GetTimestampCount(), 0);
+	ProfileFrame frame;
+	builder.Resolve(timestamps.data(), 1000, frame);
+	BIRDGAME_CHECK(frame.scopes.size() == ProfileFrameBuilder::kMaxScopes);
+	BIRDGAME_CHECK(ScopeEquals(frame.scopes.back(), "Inner", 0, 1));
+
+	// The next frame starts empty again
+	builder.BeginFrame(2);
+	BIRDGAME_CHECK(builder.BeginScope("Fresh") == 0);
+	builder.EndScope();
+	builder.EndFrame();
+	BIRDGAME_CHECK(builder.GetScopeCount() == 1);
+}
+
+BIRDGAME_TEST(CpuProfilerTimesCallingThread)
+{
+	CpuProfiler profiler;
+	BIRDGAME_CHECK(profiler.GetLatestFrame() == nullptr);
+
+	for (uint32_t frameNumber = 0; frameNumber < 2; ++frameNumber)
+	{
+		profiler.BeginFrame();
+		{
+			ProfileScope outer(profiler, "Outer");
+			ProfileScope inner(profiler, "Inner");
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+		profiler.EndFrame();
+
+		// Results are there as soon as the frame ends
+		const ProfileFrame* frame = profiler.GetLatestFrame();
+		BIRDGAME_CHECK(frame != nullptr);
+		if (frame != nullptr)
+		{
+			BIRDGAME_CHECK(frame->frameNumber == frameNumber);
+			BIRDGAME_CHECK(frame->scopes.size() == 2);
+			if (frame->scopes.size() == 2)
+			{
+				BIRDGAME_CHECK(ScopeEquals(frame->scopes[0], "Outer", ProfileScopeResult::kNoParent, 0));
+				BIRDGAME_CHECK(ScopeEquals(frame->scopes[1], "Inner", 0, 1));
+				BIRDGAME_CHECK(frame->scopes[1].milliseconds >= 1.5);
+				BIRDGAME_CHECK(frame->scopes[0].milliseconds >= frame->scopes[1].milliseconds);
+			}
+		}
+	}
+}
@@ -0,0 +1,200 @@
+#include "TestFramework.h"
+
+#include "RadixSort.h"
+#include "RenderCommandBuffer.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	// Sorts keys with RadixSort, the payload being each key's original index, and checks the result against
+	// std::stable_sort of the same keys
+	bool MatchesStableSort(const std::vector<uint64_t>& keys)
+	{
+		std::vector<uint64_t> sortedKeys = keys;
+		std::vector<uint32_t> indices(keys.size());
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			indices[i] = static_cast<uint32_t>(i);
+		}
+
+		std::vector<uint64_t> scratchKeys(keys.size());
+		std::vector<uint32_t> scratchIndices(keys.size());
+		RadixSort(sortedKeys.data(), indices.data(), scratchKeys.data(), scratchIndices.data(), keys.size());
+
+		std::vector<std::pair<uint64_t, uint32_t>> expected(keys.size());
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			expected[i] = { keys[i], static_cast<uint32_t>(i) };
+		}
+		std::stable_sort(expected.begin(), expected.end(), [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b)
+		{
+			return a.first < b.first;
+		});
+
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			if (sortedKeys[i] != expected[i].first || indices[i] != expected[i].second)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	DrawPacket MakePacket(uint64_t key, uint32_t firstInstance)
+	{
+		return { key, firstInstance, 1 };
+	}
+}
+
+BIRDGAME_TEST(RadixSortHandlesEmptyAndSingleElement)
+{
+	BIRDGAME_CHECK(MatchesStableSort({}));
+	BIRDGAME_CHECK(MatchesStableSort({ 42 }));
+}
+
+BIRDGAME_TEST(RadixSortMatchesStableSortOnRandomKeys)
+{
+	std::mt19937_64 random(1234);
+	std::vector<uint64_t> keys(5000);
+	for (uint64_t& key : keys)
+	{
+		key = random();
+	}
+	BIRDGAME_CHECK(MatchesStableSort(keys));
+}
+
+BIRDGAME_TEST(RadixSortIsStableForDuplicateKeys)
+{
+	// Few distinct keys, so most elements tie and their order has to come from the input
+	std::mt19937_64 random(5678);
+	std::vector<uint64_t> keys(2000);
+	for (uint64_t& key : keys)
+	{
+		key = random() % 7;
+	}
+	BIRDGAME_CHECK(MatchesStableSort(keys));
+}
+
+BIRDGAME_TEST(RadixSortHandlesSkippedPasses)
+{
+	// Only the top byte differs, so every other pass is skipped
+	BIRDGAME_CHECK(MatchesStableSort({ 3ull << 56, 1ull << 56, 2ull << 56, 1ull << 56, 0 }));
+
+	// Every key is the same, so every pass is skipped
+	BIRDGAME_CHECK(MatchesStableSort(std::vector<uint64_t>(100, 0x0123456789abcdefull)));
+
+	// Skipped passes in between passes that move keys
+	BIRDGAME_CHECK(MatchesStableSort({ 0xff000000000000aaull, 0x00000000000000bbull, 0xff00000000000011ull, 0x0000000000000022ull }));
+}
+
+BIRDGAME_TEST(SortKeyRoundTripsEveryField)
+{
+	const uint64_t key = SortKey::Make(200, BlendMode::Additive, PipelineId::Text, 0xabcdef, 0x123456);
+	BIRDGAME_CHECK(SortKey::GetLayer(key) == 200);
+	BIRDGAME_CHECK(SortKey::GetBlendMode(key) == BlendMode::Additive);
+	BIRDGAME_CHECK(SortKey::GetPipeline(key) == PipelineId::Text);
+	BIRDGAME_CHECK(SortKey::GetTexture(key) == 0xabcdef);
+	BIRDGAME_CHECK(SortKey::GetDepth(key) == 0x123456);
+}
+
+BIRDGAME_TEST(SortKeyMasksOversizedFields)
+{
+	// Bits past a field's width are dropped rather than spilling into the field above it
+	const uint64_t key = SortKey::Make(1, BlendMode::Opaque, PipelineId::Sprite, 0x1000001, 0xff000002);
+	BIRDGAME_CHECK(SortKey::GetLayer(key) == 1);
+	BIRDGAME_CHECK(SortKey::GetBlendMode(key) == BlendMode::Opaque);
+	BIRDGAME_CHECK(SortKey::GetPipeline(key) == PipelineId::Sprite);
+	BIRDGAME_CHECK(SortKey::GetTexture(key) == 1);
+	BIRDGAME_CHECK(SortKey::GetDepth(key) == 2);
+}
+
+BIRDGAME_TEST(SortKeyOrdersFieldsByPriority)
+{
+	// Each field outranks everything below it, whatever the lower fields hold
+	BIRDGAME_CHECK(SortKey::Make(0, BlendMode::Additive, PipelineId::Upscale, 0xffffff, 0xffffff) < SortKey::Make(1, BlendMode::Opaque, PipelineId::Sprite, 0, 0));
+	BIRDGAME_CHECK(SortKey::Make(1, BlendMode::Opaque, PipelineId::Upscale, 0xffffff, 0xffffff) < SortKey::Make(1, BlendMode::Alpha, PipelineId::Sprite, 0, 0));
+	BIRDGAME_CHECK(SortKey::Make(1, BlendMode::Alpha, PipelineId::Sprite, 0xffffff, 0xffffff) < SortKey::Make(1, BlendMode::Alpha, PipelineId::Text, 0, 0));
+	BIRDGAME_CHECK(SortKey::Make(1, BlendMode::Alpha, PipelineId::Text, 5, 0xffffff) < SortKey::Make(1, BlendMode::Alpha, PipelineId::Text, 6, 0));
+	BIRDGAME_CHECK(SortKey::Make(1, BlendMode::Alpha, PipelineId::Text, 6, 9) < SortKey::Make(1, BlendMode::Alpha, PipelineId::Text, 6, 10));
+}
+
+BIRDGAME_TEST(CommandBufferSortsByLayerThenState)
+{
+	RenderCommandBuffer buffer(16);
+	buffer.Submit(MakePacket(SortKey::Make(2, BlendMode::Alpha, PipelineId::Sprite, 1, 0), 0));
+	buffer.Submit(MakePacket(SortKey::Make(0, BlendMode::Alpha, PipelineId::Text, 3, 0), 1));
+	buffer.Submit(MakePacket(SortKey::Make(1, BlendMode::Alpha, PipelineId::Sprite, 2, 0), 2));
+	buffer.Submit(MakePacket(SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 4, 0), 3));
+	buffer.Submit(MakePacket(SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 3, 0), 4));
+	buffer.Sort();
+
+	const std::vector<DrawPacket>& packets = buffer.GetPackets();
+	BIRDGAME_CHECK(packets.size() == 5);
+	if (packets.size() == 5)
+	{
+		// Back to front by layer, then grouped by pipeline and texture within a layer
+		BIRDGAME_CHECK(packets[0].firstInstance == 4);
+		BIRDGAME_CHECK(packets[1].firstInstance == 3);
+		BIRDGAME_CHECK(packets[2].firstInstance == 1);
+		BIRDGAME_CHECK(packets[3].firstInstance == 2);
+		BIRDGAME_CHECK(packets[4].firstInstance == 0);
+	}
+	BIRDGAME_CHECK(buffer.Validate(5));
+}
+
+BIRDGAME_TEST(CommandBufferSortKeepsSubmissionOrderForEqualKeys)
+{
+	// Equal keys have to draw in the order they were submitted, or overlapping sprites flicker between frames
+	const uint64_t key = SortKey::Make(1, BlendMode::Alpha, PipelineId::Sprite, 7, 0);
+	RenderCommandBuffer buffer(64);
+	for (uint32_t i = 0; i < 32; ++i)
+	{
+		buffer.Submit(MakePacket((i % 2 == 0) ? key : SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 7, 0), i));
+	}
+	buffer.Sort();
+
+	const std::vector<DrawPacket>& packets = buffer.GetPackets();
+	for (size_t i = 1; i < packets.size(); ++i)
+	{
+		if (packets[i].key == packets[i - 1].key)
+		{
+			BIRDGAME_CHECK(packets[i].firstInstance > packets[i - 1].firstInstance);
+		}
+	}
+}
+
+BIRDGAME_TEST(CommandBufferValidateRejectsUnsortedAndOutOfRangePackets)
+{
+	RenderCommandBuffer buffer(4);
+	buffer.Submit(MakePacket(SortKey::Make(1, BlendMode::Alpha, PipelineId::Sprite, 0, 0), 0));
+	buffer.Submit(MakePacket(SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 0, 0), 1));
+	BIRDGAME_CHECK(!buffer.Validate(2));
+
+	buffer.Sort();
+	BIRDGAME_CHECK(buffer.Validate(2));
+	BIRDGAME_CHECK(!buffer.Validate(1));
+}
+
+BIRDGAME_TEST(CommandBufferStatsCountStateChanges)
+{
+	RenderCommandBuffer buffer(8);
+	buffer.Submit({ SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 1, 0), 0, 2 });
+	buffer.Submit({ SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 1, 1), 2, 3 });
+	buffer.Submit({ SortKey::Make(0, BlendMode::Alpha, PipelineId::Sprite, 2, 0), 5, 1 });
+	buffer.Submit({ SortKey::Make(0, BlendMode::Alpha, PipelineId::Text, 2, 0), 6, 1 });
+	buffer.Submit({ SortKey::Make(0, BlendMode::Additive, PipelineId::Text, 2, 0), 7, 1 });
+	buffer.Sort();
+
+	const RenderCommandBuffer::Stats stats = buffer.ComputeStats();
+	BIRDGAME_CHECK(stats.drawCount == 5);
+	BIRDGAME_CHECK(stats.instanceCount == 8);
+	BIRDGAME_CHECK(stats.pipelineChanges == 3);
+	BIRDGAME_CHECK(stats.textureChanges == 2);
+}
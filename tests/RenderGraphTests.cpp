@@ -0,0 +1,182 @@
+#include "TestFramework.h"
+
+#include "RenderGraph.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	constexpr uint64_t kPlacementAlignment = 64 * 1024;
+
+	RenderGraph::AllocationInfo GetAllocationInfo(const TextureDesc& desc)
+	{
+		return { static_cast<uint64_t>(desc.width) * desc.height * 4, kPlacementAlignment };
+	}
+
+	TextureDesc MakeDesc(uint32_t width, uint32_t height)
+	{
+		return { width, height, TextureFormat::RGBA8 };
+	}
+
+	bool BarrierEquals(const RenderGraph::Barrier& barrier, RenderGraphResource resource, ResourceState before, ResourceState after)
+	{
+		return barrier.resource == resource && barrier.before == before && barrier.after == after;
+	}
+}
+
+BIRDGAME_TEST(RenderGraphCullsPassesWhoseResultsAreUnused)
+{
+	RenderGraph graph;
+	const RenderGraphResource backBuffer = graph.ImportResource("BackBuffer", ResourceState::Present, ResourceState::Present);
+	const RenderGraphResource scene = graph.CreateTransient("Scene", MakeDesc(64, 64));
+	const RenderGraphResource unused = graph.CreateTransient("Unused", MakeDesc(64, 64));
+	const RenderGraphResource intermediate = graph.CreateTransient("Intermediate", MakeDesc(64, 64));
+	const RenderGraphResource readback = graph.CreateTransient("Readback", MakeDesc(64, 64));
+
+	const RenderGraphPass drawScene = graph.AddPass("DrawScene", [] {});
+	graph.Write(drawScene, scene, ResourceState::RenderTarget);
+
+	// Only feeds a pass whose output nobody reads, so both go
+	const RenderGraphPass drawIntermediate = graph.AddPass("DrawIntermediate", [] {});
+	graph.Write(drawIntermediate, intermediate, ResourceState::RenderTarget);
+	const RenderGraphPass drawUnused = graph.AddPass("DrawUnused", [] {});
+	graph.Read(drawUnused, intermediate, ResourceState::ShaderResource);
+	graph.Write(drawUnused, unused, ResourceState::RenderTarget);
+
+	const RenderGraphPass present = graph.AddPass("Present", [] {});
+	graph.Read(present, scene, ResourceState::ShaderResource);
+	graph.Write(present, backBuffer, ResourceState::RenderTarget);
+
+	// Nothing reads what it writes, but side effects keep it
+	const RenderGraphPass capture = graph.AddPass("Capture", [] {}, true);
+	graph.Read(capture, scene, ResourceState::CopySource);
+	graph.Write(capture, readback, ResourceState::CopyDest);
+
+	graph.Compile(GetAllocationInfo);
+
+	BIRDGAME_CHECK(!graph.IsCulled(drawScene));
+	BIRDGAME_CHECK(graph.IsCulled(drawIntermediate));
+	BIRDGAME_CHECK(graph.IsCulled(drawUnused));
+	BIRDGAME_CHECK(!graph.IsCulled(present));
+	BIRDGAME_CHECK(!graph.IsCulled(capture));
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+	BIRDGAME_CHECK(passes.size() == 3);
+	if (passes.size() == 3)
+	{
+		BIRDGAME_CHECK(passes[0].pass == drawScene && passes[1].pass == present && passes[2].pass == capture);
+	}
+
+	// Culled passes' transients take no memory
+	BIRDGAME_CHECK(graph.GetTransientPlacement(unused).size == 0);
+	BIRDGAME_CHECK(graph.GetTransientPlacement(intermediate).size == 0);
+}
+
+BIRDGAME_TEST(RenderGraphComputesBarriersBetweenPasses)
+{
+	RenderGraph graph;
+	const RenderGraphResource backBuffer = graph.ImportResource("BackBuffer", ResourceState::Present, ResourceState::Present);
+	const RenderGraphResource scene = graph.CreateTransient("Scene", MakeDesc(64, 64));
+
+	const RenderGraphPass draw = graph.AddPass("Draw", [] {});
+	graph.Write(draw, scene, ResourceState::RenderTarget);
+
+	const RenderGraphPass upscale = graph.AddPass("Upscale", [] {});
+	graph.Read(upscale, scene, ResourceState::ShaderResource);
+	graph.Write(upscale, backBuffer, ResourceState::RenderTarget);
+
+	// Reads the scene in a second state and copies over the back buffer
+	const RenderGraphPass copy = graph.AddPass("Copy", [] {});
+	graph.Read(copy, scene, ResourceState::CopySource);
+	graph.Write(copy, backBuffer, ResourceState::CopyDest);
+
+	graph.Compile(GetAllocationInfo);
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+	const std::vector<RenderGraph::Barrier>& barriers = graph.GetBarriers();
+	BIRDGAME_CHECK(passes.size() == 3);
+	BIRDGAME_CHECK(barriers.size() == 5);
+	if (passes.size() != 3 || barriers.size() != 5)
+	{
+		return;
+	}
+
+	// The transient's first use discards its contents
+	BIRDGAME_CHECK(passes[0].firstBarrier == 0 && passes[0].barrierCount == 1);
+	BIRDGAME_CHECK(BarrierEquals(barriers[0], scene, ResourceState::Undefined, ResourceState::RenderTarget));
+
+	// Going into a read state includes the states of every following reader, so the copy needs no barrier for it
+	BIRDGAME_CHECK(passes[1].firstBarrier == 1 && passes[1].barrierCount == 2);
+	BIRDGAME_CHECK(BarrierEquals(barriers[1], scene, ResourceState::RenderTarget, ResourceState::ShaderResource | ResourceState::CopySource));
+	BIRDGAME_CHECK(BarrierEquals(barriers[2], backBuffer, ResourceState::Present, ResourceState::RenderTarget));
+
+	BIRDGAME_CHECK(passes[2].firstBarrier == 3 && passes[2].barrierCount == 1);
+	BIRDGAME_CHECK(BarrierEquals(barriers[3], backBuffer, ResourceState::RenderTarget, ResourceState::CopyDest));
+
+	BIRDGAME_CHECK(graph.GetFinalBarrierStart() == 4 && graph.GetFinalBarrierCount() == 1);
+	BIRDGAME_CHECK(BarrierEquals(barriers[4], backBuffer, ResourceState::CopyDest, ResourceState::Present));
+}
+
+BIRDGAME_TEST(RenderGraphReturnsImportedResourcesInFinalState)
+{
+	RenderGraph graph;
+	const RenderGraphResource backBuffer = graph.ImportResource("BackBuffer", ResourceState::Present, ResourceState::Present);
+	const RenderGraphResource untouchedSame = graph.ImportResource("UntouchedSame", ResourceState::ShaderResource, ResourceState::ShaderResource);
+	const RenderGraphResource untouchedDifferent = graph.ImportResource("UntouchedDifferent", ResourceState::CopyDest, ResourceState::ShaderResource);
+
+	const RenderGraphPass draw = graph.AddPass("Draw", [] {});
+	graph.Write(draw, backBuffer, ResourceState::RenderTarget);
+
+	graph.Compile(GetAllocationInfo);
+
+	const std::vector<RenderGraph::Barrier>& barriers = graph.GetBarriers();
+	BIRDGAME_CHECK(graph.GetFinalBarrierCount() == 2);
+	if (graph.GetFinalBarrierCount() == 2)
+	{
+		// In resource order, and a resource already in its final state gets none
+		const uint32_t start = graph.GetFinalBarrierStart();
+		BIRDGAME_CHECK(BarrierEquals(barriers[start], backBuffer, ResourceState::RenderTarget, ResourceState::Present));
+		BIRDGAME_CHECK(BarrierEquals(barriers[start + 1], untouchedDifferent, ResourceState::CopyDest, ResourceState::ShaderResource));
+	}
+	for (const RenderGraph::Barrier& barrier : barriers)
+	{
+		BIRDGAME_CHECK(barrier.resource != untouchedSame);
+	}
+}
+
+BIRDGAME_TEST(RenderGraphAliasesTransientsWithoutOverlappingLifetimes)
+{
+	RenderGraph graph;
+	const RenderGraphResource backBuffer = graph.ImportResource("BackBuffer", ResourceState::Present, ResourceState::Present);
+	const RenderGraphResource first = graph.CreateTransient("First", MakeDesc(128, 128));    // 64KB
+	const RenderGraphResource second = graph.CreateTransient("Second", MakeDesc(64, 64));    // 16KB
+	const RenderGraphResource third = graph.CreateTransient("Third", MakeDesc(128, 128));    // 64KB
+
+	// first lives in passes 0-1, second in 1-2 and third in 2-3
+	const RenderGraphPass pass0 = graph.AddPass("Pass0", [] {});
+	graph.Write(pass0, first, ResourceState::RenderTarget);
+	const RenderGraphPass pass1 = graph.AddPass("Pass1", [] {});
+	graph.Read(pass1, first, ResourceState::ShaderResource);
+	graph.Write(pass1, second, ResourceState::RenderTarget);
+	const RenderGraphPass pass2 = graph.AddPass("Pass2", [] {});
+	graph.Read(pass2, second, ResourceState::ShaderResource);
+	graph.Write(pass2, third, ResourceState::RenderTarget);
+	const RenderGraphPass pass3 = graph.AddPass("Pass3", [] {});
+	graph.Read(pass3, third, ResourceState::ShaderResource);
+	graph.Write(pass3, backBuffer, ResourceState::RenderTarget);
+
+	graph.Compile(GetAllocationInfo);
+
+	const RenderGraph::TransientPlacement& firstPlacement = graph.GetTransientPlacement(first);
+	const RenderGraph::TransientPlacement& secondPlacement = graph.GetTransientPlacement(second);
+	const RenderGraph::TransientPlacement& thirdPlacement = graph.GetTransientPlacement(third);
+
+	// first and third never live at the same time, so they share memory. second overlaps both and goes after them.
+	BIRDGAME_CHECK(firstPlacement.offset == 0 && firstPlacement.size == 64 * 1024);
+	BIRDGAME_CHECK(thirdPlacement.offset == 0 && thirdPlacement.size == 64 * 1024);
+	BIRDGAME_CHECK(secondPlacement.offset == 64 * 1024 && secondPlacement.size == 16 * 1024);
+	BIRDGAME_CHECK(secondPlacement.offset % kPlacementAlignment == 0);
+	BIRDGAME_CHECK(graph.GetTransientHeapSize() == 80 * 1024);
+}
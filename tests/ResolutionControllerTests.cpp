@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+
+#include "ResolutionController.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	constexpr float kStep = ResolutionController::kScaleStep;
+
+	ResolutionController::Settings MakeSettings(uint32_t settleFrames)
+	{
+		ResolutionController::Settings settings;
+		settings.targetMilliseconds = 16.0f;
+		settings.minScale = 0.5f;
+		settings.maxScale = 1.0f;
+		settings.settleFrames = settleFrames;
+		return settings;
+	}
+
+	// Feeds a recorded sequence of frame times and returns the scale after each of them
+	std::vector<float> Play(ResolutionController& controller, const std::vector<double>& frameMilliseconds)
+	{
+		std::vector<float> scales;
+		for (double milliseconds : frameMilliseconds)
+		{
+			scales.push_back(controller.Update(milliseconds));
+		}
+		return scales;
+	}
+}
+
+BIRDGAME_TEST(ResolutionControllerHoldsScaleWithinBudget)
+{
+	ResolutionController controller(MakeSettings(0));
+	BIRDGAME_CHECK(controller.GetScale() == 1.0f);
+
+	// Near the target, with a single frame slightly over it that the average absorbs
+	const std::vector<float> scales = Play(controller, { 15.0, 15.5, 14.8, 19.0, 15.2, 15.0, 14.0, 15.9 });
+	BIRDGAME_CHECK(scales == std::vector<float>(8, 1.0f));
+}
+
+BIRDGAME_TEST(ResolutionControllerDropsImmediatelyOnSpike)
+{
+	ResolutionController controller(MakeSettings(0));
+
+	// The average is still under budget at 32 ms, but the spike is acted on the frame it arrives:
+	// sqrt(16 / 32) = 0.707, rounded down to 22 / 32
+	const std::vector<float> scales = Play(controller, { 15.0, 15.0, 32.0 });
+	BIRDGAME_CHECK(scales == std::vector<float>({ 1.0f, 1.0f, 22 * kStep }));
+}
+
+BIRDGAME_TEST(ResolutionControllerIncreasesInLimitedSteps)
+{
+	ResolutionController controller(MakeSettings(0));
+
+	// Way over budget clamps to the minimum scale
+	BIRDGAME_CHECK(controller.Update(200.0) == 0.5f);
+
+	// Between 0.85 x target and the target there's no headroom, so nothing changes however long it lasts
+	const std::vector<float> held = Play(controller, std::vector<double>(50, 14.0));
+	BIRDGAME_CHECK(held == std::vector<float>(50, 0.5f));
+
+	// Far below the target the ideal scale is well past the maximum, but each increase is at most four steps,
+	// and the scale never goes past the maximum
+	ResolutionController fast(MakeSettings(0));
+	fast.Update(200.0);
+	const std::vector<float> scales = Play(fast, { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 });
+	BIRDGAME_CHECK(scales == std::vector<float>({ 20 * kStep, 24 * kStep, 28 * kStep, 1.0f, 1.0f, 1.0f }));
+}
+
+BIRDGAME_TEST(ResolutionControllerSkipsSettleFrames)
+{
+	ResolutionController controller(MakeSettings(3));
+
+	// The three frames after the drop may have been rendered at the old scale, so even 40 ms doesn't drop further.
+	// The fourth starts a fresh average instead of blending with the spike, which allows an increase right away.
+	const std::vector<float> scales = Play(controller, { 15.0, 32.0, 40.0, 40.0, 40.0, 8.0 });
+	BIRDGAME_CHECK(scales == std::vector<float>({ 1.0f, 22 * kStep, 22 * kStep, 22 * kStep, 22 * kStep, 26 * kStep }));
+
+	// Increases settle too
+	const std::vector<float> afterIncrease = Play(controller, { 100.0, 100.0, 100.0, 100.0 });
+	BIRDGAME_CHECK(afterIncrease == std::vector<float>({ 26 * kStep, 26 * kStep, 26 * kStep, 0.5f }));
+}
+
+BIRDGAME_TEST(ResolutionControllerScalesTargetSize)
+{
+	ResolutionController controller(MakeSettings(0));
+	uint32_t width = 0;
+	uint32_t height = 0;
+	controller.GetScaledSize(1280, 720, width, height);
+	BIRDGAME_CHECK(width == 1280 && height == 720);
+
+	controller.Update(200.0);
+	controller.GetScaledSize(1280, 720, width, height);
+	BIRDGAME_CHECK(width == 640 && height == 360);
+
+	// Never smaller than a pixel
+	controller.GetScaledSize(1, 0, width, height);
+	BIRDGAME_CHECK(width == 1 && height == 1);
+}
@@ -0,0 +1,126 @@
+#include "TestFramework.h"
+
+#include "ResourceStateRegistry.h"
+#include "ResourceStateTracker.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	bool BarrierEquals(const ResourceStateTracker::Barrier& barrier, TrackedResource resource, ResourceState before, ResourceState after)
+	{
+		return barrier.resource == resource && barrier.before == before && barrier.after == after;
+	}
+}
+
+BIRDGAME_TEST(ResourceStateTrackerResolvesFirstUsesAgainstRegistry)
+{
+	ResourceStateRegistry registry;
+	const TrackedResource uploaded = registry.Register(ResourceState::CopyDest);
+	const TrackedResource texture = registry.Register(ResourceState::ShaderResource);
+	const TrackedResource target = registry.Register(ResourceState::RenderTarget);
+
+	// Recording doesn't know the registry states, so first uses make no barriers
+	ResourceStateTracker tracker;
+	tracker.Require(uploaded, ResourceState::ShaderResource);
+	tracker.Require(texture, ResourceState::ShaderResource);
+	tracker.Require(target, ResourceState::ShaderResource);
+	BIRDGAME_CHECK(!tracker.HasPendingBarriers());
+
+	// A later use within the list is a regular barrier from the first use's state
+	tracker.Require(uploaded, ResourceState::CopySource);
+	std::vector<ResourceStateTracker::Barrier> barriers;
+	tracker.FlushBarriers(barriers);
+	BIRDGAME_CHECK(barriers.size() == 1 && BarrierEquals(barriers[0], uploaded, ResourceState::ShaderResource, ResourceState::CopySource));
+
+	// Submit time: only the resources whose registry state differs from their first use get patched
+	std::vector<ResourceStateTracker::Barrier> patches;
+	tracker.ResolveInitialBarriers(registry, patches);
+	BIRDGAME_CHECK(patches.size() == 2);
+	if (patches.size() == 2)
+	{
+		BIRDGAME_CHECK(BarrierEquals(patches[0], uploaded, ResourceState::CopyDest, ResourceState::ShaderResource));
+		BIRDGAME_CHECK(BarrierEquals(patches[1], target, ResourceState::RenderTarget, ResourceState::ShaderResource));
+	}
+
+	tracker.Commit(registry);
+	BIRDGAME_CHECK(registry.GetState(uploaded) == ResourceState::CopySource);
+	BIRDGAME_CHECK(registry.GetState(texture) == ResourceState::ShaderResource);
+	BIRDGAME_CHECK(registry.GetState(target) == ResourceState::ShaderResource);
+	BIRDGAME_CHECK(tracker.GetFinalState(uploaded) == ResourceState::Undefined);
+}
+
+BIRDGAME_TEST(ResourceStateTrackerPatchesAgainstEarlierLists)
+{
+	ResourceStateRegistry registry;
+	const TrackedResource target = registry.Register(ResourceState::Present);
+
+	// Two lists recorded independently, submitted in order
+	ResourceStateTracker first;
+	ResourceStateTracker second;
+	first.Require(target, ResourceState::RenderTarget);
+	second.Require(target, ResourceState::ShaderResource);
+
+	std::vector<ResourceStateTracker::Barrier> patches;
+	first.ResolveInitialBarriers(registry, patches);
+	first.Commit(registry);
+	BIRDGAME_CHECK(patches.size() == 1 && BarrierEquals(patches[0], target, ResourceState::Present, ResourceState::RenderTarget));
+
+	// The second list starts from where the first left the resource
+	patches.clear();
+	second.ResolveInitialBarriers(registry, patches);
+	second.Commit(registry);
+	BIRDGAME_CHECK(patches.size() == 1 && BarrierEquals(patches[0], target, ResourceState::RenderTarget, ResourceState::ShaderResource));
+	BIRDGAME_CHECK(registry.GetState(target) == ResourceState::ShaderResource);
+}
+
+BIRDGAME_TEST(ResourceStateTrackerFoldsPendingTransitions)
+{
+	ResourceStateTracker tracker;
+	const TrackedResource texture = 0;
+	const TrackedResource target = 3;
+	tracker.Require(texture, ResourceState::RenderTarget);
+	tracker.Require(target, ResourceState::RenderTarget);
+
+	// A -> B -> C becomes A -> C
+	tracker.Require(texture, ResourceState::ShaderResource);
+	tracker.Require(texture, ResourceState::CopySource);
+
+	// A -> B -> A is dropped
+	tracker.Require(target, ResourceState::CopySource);
+	tracker.Require(target, ResourceState::RenderTarget);
+
+	std::vector<ResourceStateTracker::Barrier> barriers;
+	tracker.FlushBarriers(barriers);
+	BIRDGAME_CHECK(barriers.size() == 1 && BarrierEquals(barriers[0], texture, ResourceState::RenderTarget, ResourceState::CopySource));
+	BIRDGAME_CHECK(!tracker.HasPendingBarriers());
+
+	// Flushed barriers are recorded, so later transitions start a new barrier instead of changing them
+	barriers.clear();
+	tracker.Require(texture, ResourceState::CopySource); // Already there
+	tracker.Require(texture, ResourceState::RenderTarget);
+	tracker.FlushBarriers(barriers);
+	BIRDGAME_CHECK(barriers.size() == 1 && BarrierEquals(barriers[0], texture, ResourceState::CopySource, ResourceState::RenderTarget));
+	BIRDGAME_CHECK(tracker.GetFinalState(texture) == ResourceState::RenderTarget);
+	BIRDGAME_CHECK(tracker.GetFinalState(target) == ResourceState::RenderTarget);
+}
+
+BIRDGAME_TEST(ResourceStateRegistryReusesIds)
+{
+	ResourceStateRegistry registry;
+	const TrackedResource first = registry.Register(ResourceState::CopyDest);
+	const TrackedResource second = registry.Register(ResourceState::ShaderResource);
+	BIRDGAME_CHECK(first != second);
+	BIRDGAME_CHECK(registry.GetRegisteredCount() == 2);
+
+	registry.Unregister(first);
+	BIRDGAME_CHECK(!registry.IsRegistered(first));
+	BIRDGAME_CHECK(registry.GetRegisteredCount() == 1);
+
+	// The freed id comes back with the new resource's state
+	BIRDGAME_CHECK(registry.Register(ResourceState::RenderTarget) == first);
+	BIRDGAME_CHECK(registry.IsRegistered(first));
+	BIRDGAME_CHECK(registry.GetState(first) == ResourceState::RenderTarget);
+}
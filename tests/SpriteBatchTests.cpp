@@ -0,0 +1,136 @@
+#include "TestFramework.h"
+
+#include "RenderCommandBuffer.h"
+#include "SoftwareRasterizer.h"
+#include "SpriteBatch.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	constexpr Rect kFullUv = { 0.0f, 0.0f, 1.0f, 1.0f };
+	constexpr Rect kView = { 0.0f, 0.0f, 64.0f, 64.0f };
+
+	// Tags a sprite with its submission index in the red channel, so the order can be read back from the instances
+	Color Tag(uint8_t index)
+	{
+		return { index, 0, 0, 0xff };
+	}
+
+	Rect At(float x, float y)
+	{
+		return { x, y, 4.0f, 4.0f };
+	}
+
+	bool PixelEquals(const Image& image, uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+	{
+		const uint8_t* pixel = image.GetPixel(x, y);
+		return pixel[0] == r && pixel[1] == g && pixel[2] == b && pixel[3] == a;
+	}
+}
+
+BIRDGAME_TEST(SpriteBatchDrawsEachLayerAndPipelineOnce)
+{
+	SpriteBatch batch(32);
+	RenderCommandBuffer commands(32);
+
+	// Textures change from sprite to sprite, which mustn't split a batch
+	batch.Submit(0, At(0, 0), kFullUv, Tag(0), 1, PipelineId::Sprite);
+	batch.Submit(1, At(4, 0), kFullUv, Tag(1), 0, PipelineId::Text);
+	batch.Submit(2, At(8, 0), kFullUv, Tag(2), 1, PipelineId::Sprite);
+	batch.Submit(3, At(12, 0), kFullUv, Tag(3), 0, PipelineId::Sprite);
+	batch.Submit(4, At(16, 0), kFullUv, Tag(4), 0, PipelineId::Text);
+	batch.Submit(5, At(20, 0), kFullUv, Tag(5), 1, PipelineId::Sprite);
+	batch.Build(commands, kView);
+	commands.Sort();
+
+	const std::vector<DrawPacket>& packets = commands.GetPackets();
+	BIRDGAME_CHECK(packets.size() == 3);
+	if (packets.size() == 3)
+	{
+		BIRDGAME_CHECK(SortKey::GetLayer(packets[0].key) == 0 && SortKey::GetPipeline(packets[0].key) == PipelineId::Sprite);
+		BIRDGAME_CHECK(packets[0].instanceCount == 1);
+		BIRDGAME_CHECK(SortKey::GetLayer(packets[1].key) == 0 && SortKey::GetPipeline(packets[1].key) == PipelineId::Text);
+		BIRDGAME_CHECK(packets[1].instanceCount == 2);
+		BIRDGAME_CHECK(SortKey::GetLayer(packets[2].key) == 1 && SortKey::GetPipeline(packets[2].key) == PipelineId::Sprite);
+		BIRDGAME_CHECK(packets[2].instanceCount == 3);
+	}
+	BIRDGAME_CHECK(commands.Validate(batch.GetVisibleCount()));
+}
+
+BIRDGAME_TEST(SpriteBatchKeepsSubmissionOrderWithinLayer)
+{
+	SpriteBatch batch(64);
+	RenderCommandBuffer commands(64);
+	for (uint8_t i = 0; i < 40; ++i)
+	{
+		batch.Submit(i % 3, At(i, i), kFullUv, Tag(i), i % 2, PipelineId::Sprite);
+	}
+	batch.Build(commands, kView);
+
+	// Layer 0 holds the even tags and layer 1 the odd ones, both in the order they were submitted
+	const std::vector<SpriteInstance>& instances = batch.GetInstances();
+	BIRDGAME_CHECK(instances.size() == 40);
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		const uint32_t expected = (i < 20) ? static_cast<uint32_t>(i * 2) : static_cast<uint32_t>((i - 20) * 2 + 1);
+		BIRDGAME_CHECK(instances[i].color.r == expected);
+		BIRDGAME_CHECK(instances[i].texture == expected % 3);
+	}
+}
+
+BIRDGAME_TEST(SpriteBatchCullsSpritesOutsideView)
+{
+	SpriteBatch batch(8);
+	RenderCommandBuffer commands(8);
+	batch.Submit(0, At(-10, 0), kFullUv, Tag(0), 0, PipelineId::Sprite);
+	batch.Submit(0, At(10, 10), kFullUv, Tag(1), 0, PipelineId::Sprite);
+	batch.Submit(0, At(100, 0), kFullUv, Tag(2), 0, PipelineId::Sprite);
+	batch.Submit(0, At(62, 62), kFullUv, Tag(3), 0, PipelineId::Sprite);
+	batch.Build(commands, kView);
+
+	BIRDGAME_CHECK(batch.GetSpriteCount() == 4);
+	BIRDGAME_CHECK(batch.GetVisibleCount() == 2);
+	BIRDGAME_CHECK(batch.GetInstances().size() == 2 && batch.GetInstances()[0].color.r == 1 && batch.GetInstances()[1].color.r == 3);
+}
+
+BIRDGAME_TEST(SoftwareRasterizerDrawsSmallBatch)
+{
+	// Left half white, right half transparent
+	Image texture;
+	texture.Resize(2, 1);
+	texture.pixels = { 0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0 };
+
+	SpriteBatch batch(4);
+	RenderCommandBuffer commands(4);
+	batch.Submit(7, { 0.0f, 0.0f, 4.0f, 2.0f }, kFullUv, { 0xff, 0, 0, 0xff }, 0, PipelineId::Sprite);
+	batch.Submit(7, { 0.0f, 1.0f, 2.0f, 1.0f }, kFullUv, { 0, 0, 0xff, 0x80 }, 1, PipelineId::Sprite);
+	batch.Submit(9, { 6.0f, 0.0f, 2.0f, 2.0f }, kFullUv, kWhite, 0, PipelineId::Sprite);
+	batch.Build(commands, { 0.0f, 0.0f, 8.0f, 4.0f });
+	commands.Sort();
+
+	SoftwareRasterizer rasterizer(8, 4);
+	rasterizer.Clear({ 0, 0xff, 0, 0xff });
+	rasterizer.Execute(commands, batch.GetInstances().data(), [&texture](uint32_t textureIndex) -> const Image*
+	{
+		return (textureIndex == 7) ? &texture : nullptr;
+	});
+
+	const Image& framebuffer = rasterizer.GetFramebuffer();
+
+	// The red sprite covers its left half, its right half samples the transparent texel and leaves the clear color
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 0, 0, 0xff, 0, 0, 0xff));
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 1, 0, 0xff, 0, 0, 0xff));
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 2, 0, 0, 0xff, 0, 0xff));
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 3, 1, 0, 0xff, 0, 0xff));
+
+	// Half transparent blue drawn over red on the next layer, only its left texel is opaque
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 0, 1, 0x7f, 0, 0x80, 0xff));
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 1, 1, 0xff, 0, 0, 0xff));
+
+	// An unknown texture samples transparent black, so nothing is drawn
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 6, 0, 0, 0xff, 0, 0xff));
+	BIRDGAME_CHECK(PixelEquals(framebuffer, 7, 3, 0, 0xff, 0, 0xff));
+}
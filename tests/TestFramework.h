@@ -0,0 +1,27 @@
+#pragma once
+
+// Just enough of a test framework for the unit tests: BIRDGAME_TEST registers a test, BIRDGAME_CHECK reports a
+// failed expression and lets the test carry on, so one run shows every failure.
+
+namespace BirdGame
+{
+	namespace Test
+	{
+		using TestFunction = void (*)();
+
+		struct Registration
+		{
+			Registration(const char* name, TestFunction function);
+		};
+
+		void ReportFailure(const char* file, int line, const char* expression);
+	}
+}
+
+#define BIRDGAME_TEST(name) \
+	static void name(); \
+	static const BirdGame::Test::Registration name##Registration(#name, name); \
+	static void name()
+
+#define BIRDGAME_CHECK(expression) \
+	((expression) ? (void)0 : BirdGame::Test::ReportFailure(__FILE__, __LINE__, #expression))
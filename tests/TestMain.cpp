@@ -0,0 +1,53 @@
+#include "TestFramework.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	struct RegisteredTest
+	{
+		const char* name;
+		BirdGame::Test::TestFunction function;
+	};
+
+	// Function local so registrations from other files' static initializers never see it unconstructed
+	std::vector<RegisteredTest>& GetTests()
+	{
+		static std::vector<RegisteredTest> tests;
+		return tests;
+	}
+
+	unsigned gFailureCount = 0;
+}
+
+BirdGame::Test::Registration::Registration(const char* name, TestFunction function)
+{
+	GetTests().push_back({ name, function });
+}
+
+void BirdGame::Test::ReportFailure(const char* file, int line, const char* expression)
+{
+	printf("%s(%d): check failed: %s\n", file, line, expression);
+	gFailureCount++;
+}
+
+int main()
+{
+	unsigned failedTests = 0;
+	for (const RegisteredTest& test : GetTests())
+	{
+		const unsigned failuresBefore = gFailureCount;
+		test.function();
+
+		const bool passed = (gFailureCount == failuresBefore);
+		printf("%s %s\n", passed ? "[  PASSED  ]" : "[  FAILED  ]", test.name);
+		if (!passed)
+		{
+			failedTests++;
+		}
+	}
+
+	printf("%u of %zu tests failed\n", failedTests, GetTests().size());
+	return (failedTests == 0) ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+#include "TestFramework.h"
+
+#include "JobSystem.h"
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace BirdGame;
+
+namespace
+{
+	// Sprite-like content: smooth gradients, a hard edged disc with a soft alpha rim and a little noise
+	Image MakeTestImage(uint32_t width, uint32_t height)
+	{
+		Image image;
+		image.Resize(width, height);
+		std::mt19937 random(7);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				const float u = static_cast<float>(x) / static_cast<float>(width);
+				const float v = static_cast<float>(y) / static_cast<float>(height);
+				const float distance = std::sqrt((u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f));
+				const bool inside = distance < 0.3f;
+				const int noise = static_cast<int>(random() % 9) - 4;
+
+				uint8_t* pixel = image.GetPixel(x, y);
+				pixel[0] = static_cast<uint8_t>(std::clamp(static_cast<int>(inside ? 230.0f : 255.0f * u) + noise, 0, 255));
+				pixel[1] = static_cast<uint8_t>(std::clamp(static_cast<int>(inside ? 180.0f - 100.0f * v : 255.0f * v) + noise, 0, 255));
+				pixel[2] = static_cast<uint8_t>(std::clamp(static_cast<int>(inside ? 40.0f : 128.0f + 100.0f * std::sin(u * 6.0f)) + noise, 0, 255));
+				pixel[3] = static_cast<uint8_t>(std::clamp((0.4f - distance) * 1000.0f, 0.0f, 255.0f));
+			}
+		}
+		return image;
+	}
+
+	// Over the first channelCount channels
+	double GetPsnr(const Image& actual, const Image& expected, uint32_t channelCount)
+	{
+		double squaredError = 0.0;
+		for (uint32_t y = 0; y < expected.height; ++y)
+		{
+			for (uint32_t x = 0; x < expected.width; ++x)
+			{
+				for (uint32_t c = 0; c < channelCount; ++c)
+				{
+					const double delta = static_cast<double>(actual.GetPixel(x, y)[c]) - expected.GetPixel(x, y)[c];
+					squaredError += delta * delta;
+				}
+			}
+		}
+
+		const double meanSquaredError = squaredError / (static_cast<double>(expected.width) * expected.height * channelCount);
+		return (meanSquaredError > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 100.0;
+	}
+
+	Image RoundTrip(const Image& image, TextureCompression compression, CompressionQuality quality, std::vector<uint8_t>& blocks)
+	{
+		JobSystem jobSystem(2);
+		CompressTexture(image.pixels.data(), image.width, image.height, compression, quality, jobSystem, blocks);
+
+		Image decoded;
+		DecompressForValidation(blocks.data(), compression, image.width, image.height, decoded);
+		return decoded;
+	}
+
+	Image RoundTrip(const Image& image, TextureCompression compression, CompressionQuality quality)
+	{
+		std::vector<uint8_t> blocks;
+		return RoundTrip(image, compression, quality, blocks);
+	}
+
+	// Opaque copy, for the formats whose error is measured on color only
+	Image MakeOpaque(const Image& image)
+	{
+		Image opaque = image;
+		for (size_t i = 3; i < opaque.pixels.size(); i += Image::kBytesPerPixel)
+		{
+			opaque.pixels[i] = 255;
+		}
+		return opaque;
+	}
+
+	uint32_t ReadBits(const uint8_t* block, uint32_t position, uint32_t bitCount)
+	{
+		uint32_t value = 0;
+		for (uint32_t bit = 0; bit < bitCount; ++bit)
+		{
+			value |= ((block[(position + bit) / 8] >> ((position + bit) % 8)) & 1u) << bit;
+		}
+		return value;
+	}
+}
+
+BIRDGAME_TEST(TextureCompressionMeetsQualityFloors)
+{
+	struct Case
+	{
+		TextureCompression compression;
+		CompressionQuality quality;
+		uint32_t channelCount;
+		double minimumPsnr;
+	};
+
+	// A few dB under what the encoder reaches today, so a regression in the endpoint fit shows up here
+	const Case cases[] = {
+		{ TextureCompression::BC1, CompressionQuality::Fast, 3, 36.0 },
+		{ TextureCompression::BC1, CompressionQuality::Normal, 3, 37.0 },
+		{ TextureCompression::BC1, CompressionQuality::High, 3, 37.0 },
+		{ TextureCompression::BC3, CompressionQuality::Fast, 4, 37.0 },
+		{ TextureCompression::BC3, CompressionQuality::Normal, 4, 38.0 },
+		{ TextureCompression::BC3, CompressionQuality::High, 4, 38.0 },
+		{ TextureCompression::BC7, CompressionQuality::Fast, 4, 36.0 },
+		{ TextureCompression::BC7, CompressionQuality::Normal, 4, 37.0 },
+		{ TextureCompression::BC7, CompressionQuality::High, 4, 37.0 },
+	};
+
+	const Image image = MakeTestImage(128, 64);
+	const Image opaque = MakeOpaque(image);
+	for (const Case& testCase : cases)
+	{
+		const Image& source = (testCase.channelCount == 3) ? opaque : image;
+		const double psnr = GetPsnr(RoundTrip(source, testCase.compression, testCase.quality), source, testCase.channelCount);
+		BIRDGAME_CHECK(psnr >= testCase.minimumPsnr);
+	}
+}
+
+BIRDGAME_TEST(TextureCompressionHandlesPartialEdgeBlocks)
+{
+	const Image image = MakeTestImage(67, 45);
+	for (TextureCompression compression : { TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC7 })
+	{
+		const Image& source = (compression == TextureCompression::BC1) ? MakeOpaque(image) : image;
+		std::vector<uint8_t> blocks;
+		const Image decoded = RoundTrip(source, compression, CompressionQuality::Normal, blocks);
+
+		// 17 x 12 blocks, the last column and row only partly covered
+		BIRDGAME_CHECK(blocks.size() == 17 * 12 * GetCompressedBlockSize(compression));
+		BIRDGAME_CHECK(GetCompressedRowPitch(compression, 67) == 17 * GetCompressedBlockSize(compression));
+		BIRDGAME_CHECK(decoded.width == 67 && decoded.height == 45);
+
+		// Edge blocks repeat the last row and column, so they compress no worse than the rest
+		const double psnr = GetPsnr(decoded, source, 4);
+		BIRDGAME_CHECK(psnr >= 35.0);
+	}
+
+	// A single texel is a block of one color
+	Image texel;
+	texel.Resize(1, 1);
+	texel.pixels = { 200, 100, 50, 255 };
+	for (TextureCompression compression : { TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC7 })
+	{
+		const Image decoded = RoundTrip(texel, compression, CompressionQuality::Fast);
+		BIRDGAME_CHECK(decoded.width == 1 && decoded.height == 1);
+		BIRDGAME_CHECK(GetPsnr(decoded, texel, 4) >= 40.0);
+	}
+}
+
+BIRDGAME_TEST(TextureCompressionKeepsBc1CutOutAlpha)
+{
+	// Alpha on both sides of the cut out threshold, including blocks with no opaque texels at all
+	Image image = MakeTestImage(64, 64);
+	for (size_t i = 3; i < image.pixels.size(); i += Image::kBytesPerPixel)
+	{
+		image.pixels[i] = (image.pixels[i] >= 128) ? 255 : static_cast<uint8_t>(image.pixels[i] / 2);
+	}
+
+	for (CompressionQuality quality : { CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High })
+	{
+		const Image decoded = RoundTrip(image, TextureCompression::BC1, quality);
+		uint32_t wrongAlpha = 0;
+		uint32_t coloredTransparent = 0;
+		for (uint32_t y = 0; y < image.height; ++y)
+		{
+			for (uint32_t x = 0; x < image.width; ++x)
+			{
+				const uint8_t* pixel = decoded.GetPixel(x, y);
+				const bool opaque = image.GetPixel(x, y)[3] >= 128;
+				wrongAlpha += (pixel[3] != (opaque ? 255 : 0)) ? 1 : 0;
+
+				// Transparent texels decode as black, so filtering doesn't bleed a color around the edges
+				coloredTransparent += (!opaque && (pixel[0] | pixel[1] | pixel[2]) != 0) ? 1 : 0;
+			}
+		}
+		BIRDGAME_CHECK(wrongAlpha == 0);
+		BIRDGAME_CHECK(coloredTransparent == 0);
+	}
+}
+
+BIRDGAME_TEST(TextureCompressionSwapsBc7EndpointsForFirstIndex)
+{
+	// The first texel of each block sits at the dark end of its gradient in one image and the bright end in the other.
+	// Its index is stored without the top bit, so the encoder has to order the endpoints to keep it 0.
+	for (bool brightFirst : { false, true })
+	{
+		Image image;
+		image.Resize(4, 4);
+		for (uint32_t texel = 0; texel < 16; ++texel)
+		{
+			const uint8_t value = static_cast<uint8_t>(brightFirst ? 255 - texel * 17 : texel * 17);
+			uint8_t* pixel = image.GetPixel(texel % 4, texel / 4);
+			pixel[0] = value;
+			pixel[1] = value;
+			pixel[2] = value;
+			pixel[3] = 255;
+		}
+
+		for (CompressionQuality quality : { CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High })
+		{
+			std::vector<uint8_t> blocks;
+			const Image decoded = RoundTrip(image, TextureCompression::BC7, quality, blocks);
+			BIRDGAME_CHECK(GetPsnr(decoded, image, 4) >= 40.0);
+
+			// Mode 6, then red of endpoint 0 and endpoint 1: the endpoint nearest the first texel comes first
+			BIRDGAME_CHECK(ReadBits(blocks.data(), 0, 7) == (1u << 6));
+			const uint32_t red0 = ReadBits(blocks.data(), 7, 7);
+			const uint32_t red1 = ReadBits(blocks.data(), 14, 7);
+			BIRDGAME_CHECK(brightFirst ? red0 > red1 : red0 < red1);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#include "TestFramework.h"
+
+#include "TextureTable.h"
+
+using namespace BirdGame;
+
+BIRDGAME_TEST(TextureTableAllocatesLowestSlotFirst)
+{
+	TextureTable table(8);
+
+	// The first texture is the default one
+	const TextureHandle first = table.Allocate();
+	BIRDGAME_CHECK(first == kDefaultTexture);
+
+	const TextureHandle second = table.Allocate();
+	const TextureHandle third = table.Allocate();
+	const TextureHandle fourth = table.Allocate();
+	BIRDGAME_CHECK(TextureTable::GetIndex(second) == 1 && TextureTable::GetIndex(third) == 2 && TextureTable::GetIndex(fourth) == 3);
+
+	// Freed out of order, slots still come back lowest first, ahead of slots that were never used
+	table.Free(fourth);
+	table.Free(second);
+	table.EndFrame(1);
+	table.Retire(1);
+	BIRDGAME_CHECK(TextureTable::GetIndex(table.Allocate()) == 1);
+	BIRDGAME_CHECK(TextureTable::GetIndex(table.Allocate()) == 3);
+	BIRDGAME_CHECK(TextureTable::GetIndex(table.Allocate()) == 4);
+	BIRDGAME_CHECK(table.GetLiveCount() == 5);
+}
+
+BIRDGAME_TEST(TextureTableChecksGenerations)
+{
+	TextureTable table(4);
+	table.Allocate();
+	const TextureHandle texture = table.Allocate();
+	BIRDGAME_CHECK(table.IsValid(texture));
+
+	// Invalid as soon as it's freed, long before the slot is reused
+	table.Free(texture);
+	BIRDGAME_CHECK(!table.IsValid(texture));
+	table.EndFrame(1);
+	table.Retire(1);
+
+	// Same slot, new generation: the old handle stays invalid
+	const TextureHandle reused = table.Allocate();
+	BIRDGAME_CHECK(TextureTable::GetIndex(reused) == TextureTable::GetIndex(texture));
+	BIRDGAME_CHECK(TextureTable::GetGeneration(reused) == TextureTable::GetGeneration(texture) + 1);
+	BIRDGAME_CHECK(table.IsValid(reused));
+	BIRDGAME_CHECK(!table.IsValid(texture));
+
+	BIRDGAME_CHECK(!table.IsValid(TextureTable::kInvalidHandle));
+	BIRDGAME_CHECK(!table.IsValid(3)); // Never allocated
+}
+
+BIRDGAME_TEST(TextureTableDefersSlotReuseUntilFenceRetires)
+{
+	TextureTable table(4);
+	table.Allocate();
+	const TextureHandle texture = table.Allocate();
+	table.Free(texture);
+	table.EndFrame(5);
+
+	// The GPU may still sample slot 1, so a new texture gets a fresh slot
+	table.Retire(4);
+	BIRDGAME_CHECK(TextureTable::GetIndex(table.Allocate()) == 2);
+
+	table.Retire(5);
+	BIRDGAME_CHECK(TextureTable::GetIndex(table.Allocate()) == 1);
+}
+
+BIRDGAME_TEST(TextureTableFallsBackToDefaultTexture)
+{
+	TextureTable table(4);
+	table.Allocate();
+	const TextureHandle texture = table.Allocate();
+	BIRDGAME_CHECK(table.GetIndexOrDefault(texture) == 1);
+
+	table.Free(texture);
+	table.EndFrame(1);
+	table.Retire(1);
+	const TextureHandle reused = table.Allocate();
+
+	// The stale handle's slot now holds another texture, so it draws with the default one instead
+	BIRDGAME_CHECK(table.GetIndexOrDefault(texture) == TextureTable::GetIndex(kDefaultTexture));
+	BIRDGAME_CHECK(table.GetIndexOrDefault(reused) == 1);
+	BIRDGAME_CHECK(table.GetIndexOrDefault(TextureTable::kInvalidHandle) == TextureTable::GetIndex(kDefaultTexture));
+}
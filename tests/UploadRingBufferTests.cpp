@@ -0,0 +1,109 @@
+#include "TestFramework.h"
+
+#include "UploadRingBuffer.h"
+
+#include <vector>
+
+using namespace BirdGame;
+
+BIRDGAME_TEST(UploadRingBufferPadsForAlignment)
+{
+	std::vector<uint8_t> memory(1024);
+	UploadRingBuffer ring;
+	ring.Initialize(memory.data(), memory.size());
+
+	UploadRingBuffer::Allocation first = {};
+	UploadRingBuffer::Allocation second = {};
+	BIRDGAME_CHECK(ring.TryAllocate(10, 1, first));
+	BIRDGAME_CHECK(ring.TryAllocate(16, 256, second));
+
+	BIRDGAME_CHECK(first.offset == 0 && first.cpuAddress == memory.data());
+	BIRDGAME_CHECK(second.offset == 256 && second.cpuAddress == memory.data() + 256);
+
+	// The padding in front of the aligned allocation counts as used until the frame retires
+	BIRDGAME_CHECK(ring.GetUsed() == 272);
+	ring.EndFrame(1);
+	ring.Retire(1);
+	BIRDGAME_CHECK(ring.GetUsed() == 0);
+	BIRDGAME_CHECK(ring.GetPeakUsed() == 272);
+}
+
+BIRDGAME_TEST(UploadRingBufferWrapsAndWastesTailFragment)
+{
+	UploadRingBuffer ring;
+	ring.Initialize(nullptr, 1024);
+
+	UploadRingBuffer::Allocation allocation = {};
+	BIRDGAME_CHECK(ring.TryAllocate(400, 16, allocation) && allocation.offset == 0);
+	ring.EndFrame(1);
+	BIRDGAME_CHECK(ring.TryAllocate(400, 16, allocation) && allocation.offset == 400);
+	ring.EndFrame(2);
+	ring.Retire(1);
+	BIRDGAME_CHECK(ring.GetUsed() == 400);
+
+	// 224 bytes are left before the end, too few, so the allocation wraps to the freed start of the buffer and
+	// the fragment at the end is used up along with it
+	BIRDGAME_CHECK(ring.TryAllocate(300, 16, allocation));
+	BIRDGAME_CHECK(allocation.offset == 0);
+	BIRDGAME_CHECK(allocation.cpuAddress == nullptr);
+	BIRDGAME_CHECK(ring.GetUsed() == 400 + 224 + 300);
+	ring.EndFrame(3);
+
+	// Only [300, 400) is free now
+	BIRDGAME_CHECK(!ring.TryAllocate(101, 1, allocation));
+	BIRDGAME_CHECK(ring.TryAllocate(100, 1, allocation) && allocation.offset == 300);
+	ring.EndFrame(4);
+
+	// Retiring the wrapped frame frees the fragment too
+	ring.Retire(2);
+	BIRDGAME_CHECK(ring.GetUsed() == 224 + 300 + 100);
+	ring.Retire(3);
+	BIRDGAME_CHECK(ring.GetUsed() == 100);
+	BIRDGAME_CHECK(ring.GetPendingFrameCount() == 1);
+}
+
+BIRDGAME_TEST(UploadRingBufferBlocksUntilOldestFenceRetires)
+{
+	UploadRingBuffer ring;
+	ring.Initialize(nullptr, 1024);
+
+	UploadRingBuffer::Allocation allocation = {};
+	BIRDGAME_CHECK(ring.TryAllocate(512, 1, allocation));
+	ring.EndFrame(1);
+	BIRDGAME_CHECK(ring.TryAllocate(512, 1, allocation));
+	ring.EndFrame(2);
+	BIRDGAME_CHECK(ring.GetUsed() == 1024);
+
+	// Nothing fits while both frames are in flight, however small
+	BIRDGAME_CHECK(!ring.TryAllocate(1, 1, allocation));
+	ring.Retire(0);
+	BIRDGAME_CHECK(!ring.TryAllocate(1, 1, allocation));
+
+	// Once the oldest frame retires its half of the buffer comes back, and no more
+	ring.Retire(1);
+	BIRDGAME_CHECK(ring.GetPendingFrameCount() == 1);
+	BIRDGAME_CHECK(!ring.TryAllocate(513, 1, allocation));
+	BIRDGAME_CHECK(ring.TryAllocate(512, 1, allocation) && allocation.offset == 0);
+	ring.EndFrame(3);
+
+	ring.Retire(3);
+	BIRDGAME_CHECK(ring.GetUsed() == 0 && ring.GetPendingFrameCount() == 0);
+}
+
+BIRDGAME_TEST(UploadRingBufferRejectsWhatNeverFits)
+{
+	UploadRingBuffer ring;
+	ring.Initialize(nullptr, 1024);
+
+	UploadRingBuffer::Allocation allocation = {};
+	BIRDGAME_CHECK(!ring.TryAllocate(1025, 1, allocation));
+	BIRDGAME_CHECK(ring.GetUsed() == 0);
+
+	// The whole buffer fits exactly once, after which it is full until the frame retires
+	BIRDGAME_CHECK(ring.TryAllocate(1024, 256, allocation) && allocation.offset == 0);
+	BIRDGAME_CHECK(ring.GetUsed() == 1024);
+	BIRDGAME_CHECK(!ring.TryAllocate(1, 1, allocation));
+	ring.EndFrame(1);
+	ring.Retire(1);
+	BIRDGAME_CHECK(ring.TryAllocate(1024, 256, allocation) && allocation.offset == 0);
+}